@@ -378,6 +378,29 @@ macro(process_options)
     add_definitions(-DENABLE_DES_METRICS)
   endif()
 
+  if(${NS3_EVENT_POOL})
+    if(${NS3_SANITIZE} OR ${NS3_SANITIZE_MEMORY})
+      message(
+        ${HIGHLIGHTED_STATUS}
+        "The event pool hides event memory errors from the sanitizers. Disabling it."
+      )
+    else()
+      add_definitions(-DNS3_EVENT_POOL)
+    endif()
+  endif()
+
+  if(${NS3_COMPACT_EVENT_KEYS})
+    add_definitions(-DNS3_COMPACT_EVENT_KEYS)
+  endif()
+
+  if(${NS3_FLAT_PACKET_TAGS})
+    add_definitions(-DNS3_FLAT_PACKET_TAGS)
+  endif()
+
+  if(${NS3_MULTITHREADING})
+    add_definitions(-DNS3_MULTITHREADING)
+  endif()
+
   if(${NS3_SANITIZE} AND ${NS3_SANITIZE_MEMORY})
     message(
       FATAL_ERROR
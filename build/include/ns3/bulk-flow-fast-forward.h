@@ -0,0 +1 @@
+#include "/root/repo/src/applications/model/bulk-flow-fast-forward.h"
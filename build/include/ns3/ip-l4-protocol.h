@@ -0,0 +1 @@
+#include "/root/repo/src/internet/model/ip-l4-protocol.h"
@@ -0,0 +1 @@
+#include "/root/repo/src/point-to-point/helper/multithreaded-simulator-helper.h"
@@ -31,6 +31,11 @@ cpp_examples = [
         "True",
         "True",
     ),
+    (
+        "tcp-incast-benchmark --leaves=2 --spines=2 --hostsPerLeaf=4 --flows=16 --flowSize=20000",
+        "True",
+        "False",
+    ),
 ]
 
 # A list of Python examples to run in order to ensure that they remain
@@ -0,0 +1,490 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// Incast and shuffle benchmark for datacenter congestion controls.
+//
+// The hosts are attached to the leaves of a two-tier leaf-spine fabric:
+//
+//        spine 0   ...   spine S-1
+//          |   \         /   |
+//          |    (full mesh)  |
+//          |   /         \   |
+//        leaf 0    ...   leaf L-1
+//        / | \           / | \        (hostsPerLeaf hosts per leaf)
+//      hosts             hosts
+//
+// Two traffic patterns are supported:
+// * incast: "flows" flows, spread round-robin over all the other hosts,
+//   all send "flowSize" bytes to host 0;
+// * shuffle: every host sends "flowSize" bytes to every other host.
+//
+// All the flows start within "startWindow" of each other. The simulation
+// ends when every flow has completed, or at "stopTime".
+//
+// The program runs each of the TCP variants listed in "tcpTypeIds" in
+// turn (by default TcpSwift, TcpDctcp, TcpBbr and TcpCubic), and reports
+// for each of them:
+// * the flow completion time (FCT) percentiles, over the completed flows;
+// * the queueing delay percentiles, sampled at every switch queue disc;
+// * the number of simulator events, and events per second of wall-clock
+//   time, to track the scaling of the simulator itself;
+// * the mean and peak size of the event list, sampled every 10 us, which
+//   counts the cancelled events until their time is reached; compare with
+//   "--timerWheel", which runs the TCP timers on the timer wheel of each
+//   node, to see how many of them are cancelled timers;
+// * the peak resident set size of the process. The peak is never reset:
+//   run one TCP variant per invocation to measure each of them separately.
+//
+// The flows are spread over the spines by flow-hash ECMP; "--ecmp=0" routes
+// them all through a single spine instead.
+//
+// Switch ports use a RED queue disc marking ECN at "ecnThreshold" for
+// TcpDctcp, and a FIFO queue disc of the same size otherwise.
+//
+// Example, 1000-to-1 incast of 64 KB flows:
+//   ./ns3 run "tcp-incast-benchmark --flows=1000 --flowSize=65536"
+//
+// Example, 10000-to-1 incast with the TCP timers on the timer wheel:
+//   ./ns3 run "tcp-incast-benchmark --flows=10000 --tcpTypeIds=TcpDctcp --timerWheel"
+
+#include "ns3/applications-module.h"
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-layout-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/stats-module.h"
+#include "ns3/traffic-control-module.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <unordered_map>
+
+#ifdef __unix__
+#include <sys/resource.h>
+#endif
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("TcpIncastBenchmark");
+
+/// State of a flow of the benchmark
+struct FlowRecord
+{
+    Ptr<BulkSendApplication> sender; //!< Sending application
+    Time start;                      //!< Start time
+    uint64_t size;                   //!< Size, in bytes
+    uint64_t received;               //!< Bytes received so far
+    Time fct;                        //!< Flow completion time, or zero
+};
+
+std::vector<FlowRecord> g_flows;                   //!< Flows of the current run
+std::unordered_map<uint64_t, uint32_t> g_flowById; //!< Flow index by sender address and port
+uint32_t g_completedFlows = 0;                     //!< Number of completed flows
+Histogram g_queueDelay(1);                         //!< Queueing delays, in microseconds
+uint64_t g_peakEventListSize = 0;                  //!< Peak size of the event list
+double g_eventListSizeSum = 0;                     //!< Sum of the sampled event list sizes
+uint64_t g_eventListSamples = 0;                   //!< Number of event list size samples
+
+/**
+ * \param address the sender IPv4 address
+ * \param port the sender port
+ * \return the key of the flow in g_flowById
+ */
+uint64_t
+FlowKey(Ipv4Address address, uint16_t port)
+{
+    return (static_cast<uint64_t>(address.Get()) << 16) | port;
+}
+
+/**
+ * Map the address and port of the sender socket to the flow, once the
+ * application has opened and connected it.
+ *
+ * \param index the flow index
+ */
+void
+RegisterFlow(uint32_t index)
+{
+    Address local;
+    g_flows[index].sender->GetSocket()->GetSockName(local);
+    InetSocketAddress address = InetSocketAddress::ConvertFrom(local);
+    g_flowById[FlowKey(address.GetIpv4(), address.GetPort())] = index;
+}
+
+/**
+ * Account for the data received by a sink, and stop the simulation once
+ * every flow has completed.
+ *
+ * \param packet the received packet
+ * \param from the sender address
+ */
+void
+TraceSinkRx(Ptr<const Packet> packet, const Address& from)
+{
+    InetSocketAddress address = InetSocketAddress::ConvertFrom(from);
+    auto it = g_flowById.find(FlowKey(address.GetIpv4(), address.GetPort()));
+    if (it == g_flowById.end())
+    {
+        return;
+    }
+    FlowRecord& flow = g_flows[it->second];
+    flow.received += packet->GetSize();
+    if (flow.received >= flow.size && flow.fct.IsZero())
+    {
+        flow.fct = Simulator::Now() - flow.start;
+        if (++g_completedFlows == g_flows.size())
+        {
+            Simulator::Stop();
+        }
+    }
+}
+
+/**
+ * Record the time spent by a packet in a switch queue disc.
+ *
+ * \param sojourn the sojourn time
+ */
+void
+TraceSojournTime(Time sojourn)
+{
+    g_queueDelay.AddValue(sojourn.GetMicroSeconds());
+}
+
+/**
+ * Sample the size of the event list, and schedule the next sample.
+ *
+ * \param interval the sampling interval
+ */
+void
+SampleEventListSize(Time interval)
+{
+    uint64_t size = Simulator::GetPendingEventCount();
+    g_peakEventListSize = std::max(g_peakEventListSize, size);
+    g_eventListSizeSum += size;
+    g_eventListSamples++;
+    Simulator::Schedule(interval, &SampleEventListSize, interval);
+}
+
+/**
+ * \param sorted sorted samples
+ * \param p the percentile, in [0, 1]
+ * \return the nearest-rank percentile of the samples
+ */
+double
+Percentile(const std::vector<double>& sorted, double p)
+{
+    if (sorted.empty())
+    {
+        return 0;
+    }
+    auto rank = static_cast<std::size_t>(std::ceil(p * sorted.size()));
+    return sorted[std::max<std::size_t>(rank, 1) - 1];
+}
+
+/**
+ * \param histogram the histogram
+ * \param p the percentile, in [0, 1]
+ * \return the upper end of the bin holding the percentile of the histogram
+ */
+double
+Percentile(const Histogram& histogram, double p)
+{
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < histogram.GetNBins(); i++)
+    {
+        total += histogram.GetBinCount(i);
+    }
+    auto rank = std::max<uint64_t>(static_cast<uint64_t>(std::ceil(p * total)), 1);
+    uint64_t count = 0;
+    for (uint32_t i = 0; i < histogram.GetNBins(); i++)
+    {
+        count += histogram.GetBinCount(i);
+        if (count >= rank)
+        {
+            return histogram.GetBinEnd(i);
+        }
+    }
+    return 0;
+}
+
+/**
+ * \return the peak resident set size of the process, in KB, or zero if unknown
+ */
+uint64_t
+GetPeakRss()
+{
+#ifdef __unix__
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+    {
+        return usage.ru_maxrss;
+    }
+#endif
+    return 0;
+}
+
+/// Parameters of a benchmark run
+struct BenchmarkConfig
+{
+    std::string pattern;   //!< Traffic pattern: incast or shuffle
+    uint32_t spines;       //!< Number of spine switches
+    uint32_t leaves;       //!< Number of leaf switches
+    uint32_t hostsPerLeaf; //!< Number of hosts per leaf
+    uint32_t flows;        //!< Number of incast flows
+    uint64_t flowSize;     //!< Flow size, in bytes
+    DataRate hostRate;     //!< Host link rate
+    DataRate fabricRate;   //!< Leaf to spine link rate
+    Time linkDelay;        //!< Propagation delay of every link
+    QueueSize bufferSize;  //!< Switch queue disc size
+    uint32_t ecnThreshold; //!< DCTCP marking threshold, in packets
+    Time startWindow;      //!< Window over which the flows start
+    Time stopTime;         //!< Time at which the simulation is stopped
+    bool ecmp;             //!< Whether to enable flow-hash ECMP in the fabric
+};
+
+/**
+ * Build the fabric, run the flows with the given TCP variant and print
+ * the results.
+ *
+ * \param config the benchmark parameters
+ * \param tcpTypeId the TCP congestion control TypeId, without "ns3::"
+ */
+void
+RunBenchmark(const BenchmarkConfig& config, const std::string& tcpTypeId)
+{
+    bool dctcp = (tcpTypeId == "TcpDctcp");
+    Config::SetDefault("ns3::TcpL4Protocol::SocketType", StringValue("ns3::" + tcpTypeId));
+    // Swift needs microsecond RTT samples (the TS option has ms granularity)
+    // and the receiver host delay echo
+    Config::SetDefault("ns3::TcpSocketBase::Timestamp", BooleanValue(tcpTypeId != "TcpSwift"));
+    Config::SetDefault("ns3::TcpSocketBase::HostDelay", BooleanValue(tcpTypeId == "TcpSwift"));
+    // Spread the flows, not the packets, over the equal-cost paths, so that
+    // ECMP does not reorder the segments of a flow
+    Config::SetDefault("ns3::Ipv4GlobalRouting::EcmpMode",
+                       StringValue(config.ecmp ? "FlowHash" : "FirstRoute"));
+
+    // Queue in the switch queue discs, not in the devices
+    PointToPointHelper hostLink;
+    hostLink.SetDeviceAttribute("DataRate", DataRateValue(config.hostRate));
+    hostLink.SetChannelAttribute("Delay", TimeValue(config.linkDelay));
+    hostLink.SetQueue("ns3::DropTailQueue", "MaxSize", StringValue("10p"));
+    PointToPointHelper fabricLink;
+    fabricLink.SetDeviceAttribute("DataRate", DataRateValue(config.fabricRate));
+    fabricLink.SetChannelAttribute("Delay", TimeValue(config.linkDelay));
+    fabricLink.SetQueue("ns3::DropTailQueue", "MaxSize", StringValue("10p"));
+
+    TrafficControlHelper switchQueue;
+    if (dctcp)
+    {
+        switchQueue.SetRootQueueDisc("ns3::RedQueueDisc",
+                                     "MaxSize",
+                                     QueueSizeValue(config.bufferSize),
+                                     "UseEcn",
+                                     BooleanValue(true),
+                                     "UseHardDrop",
+                                     BooleanValue(false),
+                                     "QW",
+                                     DoubleValue(1),
+                                     "MinTh",
+                                     DoubleValue(config.ecnThreshold),
+                                     "MaxTh",
+                                     DoubleValue(config.ecnThreshold + 1));
+    }
+    else
+    {
+        switchQueue.SetRootQueueDisc("ns3::FifoQueueDisc",
+                                     "MaxSize",
+                                     QueueSizeValue(config.bufferSize));
+    }
+
+    PointToPointLeafSpineHelper fabric(config.spines,
+                                       config.leaves,
+                                       config.hostsPerLeaf,
+                                       hostLink,
+                                       fabricLink);
+    fabric.InstallStack(InternetStackHelper());
+    QueueDiscContainer queueDiscs = fabric.InstallSwitchQueueDiscs(switchQueue);
+    fabric.AssignIpv4Addresses(Ipv4Address("10.0.0.0"), Ipv4Mask("255.0.0.0"));
+    NodeContainer hosts = fabric.GetHosts();
+    for (uint32_t i = 0; i < queueDiscs.GetN(); i++)
+    {
+        queueDiscs.Get(i)->TraceConnectWithoutContext("SojournTime",
+                                                      MakeCallback(&TraceSojournTime));
+    }
+
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+
+    // One sink per receiving host
+    const uint16_t port = 5000;
+    std::vector<bool> receiver(hosts.GetN(), false);
+    std::vector<std::pair<uint32_t, uint32_t>> pairs;
+    if (config.pattern == "incast")
+    {
+        NS_ABORT_MSG_IF(hosts.GetN() < 2, "Incast needs at least two hosts");
+        for (uint32_t i = 0; i < config.flows; i++)
+        {
+            pairs.emplace_back(1 + i % (hosts.GetN() - 1), 0);
+        }
+    }
+    else if (config.pattern == "shuffle")
+    {
+        for (uint32_t src = 0; src < hosts.GetN(); src++)
+        {
+            for (uint32_t dst = 0; dst < hosts.GetN(); dst++)
+            {
+                if (src != dst)
+                {
+                    pairs.emplace_back(src, dst);
+                }
+            }
+        }
+    }
+    else
+    {
+        NS_ABORT_MSG("Unknown traffic pattern " << config.pattern);
+    }
+
+    PacketSinkHelper sinkHelper("ns3::TcpSocketFactory",
+                                InetSocketAddress(Ipv4Address::GetAny(), port));
+    Ptr<UniformRandomVariable> jitter = CreateObject<UniformRandomVariable>();
+    jitter->SetAttribute("Max", DoubleValue(config.startWindow.GetSeconds()));
+    g_flows.clear();
+    g_flows.reserve(pairs.size());
+    g_flowById.clear();
+    g_completedFlows = 0;
+    g_queueDelay.Clear();
+    g_peakEventListSize = 0;
+    g_eventListSizeSum = 0;
+    g_eventListSamples = 0;
+    for (const auto& [src, dst] : pairs)
+    {
+        if (!receiver[dst])
+        {
+            ApplicationContainer sink = sinkHelper.Install(hosts.Get(dst));
+            sink.Get(0)->TraceConnectWithoutContext("Rx", MakeCallback(&TraceSinkRx));
+            receiver[dst] = true;
+        }
+        BulkSendHelper sender("ns3::TcpSocketFactory",
+                              InetSocketAddress(fabric.GetHostIpv4Address(dst), port));
+        sender.SetAttribute("MaxBytes", UintegerValue(config.flowSize));
+        ApplicationContainer app = sender.Install(hosts.Get(src));
+        Time start = MilliSeconds(1) + Seconds(jitter->GetValue());
+        app.Start(start);
+
+        auto index = static_cast<uint32_t>(g_flows.size());
+        g_flows.push_back(
+            {DynamicCast<BulkSendApplication>(app.Get(0)), start, config.flowSize, 0, Time()});
+        // The application connects its socket at the start time
+        Simulator::Schedule(start + NanoSeconds(1), &RegisterFlow, index);
+    }
+
+    Simulator::Schedule(MicroSeconds(10), &SampleEventListSize, MicroSeconds(10));
+    Simulator::Stop(config.stopTime);
+    auto wallStart = std::chrono::steady_clock::now();
+    Simulator::Run();
+    std::chrono::duration<double> wall = std::chrono::steady_clock::now() - wallStart;
+    uint64_t events = Simulator::GetEventCount();
+    Time simulated = Simulator::Now();
+
+    std::vector<double> fcts;
+    fcts.reserve(g_completedFlows);
+    for (const auto& flow : g_flows)
+    {
+        if (!flow.fct.IsZero())
+        {
+            fcts.push_back(flow.fct.GetMicroSeconds());
+        }
+    }
+    std::sort(fcts.begin(), fcts.end());
+
+    std::cout << "=== " << tcpTypeId << " " << config.pattern << ": " << hosts.GetN()
+              << " hosts, " << g_flows.size() << " flows of " << config.flowSize << " bytes"
+              << std::endl;
+    std::cout << "Completed flows:     " << g_completedFlows << "/" << g_flows.size() << " in "
+              << simulated.As(Time::MS) << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "FCT (us):            p50 " << Percentile(fcts, 0.5) << ", p99 "
+              << Percentile(fcts, 0.99) << ", p99.9 " << Percentile(fcts, 0.999) << ", max "
+              << (fcts.empty() ? 0 : fcts.back()) << std::endl;
+    std::cout << "Queue delay (us):    p50 " << Percentile(g_queueDelay, 0.5) << ", p99 "
+              << Percentile(g_queueDelay, 0.99) << ", p99.9 " << Percentile(g_queueDelay, 0.999)
+              << std::endl;
+    std::cout << "Events:              " << events << " in " << wall.count() << " s, "
+              << std::setprecision(0) << events / std::max(wall.count(), 1e-9) << " events/s"
+              << std::endl;
+    std::cout << "Event list (events): mean "
+              << g_eventListSizeSum / std::max<uint64_t>(g_eventListSamples, 1) << ", peak "
+              << g_peakEventListSize << std::endl;
+    std::cout << "Peak RSS (KB):       " << GetPeakRss() << std::endl;
+
+    g_flows.clear();
+    g_flowById.clear();
+    Simulator::Destroy();
+}
+
+int
+main(int argc, char* argv[])
+{
+    BenchmarkConfig config;
+    config.pattern = "incast";
+    config.spines = 4;
+    config.leaves = 8;
+    config.hostsPerLeaf = 16;
+    config.flows = 100;
+    config.flowSize = 64 * 1024;
+    config.hostRate = DataRate("10Gbps");
+    config.fabricRate = DataRate("40Gbps");
+    config.linkDelay = MicroSeconds(1);
+    config.bufferSize = QueueSize("1000p");
+    config.ecnThreshold = 65;
+    config.startWindow = MicroSeconds(10);
+    config.stopTime = Seconds(10);
+    config.ecmp = true;
+    std::string tcpTypeIds = "TcpSwift,TcpDctcp,TcpBbr,TcpCubic";
+    Time minRto = MilliSeconds(5);
+    bool timerWheel = false;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("tcpTypeIds", "Comma-separated list of ns-3 TCP TypeIds to run", tcpTypeIds);
+    cmd.AddValue("pattern", "Traffic pattern: incast or shuffle", config.pattern);
+    cmd.AddValue("spines", "Number of spine switches", config.spines);
+    cmd.AddValue("leaves", "Number of leaf switches", config.leaves);
+    cmd.AddValue("hostsPerLeaf", "Number of hosts per leaf switch", config.hostsPerLeaf);
+    cmd.AddValue("flows", "Number of incast flows", config.flows);
+    cmd.AddValue("flowSize", "Flow size, in bytes", config.flowSize);
+    cmd.AddValue("hostRate", "Host link rate", config.hostRate);
+    cmd.AddValue("fabricRate", "Leaf to spine link rate", config.fabricRate);
+    cmd.AddValue("linkDelay", "Propagation delay of every link", config.linkDelay);
+    cmd.AddValue("bufferSize", "Switch queue disc size", config.bufferSize);
+    cmd.AddValue("ecnThreshold", "DCTCP marking threshold, in packets", config.ecnThreshold);
+    cmd.AddValue("startWindow", "Window over which the flows start", config.startWindow);
+    cmd.AddValue("stopTime", "Maximum simulated time", config.stopTime);
+    cmd.AddValue("ecmp",
+                 "Spread the flows over the spines with flow-hash ECMP, rather than "
+                 "routing them all through one spine",
+                 config.ecmp);
+    cmd.AddValue("minRto", "TCP minimum retransmission timeout", minRto);
+    cmd.AddValue("timerWheel", "Run the TCP timers on the timer wheel of each node", timerWheel);
+    cmd.Parse(argc, argv);
+
+    Config::SetDefault("ns3::TcpSocket::SegmentSize", UintegerValue(1448));
+    Config::SetDefault("ns3::TcpSocket::DelAckCount", UintegerValue(2));
+    Config::SetDefault("ns3::TcpSocketBase::MinRto", TimeValue(minRto));
+    Config::SetDefault("ns3::TcpSocketBase::ClockGranularity", TimeValue(MicroSeconds(10)));
+    Config::SetDefault("ns3::TcpSocketBase::TimerWheel", BooleanValue(timerWheel));
+    GlobalValue::Bind("ChecksumEnabled", BooleanValue(false));
+
+    std::istringstream list(tcpTypeIds);
+    std::string tcpTypeId;
+    while (std::getline(list, tcpTypeId, ','))
+    {
+        RunBenchmark(config, tcpTypeId);
+    }
+    return 0;
+}
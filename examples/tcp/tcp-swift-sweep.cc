@@ -0,0 +1,231 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// Parameter sweep of TcpSwift, sharing the warm-up of the flows.
+//
+// "senders" long-lived TcpSwift flows share the bottleneck of a dumbbell:
+//
+//   sender 0 --+                          +-- receiver
+//      ...     +-- router --------- router
+//   sender N --+      (bottleneck)
+//
+// The flows start within the first millisecond and converge during
+// "warmup".  The program then measures, for every pair of "baseTargets" and
+// "ais" values, the goodput and the mean queueing delay at the bottleneck
+// during "measure", with the BaseTarget and AI attributes of TcpSwift set
+// to these values on every socket.
+//
+// By default, the warm-up runs once: the simulation is forked at the end of
+// the warm-up, and every point of the grid is measured in a child process
+// (see ns3::SimulationFork).  With "--fork=false", the whole simulation runs
+// once per point, with the attributes set at the same time, to compare the
+// wall-clock time of the two methods.
+//
+// Example:
+//   ./ns3 run "tcp-swift-sweep --baseTargets=50us,100us,200us --ais=0.5,1,2"
+
+#include "ns3/applications-module.h"
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-layout-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/traffic-control-module.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("TcpSwiftSweep");
+
+Ptr<PacketSink> g_sink;      //!< The sink of all the flows
+uint64_t g_rxStart = 0;      //!< Bytes received at the start of the measurement
+double g_sojournSum = 0;     //!< Sum of the queueing delays, in microseconds
+uint64_t g_sojournCount = 0; //!< Number of queueing delay samples
+
+/**
+ * Record the time spent by a packet in the bottleneck queue disc.
+ *
+ * \param sojourn the sojourn time
+ */
+void
+TraceSojournTime(Time sojourn)
+{
+    g_sojournSum += sojourn.GetMicroSeconds();
+    g_sojournCount++;
+}
+
+/**
+ * Set the parameters of TcpSwift on every existing socket, and start the
+ * measurement.
+ *
+ * \param baseTarget the BaseTarget attribute
+ * \param ai the AI attribute
+ */
+void
+StartMeasurement(Time baseTarget, double ai)
+{
+    const std::string swift = "/NodeList/*/$ns3::TcpL4Protocol/SocketList/*/CongestionOps/"
+                              "$ns3::TcpSwift/";
+    Config::Set(swift + "BaseTarget", TimeValue(baseTarget));
+    Config::Set(swift + "AI", DoubleValue(ai));
+    g_rxStart = g_sink->GetTotalRx();
+    g_sojournSum = 0;
+    g_sojournCount = 0;
+}
+
+/**
+ * \param measure the duration of the measurement
+ * \return the goodput and mean queueing delay measured since
+ * StartMeasurement()
+ */
+std::string
+GetMeasurement(Time measure)
+{
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(1)
+        << (g_sink->GetTotalRx() - g_rxStart) * 8 / measure.GetSeconds() / 1e6 << " Mbps, "
+        << g_sojournSum / std::max<uint64_t>(g_sojournCount, 1) << " us";
+    return oss.str();
+}
+
+/**
+ * Build the dumbbell and schedule the flows.
+ *
+ * \param senders the number of senders
+ * \param bottleneck the bottleneck rate
+ */
+void
+BuildScenario(uint32_t senders, DataRate bottleneck)
+{
+    PointToPointHelper leafLink;
+    leafLink.SetDeviceAttribute("DataRate", StringValue("10Gbps"));
+    leafLink.SetChannelAttribute("Delay", StringValue("1us"));
+    PointToPointHelper routerLink;
+    routerLink.SetDeviceAttribute("DataRate", DataRateValue(bottleneck));
+    routerLink.SetChannelAttribute("Delay", StringValue("5us"));
+    routerLink.SetQueue("ns3::DropTailQueue", "MaxSize", StringValue("10p"));
+    PointToPointDumbbellHelper dumbbell(senders, leafLink, 1, leafLink, routerLink);
+    dumbbell.InstallStack(InternetStackHelper());
+
+    // The first device of the left router is the bottleneck
+    TrafficControlHelper bottleneckQueue;
+    bottleneckQueue.SetRootQueueDisc("ns3::FifoQueueDisc", "MaxSize", StringValue("1000p"));
+    QueueDiscContainer queueDiscs = bottleneckQueue.Install(dumbbell.GetLeft()->GetDevice(0));
+    queueDiscs.Get(0)->TraceConnectWithoutContext("SojournTime",
+                                                  MakeCallback(&TraceSojournTime));
+
+    dumbbell.AssignIpv4Addresses(Ipv4AddressHelper("10.1.0.0", "255.255.255.0"),
+                                 Ipv4AddressHelper("10.2.0.0", "255.255.255.0"),
+                                 Ipv4AddressHelper("10.3.0.0", "255.255.255.0"));
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+
+    const uint16_t port = 5000;
+    PacketSinkHelper sinkHelper("ns3::TcpSocketFactory",
+                                InetSocketAddress(Ipv4Address::GetAny(), port));
+    ApplicationContainer sink = sinkHelper.Install(dumbbell.GetRight(0));
+    g_sink = DynamicCast<PacketSink>(sink.Get(0));
+
+    BulkSendHelper sender("ns3::TcpSocketFactory",
+                          InetSocketAddress(dumbbell.GetRightIpv4Address(0), port));
+    for (uint32_t i = 0; i < senders; i++)
+    {
+        ApplicationContainer app = sender.Install(dumbbell.GetLeft(i));
+        app.Start(MicroSeconds(1000 * i / senders));
+    }
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t senders = 16;
+    DataRate bottleneck("10Gbps");
+    Time warmup = MilliSeconds(100);
+    Time measure = MilliSeconds(20);
+    std::string baseTargets = "50us,100us,200us,300us";
+    std::string ais = "0.5,1,2,4";
+    bool fork = true;
+    uint32_t maxChildren = 0;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("senders", "Number of senders", senders);
+    cmd.AddValue("bottleneck", "Bottleneck rate", bottleneck);
+    cmd.AddValue("warmup", "Duration of the shared warm-up", warmup);
+    cmd.AddValue("measure", "Duration of the measurement of every point", measure);
+    cmd.AddValue("baseTargets", "Comma-separated list of TcpSwift BaseTarget values", baseTargets);
+    cmd.AddValue("ais", "Comma-separated list of TcpSwift AI values", ais);
+    cmd.AddValue("fork", "Fork the points of the grid after a single warm-up", fork);
+    cmd.AddValue("maxChildren", "Maximum number of running children, 0 for default", maxChildren);
+    cmd.Parse(argc, argv);
+
+    Config::SetDefault("ns3::TcpL4Protocol::SocketType", StringValue("ns3::TcpSwift"));
+    Config::SetDefault("ns3::TcpSocket::SegmentSize", UintegerValue(1448));
+    Config::SetDefault("ns3::TcpSocketBase::Timestamp", BooleanValue(false));
+    Config::SetDefault("ns3::TcpSocketBase::HostDelay", BooleanValue(true));
+    Config::SetDefault("ns3::TcpSocketBase::MinRto", TimeValue(MilliSeconds(5)));
+    GlobalValue::Bind("ChecksumEnabled", BooleanValue(false));
+
+    std::vector<std::pair<Time, double>> grid;
+    std::istringstream targetList(baseTargets);
+    std::string target;
+    while (std::getline(targetList, target, ','))
+    {
+        std::istringstream aiList(ais);
+        std::string ai;
+        while (std::getline(aiList, ai, ','))
+        {
+            grid.emplace_back(Time(target), std::stod(ai));
+        }
+    }
+
+    auto wallStart = std::chrono::steady_clock::now();
+    std::vector<std::string> results;
+    if (fork)
+    {
+        BuildScenario(senders, bottleneck);
+        SimulationFork simulationFork;
+        if (maxChildren > 0)
+        {
+            simulationFork.SetMaxChildren(maxChildren);
+        }
+        uint32_t point = simulationFork.ForkAt(warmup, grid.size());
+        if (simulationFork.IsChild())
+        {
+            StartMeasurement(grid[point].first, grid[point].second);
+            Simulator::Stop(measure);
+            Simulator::Run();
+            simulationFork.Exit(GetMeasurement(measure));
+        }
+        results = simulationFork.GetResults();
+        Simulator::Destroy();
+    }
+    else
+    {
+        for (const auto& [baseTarget, ai] : grid)
+        {
+            BuildScenario(senders, bottleneck);
+            Simulator::Schedule(warmup, &StartMeasurement, baseTarget, ai);
+            Simulator::Stop(warmup + measure);
+            Simulator::Run();
+            results.push_back(GetMeasurement(measure));
+            Simulator::Destroy();
+        }
+    }
+    std::chrono::duration<double> wall = std::chrono::steady_clock::now() - wallStart;
+
+    for (std::size_t i = 0; i < grid.size(); i++)
+    {
+        std::cout << "BaseTarget " << grid[i].first.As(Time::US) << ", AI " << grid[i].second
+                  << ": " << results[i] << std::endl;
+    }
+    std::cout << grid.size() << " points in " << std::fixed << std::setprecision(2)
+              << wall.count() << " s" << (fork ? " (forked after the warm-up)" : "")
+              << std::endl;
+    return 0;
+}
@@ -1,28 +1,47 @@
+import struct
+import sys
+
 import matplotlib.pyplot as plt
 
+# Flow to plot, and binary trace written by ns3::TcpCongestionTraceSink
+flow = int(sys.argv[1]) if len(sys.argv) > 1 else 1
+trace = sys.argv[2] if len(sys.argv) > 2 else 'cc-trace.bin'
+segment_size = 1448
+
 # Initialize lists to store data
 time = []
 cwnd = []
 current_delay = []
 target_delay = []
 
-# Read the data from file
-with open('cwnd-flow1.dat', 'r') as f:
-    for line in f:
-        # Skip empty lines
-        if not line.strip():
-            continue
-        # Parse columns
-        cols = line.split()
-        t = float(cols[0])
-        c = float(cols[1])
-        cur_d = float(cols[2])
-        tar_d = float(cols[3])
-        
-        time.append(t)
-        cwnd.append(c)
-        current_delay.append(cur_d)
-        target_delay.append(tar_d)
+
+def read_column(f, fmt, count):
+    size = struct.calcsize(fmt)
+    return struct.unpack('=%d%s' % (count, fmt), f.read(size * count))
+
+
+# Read the data from file: a magic string, then batches of
+# (count, time[], flow[], cwnd[], delay[], target[]) columns
+with open(trace, 'rb') as f:
+    if f.read(8) != b'NS3CCTR1':
+        sys.exit('%s is not a congestion control trace' % trace)
+    while True:
+        header = f.read(4)
+        if len(header) < 4:
+            break
+        (count,) = struct.unpack('=I', header)
+        t = read_column(f, 'q', count)
+        ids = read_column(f, 'I', count)
+        c = read_column(f, 'I', count)
+        cur_d = read_column(f, 'q', count)
+        tar_d = read_column(f, 'q', count)
+        for i in range(count):
+            if ids[i] != flow:
+                continue
+            time.append(t[i] / 1e9)
+            cwnd.append(c[i] / segment_size)
+            current_delay.append(cur_d[i] / 1e9)
+            target_delay.append(tar_d[i] / 1e9)
 
 # First figure: CWND over time
 plt.figure(figsize=(8, 4))
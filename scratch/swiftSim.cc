@@ -307,18 +307,47 @@ CheckT2QueueSize (Ptr<QueueDisc> queue)
 }
 
 static std::vector<ns3::Ptr<ns3::TcpSwift>> g_swiftFlows;
+static std::string g_tcpTypeId;
 
 void
-RetrieveTcb (Ptr<OnOffApplication> onoffApp, uint32_t flowIndex)
+TraceS2R2Fluid (uint32_t flow, uint64_t bytes)
 {
-  Ptr<Socket> sock = onoffApp->GetSocket();
+  rxS2R2Bytes[0] += bytes;
+}
+
+void
+TraceS2R2Mode (uint32_t flow, bool fluid)
+{
+  std::cout << "S2-R2 flow switched to " << (fluid ? "the fluid model" : "packets")
+            << " at " << Simulator::Now ().GetSeconds () << " seconds" << std::endl;
+}
+
+void
+RetrieveTcb (Ptr<Application> app, uint32_t flowIndex)
+{
+  Ptr<Socket> sock;
+  if (Ptr<OnOffApplication> onoff = DynamicCast<OnOffApplication> (app))
+    {
+      sock = onoff->GetSocket ();
+    }
+  else if (Ptr<BulkSendApplication> bulk = DynamicCast<BulkSendApplication> (app))
+    {
+      sock = bulk->GetSocket ();
+    }
   Ptr<TcpSocketBase> tcpSocketBase = DynamicCast<TcpSocketBase>(sock);
   if (tcpSocketBase)
     {
 
-  Ptr<TcpSwift> swift = CreateObject<TcpSwift>();
-  swift->SetFlowIndex(flowIndex);  // Assign flow index
-  tcpSocketBase->SetCongestionControlAlgorithm(swift);
+      // Only Swift needs a per-flow instance (for the flow id written in
+      // the congestion control trace); other TypeIds (e.g. TcpDctcp) are
+      // kept for comparison
+      if (g_tcpTypeId == "TcpSwift")
+        {
+          Ptr<TcpSwift> swift = CreateObject<TcpSwift> ();
+          swift->SetFlowIndex (flowIndex);  // Assign flow index
+          swift->SetAttribute ("CcTrace", BooleanValue (true));
+          tcpSocketBase->SetCongestionControlAlgorithm (swift);
+        }
 
       // Store the TCB (if needed)
       g_tcbs.push_back(tcpSocketBase->GetTcb());
@@ -350,6 +379,7 @@ int main (int argc, char *argv[])
   Time convergenceTime = Seconds (0);
   Time measurementWindow = Seconds (1);
   bool enableSwitchEcn = true;
+  bool fastForward = false;
   Time progressInterval = MilliSeconds (100);
 
   CommandLine cmd (__FILE__);
@@ -358,9 +388,13 @@ int main (int argc, char *argv[])
   cmd.AddValue ("convergenceTime", "convergence time", convergenceTime);
   cmd.AddValue ("measurementWindow", "measurement window", measurementWindow);
   cmd.AddValue ("enableSwitchEcn", "enable ECN at switches", enableSwitchEcn);
+  cmd.AddValue ("fastForward", "send the S2-R2 flow in bulk, and advance it with a fluid model "
+                "while it is in steady state alone on its path (its queues restart empty "
+                "when it switches back to packets)", fastForward);
   cmd.Parse (argc, argv);
 
   Config::SetDefault ("ns3::TcpL4Protocol::SocketType", StringValue ("ns3::" + tcpTypeId));
+  g_tcpTypeId = tcpTypeId;
 
   Time startTime = Seconds (0);
 //   Time stopTime = flowStartupWindow + convergenceTime + measurementWindow;
@@ -394,6 +428,13 @@ int main (int argc, char *argv[])
 
   Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (1448));
   Config::SetDefault ("ns3::TcpSocket::DelAckCount", UintegerValue (2));
+  // Swift needs microsecond RTT samples (the TS option has ms granularity)
+  // and the receiver host delay echo to separate fabric and endpoint delay
+  Config::SetDefault ("ns3::TcpSocketBase::Timestamp", BooleanValue (false));
+  Config::SetDefault ("ns3::TcpSocketBase::HostDelay", BooleanValue (true));
+  // Per-flow Swift state is traced to a single binary file (see plot2.py)
+  Config::SetDefault ("ns3::TcpCongestionTraceSink::FileName",
+                      StringValue ("./scratch/cc-trace.bin"));
   GlobalValue::Bind ("ChecksumEnabled", BooleanValue (false));
 
   // Set default parameters for RED queue disc
@@ -542,6 +583,21 @@ int main (int argc, char *argv[])
   // For the S3->R1 flow:
   uint32_t s3r1FlowId = 2;  // Third flow
 
+  // With fastForward, the S2-R2 flow is advanced by a fluid model while it
+  // is stable and no other packet crosses its path; it is simulated with
+  // packets otherwise.  The backlog it had in the switch queues is not
+  // re-created when it switches back, so the first packets of another flow
+  // see shorter queues than they would have
+  Ptr<BulkFlowFastForward> fluid;
+  if (fastForward)
+    {
+      fluid = CreateObject<BulkFlowFastForward> ();
+      fluid->TraceConnectWithoutContext ("FluidRx", MakeCallback (&TraceS2R2Fluid));
+      fluid->TraceConnectWithoutContext ("FluidMode", MakeCallback (&TraceS2R2Mode));
+      fluid->Start (startTime);
+      fluid->Stop (stopTime);
+    }
+
   // Each sender in S2 sends to a receiver in R2
   std::vector<Ptr<PacketSink> > r2Sinks;
   r2Sinks.reserve (1);
@@ -556,26 +612,40 @@ int main (int argc, char *argv[])
       sinkApp.Start (startTime);
       sinkApp.Stop (stopTime);
 
-      OnOffHelper clientHelper1 ("ns3::TcpSocketFactory", Address ());
-      clientHelper1.SetAttribute ("OnTime", StringValue ("ns3::ConstantRandomVariable[Constant=1]"));
-      clientHelper1.SetAttribute ("OffTime", StringValue ("ns3::ConstantRandomVariable[Constant=0]"));
-      clientHelper1.SetAttribute ("DataRate", DataRateValue (DataRate ("1Gbps")));
-      // for limit flow rate
-      // clientHelper1.SetAttribute ("DataRate", DataRateValue (DataRate ("300Mbps")));
-      clientHelper1.SetAttribute ("PacketSize", UintegerValue (1000));
-
       ApplicationContainer clientApps1;
       AddressValue remoteAddress (InetSocketAddress (ipR2T2[i].GetAddress (0), port));
-      clientHelper1.SetAttribute ("Remote", remoteAddress);
-      clientApps1.Add (clientHelper1.Install (S2.Get (i)));
+      if (fastForward)
+        {
+          BulkSendHelper bulkHelper ("ns3::TcpSocketFactory", Address ());
+          bulkHelper.SetAttribute ("SendSize", UintegerValue (1000));
+          bulkHelper.SetAttribute ("Remote", remoteAddress);
+          clientApps1.Add (bulkHelper.Install (S2.Get (i)));
+
+          NetDeviceContainer path;
+          path.Add (S2T1[i].Get (0));
+          path.Add (T1T2.Get (0));
+          path.Add (R2T2[i].Get (1));
+          fluid->AddFlow (DynamicCast<BulkSendApplication> (clientApps1.Get (0)), packetSink, path);
+        }
+      else
+        {
+          OnOffHelper clientHelper1 ("ns3::TcpSocketFactory", Address ());
+          clientHelper1.SetAttribute ("OnTime", StringValue ("ns3::ConstantRandomVariable[Constant=1]"));
+          clientHelper1.SetAttribute ("OffTime", StringValue ("ns3::ConstantRandomVariable[Constant=0]"));
+          clientHelper1.SetAttribute ("DataRate", DataRateValue (DataRate ("1Gbps")));
+          // for limit flow rate
+          // clientHelper1.SetAttribute ("DataRate", DataRateValue (DataRate ("300Mbps")));
+          clientHelper1.SetAttribute ("PacketSize", UintegerValue (1000));
+          clientHelper1.SetAttribute ("Remote", remoteAddress);
+          clientApps1.Add (clientHelper1.Install (S2.Get (i)));
+        }
     //   clientApps1.Start (i * flowStartupWindow / 1  + clientStartTime + MilliSeconds (i * 5));
     //   clientApps1.Stop (stopTime);
       clientApps1.Start (Seconds (8));
       clientApps1.Stop (stopTime);
 
-           // Schedule retrieving the TCB after the OnOffApplication starts
-      Ptr<OnOffApplication> onoff = clientApps1.Get(0)->GetObject<OnOffApplication>();
-      Simulator::Schedule(Seconds(8.1), &RetrieveTcb, onoff, s2r2FlowId);
+           // Schedule retrieving the TCB after the application starts
+      Simulator::Schedule(Seconds(8.1), &RetrieveTcb, clientApps1.Get (0), s2r2FlowId);
     }
 
   // Each sender in S1 and S3 sends to R1
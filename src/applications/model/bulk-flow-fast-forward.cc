@@ -0,0 +1,607 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "bulk-flow-fast-forward.h"
+
+#include "ns3/abort.h"
+#include "ns3/double.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/ipv4-queue-disc-item.h"
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/queue-disc.h"
+#include "ns3/simulator.h"
+#include "ns3/socket.h"
+#include "ns3/tcp-header.h"
+#include "ns3/tcp-l4-protocol.h"
+#include "ns3/trace-source-accessor.h"
+#include "ns3/traffic-control-layer.h"
+#include "ns3/udp-header.h"
+#include "ns3/udp-l4-protocol.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("BulkFlowFastForward");
+
+NS_OBJECT_ENSURE_REGISTERED(BulkFlowFastForward);
+
+/// IPv4 protocol of the filler packets, reserved for experimentation (RFC 3692)
+static const uint8_t FILLER_PROTOCOL = 253;
+
+TypeId
+BulkFlowFastForward::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::BulkFlowFastForward")
+            .SetParent<Object>()
+            .SetGroupName("Applications")
+            .AddConstructor<BulkFlowFastForward>()
+            .AddAttribute("SampleInterval",
+                          "The interval between two samples of the bytes received by a flow.",
+                          TimeValue(MilliSeconds(1)),
+                          MakeTimeAccessor(&BulkFlowFastForward::m_sampleInterval),
+                          MakeTimeChecker(TimeStep(1)))
+            .AddAttribute("StableSamples",
+                          "The number of stable samples in a row after which a flow is "
+                          "advanced by the fluid model.",
+                          UintegerValue(10),
+                          MakeUintegerAccessor(&BulkFlowFastForward::m_stableSamples),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("Tolerance",
+                          "The maximum difference between the samples of a stable flow, "
+                          "relative to their mean.",
+                          DoubleValue(0.05),
+                          MakeDoubleAccessor(&BulkFlowFastForward::m_tolerance),
+                          MakeDoubleChecker<double>(0))
+            .AddAttribute("IdleTimeout",
+                          "The time after which another flow which sent nothing on the path "
+                          "of a flow is no longer considered open.",
+                          TimeValue(Seconds(1)),
+                          MakeTimeAccessor(&BulkFlowFastForward::m_idleTimeout),
+                          MakeTimeChecker())
+            .AddTraceSource("FluidRx",
+                            "Bytes of a flow delivered by the fluid model",
+                            MakeTraceSourceAccessor(&BulkFlowFastForward::m_fluidRxTrace),
+                            "ns3::BulkFlowFastForward::FluidRxCallback")
+            .AddTraceSource("FluidMode",
+                            "A flow switched to the fluid model, or back to packets",
+                            MakeTraceSourceAccessor(&BulkFlowFastForward::m_fluidModeTrace),
+                            "ns3::BulkFlowFastForward::FluidModeCallback");
+    return tid;
+}
+
+BulkFlowFastForward::BulkFlowFastForward()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+BulkFlowFastForward::~BulkFlowFastForward()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+BulkFlowFastForward::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    Simulator::Cancel(m_startEvent);
+    Simulator::Cancel(m_stopEvent);
+    for (auto& flow : m_flows)
+    {
+        flow.sampleEvent.Cancel();
+    }
+    m_flows.clear();
+    m_interfaceFlows.clear();
+    Object::DoDispose();
+}
+
+uint32_t
+BulkFlowFastForward::AddFlow(Ptr<BulkSendApplication> source,
+                             Ptr<PacketSink> sink,
+                             const NetDeviceContainer& path)
+{
+    NS_LOG_FUNCTION(this << source << sink);
+    auto index = static_cast<uint32_t>(m_flows.size());
+    Flow flow;
+    flow.source = source;
+    flow.sink = sink;
+    flow.path = path;
+    m_flows.push_back(flow);
+
+    for (auto it = path.Begin(); it != path.End(); it++)
+    {
+        Ptr<Ipv4L3Protocol> ipv4 = (*it)->GetNode()->GetObject<Ipv4L3Protocol>();
+        NS_ABORT_MSG_IF(!ipv4, "The devices of the path must have an IPv4 interface");
+        int32_t interface = ipv4->GetInterfaceForDevice(*it);
+        NS_ABORT_MSG_IF(interface < 0, "The devices of the path must have an IPv4 interface");
+
+        // The Tx trace of each IPv4 protocol is connected once
+        bool traced = std::any_of(m_interfaceFlows.begin(),
+                                  m_interfaceFlows.end(),
+                                  [ipv4](const auto& entry) { return entry.first.first == ipv4; });
+        if (!traced)
+        {
+            ipv4->TraceConnectWithoutContext("Tx", MakeCallback(&BulkFlowFastForward::IpTx, this));
+        }
+        m_interfaceFlows[{ipv4, interface}].push_back(index);
+    }
+    sink->TraceConnectWithoutContext(
+        "Rx",
+        MakeCallback(&BulkFlowFastForward::SinkRx, this).Bind(index));
+
+    if (m_running)
+    {
+        m_flows[index].lastRx = sink->GetTotalRx();
+        ScheduleSample(index);
+    }
+    return index;
+}
+
+void
+BulkFlowFastForward::Start(const Time& time)
+{
+    NS_LOG_FUNCTION(this << time.As(Time::S));
+    Simulator::Cancel(m_startEvent);
+    m_startEvent = Simulator::Schedule(time, &BulkFlowFastForward::StartRightNow, this);
+}
+
+void
+BulkFlowFastForward::Stop(const Time& time)
+{
+    NS_LOG_FUNCTION(this << time.As(Time::S));
+    Simulator::Cancel(m_stopEvent);
+    m_stopEvent = Simulator::Schedule(time, &BulkFlowFastForward::StopRightNow, this);
+}
+
+void
+BulkFlowFastForward::StartRightNow()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_running)
+    {
+        return;
+    }
+    m_running = true;
+    for (uint32_t index = 0; index < m_flows.size(); index++)
+    {
+        m_flows[index].lastRx = m_flows[index].sink->GetTotalRx();
+        ScheduleSample(index);
+    }
+}
+
+void
+BulkFlowFastForward::StopRightNow()
+{
+    NS_LOG_FUNCTION(this);
+    if (!m_running)
+    {
+        return;
+    }
+    m_running = false;
+    for (uint32_t index = 0; index < m_flows.size(); index++)
+    {
+        Flow& flow = m_flows[index];
+        if (flow.state != PACKET)
+        {
+            SwitchToPackets(index);
+        }
+        flow.sampleEvent.Cancel();
+    }
+}
+
+bool
+BulkFlowFastForward::IsFluid(uint32_t flow) const
+{
+    NS_ASSERT(flow < m_flows.size());
+    return m_flows[flow].state == FLUID;
+}
+
+uint64_t
+BulkFlowFastForward::GetFluidRx(uint32_t flow) const
+{
+    NS_ASSERT(flow < m_flows.size());
+    return m_flows[flow].fluidBytes;
+}
+
+DataRate
+BulkFlowFastForward::GetFluidRate(uint32_t flow) const
+{
+    NS_ASSERT(flow < m_flows.size());
+    return DataRate(static_cast<uint64_t>(m_flows[flow].rate * 8));
+}
+
+uint32_t
+BulkFlowFastForward::GetFluidQueue(uint32_t flow) const
+{
+    NS_ASSERT(flow < m_flows.size());
+    return m_flows[flow].queue;
+}
+
+void
+BulkFlowFastForward::ScheduleSample(uint32_t index)
+{
+    Flow& flow = m_flows[index];
+    Time delay = m_sampleInterval;
+    uint64_t remaining = GetRemainingBytes(flow);
+    if (flow.state == FLUID && remaining > 0)
+    {
+        // A fluid flow switches back as soon as it has sent all its bytes
+        Time end = flow.fluidStart + Seconds(remaining / flow.rate) + TimeStep(1);
+        delay = std::min(delay, std::max(end - Simulator::Now(), Time(0)));
+    }
+    flow.sampleEvent.Cancel();
+    flow.sampleEvent = Simulator::Schedule(delay, &BulkFlowFastForward::Sample, this, index);
+}
+
+void
+BulkFlowFastForward::Sample(uint32_t index)
+{
+    NS_LOG_FUNCTION(this << index);
+    Flow& flow = m_flows[index];
+
+    if (flow.state == PACKET)
+    {
+        uint64_t rx = flow.sink->GetTotalRx();
+        uint64_t bytes = rx - flow.lastRx;
+        flow.lastRx = rx;
+        if (!flow.connected)
+        {
+            ResolveAddresses(flow);
+        }
+        if (flow.contended || !flow.connected || bytes == 0 || HasOtherFlows(flow))
+        {
+            ResetSamples(flow);
+        }
+        else
+        {
+            flow.rxSamples.push_back(bytes);
+            flow.queueSamples.push_back(GetQueuedBytes(flow));
+            if (flow.rxSamples.size() > m_stableSamples)
+            {
+                flow.rxSamples.pop_front();
+                flow.queueSamples.pop_front();
+            }
+        }
+
+        if (flow.rxSamples.size() == m_stableSamples)
+        {
+            auto [min, max] = std::minmax_element(flow.rxSamples.begin(), flow.rxSamples.end());
+            double mean = 0;
+            double queue = 0;
+            for (uint32_t i = 0; i < m_stableSamples; i++)
+            {
+                mean += flow.rxSamples[i];
+                queue += flow.queueSamples[i];
+            }
+            mean /= m_stableSamples;
+            if (*max - *min <= m_tolerance * mean)
+            {
+                // The flow is stable: its data in flight is delivered before
+                // it is advanced by the fluid model
+                flow.rate = mean / m_sampleInterval.GetSeconds();
+                flow.queue = static_cast<uint32_t>(queue / m_stableSamples);
+                flow.bottleneck = GetBottleneck(flow);
+                NS_LOG_LOGIC("Flow " << index << " stable at " << GetFluidRate(index)
+                                     << ", draining");
+                flow.state = DRAINING;
+                flow.source->Suspend();
+            }
+        }
+    }
+
+    if (flow.state == DRAINING)
+    {
+        if (flow.contended)
+        {
+            SwitchToPackets(index);
+        }
+        else if (flow.sink->GetTotalRx() + flow.fluidBytes >= flow.source->GetTotalTx())
+        {
+            SwitchToFluid(index);
+            return;
+        }
+    }
+    else if (flow.state == FLUID)
+    {
+        Advance(index);
+        uint64_t remaining = GetRemainingBytes(flow);
+        if (flow.contended || (remaining > 0 && flow.periodBytes >= remaining))
+        {
+            SwitchToPackets(index);
+        }
+    }
+    ScheduleSample(index);
+}
+
+void
+BulkFlowFastForward::SwitchToFluid(uint32_t index)
+{
+    NS_LOG_FUNCTION(this << index);
+    Flow& flow = m_flows[index];
+    NS_ASSERT(flow.state == DRAINING);
+    flow.state = FLUID;
+    flow.fluidStart = Simulator::Now();
+    flow.periodBytes = 0;
+    flow.backlogRestored = false;
+    m_fluidModeTrace(index, true);
+    ScheduleSample(index);
+}
+
+void
+BulkFlowFastForward::SwitchToPackets(uint32_t index)
+{
+    NS_LOG_FUNCTION(this << index);
+    Flow& flow = m_flows[index];
+    NS_ASSERT(flow.state != PACKET);
+    bool fluid = flow.state == FLUID;
+    if (fluid)
+    {
+        Advance(index);
+        RestoreBacklog(index);
+    }
+    uint64_t skippedBytes = flow.periodBytes;
+    flow.state = PACKET;
+    flow.periodBytes = 0;
+    ResetSamples(flow);
+    flow.lastRx = flow.sink->GetTotalRx();
+    if (fluid)
+    {
+        m_fluidModeTrace(index, false);
+    }
+    flow.source->Resume(skippedBytes);
+}
+
+void
+BulkFlowFastForward::RestoreBacklog(uint32_t index)
+{
+    NS_LOG_FUNCTION(this << index);
+    Flow& flow = m_flows[index];
+    if (flow.backlogRestored || !flow.bottleneck || !flow.connected)
+    {
+        return;
+    }
+    flow.backlogRestored = true;
+
+    Ptr<TrafficControlLayer> tc = flow.bottleneck->GetNode()->GetObject<TrafficControlLayer>();
+    Ipv4Header header;
+    header.SetSource(std::get<0>(flow.key));
+    header.SetDestination(Ipv4Address::GetBroadcast());
+    header.SetProtocol(FILLER_PROTOCOL);
+    header.SetTtl(1);
+    if (Node::ChecksumEnabled())
+    {
+        header.EnableChecksum();
+    }
+    // The fillers are as large as the packets of the flow, which the queue held
+    uint32_t maxSize = flow.bottleneck->GetMtu();
+    if (flow.packetSize > header.GetSerializedSize())
+    {
+        maxSize = std::min(maxSize, flow.packetSize);
+    }
+    uint32_t remaining = flow.queue;
+    while (remaining > header.GetSerializedSize())
+    {
+        uint32_t size = std::min(remaining, maxSize) - header.GetSerializedSize();
+        header.SetPayloadSize(size);
+        tc->Send(flow.bottleneck,
+                 Create<Ipv4QueueDiscItem>(Create<Packet>(size),
+                                           flow.bottleneck->GetBroadcast(),
+                                           Ipv4L3Protocol::PROT_NUMBER,
+                                           header));
+        remaining -= size + header.GetSerializedSize();
+    }
+    NS_LOG_LOGIC("Flow " << index << " restored " << flow.queue - remaining << " bytes on "
+                         << flow.bottleneck);
+}
+
+void
+BulkFlowFastForward::Advance(uint32_t index)
+{
+    Flow& flow = m_flows[index];
+    Time elapsed = Simulator::Now() - flow.fluidStart;
+    auto total = static_cast<uint64_t>(flow.rate * elapsed.GetSeconds());
+    uint64_t remaining = GetRemainingBytes(flow);
+    if (remaining > 0)
+    {
+        total = std::min(total, remaining);
+    }
+    if (total > flow.periodBytes)
+    {
+        uint64_t bytes = total - flow.periodBytes;
+        flow.periodBytes = total;
+        flow.fluidBytes += bytes;
+        m_fluidRxTrace(index, bytes);
+    }
+}
+
+uint64_t
+BulkFlowFastForward::GetRemainingBytes(const Flow& flow) const
+{
+    UintegerValue maxBytes;
+    flow.source->GetAttribute("MaxBytes", maxBytes);
+    if (maxBytes.Get() == 0)
+    {
+        return 0;
+    }
+    // The bytes of the current fluid period are not counted by the
+    // application until it is resumed
+    return maxBytes.Get() - std::min(maxBytes.Get(), flow.source->GetTotalTx());
+}
+
+void
+BulkFlowFastForward::ResetSamples(Flow& flow)
+{
+    flow.contended = false;
+    flow.rxSamples.clear();
+    flow.queueSamples.clear();
+}
+
+void
+BulkFlowFastForward::ResolveAddresses(Flow& flow)
+{
+    Ptr<Socket> socket = flow.source->GetSocket();
+    Address local;
+    Address peer;
+    if (!socket || socket->GetSockName(local) != 0 || socket->GetPeerName(peer) != 0 ||
+        !InetSocketAddress::IsMatchingType(local) || !InetSocketAddress::IsMatchingType(peer))
+    {
+        return;
+    }
+    InetSocketAddress localAddress = InetSocketAddress::ConvertFrom(local);
+    InetSocketAddress peerAddress = InetSocketAddress::ConvertFrom(peer);
+    flow.key = {localAddress.GetIpv4(),
+                peerAddress.GetIpv4(),
+                TcpL4Protocol::PROT_NUMBER,
+                localAddress.GetPort(),
+                peerAddress.GetPort()};
+    flow.otherFlows.erase(flow.key);
+    flow.connected = true;
+}
+
+bool
+BulkFlowFastForward::HasOtherFlows(Flow& flow) const
+{
+    bool open = false;
+    for (auto it = flow.otherFlows.begin(); it != flow.otherFlows.end();)
+    {
+        if (it->second.expiry <= Simulator::Now())
+        {
+            it = flow.otherFlows.erase(it);
+        }
+        else
+        {
+            open = open || !it->second.closed;
+            it++;
+        }
+    }
+    return open;
+}
+
+BulkFlowFastForward::FlowKey
+BulkFlowFastForward::GetFlowKey(Ptr<const Packet> packet, bool& closing)
+{
+    closing = false;
+    Ptr<Packet> copy = packet->Copy();
+    Ipv4Header ipHeader;
+    copy->RemoveHeader(ipHeader);
+    uint16_t sourcePort = 0;
+    uint16_t destinationPort = 0;
+    if (ipHeader.GetFragmentOffset() == 0 && ipHeader.GetProtocol() == TcpL4Protocol::PROT_NUMBER)
+    {
+        TcpHeader tcpHeader;
+        copy->PeekHeader(tcpHeader);
+        sourcePort = tcpHeader.GetSourcePort();
+        destinationPort = tcpHeader.GetDestinationPort();
+        closing = (tcpHeader.GetFlags() & (TcpHeader::FIN | TcpHeader::RST)) != 0;
+    }
+    else if (ipHeader.GetFragmentOffset() == 0 &&
+             ipHeader.GetProtocol() == UdpL4Protocol::PROT_NUMBER)
+    {
+        UdpHeader udpHeader;
+        copy->PeekHeader(udpHeader);
+        sourcePort = udpHeader.GetSourcePort();
+        destinationPort = udpHeader.GetDestinationPort();
+    }
+    return {ipHeader.GetSource(),
+            ipHeader.GetDestination(),
+            ipHeader.GetProtocol(),
+            sourcePort,
+            destinationPort};
+}
+
+uint32_t
+BulkFlowFastForward::GetQueuedBytes(const Flow& flow) const
+{
+    uint32_t bytes = 0;
+    for (auto it = flow.path.Begin(); it != flow.path.End(); it++)
+    {
+        Ptr<TrafficControlLayer> tc = (*it)->GetNode()->GetObject<TrafficControlLayer>();
+        Ptr<QueueDisc> queueDisc = tc ? tc->GetRootQueueDiscOnDevice(*it) : nullptr;
+        if (queueDisc)
+        {
+            bytes += queueDisc->GetNBytes();
+        }
+    }
+    return bytes;
+}
+
+Ptr<NetDevice>
+BulkFlowFastForward::GetBottleneck(const Flow& flow) const
+{
+    Ptr<NetDevice> bottleneck;
+    uint32_t maxBytes = 0;
+    for (auto it = flow.path.Begin(); it != flow.path.End(); it++)
+    {
+        Ptr<TrafficControlLayer> tc = (*it)->GetNode()->GetObject<TrafficControlLayer>();
+        Ptr<QueueDisc> queueDisc = tc ? tc->GetRootQueueDiscOnDevice(*it) : nullptr;
+        if (queueDisc && queueDisc->GetNBytes() > maxBytes)
+        {
+            maxBytes = queueDisc->GetNBytes();
+            bottleneck = *it;
+        }
+    }
+    return bottleneck;
+}
+
+void
+BulkFlowFastForward::IpTx(Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface)
+{
+    auto it = m_interfaceFlows.find({ipv4, interface});
+    if (it == m_interfaceFlows.end())
+    {
+        return;
+    }
+    bool closing = false;
+    FlowKey key = GetFlowKey(packet, closing);
+    for (uint32_t index : it->second)
+    {
+        Flow& flow = m_flows[index];
+        if (flow.connected && key == flow.key)
+        {
+            flow.packetSize = std::max(flow.packetSize, packet->GetSize());
+            continue;
+        }
+        // The last packets of a closed flow, e.g. the ACK of the FIN of its
+        // peer, do not open it again
+        auto other = flow.otherFlows.find(key);
+        if (other != flow.otherFlows.end() && other->second.closed)
+        {
+            continue;
+        }
+        OtherFlow& otherFlow = flow.otherFlows[key];
+        otherFlow.expiry = Simulator::Now() + m_idleTimeout;
+        otherFlow.closed = closing;
+        flow.contended = true;
+        if (flow.state == FLUID)
+        {
+            // The queue of the fluid model is re-created before the packet
+            // reaches it, but the flow is resumed right after the packet is
+            // sent, rather than from within the transmission of the packet
+            NS_LOG_LOGIC("Flow " << index << " contended by packet " << packet->GetUid());
+            RestoreBacklog(index);
+            flow.sampleEvent.Cancel();
+            flow.sampleEvent = Simulator::ScheduleNow(&BulkFlowFastForward::Sample, this, index);
+        }
+    }
+}
+
+void
+BulkFlowFastForward::SinkRx(uint32_t index, Ptr<const Packet> packet, const Address& from)
+{
+    Flow& flow = m_flows[index];
+    if (flow.state == DRAINING && !flow.contended &&
+        flow.sink->GetTotalRx() + flow.fluidBytes >= flow.source->GetTotalTx())
+    {
+        SwitchToFluid(index);
+    }
+}
+
+} // namespace ns3
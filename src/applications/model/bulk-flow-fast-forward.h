@@ -0,0 +1,333 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef BULK_FLOW_FAST_FORWARD_H
+#define BULK_FLOW_FAST_FORWARD_H
+
+#include "bulk-send-application.h"
+#include "packet-sink.h"
+
+#include "ns3/data-rate.h"
+#include "ns3/event-id.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/ipv4.h"
+#include "ns3/net-device-container.h"
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+#include "ns3/traced-callback.h"
+
+#include <deque>
+#include <map>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup bulksend
+ *
+ * \brief Advance the bulk flows in steady state with a fluid model.
+ *
+ * Long BulkSendApplication flows spend most of their time in congestion
+ * avoidance, at the rate of their bottleneck, yet every one of their
+ * packets is simulated.  This object samples, every SampleInterval, the
+ * bytes received by the PacketSink of each flow added to it.  Once the
+ * received bytes of StableSamples samples in a row are within Tolerance of
+ * their mean, and no other packet was sent on the devices of the path of
+ * the flow meanwhile, the flow is in steady state; if, in addition, no
+ * other flow is open on its path, its application is suspended and, as
+ * soon as its data in flight is delivered, the flow is advanced at the
+ * mean rate of the samples, without any packet.  The mean number of bytes
+ * queued on its path is kept as the queue occupancy of the fluid model.
+ *
+ * The other flows are told apart by their addresses, protocol and ports.
+ * One is open on the path from its first packet until its FIN or RST, or
+ * until it sends nothing on the path for IdleTimeout, so that a flow in
+ * backoff, e.g. waiting for a retransmission timeout, still counts.
+ *
+ * A fluid flow switches back to packets as soon as another packet is sent
+ * on one of the devices of its path (a new flow, or any change of the
+ * queues of its path), when it reaches the MaxBytes of its application, or
+ * when the fast-forward is stopped.  Its TCP connection is kept open while
+ * it is fluid, so that it resumes with its congestion state.
+ *
+ * The queue occupancy of the fluid model is re-created when the flow
+ * switches back to packets: filler packets of as many bytes are sent
+ * through the root queue disc of the bottleneck of the path, the device
+ * whose queue disc held the most bytes when the flow became stable, so
+ * that the packets which end a fluid period, e.g. the first packets of a
+ * new flow on the path, see the queueing delay of the fluid model.  The
+ * filler packets are as large as the largest packet of the flow, and are
+ * IPv4 broadcasts of protocol 253 (reserved for experimentation), which the
+ * next node drops.
+ *
+ * The bytes delivered by the fluid model are not seen by the PacketSink:
+ * they are reported, at every sample, by the FluidRx trace source, and
+ * they count towards the MaxBytes of the application.
+ *
+ * Only the IPv4 flows are advanced.  The samples are periodic: the
+ * fast-forward has to be stopped, or the simulation run with a stop time.
+ */
+class BulkFlowFastForward : public Object
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    BulkFlowFastForward();
+    ~BulkFlowFastForward() override;
+
+    /**
+     * \brief Add a flow.
+     *
+     * \param source the application which sends the flow
+     * \param sink the application which receives it
+     * \param path the devices the data of the flow is sent on, from the
+     *        source to the sink; they must have an IPv4 interface
+     * \return the index of the flow
+     */
+    uint32_t AddFlow(Ptr<BulkSendApplication> source,
+                     Ptr<PacketSink> sink,
+                     const NetDeviceContainer& path);
+
+    /**
+     * \brief Set the time, counting from the current time, at which the
+     * flows start to be sampled.
+     *
+     * This method overwrites any previous calls to Start()
+     *
+     * \param time delay at which the sampling starts
+     */
+    void Start(const Time& time);
+
+    /**
+     * \brief Set the time, counting from the current time, at which the
+     * sampling stops, and the fluid flows switch back to packets.
+     *
+     * This method overwrites any previous calls to Stop()
+     *
+     * \param time delay at which the sampling stops
+     */
+    void Stop(const Time& time);
+
+    /// Start the sampling right now
+    void StartRightNow();
+
+    /// Stop the sampling right now
+    void StopRightNow();
+
+    /**
+     * \param flow the index of the flow
+     * \return true if the flow is currently advanced by the fluid model
+     */
+    bool IsFluid(uint32_t flow) const;
+
+    /**
+     * \param flow the index of the flow
+     * \return the number of bytes the fluid model delivered for the flow
+     */
+    uint64_t GetFluidRx(uint32_t flow) const;
+
+    /**
+     * \param flow the index of the flow
+     * \return the rate of the flow in its last fluid period
+     */
+    DataRate GetFluidRate(uint32_t flow) const;
+
+    /**
+     * \param flow the index of the flow
+     * \return the bytes queued on its path in its last fluid period
+     */
+    uint32_t GetFluidQueue(uint32_t flow) const;
+
+    /**
+     * TracedCallback signature for the bytes delivered by the fluid model.
+     *
+     * \param [in] flow the index of the flow
+     * \param [in] bytes the number of bytes
+     */
+    typedef void (*FluidRxCallback)(uint32_t flow, uint64_t bytes);
+
+    /**
+     * TracedCallback signature for the switches of a flow.
+     *
+     * \param [in] flow the index of the flow
+     * \param [in] fluid true when the flow switches to the fluid model,
+     *             false when it switches back to packets
+     */
+    typedef void (*FluidModeCallback)(uint32_t flow, bool fluid);
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /// State of a flow
+    enum State
+    {
+        PACKET,   //!< Simulated with packets
+        DRAINING, //!< Application suspended, data in flight not delivered yet
+        FLUID,    //!< Advanced by the fluid model
+    };
+
+    /// Addresses, protocol and ports of a flow
+    typedef std::tuple<Ipv4Address, Ipv4Address, uint8_t, uint16_t, uint16_t> FlowKey;
+
+    /// Another flow seen on the path of a flow
+    struct OtherFlow
+    {
+        Time expiry;        //!< Time at which the flow is forgotten
+        bool closed{false}; //!< True once its FIN or RST was seen
+    };
+
+    /// A flow
+    struct Flow
+    {
+        Ptr<BulkSendApplication> source;         //!< Sending application
+        Ptr<PacketSink> sink;                    //!< Receiving application
+        NetDeviceContainer path;                 //!< Devices of the path
+        bool connected{false};                   //!< True once the addresses are known
+        FlowKey key;                             //!< Addresses, protocol and ports of the flow
+        std::map<FlowKey, OtherFlow> otherFlows; //!< Other flows seen on the path
+        State state{PACKET};                     //!< State of the flow
+        bool contended{false};                   //!< True if another flow crossed the path
+        uint64_t lastRx{0};                      //!< Bytes received by the sink at the last sample
+        std::deque<uint64_t> rxSamples;          //!< Bytes received during the last samples
+        std::deque<uint32_t> queueSamples;       //!< Bytes queued on the path at the last samples
+        double rate{0};                          //!< Rate of the fluid model, in bytes per second
+        uint32_t queue{0};                       //!< Bytes queued on the path in the fluid model
+        Ptr<NetDevice> bottleneck;               //!< Device holding the queue of the fluid model
+        bool backlogRestored{false};             //!< True once the queue is re-created
+        uint32_t packetSize{0};                  //!< Largest IP packet of the flow on the path
+        Time fluidStart;                         //!< Start of the current fluid period
+        uint64_t periodBytes{0};                 //!< Bytes delivered in the current fluid period
+        uint64_t fluidBytes{0};                  //!< Bytes delivered by the fluid model
+        EventId sampleEvent;                     //!< Next sample
+    };
+
+    /**
+     * \brief Sample a flow, and switch it to the fluid model or back.
+     * \param index the index of the flow
+     */
+    void Sample(uint32_t index);
+
+    /**
+     * \brief Schedule the next sample of a flow.
+     * \param index the index of the flow
+     */
+    void ScheduleSample(uint32_t index);
+
+    /**
+     * \brief Switch a drained flow to the fluid model.
+     * \param index the index of the flow
+     */
+    void SwitchToFluid(uint32_t index);
+
+    /**
+     * \brief Switch a suspended flow back to packets.
+     * \param index the index of the flow
+     */
+    void SwitchToPackets(uint32_t index);
+
+    /**
+     * \brief Re-create the queue of the fluid model of a flow with filler
+     * packets, once per fluid period.
+     * \param index the index of the flow
+     */
+    void RestoreBacklog(uint32_t index);
+
+    /**
+     * \brief Deliver the bytes of a fluid flow up to the current time.
+     * \param index the index of the flow
+     */
+    void Advance(uint32_t index);
+
+    /**
+     * \param flow the flow
+     * \return the number of bytes its application may still send, or 0 if
+     *         there is no limit
+     */
+    uint64_t GetRemainingBytes(const Flow& flow) const;
+
+    /**
+     * \brief Clear the samples of a flow, which has to become stable again.
+     * \param flow the flow
+     */
+    void ResetSamples(Flow& flow);
+
+    /**
+     * \brief Get the addresses of a flow, once its socket is connected.
+     * \param flow the flow
+     */
+    void ResolveAddresses(Flow& flow);
+
+    /**
+     * \brief Forget the other flows of the path of a flow which expired.
+     * \param flow the flow
+     * \return true if another flow is open on the path
+     */
+    bool HasOtherFlows(Flow& flow) const;
+
+    /**
+     * \param packet an IPv4 packet, with its header
+     * \param [out] closing true if the packet is a TCP FIN or RST
+     * \return the addresses, protocol and ports of the packet
+     */
+    static FlowKey GetFlowKey(Ptr<const Packet> packet, bool& closing);
+
+    /**
+     * \param flow the flow
+     * \return the number of bytes in the root queue discs of its path
+     */
+    uint32_t GetQueuedBytes(const Flow& flow) const;
+
+    /**
+     * \param flow the flow
+     * \return the device of its path with the most bytes in its root queue
+     *         disc, or nullptr if they are all empty
+     */
+    Ptr<NetDevice> GetBottleneck(const Flow& flow) const;
+
+    /**
+     * \brief Packet sent on an IPv4 interface (Tx trace of Ipv4L3Protocol).
+     * \param packet the packet, with its IPv4 header
+     * \param ipv4 the IPv4 protocol
+     * \param interface the interface
+     */
+    void IpTx(Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface);
+
+    /**
+     * \brief Packet received by the sink of a flow (Rx trace of PacketSink).
+     * \param index the index of the flow
+     * \param packet the packet
+     * \param from the address of the sender
+     */
+    void SinkRx(uint32_t index, Ptr<const Packet> packet, const Address& from);
+
+    Time m_sampleInterval;     //!< Interval between the samples of a flow
+    uint32_t m_stableSamples;  //!< Number of stable samples before a flow becomes fluid
+    double m_tolerance;        //!< Relative variation of the samples of a stable flow
+    Time m_idleTimeout;        //!< Time after which a silent other flow is forgotten
+    bool m_running{false};     //!< True if the flows are sampled
+    EventId m_startEvent;      //!< Start event
+    EventId m_stopEvent;       //!< Stop event
+    std::vector<Flow> m_flows; //!< Flows, by index
+
+    /// Flows whose path goes through an IPv4 interface
+    std::map<std::pair<Ptr<Ipv4>, uint32_t>, std::vector<uint32_t>> m_interfaceFlows;
+
+    /// Traced Callback: bytes delivered by the fluid model
+    TracedCallback<uint32_t, uint64_t> m_fluidRxTrace;
+
+    /// Traced Callback: switches between packets and the fluid model
+    TracedCallback<uint32_t, bool> m_fluidModeTrace;
+};
+
+} // namespace ns3
+
+#endif /* BULK_FLOW_FAST_FORWARD_H */
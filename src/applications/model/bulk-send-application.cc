@@ -121,6 +121,39 @@ BulkSendApplication::GetSocket() const
     return m_socket;
 }
 
+uint64_t
+BulkSendApplication::GetTotalTx() const
+{
+    return m_totBytes;
+}
+
+void
+BulkSendApplication::Suspend()
+{
+    NS_LOG_FUNCTION(this);
+    m_suspended = true;
+}
+
+void
+BulkSendApplication::Resume(uint64_t skippedBytes)
+{
+    NS_LOG_FUNCTION(this << skippedBytes);
+    m_suspended = false;
+    m_totBytes += skippedBytes;
+    if (m_maxBytes > 0)
+    {
+        m_totBytes = std::min(m_totBytes, m_maxBytes);
+    }
+    if (m_connected)
+    {
+        Address from;
+        Address to;
+        m_socket->GetSockName(from);
+        m_socket->GetPeerName(to);
+        SendData(from, to);
+    }
+}
+
 void
 BulkSendApplication::DoDispose()
 {
@@ -229,7 +262,7 @@ BulkSendApplication::SendData(const Address& from, const Address& to)
 {
     NS_LOG_FUNCTION(this);
 
-    while (m_maxBytes == 0 || m_totBytes < m_maxBytes)
+    while (!m_suspended && (m_maxBytes == 0 || m_totBytes < m_maxBytes))
     { // Time to send more
 
         // uint64_t to allow the comparison later.
@@ -98,6 +98,31 @@ class BulkSendApplication : public Application
      */
     Ptr<Socket> GetSocket() const;
 
+    /**
+     * \brief Get the total number of bytes sent so far.
+     *
+     * The bytes skipped by Resume() are included.
+     *
+     * \return the number of bytes sent
+     */
+    uint64_t GetTotalTx() const;
+
+    /**
+     * \brief Stop writing to the socket, without closing it.
+     *
+     * The data already written to the socket is still sent.  A fluid model
+     * (see BulkFlowFastForward) may then advance the flow without packets.
+     */
+    void Suspend();
+
+    /**
+     * \brief Write to the socket again, after Suspend().
+     *
+     * \param skippedBytes number of bytes the flow was advanced by while it
+     *        was suspended; they count as sent, towards MaxBytes
+     */
+    void Resume(uint64_t skippedBytes);
+
   protected:
     void DoDispose() override;
 
@@ -124,6 +149,7 @@ class BulkSendApplication : public Application
     uint32_t m_seq{0};                   //!< Sequence
     Ptr<Packet> m_unsentPacket;          //!< Variable to cache unsent packet
     bool m_enableSeqTsSizeHeader{false}; //!< Enable or disable the SeqTsSizeHeader
+    bool m_suspended{false};             //!< True if the writes to the socket are suspended
 
     /// Traced Callback: sent packets
     TracedCallback<Ptr<const Packet>> m_txTrace;
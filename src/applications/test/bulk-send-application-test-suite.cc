@@ -7,6 +7,7 @@
 
 #include "ns3/application-container.h"
 #include "ns3/boolean.h"
+#include "ns3/bulk-flow-fast-forward.h"
 #include "ns3/bulk-send-application.h"
 #include "ns3/bulk-send-helper.h"
 #include "ns3/inet-socket-address.h"
@@ -19,12 +20,17 @@
 #include "ns3/nstime.h"
 #include "ns3/packet-sink-helper.h"
 #include "ns3/packet-sink.h"
+#include "ns3/queue-disc.h"
 #include "ns3/simple-net-device-helper.h"
+#include "ns3/simple-net-device.h"
 #include "ns3/string.h"
 #include "ns3/test.h"
 #include "ns3/traced-callback.h"
+#include "ns3/traffic-control-layer.h"
 #include "ns3/uinteger.h"
 
+#include <vector>
+
 using namespace ns3;
 
 /**
@@ -250,6 +256,219 @@ BulkSendSeqTsSizeTestCase::DoRun()
     NS_TEST_ASSERT_MSG_EQ(m_received, 300000, "Received the full 300000 bytes");
 }
 
+/**
+ * \ingroup applications-test
+ * \ingroup tests
+ *
+ * This test checks that a long transfer, alone on its path, is advanced by
+ * the fluid model of BulkFlowFastForward, that it switches back to packets
+ * when a second flow starts on its path, with the queue of the fluid model
+ * restored on the path, and that it completes with all its bytes, close to
+ * the time it takes with packets only.
+ */
+class BulkSendFastForwardTestCase : public TestCase
+{
+  public:
+    BulkSendFastForwardTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Run the transfers.
+     * \param fastForward true to advance the long transfer with the fluid model
+     * \return the completion time of the long transfer
+     */
+    Time RunTransfers(bool fastForward);
+
+    /**
+     * Record the bytes of the long transfer
+     * \param bytes the number of bytes received
+     */
+    void Receive(uint64_t bytes);
+
+    /**
+     * Record a packet received by the sink of the long transfer
+     * \param p the packet
+     * \param addr the sender's address
+     */
+    void ReceiveRx(Ptr<const Packet> p, const Address& addr);
+
+    /**
+     * Record the bytes of the long transfer delivered by the fluid model
+     * \param flow the index of the flow
+     * \param bytes the number of bytes
+     */
+    void FluidRx(uint32_t flow, uint64_t bytes);
+
+    /**
+     * Record a switch of the long transfer
+     * \param flow the index of the flow
+     * \param fluid true if the flow switched to the fluid model
+     */
+    void FluidMode(uint32_t flow, bool fluid);
+
+    uint64_t m_received{0};                     //!< bytes of the long transfer received
+    uint64_t m_fluidReceived{0};                //!< bytes delivered by the fluid model
+    Time m_completion;                          //!< completion time of the long transfer
+    std::vector<std::pair<Time, bool>> m_modes; //!< switches of the long transfer
+    Ptr<BulkFlowFastForward> m_fluid;           //!< fluid model of the long transfer
+    Ptr<SimpleNetDevice> m_bottleneck;          //!< device of the long transfer
+    uint32_t m_fluidQueue{0};                   //!< queue of the fluid model at the switch
+    uint32_t m_restoredQueue{0};                //!< bytes queued on the device at the switch
+};
+
+/// Bytes of the long transfer
+static const uint64_t FAST_FORWARD_TEST_BYTES = 20000000;
+
+BulkSendFastForwardTestCase::BulkSendFastForwardTestCase()
+    : TestCase("Check a 20MB transfer advanced by the fluid model")
+{
+}
+
+void
+BulkSendFastForwardTestCase::Receive(uint64_t bytes)
+{
+    m_received += bytes;
+    if (m_received == FAST_FORWARD_TEST_BYTES)
+    {
+        m_completion = Simulator::Now();
+    }
+}
+
+void
+BulkSendFastForwardTestCase::ReceiveRx(Ptr<const Packet> p, const Address& addr)
+{
+    Receive(p->GetSize());
+}
+
+void
+BulkSendFastForwardTestCase::FluidRx(uint32_t flow, uint64_t bytes)
+{
+    m_fluidReceived += bytes;
+    Receive(bytes);
+}
+
+void
+BulkSendFastForwardTestCase::FluidMode(uint32_t flow, bool fluid)
+{
+    m_modes.emplace_back(Simulator::Now(), fluid);
+    // The queue re-created when the short transfer starts
+    if (!fluid && m_modes.size() == 2)
+    {
+        Ptr<TrafficControlLayer> tc = m_bottleneck->GetNode()->GetObject<TrafficControlLayer>();
+        m_fluidQueue = m_fluid->GetFluidQueue(flow);
+        m_restoredQueue = tc->GetRootQueueDiscOnDevice(m_bottleneck)->GetNBytes() +
+                          m_bottleneck->GetQueue()->GetNBytes();
+    }
+}
+
+Time
+BulkSendFastForwardTestCase::RunTransfers(bool fastForward)
+{
+    m_received = 0;
+    m_fluidReceived = 0;
+    m_completion = Time();
+    m_modes.clear();
+    m_fluidQueue = 0;
+    m_restoredQueue = 0;
+
+    NodeContainer nodes;
+    nodes.Create(2);
+    SimpleNetDeviceHelper simpleHelper;
+    simpleHelper.SetDeviceAttribute("DataRate", StringValue("100Mbps"));
+    simpleHelper.SetChannelAttribute("Delay", StringValue("1ms"));
+    NetDeviceContainer devices = simpleHelper.Install(nodes);
+    InternetStackHelper internet;
+    internet.Install(nodes);
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.1.1.0", "255.255.255.0");
+    Ipv4InterfaceContainer i = ipv4.Assign(devices);
+
+    // The long transfer, then a short one on the same path
+    ApplicationContainer sourceApps;
+    ApplicationContainer sinkApps;
+    for (uint16_t port : {9, 10})
+    {
+        BulkSendHelper sourceHelper("ns3::TcpSocketFactory",
+                                    InetSocketAddress(i.GetAddress(1), port));
+        sourceHelper.SetAttribute("SendSize", UintegerValue(1448));
+        sourceHelper.SetAttribute("MaxBytes",
+                                  UintegerValue(port == 9 ? FAST_FORWARD_TEST_BYTES : 100000));
+        ApplicationContainer sourceApp = sourceHelper.Install(nodes.Get(0));
+        sourceApp.Start(port == 9 ? Seconds(0) : Seconds(1));
+        sourceApps.Add(sourceApp);
+        PacketSinkHelper sinkHelper("ns3::TcpSocketFactory",
+                                    InetSocketAddress(Ipv4Address::GetAny(), port));
+        sinkApps.Add(sinkHelper.Install(nodes.Get(1)));
+    }
+    sourceApps.Stop(Seconds(10));
+    sinkApps.Stop(Seconds(10));
+
+    Ptr<BulkSendApplication> source = DynamicCast<BulkSendApplication>(sourceApps.Get(0));
+    Ptr<PacketSink> sink = DynamicCast<PacketSink>(sinkApps.Get(0));
+    sink->TraceConnectWithoutContext("Rx",
+                                     MakeCallback(&BulkSendFastForwardTestCase::ReceiveRx, this));
+
+    Ptr<BulkFlowFastForward> fluid;
+    if (fastForward)
+    {
+        fluid = CreateObject<BulkFlowFastForward>();
+        m_fluid = fluid;
+        m_bottleneck = DynamicCast<SimpleNetDevice>(devices.Get(0));
+        fluid->SetAttribute("SampleInterval", TimeValue(MilliSeconds(10)));
+        fluid->AddFlow(source, sink, NetDeviceContainer(devices.Get(0)));
+        fluid->TraceConnectWithoutContext(
+            "FluidRx",
+            MakeCallback(&BulkSendFastForwardTestCase::FluidRx, this));
+        fluid->TraceConnectWithoutContext(
+            "FluidMode",
+            MakeCallback(&BulkSendFastForwardTestCase::FluidMode, this));
+        fluid->Start(Seconds(0));
+        fluid->Stop(Seconds(10));
+    }
+
+    Simulator::Stop(Seconds(10));
+    Simulator::Run();
+    NS_TEST_EXPECT_MSG_EQ(DynamicCast<PacketSink>(sinkApps.Get(1))->GetTotalRx(),
+                          100000,
+                          "The short transfer did not complete");
+    Simulator::Destroy();
+    m_fluid = nullptr;
+    m_bottleneck = nullptr;
+
+    NS_TEST_EXPECT_MSG_EQ(m_received, FAST_FORWARD_TEST_BYTES, "Wrong number of bytes received");
+    return m_completion;
+}
+
+void
+BulkSendFastForwardTestCase::DoRun()
+{
+    Time reference = RunTransfers(false);
+    NS_TEST_EXPECT_MSG_EQ(m_fluidReceived, 0, "No fluid model without fast-forward");
+
+    Time completion = RunTransfers(true);
+    NS_TEST_EXPECT_MSG_GT(m_fluidReceived, 0, "The transfer was not advanced by the fluid model");
+    NS_TEST_ASSERT_MSG_GT_OR_EQ(m_modes.size(), 2, "The transfer did not switch back");
+    NS_TEST_EXPECT_MSG_EQ(m_modes[0].second, true, "The first switch must be to the fluid model");
+    NS_TEST_EXPECT_MSG_LT(m_modes[0].first, Seconds(1), "The transfer was not stable early");
+    NS_TEST_EXPECT_MSG_EQ(m_modes[1].second, false, "The second switch must be to packets");
+    NS_TEST_EXPECT_MSG_EQ_TOL(m_modes[1].first,
+                              Seconds(1),
+                              MilliSeconds(1),
+                              "The transfer must switch back when the short one starts");
+    NS_TEST_EXPECT_MSG_GT(m_fluidQueue, 0, "The fluid model has no queue");
+    // The device may be sending a filler packet
+    NS_TEST_EXPECT_MSG_EQ_TOL(m_restoredQueue,
+                              m_fluidQueue,
+                              2 * 1500,
+                              "The queue of the fluid model was not restored");
+    NS_TEST_EXPECT_MSG_EQ_TOL(completion,
+                              reference,
+                              reference / 20,
+                              "The completion time is not close to the one with packets");
+}
+
 /**
  * \ingroup applications-test
  * \ingroup tests
@@ -267,6 +486,7 @@ BulkSendTestSuite::BulkSendTestSuite()
 {
     AddTestCase(new BulkSendBasicTestCase, TestCase::Duration::QUICK);
     AddTestCase(new BulkSendSeqTsSizeTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new BulkSendFastForwardTestCase, TestCase::Duration::QUICK);
 }
 
 static BulkSendTestSuite g_bulkSendTestSuite; //!< Static variable for test initialization
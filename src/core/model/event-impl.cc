@@ -10,6 +10,9 @@
 
 #include "log.h"
 
+#include <array>
+#include <new>
+
 /**
  * \file
  * \ingroup events
@@ -56,4 +59,155 @@ EventImpl::IsCancelled()
     return m_cancel;
 }
 
+#ifdef NS3_EVENT_POOL
+
+namespace
+{
+
+/**
+ * \ingroup events
+ * Per-thread free lists of event memory blocks.
+ *
+ * The blocks are regular heap allocations, so a block released by another
+ * thread than the one which allocated it simply joins the free list of the
+ * releasing thread.
+ */
+class EventPool
+{
+  public:
+    /** Granularity of the size classes, in bytes. */
+    static constexpr std::size_t GRANULARITY = 16;
+    /** Number of size classes; larger events bypass the pool. */
+    static constexpr std::size_t N_CLASSES = 16;
+    /** Maximum number of free blocks kept per size class. */
+    static constexpr uint32_t MAX_FREE = 4096;
+
+    /** Release the blocks of the free lists. */
+    ~EventPool();
+
+    /**
+     * \param [in] size The size of the event.
+     * \returns The size class of the event.
+     */
+    static std::size_t GetClass(std::size_t size)
+    {
+        return (size - 1) / GRANULARITY;
+    }
+
+    /**
+     * Get a block from a free list, or from the heap if the list is empty.
+     * \param [in] sizeClass The size class.
+     * \returns The block.
+     */
+    void* Allocate(std::size_t sizeClass);
+
+    /**
+     * Put a block on a free list, or release it if the list is full.
+     * \param [in] p The block.
+     * \param [in] sizeClass The size class.
+     */
+    void Release(void* p, std::size_t sizeClass);
+
+  private:
+    /** A free block. */
+    struct Block
+    {
+        Block* next; //!< Next free block of the size class
+    };
+
+    std::array<Block*, N_CLASSES> m_free{};    //!< Free lists
+    std::array<uint32_t, N_CLASSES> m_nFree{}; //!< Lengths of the free lists
+};
+
+/** Free lists of the thread. */
+thread_local EventPool t_eventPool;
+/**
+ * Whether the free lists of the thread were destroyed.  Events deleted during
+ * the destruction of static objects, after the thread_local objects of the
+ * main thread, go straight back to the heap.
+ */
+thread_local bool t_eventPoolDestroyed = false;
+
+EventPool::~EventPool()
+{
+    for (std::size_t i = 0; i < N_CLASSES; ++i)
+    {
+        while (m_free[i])
+        {
+            Block* block = m_free[i];
+            m_free[i] = block->next;
+            ::operator delete(block);
+        }
+    }
+    t_eventPoolDestroyed = true;
+}
+
+void*
+EventPool::Allocate(std::size_t sizeClass)
+{
+    Block* block = m_free[sizeClass];
+    if (block)
+    {
+        m_free[sizeClass] = block->next;
+        --m_nFree[sizeClass];
+        return block;
+    }
+    return ::operator new((sizeClass + 1) * GRANULARITY);
+}
+
+void
+EventPool::Release(void* p, std::size_t sizeClass)
+{
+    if (m_nFree[sizeClass] >= MAX_FREE)
+    {
+        ::operator delete(p);
+        return;
+    }
+    auto block = static_cast<Block*>(p);
+    block->next = m_free[sizeClass];
+    m_free[sizeClass] = block;
+    ++m_nFree[sizeClass];
+}
+
+} // unnamed namespace
+
+void*
+EventImpl::operator new(std::size_t size)
+{
+    std::size_t sizeClass = EventPool::GetClass(size);
+    if (sizeClass >= EventPool::N_CLASSES || t_eventPoolDestroyed)
+    {
+        return ::operator new(size);
+    }
+    return t_eventPool.Allocate(sizeClass);
+}
+
+void
+EventImpl::operator delete(void* p, std::size_t size)
+{
+    std::size_t sizeClass = EventPool::GetClass(size);
+    if (sizeClass >= EventPool::N_CLASSES || t_eventPoolDestroyed)
+    {
+        ::operator delete(p);
+        return;
+    }
+    t_eventPool.Release(p, sizeClass);
+}
+
+#else /* NS3_EVENT_POOL */
+
+void*
+EventImpl::operator new(std::size_t size)
+{
+    return ::operator new(size);
+}
+
+void
+EventImpl::operator delete(void* p, std::size_t /* size */)
+{
+    ::operator delete(p);
+}
+
+#endif /* NS3_EVENT_POOL */
+
 } // namespace ns3
@@ -10,6 +10,7 @@
 
 #include "simple-ref-count.h"
 
+#include <cstddef>
 #include <stdint.h>
 
 /**
@@ -56,6 +57,26 @@ class EventImpl : public SimpleRefCount<EventImpl>
      */
     bool IsCancelled();
 
+    /**
+     * Allocate the memory of an event.
+     *
+     * When ns-3 is configured with \c NS3_EVENT_POOL, the memory of
+     * deleted events is kept in per-thread free lists, one per size
+     * class, and handed out again to the next events of the same size
+     * class, so that scheduling an event does not usually reach malloc.
+     *
+     * \param [in] size The size of the event.
+     * \returns The memory of the event.
+     */
+    static void* operator new(std::size_t size);
+    /**
+     * Release the memory of an event.
+     *
+     * \param [in] p The memory of the event.
+     * \param [in] size The size of the event.
+     */
+    static void operator delete(void* p, std::size_t size);
+
   protected:
     /**
      * Implementation for Invoke().
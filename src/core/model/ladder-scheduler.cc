@@ -0,0 +1,304 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "ladder-scheduler.h"
+
+#include "assert.h"
+#include "event-impl.h"
+#include "log.h"
+#include "type-id.h"
+
+#include <algorithm>
+#include <utility>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::LadderScheduler class implementation.
+ */
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("LadderScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED(LadderScheduler);
+
+namespace
+{
+
+/** Largest container of events which is sorted rather than spread into a rung. */
+const uint32_t LADDER_THRESHOLD = 50;
+/** Largest number of rungs. */
+const uint32_t LADDER_MAX_RUNGS = 8;
+
+/**
+ * Order events by decreasing key.
+ * \param [in] a The first event.
+ * \param [in] b The second event.
+ * \returns \c true if \p a is later than \p b.
+ */
+bool
+LaterEvent(const Scheduler::Event& a, const Scheduler::Event& b)
+{
+    return a.key > b.key;
+}
+
+} // unnamed namespace
+
+TypeId
+LadderScheduler::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::LadderScheduler")
+                            .SetParent<Scheduler>()
+                            .SetGroupName("Core")
+                            .AddConstructor<LadderScheduler>();
+    return tid;
+}
+
+LadderScheduler::LadderScheduler()
+    : m_topMin(UINT64_MAX),
+      m_topMax(0),
+      m_topStart(0),
+      m_rungs(LADDER_MAX_RUNGS),
+      m_nRungs(0),
+      m_qSize(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+LadderScheduler::~LadderScheduler()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+uint32_t
+LadderScheduler::Rung::GetBucket(uint64_t ts) const
+{
+    uint64_t bucket = (ts - start) / width;
+    return bucket < nBuckets ? static_cast<uint32_t>(bucket) : nBuckets - 1;
+}
+
+void
+LadderScheduler::Insert(const Event& ev)
+{
+    NS_LOG_FUNCTION(this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+    uint64_t ts = ev.key.m_ts;
+    m_qSize++;
+
+    if (ts >= m_topStart)
+    {
+        m_top.push_back(ev);
+        m_topMin = std::min(m_topMin, ts);
+        m_topMax = std::max(m_topMax, ts);
+        if (m_bottom.empty())
+        {
+            FillBottom();
+        }
+        return;
+    }
+    // A rung whose buckets were all consumed only waits for its lower rungs
+    // to run out, and takes no more events
+    for (uint32_t i = 0; i < m_nRungs; i++)
+    {
+        Rung& rung = m_rungs[i];
+        if (rung.cur < rung.nBuckets && ts >= rung.GetCurStart())
+        {
+            rung.buckets[rung.GetBucket(ts)].push_back(ev);
+            if (m_bottom.empty())
+            {
+                FillBottom();
+            }
+            return;
+        }
+    }
+
+    m_bottom.insert(FindInBottom(ev.key), ev);
+    if (m_bottom.size() > LADDER_THRESHOLD && m_nRungs < LADDER_MAX_RUNGS &&
+        m_bottom.front().key.m_ts > m_bottom.back().key.m_ts)
+    {
+        SpawnRung(m_bottom, m_bottom.back().key.m_ts, m_bottom.front().key.m_ts);
+        FillBottom();
+    }
+}
+
+bool
+LadderScheduler::IsEmpty() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_qSize == 0;
+}
+
+Scheduler::Event
+LadderScheduler::PeekNext() const
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(!IsEmpty());
+    return m_bottom.back();
+}
+
+Scheduler::Event
+LadderScheduler::RemoveNext()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(!IsEmpty());
+
+    Scheduler::Event ev = m_bottom.back();
+    m_bottom.pop_back();
+    m_qSize--;
+    if (m_bottom.empty() && m_qSize > 0)
+    {
+        FillBottom();
+    }
+    NS_LOG_LOGIC("remove ts=" << ev.key.m_ts << ", key=" << ev.key.m_uid);
+    return ev;
+}
+
+void
+LadderScheduler::Remove(const Event& ev)
+{
+    NS_LOG_FUNCTION(this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+    NS_ASSERT(!IsEmpty());
+    uint64_t ts = ev.key.m_ts;
+    m_qSize--;
+
+    if (ts >= m_topStart)
+    {
+        RemoveFrom(m_top, ev);
+        return;
+    }
+    for (uint32_t i = 0; i < m_nRungs; i++)
+    {
+        Rung& rung = m_rungs[i];
+        if (rung.cur < rung.nBuckets && ts >= rung.GetCurStart())
+        {
+            RemoveFrom(rung.buckets[rung.GetBucket(ts)], ev);
+            return;
+        }
+    }
+
+    auto it = FindInBottom(ev.key);
+    NS_ASSERT(it != m_bottom.end() && it->impl == ev.impl);
+    m_bottom.erase(it);
+    if (m_bottom.empty() && m_qSize > 0)
+    {
+        FillBottom();
+    }
+}
+
+void
+LadderScheduler::SpawnRung(Bucket& events, uint64_t minTs, uint64_t maxTs)
+{
+    NS_LOG_FUNCTION(this << events.size() << minTs << maxTs);
+    NS_ASSERT(m_nRungs < LADDER_MAX_RUNGS && !events.empty());
+
+    Rung& rung = m_rungs[m_nRungs++];
+    rung.nBuckets = events.size();
+    if (rung.buckets.size() < rung.nBuckets)
+    {
+        rung.buckets.resize(rung.nBuckets);
+    }
+    rung.start = minTs;
+    rung.width = (maxTs - minTs) / rung.nBuckets + 1;
+    rung.cur = 0;
+
+    for (const auto& ev : events)
+    {
+        rung.buckets[rung.GetBucket(ev.key.m_ts)].push_back(ev);
+    }
+    events.clear();
+}
+
+void
+LadderScheduler::SortIntoBottom(Bucket& events)
+{
+    NS_LOG_FUNCTION(this << events.size());
+    NS_ASSERT(m_bottom.empty());
+    // Swap rather than copy, so that both vectors keep their capacity
+    std::swap(m_bottom, events);
+    std::sort(m_bottom.begin(), m_bottom.end(), LaterEvent);
+}
+
+void
+LadderScheduler::FillBottom()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(m_bottom.empty() && m_qSize > 0);
+
+    while (m_bottom.empty())
+    {
+        if (m_nRungs == 0)
+        {
+            NS_ASSERT(!m_top.empty());
+            if (m_top.size() <= LADDER_THRESHOLD || m_topMin == m_topMax)
+            {
+                m_topStart = m_topMax + 1;
+                SortIntoBottom(m_top);
+            }
+            else
+            {
+                SpawnRung(m_top, m_topMin, m_topMax);
+                m_topStart = m_rungs[0].start + m_rungs[0].nBuckets * m_rungs[0].width;
+            }
+            m_topMin = UINT64_MAX;
+            m_topMax = 0;
+            continue;
+        }
+
+        Rung& rung = m_rungs[m_nRungs - 1];
+        while (rung.cur < rung.nBuckets && rung.buckets[rung.cur].empty())
+        {
+            rung.cur++;
+        }
+        if (rung.cur == rung.nBuckets)
+        {
+            m_nRungs--;
+            continue;
+        }
+
+        // Events inserted from now on and earlier than the next bucket go
+        // in a lower rung or in the bottom
+        Bucket& bucket = rung.buckets[rung.cur];
+        rung.cur++;
+        if (bucket.size() > LADDER_THRESHOLD && m_nRungs < LADDER_MAX_RUNGS)
+        {
+            auto [minEv, maxEv] = std::minmax_element(
+                bucket.begin(),
+                bucket.end(),
+                [](const Event& a, const Event& b) { return a.key.m_ts < b.key.m_ts; });
+            if (minEv->key.m_ts < maxEv->key.m_ts)
+            {
+                SpawnRung(bucket, minEv->key.m_ts, maxEv->key.m_ts);
+                continue;
+            }
+        }
+        SortIntoBottom(bucket);
+    }
+}
+
+LadderScheduler::Bucket::iterator
+LadderScheduler::FindInBottom(const Scheduler::EventKey& key)
+{
+    Scheduler::Event ev;
+    ev.key = key;
+    return std::lower_bound(m_bottom.begin(), m_bottom.end(), ev, LaterEvent);
+}
+
+void
+LadderScheduler::RemoveFrom(Bucket& events, const Scheduler::Event& ev)
+{
+    for (auto& i : events)
+    {
+        if (i.key.m_uid == ev.key.m_uid)
+        {
+            NS_ASSERT(ev.impl == i.impl);
+            i = events.back();
+            events.pop_back();
+            return;
+        }
+    }
+    NS_ASSERT(false);
+}
+
+} // namespace ns3
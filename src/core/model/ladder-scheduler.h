@@ -0,0 +1,171 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef LADDER_SCHEDULER_H
+#define LADDER_SCHEDULER_H
+
+#include "scheduler.h"
+
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::LadderScheduler declaration.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup scheduler
+ * \brief a ladder queue event scheduler
+ *
+ * This event scheduler implements the ladder queue published in 2005 in
+ * ["Ladder Queue: An O(1) Priority Queue Structure for Large-Scale Discrete
+ * Event Simulation" by Wai Teng Tang, Rick Siow Mong Goh and Ian Li-Jin
+ * Thng][Tang].
+ *
+ * [Tang]: https://doi.org/10.1145/1103323.1103324 "Tang"
+ *
+ * The events are kept in three tiers:
+ *  - the top, an unsorted `std::vector` of the events later than all the
+ *    events of the other tiers;
+ *  - the ladder, a stack of rungs.  Each rung is an array of unsorted
+ *    buckets, each bucket covering a uniform time span.  A rung is created
+ *    by spreading the events of the top, or those of a crowded bucket of
+ *    the rung above, over as many buckets as there are events, so the
+ *    rungs adapt to the distribution of the time stamps, however skewed;
+ *  - the bottom, a short `std::vector` of the earliest events, sorted by
+ *    decreasing EventKey so that the next event is at its back.
+ *
+ * When the bottom runs out, the next non-empty bucket of the lowest rung is
+ * either sorted into the bottom, if it holds at most 50 events, or spread
+ * into a new rung.  A bottom which grows beyond 50 events because of
+ * insertions is spread into a new rung as well.  There are at most 8 rungs;
+ * past that limit, buckets are sorted into the bottom whatever their size.
+ *
+ * The buckets and the bottom are vectors which keep their capacity across
+ * rungs, so that, once the scheduler is warmed up, moving events between
+ * the tiers does not allocate memory.
+ *
+ * \par Time Complexity
+ *
+ * Operation    | Amortized %Time | Reason
+ * :----------- | :-------------- | :-----
+ * Insert()     | ~Constant       | Append to the top or a bucket
+ * IsEmpty()    | Constant        | Explicit queue size
+ * PeekNext()   | Constant        | Next event at the back of the bottom
+ * Remove()     | Linear          | Search within the top or a bucket
+ * RemoveNext() | ~Constant       | Amortized transfers between the tiers
+ *
+ * \par Memory Complexity
+ *
+ * Category  | Memory                               | Reason
+ * :-------- | :----------------------------------- | :-----
+ * Overhead  | 8 rungs of `std::vector` of buckets  | Ladder
+ * Per Event | 0                                    | Events stored in `std::vector` directly
+ */
+class LadderScheduler : public Scheduler
+{
+  public:
+    /**
+     *  Register this type.
+     *  \return The object TypeId.
+     */
+    static TypeId GetTypeId();
+
+    /** Constructor. */
+    LadderScheduler();
+    /** Destructor. */
+    ~LadderScheduler() override;
+
+    // Inherited
+    void Insert(const Scheduler::Event& ev) override;
+    bool IsEmpty() const override;
+    Scheduler::Event PeekNext() const override;
+    Scheduler::Event RemoveNext() override;
+    void Remove(const Scheduler::Event& ev) override;
+
+  private:
+    /** Unsorted container of events. */
+    typedef std::vector<Scheduler::Event> Bucket;
+
+    /** A rung of the ladder. */
+    struct Rung
+    {
+        std::vector<Bucket> buckets; //!< Buckets of the rung
+        uint64_t start;              //!< Time stamp of the start of the first bucket
+        uint64_t width;              //!< Time span of a bucket
+        uint32_t nBuckets;           //!< Number of buckets in use
+        uint32_t cur;                //!< Index of the first bucket not yet consumed
+
+        /** \returns The time stamp of the start of the first bucket not yet consumed. */
+        uint64_t GetCurStart() const
+        {
+            return start + cur * width;
+        }
+
+        /**
+         * The last bucket also takes the time stamps past the end of the rung.
+         *
+         * \param [in] ts A time stamp, from GetCurStart() on.
+         * \returns The index of the bucket of the time stamp.
+         */
+        uint32_t GetBucket(uint64_t ts) const;
+    };
+
+    /**
+     * Make a new rung the lowest rung of the ladder.
+     *
+     * \param [in,out] events The events to spread into the rung; left empty.
+     * \param [in] minTs The earliest time stamp of the \p events.
+     * \param [in] maxTs The latest time stamp of the \p events.
+     */
+    void SpawnRung(Bucket& events, uint64_t minTs, uint64_t maxTs);
+    /**
+     * Sort a container of events into the empty bottom.
+     *
+     * \param [in,out] events The events; left empty.
+     */
+    void SortIntoBottom(Bucket& events);
+    /** Move the earliest events into the empty bottom. */
+    void FillBottom();
+    /**
+     * Find the position of an event in the bottom.
+     *
+     * \param [in] key The key of the event.
+     * \returns The position of the event, or of its insertion point.
+     */
+    Bucket::iterator FindInBottom(const Scheduler::EventKey& key);
+    /**
+     * Remove an event from an unsorted container.
+     *
+     * \param [in,out] events The container of the event.
+     * \param [in] ev The event.
+     */
+    static void RemoveFrom(Bucket& events, const Scheduler::Event& ev);
+
+    /** Unsorted events later than the ladder. */
+    Bucket m_top;
+    /** Earliest time stamp of the top. */
+    uint64_t m_topMin;
+    /** Latest time stamp of the top. */
+    uint64_t m_topMax;
+    /** Events with a time stamp from this one on go in the top. */
+    uint64_t m_topStart;
+    /** The rungs, allocated once; the first m_nRungs ones are in use. */
+    std::vector<Rung> m_rungs;
+    /** Number of rungs in use. */
+    uint32_t m_nRungs;
+    /** Earliest events, sorted by decreasing key. */
+    Bucket m_bottom;
+    /** Number of events in queue. */
+    uint32_t m_qSize;
+};
+
+} // namespace ns3
+
+#endif /* LADDER_SCHEDULER_H */
@@ -0,0 +1,705 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "multithreaded-simulator-impl.h"
+
+#include "abort.h"
+#include "assert.h"
+#include "log.h"
+#include "simulator.h"
+
+#include <algorithm>
+#include <barrier>
+#include <thread>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::MultithreadedSimulatorImpl implementation.
+ */
+
+namespace ns3
+{
+
+// Note:  Logging in this file is largely avoided due to the
+// number of calls that are made to these functions and the possibility
+// of causing recursions leading to stack overflow
+NS_LOG_COMPONENT_DEFINE("MultithreadedSimulatorImpl");
+
+NS_OBJECT_ENSURE_REGISTERED(MultithreadedSimulatorImpl);
+
+thread_local MultithreadedSimulatorImpl::Partition* MultithreadedSimulatorImpl::t_partition =
+    nullptr;
+
+TypeId
+MultithreadedSimulatorImpl::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::MultithreadedSimulatorImpl")
+                            .SetParent<SimulatorImpl>()
+                            .SetGroupName("Core")
+                            .AddConstructor<MultithreadedSimulatorImpl>();
+    return tid;
+}
+
+MultithreadedSimulatorImpl::MultithreadedSimulatorImpl()
+    : m_repartition(false),
+      m_lookahead(0),
+      m_windowStart(0),
+      m_windowEnd(0),
+      m_stopTs(UINT64_MAX),
+      m_stop(false),
+      m_running(false),
+      m_eventsWithContextEmpty(true)
+{
+    NS_LOG_FUNCTION(this);
+    m_mainThreadId = std::this_thread::get_id();
+    SetNPartitions(1);
+}
+
+MultithreadedSimulatorImpl::~MultithreadedSimulatorImpl()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+MultithreadedSimulatorImpl::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    for (auto& p : m_partitions)
+    {
+        for (auto& outbox : p.outboxes)
+        {
+            for (auto& ev : outbox)
+            {
+                ev.event->Unref();
+            }
+        }
+        while (p.events && !p.events->IsEmpty())
+        {
+            Scheduler::Event next = p.events->RemoveNext();
+            next.impl->Unref();
+        }
+    }
+    for (auto& ev : m_eventsWithContext)
+    {
+        ev.event->Unref();
+    }
+    m_eventsWithContext.clear();
+    m_partitions.clear();
+    SimulatorImpl::DoDispose();
+}
+
+void
+MultithreadedSimulatorImpl::Destroy()
+{
+    NS_LOG_FUNCTION(this);
+    std::unique_lock lock{m_destroyEventsMutex};
+    while (!m_destroyEvents.empty())
+    {
+        Ptr<EventImpl> ev = m_destroyEvents.front().PeekEventImpl();
+        m_destroyEvents.pop_front();
+        NS_LOG_LOGIC("handle destroy " << ev);
+        if (!ev->IsCancelled())
+        {
+            // The event may schedule or remove destroy events
+            lock.unlock();
+            ev->Invoke();
+            lock.lock();
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::SetScheduler(ObjectFactory schedulerFactory)
+{
+    NS_LOG_FUNCTION(this << schedulerFactory);
+    NS_ABORT_MSG_IF(m_running, "Cannot change the scheduler during a run");
+    m_schedulerFactory = schedulerFactory;
+
+    for (auto& p : m_partitions)
+    {
+        Ptr<Scheduler> scheduler = m_schedulerFactory.Create<Scheduler>();
+        if (p.events)
+        {
+            while (!p.events->IsEmpty())
+            {
+                scheduler->Insert(p.events->RemoveNext());
+            }
+        }
+        p.events = scheduler;
+    }
+}
+
+void
+MultithreadedSimulatorImpl::SetNPartitions(uint32_t n)
+{
+    NS_LOG_FUNCTION(this << n);
+    NS_ASSERT(n >= m_partitions.size());
+
+    uint64_t ts = m_partitions.empty() ? 0 : GetMainThreadTs();
+    m_partitions.resize(n);
+    for (auto& p : m_partitions)
+    {
+        if (p.outboxes.empty())
+        {
+            if (m_schedulerFactory.IsTypeIdSet())
+            {
+                p.events = m_schedulerFactory.Create<Scheduler>();
+            }
+            p.uid = EventId::UID::VALID;
+            p.currentUid = EventId::UID::INVALID;
+            p.currentTs = ts;
+            p.currentContext = Simulator::NO_CONTEXT;
+            p.eventCount = 0;
+            p.unscheduledEvents = 0;
+            p.stop = false;
+        }
+        p.outboxes.resize(n);
+    }
+    SpreadUids();
+}
+
+void
+MultithreadedSimulatorImpl::SpreadUids()
+{
+    // Partition i takes the uids equal to i modulo the number of partitions,
+    // above all the uids taken so far: the events of two partitions never
+    // share a uid, even once moved to the same partition
+    uint32_t uid = 0;
+    for (const auto& p : m_partitions)
+    {
+        uid = std::max(uid, p.uid);
+    }
+    for (auto& p : m_partitions)
+    {
+        p.uid = uid++;
+    }
+}
+
+void
+MultithreadedSimulatorImpl::SetPartition(uint32_t context, uint32_t partition)
+{
+    NS_LOG_FUNCTION(this << context << partition);
+    NS_ABORT_MSG_IF(m_running, "Cannot change the partitions during a run");
+    NS_ABORT_MSG_IF(context == Simulator::NO_CONTEXT, "NO_CONTEXT always runs in partition 0");
+
+    if (partition >= m_partitions.size())
+    {
+        SetNPartitions(partition + 1);
+    }
+    if (context >= m_partitionOf.size())
+    {
+        m_partitionOf.resize(context + 1, 0);
+    }
+    if (m_partitionOf[context] != partition)
+    {
+        m_partitionOf[context] = partition;
+        m_repartition = true;
+    }
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetPartition(uint32_t context) const
+{
+    return context < m_partitionOf.size() ? m_partitionOf[context] : 0;
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetNPartitions() const
+{
+    return m_partitions.size();
+}
+
+void
+MultithreadedSimulatorImpl::SetLookahead(const Time& lookahead)
+{
+    NS_LOG_FUNCTION(this << lookahead);
+    NS_ABORT_MSG_IF(m_running, "Cannot change the lookahead during a run");
+    NS_ABORT_MSG_IF(lookahead.IsStrictlyNegative(), "The lookahead cannot be negative");
+    m_lookahead = lookahead.GetTimeStep();
+}
+
+Time
+MultithreadedSimulatorImpl::GetLookahead() const
+{
+    return TimeStep(m_lookahead);
+}
+
+void
+MultithreadedSimulatorImpl::Repartition()
+{
+    NS_LOG_FUNCTION(this);
+    // Keep the keys of the events, so that their EventIds remain valid: their
+    // uids are unique across the partitions
+    std::vector<Scheduler::Event> events;
+    for (auto& p : m_partitions)
+    {
+        while (!p.events->IsEmpty())
+        {
+            events.push_back(p.events->RemoveNext());
+        }
+        p.unscheduledEvents = 0;
+    }
+    for (const auto& ev : events)
+    {
+        Partition& p = m_partitions[GetPartition(ev.key.m_context)];
+        p.events->Insert(ev);
+        p.unscheduledEvents++;
+    }
+    m_repartition = false;
+}
+
+MultithreadedSimulatorImpl::Partition&
+MultithreadedSimulatorImpl::GetCurrentPartition()
+{
+    return t_partition != nullptr ? *t_partition : m_partitions[0];
+}
+
+const MultithreadedSimulatorImpl::Partition&
+MultithreadedSimulatorImpl::GetCurrentPartition() const
+{
+    return t_partition != nullptr ? *t_partition : m_partitions[0];
+}
+
+uint64_t
+MultithreadedSimulatorImpl::GetMainThreadTs() const
+{
+    uint64_t ts = 0;
+    for (const auto& p : m_partitions)
+    {
+        ts = std::max(ts, p.currentTs);
+    }
+    return ts;
+}
+
+// System ID for non-distributed simulation is always zero
+uint32_t
+MultithreadedSimulatorImpl::GetSystemId() const
+{
+    return 0;
+}
+
+Scheduler::EventKey
+MultithreadedSimulatorImpl::Insert(Partition& p, uint64_t ts, uint32_t context, EventImpl* event)
+{
+    Scheduler::Event ev;
+    ev.impl = event;
+    ev.key.m_ts = ts;
+    ev.key.m_context = context;
+    ev.key.m_uid = p.uid;
+    p.uid += m_partitions.size();
+    p.unscheduledEvents++;
+    p.events->Insert(ev);
+    return ev.key;
+}
+
+void
+MultithreadedSimulatorImpl::ProcessOneEvent(Partition& p)
+{
+    Scheduler::Event next = p.events->RemoveNext();
+
+    PreEventHook(EventId(next.impl, next.key.m_ts, next.key.m_context, next.key.m_uid));
+
+    NS_ASSERT(next.key.m_ts >= p.currentTs);
+    p.unscheduledEvents--;
+    p.eventCount++;
+
+    p.currentTs = next.key.m_ts;
+    p.currentContext = next.key.m_context;
+    p.currentUid = next.key.m_uid;
+    next.impl->Invoke();
+    next.impl->Unref();
+}
+
+bool
+MultithreadedSimulatorImpl::IsFinished() const
+{
+    if (m_stop)
+    {
+        return true;
+    }
+    return std::all_of(m_partitions.begin(), m_partitions.end(), [](const Partition& p) {
+        return p.events->IsEmpty();
+    });
+}
+
+void
+MultithreadedSimulatorImpl::RunWindow(uint32_t index)
+{
+    Partition& p = m_partitions[index];
+    // Cut the window short to take the events scheduled by other threads
+    while (!p.stop && !p.events->IsEmpty() && p.events->PeekNext().key.m_ts < m_windowEnd &&
+           m_eventsWithContextEmpty)
+    {
+        ProcessOneEvent(p);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::EndWindow()
+{
+    // Deliver the events in a fixed order, so that their unique ids, which
+    // break the ties between simultaneous events, do not depend on the
+    // scheduling of the threads
+    for (auto& src : m_partitions)
+    {
+        for (uint32_t dst = 0; dst < m_partitions.size(); dst++)
+        {
+            for (const auto& ev : src.outboxes[dst])
+            {
+                Insert(m_partitions[dst], ev.timestamp, ev.context, ev.event);
+            }
+            src.outboxes[dst].clear();
+        }
+    }
+    {
+        std::unique_lock lock{m_eventsWithContextMutex};
+        for (const auto& ev : m_eventsWithContext)
+        {
+            Partition& p = m_partitions[GetPartition(ev.context)];
+            uint64_t ts = std::max(p.currentTs, m_windowStart) + ev.timestamp;
+            Insert(p, ts, ev.context, ev.event);
+        }
+        m_eventsWithContext.clear();
+        m_eventsWithContextEmpty = true;
+    }
+
+    uint64_t next = UINT64_MAX;
+    for (const auto& p : m_partitions)
+    {
+        if (!p.events->IsEmpty())
+        {
+            next = std::min(next, p.events->PeekNext().key.m_ts);
+        }
+    }
+    if (m_stop || next == UINT64_MAX)
+    {
+        m_running = false;
+        return;
+    }
+
+    m_windowStart = next;
+    if (m_partitions.size() == 1 || next > UINT64_MAX - m_lookahead)
+    {
+        m_windowEnd = UINT64_MAX;
+    }
+    else
+    {
+        m_windowEnd = next + m_lookahead;
+    }
+    // Do not run the other partitions past a pending Stop(delay)
+    uint64_t stopTs = m_stopTs;
+    if (stopTs < next)
+    {
+        // The stop event was cancelled
+        m_stopTs = UINT64_MAX;
+    }
+    else if (stopTs < m_windowEnd)
+    {
+        m_windowEnd = stopTs + 1;
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Run()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ABORT_MSG_IF(m_running, "Simulator::Run is not reentrant");
+    uint32_t n = m_partitions.size();
+    NS_ABORT_MSG_IF(n > 1 && m_lookahead == 0, "Running several partitions requires a lookahead");
+
+    // Set the current threadId as the main threadId
+    m_mainThreadId = std::this_thread::get_id();
+    if (m_repartition)
+    {
+        Repartition();
+    }
+    m_stop = false;
+    for (auto& p : m_partitions)
+    {
+        p.stop = false;
+    }
+    m_running = true;
+    EndWindow();
+
+#ifdef NS3_MULTITHREADING
+    std::barrier barrier(n, EndWindowFunction{this});
+    auto worker = [this, &barrier](uint32_t index) {
+        t_partition = &m_partitions[index];
+        while (m_running)
+        {
+            RunWindow(index);
+            barrier.arrive_and_wait();
+        }
+        t_partition = nullptr;
+    };
+
+    std::vector<std::thread> threads;
+    for (uint32_t i = 1; i < n; i++)
+    {
+        threads.emplace_back(worker, i);
+    }
+    worker(0);
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+#else
+    // Without the thread-safe core, the calling thread runs the windows of
+    // the partitions one after the other
+    while (m_running)
+    {
+        for (uint32_t index = 0; index < n; index++)
+        {
+            t_partition = &m_partitions[index];
+            RunWindow(index);
+        }
+        t_partition = nullptr;
+        EndWindow();
+    }
+#endif
+
+    // If the simulator stopped naturally by lack of events, make a
+    // consistency test to check that we didn't lose any events along the way.
+    NS_ASSERT(m_stop || std::all_of(m_partitions.begin(),
+                                    m_partitions.end(),
+                                    [](const Partition& p) { return p.unscheduledEvents == 0; }));
+}
+
+void
+MultithreadedSimulatorImpl::Stop()
+{
+    NS_LOG_FUNCTION(this);
+    if (t_partition != nullptr)
+    {
+        t_partition->stop = true;
+    }
+    m_stop = true;
+}
+
+EventId
+MultithreadedSimulatorImpl::Stop(const Time& delay)
+{
+    NS_LOG_FUNCTION(this << delay.GetTimeStep());
+    EventId id = Simulator::Schedule(delay, &Simulator::Stop);
+    uint64_t stopTs = m_stopTs;
+    while (id.GetTs() < stopTs && !m_stopTs.compare_exchange_weak(stopTs, id.GetTs()))
+    {
+    }
+    return id;
+}
+
+//
+// Schedule an event for a _relative_ time in the future.
+//
+EventId
+MultithreadedSimulatorImpl::Schedule(const Time& delay, EventImpl* event)
+{
+    NS_LOG_FUNCTION(this << delay.GetTimeStep() << event);
+    NS_ASSERT_MSG(t_partition != nullptr ||
+                      (!m_running && m_mainThreadId == std::this_thread::get_id()),
+                  "Simulator::Schedule Thread-unsafe invocation!");
+    NS_ASSERT_MSG(delay.IsPositive(), "MultithreadedSimulatorImpl::Schedule(): Negative delay");
+
+    Partition& p = GetCurrentPartition();
+    Time tAbsolute = delay + TimeStep(t_partition != nullptr ? p.currentTs : GetMainThreadTs());
+    Scheduler::EventKey key =
+        Insert(p, (uint64_t)tAbsolute.GetTimeStep(), p.currentContext, event);
+    return EventId(event, key.m_ts, key.m_context, key.m_uid);
+}
+
+void
+MultithreadedSimulatorImpl::ScheduleWithContext(uint32_t context,
+                                                const Time& delay,
+                                                EventImpl* event)
+{
+    NS_LOG_FUNCTION(this << context << delay.GetTimeStep() << event);
+
+    uint32_t dst = GetPartition(context);
+    if (t_partition == nullptr && !m_running && m_mainThreadId == std::this_thread::get_id())
+    {
+        Time tAbsolute = delay + TimeStep(GetMainThreadTs());
+        Insert(m_partitions[dst], (uint64_t)tAbsolute.GetTimeStep(), context, event);
+    }
+    else if (t_partition == nullptr)
+    {
+        RemoteEvent ev;
+        ev.context = context;
+        // Current time added in EndWindow()
+        ev.timestamp = delay.GetTimeStep();
+        ev.event = event;
+        std::unique_lock lock{m_eventsWithContextMutex};
+        m_eventsWithContext.push_back(ev);
+        m_eventsWithContextEmpty = false;
+    }
+    else if (t_partition == &m_partitions[dst])
+    {
+        Time tAbsolute = delay + TimeStep(t_partition->currentTs);
+        Insert(*t_partition, (uint64_t)tAbsolute.GetTimeStep(), context, event);
+    }
+    else
+    {
+        NS_ABORT_MSG_IF(static_cast<uint64_t>(delay.GetTimeStep()) < m_lookahead,
+                        "Event scheduled for partition " << dst << " with a delay of " << delay
+                                                         << ", shorter than the lookahead "
+                                                         << GetLookahead());
+        RemoteEvent ev;
+        ev.context = context;
+        ev.timestamp = t_partition->currentTs + delay.GetTimeStep();
+        ev.event = event;
+        t_partition->outboxes[dst].push_back(ev);
+    }
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleNow(EventImpl* event)
+{
+    NS_ASSERT_MSG(t_partition != nullptr ||
+                      (!m_running && m_mainThreadId == std::this_thread::get_id()),
+                  "Simulator::ScheduleNow Thread-unsafe invocation!");
+
+    return Schedule(Time(0), event);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleDestroy(EventImpl* event)
+{
+    EventId id(Ptr<EventImpl>(event, false), GetCurrentPartition().currentTs, 0xffffffff, 2);
+    std::unique_lock lock{m_destroyEventsMutex};
+    m_destroyEvents.push_back(id);
+    return id;
+}
+
+Time
+MultithreadedSimulatorImpl::Now() const
+{
+    // Do not add function logging here, to avoid stack overflow
+    return TimeStep(t_partition != nullptr ? t_partition->currentTs : GetMainThreadTs());
+}
+
+Time
+MultithreadedSimulatorImpl::GetDelayLeft(const EventId& id) const
+{
+    if (IsExpired(id))
+    {
+        return TimeStep(0);
+    }
+    else
+    {
+        // Seen from the main thread, an event of a partition which stopped
+        // earlier than the others may be due before Now()
+        uint64_t now = Now().GetTimeStep();
+        return TimeStep(std::max(id.GetTs(), now) - now);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Remove(const EventId& id)
+{
+    if (id.GetUid() == EventId::UID::DESTROY)
+    {
+        // destroy events.
+        std::unique_lock lock{m_destroyEventsMutex};
+        for (auto i = m_destroyEvents.begin(); i != m_destroyEvents.end(); i++)
+        {
+            if (*i == id)
+            {
+                m_destroyEvents.erase(i);
+                break;
+            }
+        }
+        return;
+    }
+    if (IsExpired(id))
+    {
+        return;
+    }
+    Partition& p = m_partitions[GetPartition(id.GetContext())];
+    NS_ASSERT_MSG(t_partition == nullptr || t_partition == &p,
+                  "Simulator::Remove of an event of another partition");
+    Scheduler::Event event;
+    event.impl = id.PeekEventImpl();
+    event.key.m_ts = id.GetTs();
+    event.key.m_context = id.GetContext();
+    event.key.m_uid = id.GetUid();
+    p.events->Remove(event);
+    event.impl->Cancel();
+    // whenever we remove an event from the event list, we have to unref it.
+    event.impl->Unref();
+
+    p.unscheduledEvents--;
+}
+
+void
+MultithreadedSimulatorImpl::Cancel(const EventId& id)
+{
+    if (!IsExpired(id))
+    {
+        id.PeekEventImpl()->Cancel();
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::IsExpired(const EventId& id) const
+{
+    if (id.GetUid() == EventId::UID::DESTROY)
+    {
+        if (id.PeekEventImpl() == nullptr || id.PeekEventImpl()->IsCancelled())
+        {
+            return true;
+        }
+        // destroy events.
+        std::unique_lock lock{m_destroyEventsMutex};
+        return std::find(m_destroyEvents.begin(), m_destroyEvents.end(), id) ==
+               m_destroyEvents.end();
+    }
+    const Partition& p = m_partitions[GetPartition(id.GetContext())];
+    return id.PeekEventImpl() == nullptr || id.GetTs() < p.currentTs ||
+           (id.GetTs() == p.currentTs && id.GetUid() <= p.currentUid) ||
+           id.PeekEventImpl()->IsCancelled();
+}
+
+Time
+MultithreadedSimulatorImpl::GetMaximumSimulationTime() const
+{
+    return TimeStep(0x7fffffffffffffffLL);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetContext() const
+{
+    return GetCurrentPartition().currentContext;
+}
+
+uint64_t
+MultithreadedSimulatorImpl::GetEventCount() const
+{
+    if (t_partition != nullptr)
+    {
+        return t_partition->eventCount;
+    }
+    uint64_t count = 0;
+    for (const auto& p : m_partitions)
+    {
+        count += p.eventCount;
+    }
+    return count;
+}
+
+uint64_t
+MultithreadedSimulatorImpl::GetPendingEventCount() const
+{
+    if (t_partition != nullptr)
+    {
+        return t_partition->unscheduledEvents;
+    }
+    uint64_t count = 0;
+    for (const auto& p : m_partitions)
+    {
+        count += p.unscheduledEvents;
+    }
+    return count;
+}
+
+} // namespace ns3
@@ -0,0 +1,268 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef MULTITHREADED_SIMULATOR_IMPL_H
+#define MULTITHREADED_SIMULATOR_IMPL_H
+
+#include "object-factory.h"
+#include "scheduler.h"
+#include "simulator-impl.h"
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::MultithreadedSimulatorImpl declaration.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup simulator
+ *
+ * \brief A shared-memory parallel simulator implementation.
+ *
+ * The execution contexts, i.e., the nodes, are split into partitions, and
+ * every partition has its own event queue, run by its own thread.  The
+ * partitions are synchronized conservatively, with barrier-synchronized
+ * windows: if the earliest pending event of all the partitions is at
+ * \c t, every partition runs all its events earlier than
+ * \c t + \c lookahead, then waits at a barrier for the others.
+ *
+ * The lookahead is the smallest delay of the events scheduled by a
+ * partition for a context of another partition, typically the smallest
+ * delay of the channels between the partitions, so the events exchanged
+ * during a window always belong to a later window.  They are appended to
+ * per pair of partitions outboxes, which are only written by the sender
+ * during the window and only read after the barrier, so the exchange
+ * needs no lock.  The events received are inserted in the order of their
+ * sender partition, so the runs are reproducible, whatever the scheduling
+ * of the threads.
+ *
+ * The partitions and the lookahead are usually set up by the
+ * MultithreadedSimulatorHelper of the point-to-point module.  Contexts
+ * without a partition, including Simulator::NO_CONTEXT, belong to
+ * partition 0, which is run by the thread calling Simulator::Run.
+ *
+ * ns-3 must be configured with \c --enable-multithreading to run the
+ * partitions in parallel, so that the reference counts of the objects
+ * shared by the partitions are atomic.  Otherwise, the thread calling
+ * Simulator::Run runs the windows of the partitions one after the other,
+ * which gives the same results, e.g., to check a partitioning, without the
+ * speedup.  Besides, the models must not share any
+ * other mutable state across partitions: e.g., a random variable, a trace
+ * file or a FlowMonitor used by the nodes of several partitions.
+ *
+ * Within a partition, events are scheduled, cancelled and removed as with
+ * the DefaultSimulatorImpl, but an event can only be cancelled or removed
+ * by its own partition.  Simulator::Stop stops the calling partition
+ * immediately and the other ones at the end of the window.
+ */
+class MultithreadedSimulatorImpl : public SimulatorImpl
+{
+  public:
+    /**
+     *  Register this type.
+     *  \return The object TypeId.
+     */
+    static TypeId GetTypeId();
+
+    /** Constructor. */
+    MultithreadedSimulatorImpl();
+    /** Destructor. */
+    ~MultithreadedSimulatorImpl() override;
+
+    // Inherited
+    void Destroy() override;
+    bool IsFinished() const override;
+    void Stop() override;
+    EventId Stop(const Time& delay) override;
+    EventId Schedule(const Time& delay, EventImpl* event) override;
+    void ScheduleWithContext(uint32_t context, const Time& delay, EventImpl* event) override;
+    EventId ScheduleNow(EventImpl* event) override;
+    EventId ScheduleDestroy(EventImpl* event) override;
+    void Remove(const EventId& id) override;
+    void Cancel(const EventId& id) override;
+    bool IsExpired(const EventId& id) const override;
+    void Run() override;
+    Time Now() const override;
+    Time GetDelayLeft(const EventId& id) const override;
+    Time GetMaximumSimulationTime() const override;
+    void SetScheduler(ObjectFactory schedulerFactory) override;
+    uint32_t GetSystemId() const override;
+    uint32_t GetContext() const override;
+    uint64_t GetEventCount() const override;
+    uint64_t GetPendingEventCount() const override;
+
+    /**
+     * Assign a context to a partition.
+     *
+     * Partitions are created as needed; there is one thread per partition.
+     * The pending events of the context are moved to its partition at the
+     * next Run.
+     *
+     * \param [in] context The context, usually a node id.
+     * \param [in] partition The partition.
+     */
+    void SetPartition(uint32_t context, uint32_t partition);
+    /**
+     * \param [in] context The context.
+     * \returns The partition of the context.
+     */
+    uint32_t GetPartition(uint32_t context) const;
+    /**
+     * \returns The number of partitions.
+     */
+    uint32_t GetNPartitions() const;
+    /**
+     * Set the lookahead, the smallest delay of the events scheduled for a
+     * context of another partition.
+     *
+     * \param [in] lookahead The lookahead.
+     */
+    void SetLookahead(const Time& lookahead);
+    /**
+     * \returns The lookahead.
+     */
+    Time GetLookahead() const;
+
+  private:
+    void DoDispose() override;
+
+    /** An event scheduled for a context of another partition. */
+    struct RemoteEvent
+    {
+        uint64_t timestamp; //!< Event time stamp
+        uint32_t context;   //!< Event context
+        EventImpl* event;   //!< Event implementation
+    };
+
+    /** The state of a partition, only accessed by its thread during a window. */
+    struct Partition
+    {
+        Ptr<Scheduler> events;   //!< The event priority queue
+        uint32_t uid;            //!< Next event unique id, in steps of the number of partitions
+        uint32_t currentUid;     //!< Unique id of the current event
+        uint64_t currentTs;      //!< Timestamp of the current event
+        uint32_t currentContext; //!< Execution context of the current event
+        uint64_t eventCount;     //!< The event count
+        int unscheduledEvents;   //!< Number of events inserted but not yet run
+        bool stop;               //!< Whether the partition was stopped
+        /** Events scheduled for the other partitions, indexed by partition. */
+        std::vector<std::vector<RemoteEvent>> outboxes;
+    };
+
+    /** Completion of the windows, run by a single thread once all arrived at the barrier. */
+    struct EndWindowFunction
+    {
+        MultithreadedSimulatorImpl* impl; //!< The simulator
+        /** Run the completion. */
+        void operator()() noexcept
+        {
+            impl->EndWindow();
+        }
+    };
+
+    /**
+     * \returns The partition of the calling thread, or partition 0 for the
+     * threads which do not run a partition.
+     */
+    Partition& GetCurrentPartition();
+    /** \copydoc GetCurrentPartition() */
+    const Partition& GetCurrentPartition() const;
+    /**
+     * \returns The time of the simulation seen by the threads which do not
+     * run a partition: the latest time reached by a partition, since the
+     * partitions may stop at different times within a window.
+     */
+    uint64_t GetMainThreadTs() const;
+    /**
+     * Set the number of partitions.
+     * \param [in] n The number of partitions.
+     */
+    void SetNPartitions(uint32_t n);
+    /**
+     * Interleave the uids of the partitions above all the uids already taken,
+     * so that the pending events keep unique keys when moved between
+     * partitions.
+     */
+    void SpreadUids();
+    /** Move the pending events to the partitions of their contexts. */
+    void Repartition();
+    /**
+     * Insert an event in a partition.
+     * \param [in] p The partition.
+     * \param [in] ts The time stamp of the event.
+     * \param [in] context The context of the event.
+     * \param [in] event The event.
+     * \returns The key of the event.
+     */
+    Scheduler::EventKey Insert(Partition& p, uint64_t ts, uint32_t context, EventImpl* event);
+    /**
+     * Run the next event of a partition.
+     * \param [in] p The partition.
+     */
+    void ProcessOneEvent(Partition& p);
+    /**
+     * Run the events of a partition earlier than the end of the window.
+     * \param [in] index The index of the partition.
+     */
+    void RunWindow(uint32_t index);
+    /**
+     * Deliver the events exchanged during the window and set up the next
+     * window, or the end of the run.
+     */
+    void EndWindow();
+
+    /** The partition run by the calling thread, if any. */
+    static thread_local Partition* t_partition;
+
+    /** The partitions. */
+    std::vector<Partition> m_partitions;
+    /** The partition of every context, indexed by context. */
+    std::vector<uint32_t> m_partitionOf;
+    /** Whether contexts changed partition since the last Run. */
+    bool m_repartition;
+    /** The lookahead, in time steps. */
+    uint64_t m_lookahead;
+    /** The scheduler factory. */
+    ObjectFactory m_schedulerFactory;
+
+    /** Time stamp of the start of the window. */
+    uint64_t m_windowStart;
+    /** Time stamp of the end of the window, excluded. */
+    uint64_t m_windowEnd;
+    /** Time stamp of the earliest stop, scheduled by Stop(delay). */
+    std::atomic<uint64_t> m_stopTs;
+    /** Flag calling for the end of the simulation. */
+    std::atomic<bool> m_stop;
+    /** Whether a run is in progress. */
+    std::atomic<bool> m_running;
+
+    /** Thread which configures the simulation and calls Run. */
+    std::thread::id m_mainThreadId;
+    /** Events scheduled by threads which do not run a partition. */
+    std::list<RemoteEvent> m_eventsWithContext;
+    /** Flag \c true if all events with context have been moved to the partitions. */
+    std::atomic<bool> m_eventsWithContextEmpty;
+    /** Mutex to control access to the list of events with context. */
+    std::mutex m_eventsWithContextMutex;
+
+    /** Container type for the events to run at Simulator::Destroy() */
+    typedef std::list<EventId> DestroyEvents;
+    /** The container of events to run at Destroy. */
+    DestroyEvents m_destroyEvents;
+    /** Mutex to control access to the events to run at Destroy. */
+    mutable std::mutex m_destroyEventsMutex;
+};
+
+} // namespace ns3
+
+#endif /* MULTITHREADED_SIMULATOR_IMPL_H */
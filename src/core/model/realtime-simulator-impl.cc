@@ -791,6 +791,13 @@ RealtimeSimulatorImpl::GetEventCount() const
     return m_eventCount;
 }
 
+uint64_t
+RealtimeSimulatorImpl::GetPendingEventCount() const
+{
+    std::unique_lock lock{m_mutex};
+    return m_unscheduledEvents;
+}
+
 void
 RealtimeSimulatorImpl::SetSynchronizationMode(SynchronizationMode mode)
 {
@@ -11,6 +11,7 @@
 
 #include "object.h"
 
+#include <cstring>
 #include <stdint.h>
 
 /**
@@ -21,6 +22,15 @@
  * ns3::Scheduler::EventKey declarations.
  */
 
+#if defined(NS3_COMPACT_EVENT_KEYS) && defined(__SIZEOF_INT128__) &&                              \
+    __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+/**
+ * \ingroup events
+ * Order the event keys as single 128-bit integers.
+ */
+#define NS3_EVENT_KEY_INT128
+#endif
+
 namespace ns3
 {
 
@@ -154,12 +164,24 @@ class Scheduler : public Object
     /**
      * \ingroup events
      * Structure for sorting and comparing Events.
+     *
+     * When ns-3 is configured with \c NS3_COMPACT_EVENT_KEYS, on hosts with
+     * native 128-bit integers, the fields are laid out so that the 16 bytes
+     * of a key, read as a little-endian integer, are ordered by time stamp
+     * then by uid: comparing two keys takes a single integer comparison
+     * instead of two dependent branches.
      */
     struct EventKey
     {
+#ifdef NS3_EVENT_KEY_INT128
+        uint32_t m_context; /**< Event context. */
+        uint32_t m_uid;     /**< Event unique id. */
+        uint64_t m_ts;      /**< Event time stamp. */
+#else
         uint64_t m_ts;      /**< Event time stamp. */
         uint32_t m_uid;     /**< Event unique id. */
         uint32_t m_context; /**< Event context. */
+#endif
     };
 
     /**
@@ -217,6 +239,27 @@ class Scheduler : public Object
     virtual void Remove(const Event& ev) = 0;
 };
 
+#ifdef NS3_EVENT_KEY_INT128
+/**
+ * \ingroup events
+ * Get the integer value of an EventKey.
+ *
+ * The context sits in the low-order bits: since uids are unique, it never
+ * decides the order of two distinct events.
+ *
+ * \param [in] key The event key.
+ * \returns The key, as an integer ordered by time stamp then uid.
+ */
+inline __uint128_t
+GetEventKeyValue(const Scheduler::EventKey& key)
+{
+    static_assert(sizeof(Scheduler::EventKey) == sizeof(__uint128_t));
+    __uint128_t value;
+    std::memcpy(&value, &key, sizeof(value));
+    return value;
+}
+#endif
+
 /**
  * \ingroup events
  * Compare (equal) two events by EventKey.
@@ -261,7 +304,11 @@ operator!=(const Scheduler::EventKey& a, const Scheduler::EventKey& b)
 inline bool
 operator<(const Scheduler::EventKey& a, const Scheduler::EventKey& b)
 {
+#ifdef NS3_EVENT_KEY_INT128
+    return GetEventKeyValue(a) < GetEventKeyValue(b);
+#else
     return (a.m_ts < b.m_ts || (a.m_ts == b.m_ts && a.m_uid < b.m_uid));
+#endif
 }
 
 /**
@@ -274,7 +321,11 @@ operator<(const Scheduler::EventKey& a, const Scheduler::EventKey& b)
 inline bool
 operator>(const Scheduler::EventKey& a, const Scheduler::EventKey& b)
 {
+#ifdef NS3_EVENT_KEY_INT128
+    return GetEventKeyValue(a) > GetEventKeyValue(b);
+#else
     return (a.m_ts > b.m_ts || (a.m_ts == b.m_ts && a.m_uid > b.m_uid));
+#endif
 }
 
 /**
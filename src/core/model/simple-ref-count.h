@@ -16,6 +16,10 @@
 #include <limits>
 #include <stdint.h>
 
+#ifdef NS3_MULTITHREADING
+#include <atomic>
+#endif
+
 /**
  * \file
  * \ingroup ptr
@@ -64,6 +68,10 @@ class Empty
  *      to the object it manages exist anymore.
  *
  * Interesting users of this class include ns3::Object as well as ns3::Packet.
+ *
+ * When ns-3 is configured with \c NS3_MULTITHREADING, the reference count
+ * is atomic, so that the objects shared by the partitions of a
+ * MultithreadedSimulatorImpl can be referenced from several threads.
  */
 template <typename T, typename PARENT = Empty, typename DELETER = DefaultDeleter<T>>
 class SimpleRefCount : public PARENT
@@ -103,7 +111,11 @@ class SimpleRefCount : public PARENT
     inline void Ref() const
     {
         NS_ASSERT(m_count < std::numeric_limits<uint32_t>::max());
+#ifdef NS3_MULTITHREADING
+        m_count.fetch_add(1, std::memory_order_relaxed);
+#else
         m_count++;
+#endif
     }
 
     /**
@@ -114,8 +126,12 @@ class SimpleRefCount : public PARENT
      */
     inline void Unref() const
     {
+#ifdef NS3_MULTITHREADING
+        if (m_count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+#else
         m_count--;
         if (m_count == 0)
+#endif
         {
             DELETER::Delete(static_cast<T*>(const_cast<SimpleRefCount*>(this)));
         }
@@ -140,7 +156,11 @@ class SimpleRefCount : public PARENT
      * Note we make this mutable so that the const methods can still
      * change it.
      */
+#ifdef NS3_MULTITHREADING
+    mutable std::atomic<uint32_t> m_count;
+#else
     mutable uint32_t m_count;
+#endif
 };
 
 } // namespace ns3
@@ -0,0 +1,318 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "simulation-fork.h"
+
+#include "abort.h"
+#include "log.h"
+#include "simulator.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <poll.h>
+#include <sstream>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::SimulationFork implementation.
+ */
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("SimulationFork");
+
+namespace
+{
+
+/** A running child, seen from the parent. */
+struct Child
+{
+    uint32_t index;     //!< The index of the child
+    pid_t pid;          //!< The process id of the child
+    int fd;             //!< The read end of the pipe from the child
+    std::string result; //!< The result received so far
+};
+
+/**
+ * Write a buffer to a file descriptor, retrying short writes.
+ *
+ * \param [in] fd The file descriptor.
+ * \param [in] data The buffer.
+ * \returns \c true on success.
+ */
+bool
+WriteAll(int fd, const std::string& data)
+{
+    std::size_t written = 0;
+    while (written < data.size())
+    {
+        ssize_t n = ::write(fd, data.data() + written, data.size() - written);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        written += n;
+    }
+    return true;
+}
+
+/**
+ * Wait for a child whose pipe is closed, and check that it exited normally.
+ *
+ * \param [in] child The child.
+ * \returns An error message, empty if the child exited normally.
+ */
+std::string
+Reap(const Child& child)
+{
+    int status;
+    pid_t waited;
+    do
+    {
+        waited = ::waitpid(child.pid, &status, 0);
+    } while (waited == -1 && errno == EINTR);
+    std::ostringstream oss;
+    if (waited == -1)
+    {
+        oss << "waitpid() fails, errno = " << std::strerror(errno);
+    }
+    else if (WIFSIGNALED(status))
+    {
+        oss << "child " << child.index << " killed by signal " << WTERMSIG(status);
+    }
+    else if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+    {
+        oss << "child " << child.index << " exited with status " << WEXITSTATUS(status);
+    }
+    return oss.str();
+}
+
+/**
+ * Kill and reap the running children, so that none outlives a failure.
+ *
+ * \param [in,out] running The running children, cleared.
+ */
+void
+KillAll(std::vector<Child>& running)
+{
+    for (const auto& child : running)
+    {
+        ::kill(child.pid, SIGKILL);
+        ::close(child.fd);
+    }
+    for (const auto& child : running)
+    {
+        while (::waitpid(child.pid, nullptr, 0) == -1 && errno == EINTR)
+        {
+        }
+    }
+    running.clear();
+}
+
+/**
+ * Kill and reap the running children, then abort.
+ *
+ * \param [in,out] running The running children.
+ * \param [in] error The error message.
+ */
+[[noreturn]] void
+Fail(std::vector<Child>& running, const std::string& error)
+{
+    KillAll(running);
+    NS_FATAL_ERROR("SimulationFork: " << error);
+}
+
+} // namespace
+
+SimulationFork::SimulationFork()
+    : m_maxChildren(std::max(std::thread::hardware_concurrency(), 1U)),
+      m_index(PARENT),
+      m_fd(-1)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+SimulationFork::~SimulationFork()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_fd != -1)
+    {
+        ::close(m_fd);
+    }
+}
+
+void
+SimulationFork::SetMaxChildren(uint32_t maxChildren)
+{
+    NS_LOG_FUNCTION(this << maxChildren);
+    NS_ABORT_MSG_IF(maxChildren == 0, "At least one child must be able to run");
+    m_maxChildren = maxChildren;
+}
+
+uint32_t
+SimulationFork::ForkAt(const Time& time, uint32_t n)
+{
+    NS_LOG_FUNCTION(this << time << n);
+    NS_ABORT_MSG_IF(IsChild(), "SimulationFork::ForkAt() called in a child");
+    NS_ABORT_MSG_IF(time < Simulator::Now(), "SimulationFork::ForkAt() time is in the past");
+
+    // Run the shared warm-up
+    if (time > Simulator::Now())
+    {
+        EventId stop = Simulator::Stop(time - Simulator::Now());
+        Simulator::Run();
+        if (stop.IsPending())
+        {
+            NS_LOG_WARN("The simulation stopped before the fork time " << time);
+            stop.Remove();
+        }
+    }
+
+    // Do not write the buffered output of the parent once per child
+    std::cout.flush();
+    std::cerr.flush();
+    std::fflush(nullptr);
+
+    m_results.assign(n, std::string());
+    std::vector<Child> running;
+    uint32_t next = 0;
+    while (next < n || !running.empty())
+    {
+        while (next < n && running.size() < m_maxChildren)
+        {
+            int fds[2];
+            if (::pipe(fds) == -1)
+            {
+                Fail(running, std::string("pipe() fails, errno = ") + std::strerror(errno));
+            }
+            pid_t pid = ::fork();
+            if (pid == -1)
+            {
+                std::string error = std::string("fork() fails, errno = ") + std::strerror(errno);
+                ::close(fds[0]);
+                ::close(fds[1]);
+                Fail(running, error);
+            }
+            if (pid == 0)
+            {
+                ::close(fds[0]);
+                for (const auto& child : running)
+                {
+                    ::close(child.fd);
+                }
+                m_index = next;
+                m_fd = fds[1];
+                m_results.clear();
+                NS_LOG_DEBUG("Child " << m_index << " started");
+                return m_index;
+            }
+            ::close(fds[1]);
+            NS_LOG_DEBUG("Forked child " << next << " as process " << pid);
+            running.push_back({next, pid, fds[0], std::string()});
+            next++;
+        }
+
+        // Read the results until a child closes its pipe
+        std::vector<pollfd> fds;
+        fds.reserve(running.size());
+        for (const auto& child : running)
+        {
+            fds.push_back({child.fd, POLLIN, 0});
+        }
+        if (::poll(fds.data(), fds.size(), -1) == -1)
+        {
+            if (errno != EINTR)
+            {
+                Fail(running, std::string("poll() fails, errno = ") + std::strerror(errno));
+            }
+            continue;
+        }
+        for (std::size_t i = fds.size(); i-- > 0;)
+        {
+            if (fds[i].revents == 0)
+            {
+                continue;
+            }
+            char buffer[4096];
+            ssize_t len = ::read(fds[i].fd, buffer, sizeof(buffer));
+            if (len > 0)
+            {
+                running[i].result.append(buffer, len);
+                continue;
+            }
+            if (len == -1)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                Fail(running,
+                     "read() from child " + std::to_string(running[i].index) +
+                         " fails, errno = " + std::strerror(errno));
+            }
+            // End of file: the child has exited
+            ::close(running[i].fd);
+            std::string error = Reap(running[i]);
+            Child child = std::move(running[i]);
+            running.erase(running.begin() + i);
+            if (!error.empty())
+            {
+                Fail(running, error);
+            }
+            NS_LOG_DEBUG("Child " << child.index << " exited");
+            m_results[child.index] = std::move(child.result);
+        }
+    }
+    return PARENT;
+}
+
+bool
+SimulationFork::IsChild() const
+{
+    return m_index != PARENT;
+}
+
+uint32_t
+SimulationFork::GetChildIndex() const
+{
+    return m_index;
+}
+
+void
+SimulationFork::Exit(const std::string& result)
+{
+    NS_LOG_FUNCTION(this);
+    NS_ABORT_MSG_IF(!IsChild(), "SimulationFork::Exit() called in the parent");
+    Simulator::Destroy();
+    int status = WriteAll(m_fd, result) ? 0 : 1;
+    ::close(m_fd);
+    m_fd = -1;
+    std::cout.flush();
+    std::cerr.flush();
+    std::fflush(nullptr);
+    // Skip the static destructors and exit handlers, which belong to the
+    // parent
+    ::_exit(status);
+}
+
+const std::vector<std::string>&
+SimulationFork::GetResults() const
+{
+    return m_results;
+}
+
+} // namespace ns3
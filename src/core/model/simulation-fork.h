@@ -0,0 +1,125 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef SIMULATION_FORK_H
+#define SIMULATION_FORK_H
+
+#include "nstime.h"
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::SimulationFork declaration.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup simulator
+ * \brief Run a shared warm-up once, then continue it in forked child
+ * processes.
+ *
+ * Parameter sweeps often repeat the same start-up phase, e.g., the flows
+ * starting and converging, before the phase which is measured.  ForkAt()
+ * runs the simulation until the end of this warm-up, then forks child
+ * processes which inherit the whole simulation state copy-on-write.  Each
+ * child applies its own parameters, e.g., with Config::Set(), continues the
+ * simulation and sends a result back with Exit(); the parent process
+ * collects the results of all the children:
+ *
+ * \code
+ *   SimulationFork fork;
+ *   uint32_t child = fork.ForkAt(Seconds(2), targets.size());
+ *   if (fork.IsChild())
+ *   {
+ *       Config::Set("/NodeList/.../$ns3::TcpSwift/BaseTarget", TimeValue(targets[child]));
+ *       Simulator::Stop(Seconds(1));
+ *       Simulator::Run();
+ *       fork.Exit(Measure());
+ *   }
+ *   for (const auto& result : fork.GetResults())
+ *   {
+ *       ...
+ *   }
+ * \endcode
+ *
+ * The children inherit the state of the random number generators as well,
+ * so that they differ only by the parameters they apply.  The parameters
+ * must be applied to the existing objects: Config::SetDefault() only
+ * affects the objects created afterwards.
+ *
+ * Forking only duplicates the calling thread, so that ForkAt() must not be
+ * called while other threads run, and cannot be used with the distributed
+ * simulator implementations.  SimulationFork is not available on Windows.
+ */
+class SimulationFork
+{
+  public:
+    /** The child index returned to the parent process. */
+    static constexpr uint32_t PARENT = 0xffffffff;
+
+    SimulationFork();
+    ~SimulationFork();
+
+    // Delete copy constructor and assignment operator to avoid misuse
+    SimulationFork(const SimulationFork&) = delete;
+    SimulationFork& operator=(const SimulationFork&) = delete;
+
+    /**
+     * Set the maximum number of children which run at the same time; by
+     * default, the number of hardware threads.
+     *
+     * \param [in] maxChildren The maximum number of running children.
+     */
+    void SetMaxChildren(uint32_t maxChildren);
+
+    /**
+     * Run the simulation until \pname{time}, then fork \pname{n} children.
+     *
+     * ForkAt() returns in every child, with the index of the child.  In the
+     * parent, it returns PARENT once all the children have exited.  If a
+     * child fails, or its result cannot be read, the parent kills the other
+     * children and aborts.
+     *
+     * \param [in] time The absolute time at which to fork.
+     * \param [in] n The number of children.
+     * \returns The index of the child in [0, n), or PARENT.
+     */
+    uint32_t ForkAt(const Time& time, uint32_t n);
+
+    /** \returns \c true in a child process. */
+    bool IsChild() const;
+
+    /** \returns The index of the child, or PARENT. */
+    uint32_t GetChildIndex() const;
+
+    /**
+     * Destroy the simulation, send the result to the parent and exit the
+     * child process.
+     *
+     * \param [in] result The result of the child.
+     */
+    [[noreturn]] void Exit(const std::string& result);
+
+    /**
+     * \returns The results of the children, by child index; the result of a
+     * child which exited without calling Exit() is empty.
+     */
+    const std::vector<std::string>& GetResults() const;
+
+  private:
+    uint32_t m_maxChildren;             //!< The maximum number of running children
+    uint32_t m_index;                   //!< The index of the child, or PARENT
+    int m_fd;                           //!< The pipe to the parent, in a child
+    std::vector<std::string> m_results; //!< The results of the children
+};
+
+} // namespace ns3
+
+#endif /* SIMULATION_FORK_H */
@@ -29,4 +29,11 @@ SimulatorImpl::GetTypeId()
     return tid;
 }
 
+uint64_t
+SimulatorImpl::GetPendingEventCount() const
+{
+    NS_LOG_FUNCTION(this);
+    return 0;
+}
+
 } // namespace ns3
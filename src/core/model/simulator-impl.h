@@ -89,6 +89,13 @@ class SimulatorImpl : public Object
     virtual uint32_t GetContext() const = 0;
     /** \copydoc Simulator::GetEventCount */
     virtual uint64_t GetEventCount() const = 0;
+    /**
+     * \copydoc Simulator::GetPendingEventCount
+     *
+     * The default implementation, for the simulators which do not count
+     * their pending events, returns 0.
+     */
+    virtual uint64_t GetPendingEventCount() const;
 
     /**
      * Hook called before processing each event.
@@ -205,6 +205,17 @@ class Simulator
      */
     static uint64_t GetEventCount();
 
+    /**
+     * Get the number of events in the event list.
+     *
+     * The cancelled events are counted until their time is reached, since
+     * they are only removed from the event list then.
+     *
+     * \returns The number of events in the event list, or 0 if the
+     * simulator implementation does not count them.
+     */
+    static uint64_t GetPendingEventCount();
+
     /**
      * @name Schedule events (in the same context) to run at a future time.
      */
@@ -0,0 +1,470 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "timer-wheel.h"
+
+#include "abort.h"
+#include "assert.h"
+#include "log.h"
+#include "simulator.h"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <mutex>
+#include <unordered_map>
+
+/**
+ * \file
+ * \ingroup timer
+ * ns3::TimerWheel and ns3::WheelEventId implementations.
+ */
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("TimerWheel");
+
+namespace
+{
+
+/** The slot of a timer which is not linked in a wheel. */
+constexpr uint32_t UNLINKED = std::numeric_limits<uint32_t>::max();
+/** The time stamp when there is no event. */
+constexpr int64_t NO_TS = std::numeric_limits<int64_t>::max();
+
+/** Protects the wheels of the contexts. */
+std::mutex g_wheelsMutex;
+/** The wheels of the contexts. */
+std::unordered_map<uint32_t, Ptr<TimerWheel>> g_wheels;
+
+} // namespace
+
+TimerWheel::TimerWheel(uint32_t context, Time granularity)
+    : m_context(context),
+      m_granularity(granularity.GetTimeStep()),
+      m_tick(0),
+      m_slots{},
+      m_occupied{},
+      m_seq(0),
+      m_eventTs(NO_TS),
+      m_nTimers(0),
+      m_nScheduled(0),
+      m_nCancelled(0),
+      m_nTicks(0)
+{
+    NS_LOG_FUNCTION(this << context << granularity);
+    NS_ABORT_MSG_IF(m_granularity <= 0, "The granularity of a TimerWheel must be positive");
+    m_tick = Simulator::Now().GetTimeStep() / m_granularity;
+}
+
+TimerWheel::~TimerWheel()
+{
+    NS_LOG_FUNCTION(this);
+    for (uint32_t slot = 0; slot <= OVERFLOW_SLOT; slot++)
+    {
+        while (m_slots[slot] != nullptr)
+        {
+            Entry* entry = m_slots[slot];
+            Unlink(entry);
+            entry->event = nullptr;
+            entry->Unref();
+        }
+    }
+}
+
+Ptr<TimerWheel>
+TimerWheel::GetWheel(uint32_t context)
+{
+    std::unique_lock lock{g_wheelsMutex};
+    Ptr<TimerWheel>& wheel = g_wheels[context];
+    if (!wheel)
+    {
+        if (g_wheels.size() == 1)
+        {
+            Simulator::ScheduleDestroy(&TimerWheel::DestroyWheels);
+        }
+        wheel = Create<TimerWheel>(context);
+    }
+    return wheel;
+}
+
+void
+TimerWheel::DestroyWheels()
+{
+    std::unique_lock lock{g_wheelsMutex};
+    g_wheels.clear();
+}
+
+WheelEventId
+TimerWheel::Schedule(const Time& delay, const Ptr<EventImpl>& event)
+{
+    return DoSchedule(delay, GetPointer(event));
+}
+
+WheelEventId
+TimerWheel::DoSchedule(const Time& delay, EventImpl* event)
+{
+    NS_LOG_FUNCTION(this << delay << event);
+    NS_ASSERT_MSG(!delay.IsStrictlyNegative(), "TimerWheel::Schedule(): negative delay");
+    int64_t now = Simulator::Now().GetTimeStep();
+    Advance(now / m_granularity);
+
+    Ptr<Entry> entry = Create<Entry>();
+    entry->event = Ptr<EventImpl>(event, false);
+    entry->ts = now + delay.GetTimeStep();
+    entry->seq = m_seq++;
+    entry->wheel = this;
+    // The wheel holds a reference to its pending timers
+    entry->Ref();
+    Insert(GetPointer(entry));
+    m_nTimers++;
+    m_nScheduled++;
+    if (entry->ts < m_eventTs)
+    {
+        Arm();
+    }
+    return WheelEventId(entry);
+}
+
+void
+TimerWheel::Cancel(Entry* entry)
+{
+    NS_LOG_FUNCTION(this << entry);
+    NS_ASSERT(entry->wheel == this);
+    Unlink(entry);
+    entry->event = nullptr;
+    entry->Unref();
+    m_nTimers--;
+    m_nCancelled++;
+    // The event of the wheel is left in place, unless no timer is left
+    if (m_nTimers == 0 && m_event.IsPending())
+    {
+        m_event.Remove();
+        m_eventTs = NO_TS;
+    }
+}
+
+uint64_t
+TimerWheel::GetNTimers() const
+{
+    return m_nTimers;
+}
+
+uint64_t
+TimerWheel::GetScheduledCount() const
+{
+    return m_nScheduled;
+}
+
+uint64_t
+TimerWheel::GetCancelledCount() const
+{
+    return m_nCancelled;
+}
+
+uint64_t
+TimerWheel::GetTickCount() const
+{
+    return m_nTicks;
+}
+
+void
+TimerWheel::Insert(Entry* entry)
+{
+    auto tick = static_cast<uint64_t>(entry->ts / m_granularity);
+    NS_ASSERT(tick >= m_tick);
+    // The level is given by the highest bit which differs from the current tick
+    uint64_t diff = tick ^ m_tick;
+    uint32_t level = diff == 0 ? 0 : (std::bit_width(diff) - 1) / SLOT_BITS;
+    uint32_t slot = OVERFLOW_SLOT;
+    if (level < LEVELS)
+    {
+        uint32_t index = (tick >> (level * SLOT_BITS)) & (SLOTS - 1);
+        slot = level * SLOTS + index;
+        m_occupied[level] |= uint64_t(1) << index;
+    }
+    entry->wheel = this;
+    entry->slot = slot;
+    entry->prev = nullptr;
+    entry->next = m_slots[slot];
+    if (entry->next != nullptr)
+    {
+        entry->next->prev = entry;
+    }
+    m_slots[slot] = entry;
+}
+
+void
+TimerWheel::Unlink(Entry* entry)
+{
+    uint32_t slot = entry->slot;
+    if (entry->prev != nullptr)
+    {
+        entry->prev->next = entry->next;
+    }
+    else
+    {
+        m_slots[slot] = entry->next;
+    }
+    if (entry->next != nullptr)
+    {
+        entry->next->prev = entry->prev;
+    }
+    if (m_slots[slot] == nullptr && slot != OVERFLOW_SLOT)
+    {
+        m_occupied[slot / SLOTS] &= ~(uint64_t(1) << (slot % SLOTS));
+    }
+    entry->wheel = nullptr;
+    entry->slot = UNLINKED;
+    entry->prev = nullptr;
+    entry->next = nullptr;
+}
+
+void
+TimerWheel::Reinsert(uint32_t slot)
+{
+    Entry* entry = m_slots[slot];
+    m_slots[slot] = nullptr;
+    if (slot != OVERFLOW_SLOT)
+    {
+        m_occupied[slot / SLOTS] &= ~(uint64_t(1) << (slot % SLOTS));
+    }
+    while (entry != nullptr)
+    {
+        Entry* next = entry->next;
+        Insert(entry);
+        entry = next;
+    }
+}
+
+void
+TimerWheel::Advance(uint64_t tick)
+{
+    if (tick <= m_tick)
+    {
+        return;
+    }
+    uint64_t old = m_tick;
+    m_tick = tick;
+    // All the slots before the new tick are empty, since the event of the
+    // wheel runs at the earliest move of a timer to a lower level; only the
+    // slots of the new tick hold timers which must move down.
+    if ((old >> (LEVELS * SLOT_BITS)) != (tick >> (LEVELS * SLOT_BITS)))
+    {
+        Reinsert(OVERFLOW_SLOT);
+    }
+    for (uint32_t level = LEVELS - 1; level > 0; level--)
+    {
+        uint32_t shift = level * SLOT_BITS;
+        if ((old >> shift) != (tick >> shift))
+        {
+            Reinsert(level * SLOTS + ((tick >> shift) & (SLOTS - 1)));
+        }
+    }
+}
+
+int64_t
+TimerWheel::GetNextTs() const
+{
+    if (m_occupied[0] != 0)
+    {
+        // The timers of the first level are in the block of the current
+        // tick, so that the first non-empty slot holds the earliest timers
+        int64_t ts = NO_TS;
+        for (Entry* entry = m_slots[std::countr_zero(m_occupied[0])]; entry != nullptr;
+             entry = entry->next)
+        {
+            ts = std::min(ts, entry->ts);
+        }
+        return ts;
+    }
+    for (uint32_t level = 1; level < LEVELS; level++)
+    {
+        if (m_occupied[level] != 0)
+        {
+            uint32_t shift = (level + 1) * SLOT_BITS;
+            uint64_t tick = ((m_tick >> shift) << shift) |
+                            (uint64_t(std::countr_zero(m_occupied[level])) << (shift - SLOT_BITS));
+            return static_cast<int64_t>(tick) * m_granularity;
+        }
+    }
+    if (m_slots[OVERFLOW_SLOT] != nullptr)
+    {
+        uint32_t shift = LEVELS * SLOT_BITS;
+        uint64_t tick = ((m_tick >> shift) + 1) << shift;
+        return static_cast<int64_t>(tick) * m_granularity;
+    }
+    return NO_TS;
+}
+
+void
+TimerWheel::Arm()
+{
+    int64_t ts = GetNextTs();
+    if (ts >= m_eventTs)
+    {
+        // The event of the wheel runs early enough
+        return;
+    }
+    if (m_event.IsPending())
+    {
+        m_event.Remove();
+    }
+    m_eventTs = ts;
+    Time delay = TimeStep(ts) - Simulator::Now();
+    if (m_context == Simulator::NO_CONTEXT || m_context == Simulator::GetContext())
+    {
+        m_event = Simulator::Schedule(delay, &TimerWheel::Expire, Ptr<TimerWheel>(this));
+    }
+    else
+    {
+        // The event cannot be removed if an earlier timer is scheduled, and
+        // will then run for nothing
+        m_event = EventId();
+        Simulator::ScheduleWithContext(m_context,
+                                       delay,
+                                       &TimerWheel::Expire,
+                                       Ptr<TimerWheel>(this));
+    }
+}
+
+void
+TimerWheel::Expire()
+{
+    NS_LOG_FUNCTION(this);
+    int64_t now = Simulator::Now().GetTimeStep();
+    if (now < m_eventTs)
+    {
+        // A former event of the wheel, which could not be removed
+        return;
+    }
+    // The timers scheduled while expiring are taken into account at the end
+    m_event = EventId();
+    m_eventTs = now;
+    m_nTicks++;
+    Advance(now / m_granularity);
+
+    // The due timers are in the current slot of the first level; expiring a
+    // timer may cancel another one, or schedule one due now
+    uint32_t slot = m_tick & (SLOTS - 1);
+    while (true)
+    {
+        for (Entry* entry = m_slots[slot]; entry != nullptr; entry = entry->next)
+        {
+            if (entry->ts == now)
+            {
+                m_due.emplace_back(entry);
+            }
+        }
+        if (m_due.empty())
+        {
+            break;
+        }
+        std::sort(m_due.begin(), m_due.end(), [](const Ptr<Entry>& a, const Ptr<Entry>& b) {
+            return a->seq < b->seq;
+        });
+        for (const auto& entry : m_due)
+        {
+            if (entry->wheel != this)
+            {
+                continue;
+            }
+            Ptr<EventImpl> event = entry->event;
+            Unlink(GetPointer(entry));
+            entry->event = nullptr;
+            entry->Unref();
+            m_nTimers--;
+            event->Invoke();
+        }
+        m_due.clear();
+    }
+    m_eventTs = NO_TS;
+    Arm();
+}
+
+WheelEventId::WheelEventId()
+    : m_event(),
+      m_timer(nullptr)
+{
+}
+
+WheelEventId::WheelEventId(const EventId& id)
+    : m_event(id),
+      m_timer(nullptr)
+{
+}
+
+WheelEventId::WheelEventId(const Ptr<TimerWheel::Entry>& entry)
+    : m_event(),
+      m_timer(entry)
+{
+}
+
+void
+WheelEventId::Cancel()
+{
+    if (m_timer)
+    {
+        if (m_timer->wheel != nullptr)
+        {
+            m_timer->wheel->Cancel(GetPointer(m_timer));
+        }
+    }
+    else
+    {
+        m_event.Cancel();
+    }
+}
+
+void
+WheelEventId::Remove()
+{
+    if (m_timer)
+    {
+        Cancel();
+    }
+    else
+    {
+        m_event.Remove();
+    }
+}
+
+bool
+WheelEventId::IsExpired() const
+{
+    if (m_timer)
+    {
+        return m_timer->wheel == nullptr;
+    }
+    return m_event.IsExpired();
+}
+
+bool
+WheelEventId::IsPending() const
+{
+    return !IsExpired();
+}
+
+uint64_t
+WheelEventId::GetTs() const
+{
+    if (m_timer)
+    {
+        return m_timer->ts;
+    }
+    return m_event.GetTs();
+}
+
+Time
+WheelEventId::GetDelayLeft() const
+{
+    if (m_timer)
+    {
+        return IsExpired() ? TimeStep(0) : TimeStep(m_timer->ts) - Simulator::Now();
+    }
+    return Simulator::GetDelayLeft(m_event);
+}
+
+} // namespace ns3
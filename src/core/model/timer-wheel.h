@@ -0,0 +1,286 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include "event-id.h"
+#include "make-event.h"
+#include "nstime.h"
+#include "ptr.h"
+#include "simple-ref-count.h"
+
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup timer
+ * ns3::TimerWheel and ns3::WheelEventId declarations.
+ */
+
+namespace ns3
+{
+
+class WheelEventId;
+
+/**
+ * \ingroup timer
+ * \brief A hierarchical timing wheel, to run many timers which are often
+ * cancelled or rescheduled.
+ *
+ * Protocol timers, such as the TCP retransmission timer, are mostly
+ * rescheduled before they expire.  Scheduled as simulator events, every
+ * reschedule leaves a cancelled event in the event list until its time is
+ * reached, so that the event list holds many more dead events than live
+ * ones.  The timers of a TimerWheel are instead held in the slots of the
+ * wheel: scheduling a timer links it in a slot, and cancelling it unlinks
+ * it, both in constant time, so that cancelled timers do not take any room.
+ *
+ * The wheel has 8 levels of 64 slots.  A slot of the first level spans one
+ * tick of the wheel granularity, and a slot of every other level spans the
+ * 64 slots of the level below.  A timer is held in the lowest level whose
+ * slots do not cover the current tick, and moves to the lower levels as
+ * time passes; the timers more than 2^48 ticks away are held in an overflow
+ * list.
+ *
+ * The wheel schedules a single simulator event, at the expiration time of
+ * its earliest timer, or at the time its earliest timer moves to a lower
+ * level.  This event is left in place when the earliest timer is cancelled
+ * or rescheduled later, and does nothing but schedule the next one if no
+ * timer is due when it runs.  The timers expire at their exact time, in the
+ * order they were scheduled; they run within the event of the wheel, so
+ * that the order of a timer and of a simulator event with the same time
+ * stamp is unspecified.
+ *
+ * Wheels are normally shared by all the timers of a context, i.e., of a
+ * node, with GetWheel(): the wheel runs its timers in its context.  The
+ * wheel of a context is created on first use and released by
+ * Simulator::Destroy().
+ */
+class TimerWheel : public SimpleRefCount<TimerWheel>
+{
+  public:
+    /**
+     * Create a TimerWheel.
+     *
+     * \param [in] context The context in which the timers run; by default,
+     * the current context whenever the wheel schedules its event.
+     * \param [in] granularity The span of the slots of the first level.
+     */
+    TimerWheel(uint32_t context = 0xffffffff, Time granularity = MicroSeconds(1));
+    ~TimerWheel();
+
+    // Delete copy constructor and assignment operator to avoid misuse
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    /**
+     * \param [in] context The context
+     * \returns The wheel shared by the timers of the context.
+     */
+    static Ptr<TimerWheel> GetWheel(uint32_t context);
+
+    /**
+     * Schedule a timer to expire after \pname{delay}.
+     *
+     * \tparam FUNC \deduced The type of the function or member function.
+     * \tparam Ts \deduced Argument types.
+     * \param [in] delay The relative expiration time of the timer.
+     * \param [in] f The function or member function to invoke.
+     * \param [in] args Arguments to pass to the invoked function.
+     * \returns The id of the timer.
+     */
+    template <typename FUNC, typename... Ts>
+    WheelEventId Schedule(const Time& delay, FUNC f, Ts&&... args);
+
+    /**
+     * Schedule a timer to expire after \pname{delay}.
+     *
+     * \tparam Us \deduced Formal function argument types.
+     * \tparam Ts \deduced Actual function argument types.
+     * \param [in] delay The relative expiration time of the timer.
+     * \param [in] f The function to invoke.
+     * \param [in] args Arguments to pass to the invoked function.
+     * \returns The id of the timer.
+     */
+    template <typename... Us, typename... Ts>
+    WheelEventId Schedule(const Time& delay, void (*f)(Us...), Ts&&... args);
+
+    /**
+     * Schedule a timer to expire after \pname{delay}.
+     *
+     * \param [in] delay The relative expiration time of the timer.
+     * \param [in] event The event to invoke.
+     * \returns The id of the timer.
+     */
+    WheelEventId Schedule(const Time& delay, const Ptr<EventImpl>& event);
+
+    /** \returns The number of pending timers. */
+    uint64_t GetNTimers() const;
+    /** \returns The number of timers scheduled so far. */
+    uint64_t GetScheduledCount() const;
+    /** \returns The number of timers cancelled before they expired. */
+    uint64_t GetCancelledCount() const;
+    /** \returns The number of simulator events run by the wheel. */
+    uint64_t GetTickCount() const;
+
+    /** A timer, linked in a slot of its wheel while pending. */
+    struct Entry : public SimpleRefCount<Entry>
+    {
+        Ptr<EventImpl> event; //!< The event to invoke
+        int64_t ts;           //!< The expiration time stamp
+        uint64_t seq;         //!< The scheduling order
+        TimerWheel* wheel;    //!< The wheel, or null once expired or cancelled
+        uint32_t slot;        //!< The slot which holds the timer
+        Entry* prev;          //!< The previous timer of the slot
+        Entry* next;          //!< The next timer of the slot
+    };
+
+    /**
+     * Cancel a pending timer.
+     *
+     * \param [in] entry The timer.
+     */
+    void Cancel(Entry* entry);
+
+  private:
+    /** Number of levels. */
+    static constexpr uint32_t LEVELS = 8;
+    /** Number of bits of the slot index. */
+    static constexpr uint32_t SLOT_BITS = 6;
+    /** Number of slots per level. */
+    static constexpr uint32_t SLOTS = 1 << SLOT_BITS;
+    /** The slot of the overflow list. */
+    static constexpr uint32_t OVERFLOW_SLOT = LEVELS * SLOTS;
+
+    /**
+     * Schedule a timer.
+     *
+     * \param [in] delay The relative expiration time of the timer.
+     * \param [in] event The event to invoke.
+     * \returns The id of the timer.
+     */
+    WheelEventId DoSchedule(const Time& delay, EventImpl* event);
+    /**
+     * Link a timer in its slot, relative to the current tick.
+     *
+     * \param [in] entry The timer.
+     */
+    void Insert(Entry* entry);
+    /**
+     * Unlink a timer from its slot.
+     *
+     * \param [in] entry The timer.
+     */
+    void Unlink(Entry* entry);
+    /**
+     * Unlink all the timers of a slot and link them again.
+     *
+     * \param [in] slot The slot.
+     */
+    void Reinsert(uint32_t slot);
+    /**
+     * Move the current tick forward, and the timers to their new levels.
+     *
+     * \param [in] tick The new current tick.
+     */
+    void Advance(uint64_t tick);
+    /**
+     * \returns The time stamp of the earliest timer, or of the earliest
+     * move of a timer to a lower level.
+     */
+    int64_t GetNextTs() const;
+    /** Schedule the event of the wheel at the next time stamp, if needed. */
+    void Arm();
+    /** Expire the due timers. */
+    void Expire();
+    /** Release the wheels of the contexts. */
+    static void DestroyWheels();
+
+    uint32_t m_context;                //!< The context of the timers
+    int64_t m_granularity;             //!< The span of a tick, in time steps
+    uint64_t m_tick;                   //!< The current tick
+    Entry* m_slots[OVERFLOW_SLOT + 1]; //!< The first timer of every slot
+    uint64_t m_occupied[LEVELS];       //!< The non-empty slots of every level
+    uint64_t m_seq;                    //!< The next scheduling order
+    EventId m_event;                   //!< The event of the wheel
+    int64_t m_eventTs;                 //!< The time stamp of the event of the wheel
+    std::vector<Ptr<Entry>> m_due;     //!< The timers being expired
+    uint64_t m_nTimers;                //!< The number of pending timers
+    uint64_t m_nScheduled;             //!< The number of timers scheduled
+    uint64_t m_nCancelled;             //!< The number of timers cancelled
+    uint64_t m_nTicks;                 //!< The number of events run
+};
+
+/**
+ * \ingroup timer
+ * \brief An identifier for a timer of a TimerWheel, or for a simulator
+ * event.
+ *
+ * WheelEventId offers the same methods as EventId, and can be assigned an
+ * EventId, so that the same variable can hold a timer scheduled on a
+ * TimerWheel or with Simulator::Schedule().  Cancelling or removing a timer
+ * of a wheel unlinks it from the wheel.
+ */
+class WheelEventId
+{
+  public:
+    /** Default constructor. This WheelEventId does nothing. */
+    WheelEventId();
+    /**
+     * Construct from a simulator event.
+     *
+     * \param [in] id The event.
+     */
+    WheelEventId(const EventId& id);
+    /**
+     * Construct from a timer of a wheel.
+     *
+     * \param [in] entry The timer.
+     */
+    WheelEventId(const Ptr<TimerWheel::Entry>& entry);
+
+    /** Cancel the timer or the event. */
+    void Cancel();
+    /** Cancel the timer, or remove the event from the event list. */
+    void Remove();
+    /** \returns \c true if the timer or event has expired or was cancelled. */
+    bool IsExpired() const;
+    /** \returns \c true if the timer or event is pending. */
+    bool IsPending() const;
+    /** \returns The virtual time stamp. */
+    uint64_t GetTs() const;
+    /**
+     * \returns The time left until the timer or event expires, or zero if
+     * it has expired.
+     */
+    Time GetDelayLeft() const;
+
+  private:
+    EventId m_event;                //!< The simulator event
+    Ptr<TimerWheel::Entry> m_timer; //!< The timer, if scheduled on a wheel
+};
+
+/*************************************************
+ **  Inline implementations
+ ************************************************/
+
+template <typename FUNC, typename... Ts>
+WheelEventId
+TimerWheel::Schedule(const Time& delay, FUNC f, Ts&&... args)
+{
+    return DoSchedule(delay, MakeEvent(f, std::forward<Ts>(args)...));
+}
+
+template <typename... Us, typename... Ts>
+WheelEventId
+TimerWheel::Schedule(const Time& delay, void (*f)(Us...), Ts&&... args)
+{
+    return DoSchedule(delay, MakeEvent(f, std::forward<Ts>(args)...));
+}
+
+} // namespace ns3
+
+#endif /* TIMER_WHEEL_H */
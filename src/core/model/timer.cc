@@ -82,7 +82,7 @@ Timer::GetDelayLeft() const
     switch (GetState())
     {
     case Timer::RUNNING:
-        return Simulator::GetDelayLeft(m_event);
+        return m_event.GetDelayLeft();
     case Timer::EXPIRED:
         return TimeStep(0);
     case Timer::SUSPENDED:
@@ -163,7 +163,27 @@ Timer::Schedule(Time delay)
     {
         NS_FATAL_ERROR("Event is still running while re-scheduling.");
     }
-    m_event = m_impl->Schedule(delay);
+    DoSchedule(delay);
+}
+
+void
+Timer::SetTimerWheel(Ptr<TimerWheel> wheel)
+{
+    NS_LOG_FUNCTION(this << wheel);
+    m_wheel = wheel;
+}
+
+void
+Timer::DoSchedule(const Time& delay)
+{
+    if (m_wheel)
+    {
+        m_event = m_wheel->Schedule(delay, &internal::TimerImpl::Invoke, m_impl);
+    }
+    else
+    {
+        m_event = m_impl->Schedule(delay);
+    }
 }
 
 void
@@ -171,7 +191,7 @@ Timer::Suspend()
 {
     NS_LOG_FUNCTION(this);
     NS_ASSERT(IsRunning());
-    m_delayLeft = Simulator::GetDelayLeft(m_event);
+    m_delayLeft = m_event.GetDelayLeft();
     if (m_flags & CANCEL_ON_DESTROY)
     {
         m_event.Cancel();
@@ -188,7 +208,7 @@ Timer::Resume()
 {
     NS_LOG_FUNCTION(this);
     NS_ASSERT(m_flags & TIMER_SUSPENDED);
-    m_event = m_impl->Schedule(m_delayLeft);
+    DoSchedule(m_delayLeft);
     m_flags &= ~TIMER_SUSPENDED;
 }
 
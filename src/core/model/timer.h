@@ -11,6 +11,7 @@
 #include "event-id.h"
 #include "fatal-error.h"
 #include "nstime.h"
+#include "timer-wheel.h"
 
 /**
  * \file
@@ -205,6 +206,15 @@ class Timer
      */
     void Schedule(Time delay);
 
+    /**
+     * \param [in] wheel the wheel, or null
+     *
+     * Schedule the next events on this TimerWheel rather than with the
+     * Simulator, to cancel them in constant time.  The event currently
+     * running, if any, is not moved.
+     */
+    void SetTimerWheel(Ptr<TimerWheel> wheel);
+
     /**
      * Pause the timer and save the amount of time left until it was
      * set to expire.
@@ -229,6 +239,13 @@ class Timer
     /** Internal bit marking the suspended timer state */
     static constexpr auto TIMER_SUSPENDED{1 << 7};
 
+    /**
+     * Schedule the event of the timer, on the wheel if set.
+     *
+     * \param [in] delay the delay to use
+     */
+    void DoSchedule(const Time& delay);
+
     /**
      * Bitfield for Timer State, DestroyPolicy and InternalSuspended.
      *
@@ -242,7 +259,9 @@ class Timer
     /** The delay configured for this Timer. */
     Time m_delay;
     /** The future event scheduled to expire the timer. */
-    EventId m_event;
+    WheelEventId m_event;
+    /** The wheel on which the events are scheduled, if any. */
+    Ptr<TimerWheel> m_wheel;
     /**
      * The timer implementation, which contains the bound callback
      * function and arguments.
@@ -0,0 +1,392 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "ns3/config.h"
+#include "ns3/multithreaded-simulator-impl.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/test.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \file
+ * \ingroup multithreaded-simulator-tests
+ * Multithreaded simulator test suite
+ */
+
+/**
+ * \ingroup core-tests
+ * \defgroup multithreaded-simulator-tests Multithreaded simulator tests
+ */
+
+/**
+ * \ingroup multithreaded-simulator-tests
+ *
+ * \brief Check that the MultithreadedSimulatorImpl runs the same events as
+ * the DefaultSimulatorImpl.
+ *
+ * Tokens travel around a ring of contexts, with a hop delay of at least the
+ * lookahead, and every context schedules local events in between.  The
+ * contexts are spread over the partitions round-robin, so every hop
+ * crosses partitions.
+ */
+class MultithreadedSimulatorTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     *
+     * \param partitions The number of partitions.
+     * \param stop The simulation stop time, or zero to run out of events.
+     */
+    MultithreadedSimulatorTestCase(uint32_t partitions, Time stop);
+
+  private:
+    void DoRun() override;
+    void DoTeardown() override;
+
+    /** The events run by a context: time stamp and token. */
+    typedef std::vector<std::pair<int64_t, uint32_t>> Log;
+
+    /**
+     * Run the ring.
+     * \param [in] simulatorType The simulator implementation.
+     * \returns The events run by every context.
+     */
+    std::vector<Log> RunRing(const std::string& simulatorType);
+    /**
+     * Receive a token.
+     * \param [in] context The context.
+     * \param [in] token The token.
+     * \param [in] hops The number of hops left.
+     */
+    void Receive(uint32_t context, uint32_t token, uint32_t hops);
+    /**
+     * Local event.
+     * \param [in] context The context.
+     * \param [in] token The token which scheduled it.
+     */
+    void Tick(uint32_t context, uint32_t token);
+
+    uint32_t m_partitions;  //!< Number of partitions
+    Time m_stop;            //!< Stop time
+    std::vector<Log> m_log; //!< Events run by every context
+};
+
+/// Number of contexts of the ring.
+constexpr uint32_t N_CONTEXTS = 12;
+/// Number of hops of every token.
+constexpr uint32_t N_HOPS = 200;
+
+MultithreadedSimulatorTestCase::MultithreadedSimulatorTestCase(uint32_t partitions, Time stop)
+    : TestCase("Ring of " + std::to_string(N_CONTEXTS) + " contexts over " +
+               std::to_string(partitions) + " partitions, stop at " +
+               std::to_string(stop.GetNanoSeconds()) + "ns"),
+      m_partitions(partitions),
+      m_stop(stop)
+{
+}
+
+void
+MultithreadedSimulatorTestCase::Receive(uint32_t context, uint32_t token, uint32_t hops)
+{
+    // Each context is only written by the thread of its partition, and the
+    // test macros are not thread-safe, so wrong contexts are logged instead
+    int64_t now = Simulator::GetContext() == context ? Simulator::Now().GetNanoSeconds() : -1;
+    m_log[context].emplace_back(now, token);
+    Simulator::Schedule(NanoSeconds(1 + (token * 7 + context) % 900),
+                        &MultithreadedSimulatorTestCase::Tick,
+                        this,
+                        context,
+                        token);
+    if (hops > 0)
+    {
+        uint32_t next = (context + 1) % N_CONTEXTS;
+        Simulator::ScheduleWithContext(next,
+                                       MicroSeconds(1) + NanoSeconds((token * 13) % 500),
+                                       &MultithreadedSimulatorTestCase::Receive,
+                                       this,
+                                       next,
+                                       token,
+                                       hops - 1);
+    }
+}
+
+void
+MultithreadedSimulatorTestCase::Tick(uint32_t context, uint32_t token)
+{
+    int64_t now = Simulator::GetContext() == context ? Simulator::Now().GetNanoSeconds() : -1;
+    m_log[context].emplace_back(now, token + 1000);
+}
+
+std::vector<MultithreadedSimulatorTestCase::Log>
+MultithreadedSimulatorTestCase::RunRing(const std::string& simulatorType)
+{
+    Config::SetGlobal("SimulatorImplementationType", StringValue(simulatorType));
+    m_log.assign(N_CONTEXTS, Log());
+
+    Ptr<MultithreadedSimulatorImpl> impl =
+        DynamicCast<MultithreadedSimulatorImpl>(Simulator::GetImplementation());
+    if (impl)
+    {
+        for (uint32_t context = 0; context < N_CONTEXTS; context++)
+        {
+            impl->SetPartition(context, context % m_partitions);
+        }
+        impl->SetLookahead(MicroSeconds(1));
+        NS_TEST_EXPECT_MSG_EQ(impl->GetNPartitions(), m_partitions, "Wrong number of partitions");
+    }
+
+    for (uint32_t token = 0; token < 3 * N_CONTEXTS; token++)
+    {
+        uint32_t context = token % N_CONTEXTS;
+        Simulator::ScheduleWithContext(context,
+                                       NanoSeconds(token * 100),
+                                       &MultithreadedSimulatorTestCase::Receive,
+                                       this,
+                                       context,
+                                       token,
+                                       N_HOPS);
+    }
+    if (!m_stop.IsZero())
+    {
+        Simulator::Stop(m_stop);
+    }
+    Simulator::Run();
+    Simulator::Destroy();
+
+    std::vector<Log> log;
+    std::swap(log, m_log);
+    return log;
+}
+
+void
+MultithreadedSimulatorTestCase::DoRun()
+{
+    std::vector<Log> expected = RunRing("ns3::DefaultSimulatorImpl");
+    std::vector<Log> log = RunRing("ns3::MultithreadedSimulatorImpl");
+    std::vector<Log> again = RunRing("ns3::MultithreadedSimulatorImpl");
+
+    for (uint32_t context = 0; context < N_CONTEXTS; context++)
+    {
+        NS_TEST_EXPECT_MSG_EQ((log[context] == again[context]),
+                              true,
+                              "The runs of context " << context << " are not reproducible");
+
+        // Simultaneous events may run in another order, and the other
+        // partitions run the events simultaneous with the stop event
+        auto filter = [this](Log l) {
+            if (!m_stop.IsZero())
+            {
+                int64_t stop = m_stop.GetNanoSeconds();
+                l.erase(std::remove_if(l.begin(),
+                                       l.end(),
+                                       [stop](const auto& e) { return e.first >= stop; }),
+                        l.end());
+            }
+            std::sort(l.begin(), l.end());
+            return l;
+        };
+        NS_TEST_EXPECT_MSG_EQ(log[context].empty(), false, "No events in context " << context);
+        NS_TEST_EXPECT_MSG_EQ((filter(log[context]) == filter(expected[context])),
+                              true,
+                              "Context " << context << " ran other events");
+        if (!m_stop.IsZero())
+        {
+            NS_TEST_EXPECT_MSG_LT_OR_EQ(log[context].back().first,
+                                        m_stop.GetNanoSeconds(),
+                                        "Context " << context << " ran past the stop");
+        }
+    }
+}
+
+void
+MultithreadedSimulatorTestCase::DoTeardown()
+{
+    Config::SetGlobal("SimulatorImplementationType", StringValue("ns3::DefaultSimulatorImpl"));
+}
+
+/**
+ * \ingroup multithreaded-simulator-tests
+ *
+ * \brief Check the time seen by the main thread between two runs.
+ *
+ * Of two partitions, only the second one has events, so the first one
+ * stays at time zero.  After the run, the main thread must see the time
+ * reached by the second one, and schedule its events after it.
+ */
+class MultithreadedSimulatorMainThreadTestCase : public TestCase
+{
+  public:
+    MultithreadedSimulatorMainThreadTestCase();
+
+  private:
+    void DoRun() override;
+    void DoTeardown() override;
+
+    /** Record the time of an event. */
+    void Record();
+
+    std::vector<Time> m_times; //!< Times of the events
+};
+
+MultithreadedSimulatorMainThreadTestCase::MultithreadedSimulatorMainThreadTestCase()
+    : TestCase("Main thread schedules after the latest partition")
+{
+}
+
+void
+MultithreadedSimulatorMainThreadTestCase::Record()
+{
+    m_times.push_back(Simulator::Now());
+}
+
+void
+MultithreadedSimulatorMainThreadTestCase::DoRun()
+{
+    Config::SetGlobal("SimulatorImplementationType",
+                      StringValue("ns3::MultithreadedSimulatorImpl"));
+    Ptr<MultithreadedSimulatorImpl> impl =
+        DynamicCast<MultithreadedSimulatorImpl>(Simulator::GetImplementation());
+    impl->SetPartition(1, 1);
+    impl->SetLookahead(MicroSeconds(1));
+
+    Simulator::ScheduleWithContext(1,
+                                   MicroSeconds(10),
+                                   &MultithreadedSimulatorMainThreadTestCase::Record,
+                                   this);
+    Simulator::Run();
+    NS_TEST_EXPECT_MSG_EQ(Simulator::Now(), MicroSeconds(10), "Wrong time after the run");
+
+    Simulator::Schedule(MicroSeconds(1), &MultithreadedSimulatorMainThreadTestCase::Record, this);
+    Simulator::ScheduleWithContext(1,
+                                   MicroSeconds(2),
+                                   &MultithreadedSimulatorMainThreadTestCase::Record,
+                                   this);
+    Simulator::Run();
+    Simulator::Destroy();
+
+    NS_TEST_ASSERT_MSG_EQ(m_times.size(), 3, "Wrong number of events");
+    NS_TEST_EXPECT_MSG_EQ(m_times[1], MicroSeconds(11), "Wrong time of the Schedule event");
+    NS_TEST_EXPECT_MSG_EQ(m_times[2],
+                          MicroSeconds(12),
+                          "Wrong time of the ScheduleWithContext event");
+}
+
+void
+MultithreadedSimulatorMainThreadTestCase::DoTeardown()
+{
+    Config::SetGlobal("SimulatorImplementationType", StringValue("ns3::DefaultSimulatorImpl"));
+}
+
+/**
+ * \ingroup multithreaded-simulator-tests
+ *
+ * \brief Check that the pending events survive a change of partitions.
+ *
+ * The events of two contexts, scheduled in two partitions, are merged into
+ * one partition before the first run, which stops half-way, and into the
+ * other one before the second run.  The merged events must keep unique
+ * keys, and run in the order they were scheduled.
+ */
+class MultithreadedSimulatorRepartitionTestCase : public TestCase
+{
+  public:
+    MultithreadedSimulatorRepartitionTestCase();
+
+  private:
+    void DoRun() override;
+    void DoTeardown() override;
+
+    /** Record the time and context of an event. */
+    void Record();
+
+    std::vector<std::pair<Time, uint32_t>> m_events; //!< Times and contexts of the events
+};
+
+MultithreadedSimulatorRepartitionTestCase::MultithreadedSimulatorRepartitionTestCase()
+    : TestCase("Pending events moved between partitions")
+{
+}
+
+void
+MultithreadedSimulatorRepartitionTestCase::Record()
+{
+    m_events.emplace_back(Simulator::Now(), Simulator::GetContext());
+}
+
+void
+MultithreadedSimulatorRepartitionTestCase::DoRun()
+{
+    Config::SetGlobal("SimulatorImplementationType",
+                      StringValue("ns3::MultithreadedSimulatorImpl"));
+    Ptr<MultithreadedSimulatorImpl> impl =
+        DynamicCast<MultithreadedSimulatorImpl>(Simulator::GetImplementation());
+    impl->SetPartition(2, 1);
+    impl->SetLookahead(MicroSeconds(1));
+
+    std::vector<std::pair<Time, uint32_t>> expected;
+    for (uint32_t i = 0; i < 5; i++)
+    {
+        for (uint32_t context : {1, 2})
+        {
+            Simulator::ScheduleWithContext(context,
+                                           MicroSeconds(10 + i),
+                                           &MultithreadedSimulatorRepartitionTestCase::Record,
+                                           this);
+            expected.emplace_back(MicroSeconds(10 + i), context);
+        }
+    }
+
+    impl->SetPartition(2, 0);
+    Simulator::Stop(MicroSeconds(12));
+    Simulator::Run();
+    NS_TEST_EXPECT_MSG_EQ(m_events.size(), 6, "Wrong number of events before the stop");
+
+    impl->SetPartition(1, 1);
+    impl->SetPartition(2, 1);
+    Simulator::Run();
+    Simulator::Destroy();
+
+    NS_TEST_EXPECT_MSG_EQ((m_events == expected), true, "Events lost or run out of order");
+}
+
+void
+MultithreadedSimulatorRepartitionTestCase::DoTeardown()
+{
+    Config::SetGlobal("SimulatorImplementationType", StringValue("ns3::DefaultSimulatorImpl"));
+}
+
+/**
+ * \ingroup multithreaded-simulator-tests
+ *
+ * \brief The multithreaded simulator Test Suite.
+ */
+class MultithreadedSimulatorTestSuite : public TestSuite
+{
+  public:
+    MultithreadedSimulatorTestSuite()
+        : TestSuite("multithreaded-simulator")
+    {
+        // Without the thread-safe core, the partitions run one after the
+        // other in the main thread
+        for (uint32_t partitions : {1, 2, 4})
+        {
+            AddTestCase(new MultithreadedSimulatorTestCase(partitions, Time(0)),
+                        TestCase::Duration::QUICK);
+            AddTestCase(new MultithreadedSimulatorTestCase(partitions, MicroSeconds(57)),
+                        TestCase::Duration::QUICK);
+        }
+        AddTestCase(new MultithreadedSimulatorMainThreadTestCase, TestCase::Duration::QUICK);
+        AddTestCase(new MultithreadedSimulatorRepartitionTestCase, TestCase::Duration::QUICK);
+    }
+};
+
+/// Static variable for test initialization.
+static MultithreadedSimulatorTestSuite g_multithreadedSimulatorTestSuite;
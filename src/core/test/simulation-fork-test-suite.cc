@@ -0,0 +1,114 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "ns3/nstime.h"
+#include "ns3/simulation-fork.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include <string>
+
+/**
+ * \file
+ * \ingroup simulation-fork-tests
+ * SimulationFork test suite
+ */
+
+/**
+ * \ingroup core-tests
+ * \defgroup simulation-fork-tests SimulationFork tests
+ */
+
+using namespace ns3;
+
+/**
+ * \ingroup simulation-fork-tests
+ *
+ * \brief Check that the children continue the warm-up of the parent with
+ * their own parameters, and that the parent collects their results.
+ */
+class SimulationForkTestCase : public TestCase
+{
+  public:
+    SimulationForkTestCase();
+
+  private:
+    void DoRun() override;
+
+    /** Add the step to the counter every millisecond. */
+    void Tick();
+
+    uint64_t m_count; //!< The counter
+    uint64_t m_step;  //!< The increment of the counter
+};
+
+SimulationForkTestCase::SimulationForkTestCase()
+    : TestCase("Check that forked children continue the warm-up and report their results")
+{
+}
+
+void
+SimulationForkTestCase::Tick()
+{
+    m_count += m_step;
+    Simulator::Schedule(MilliSeconds(1), &SimulationForkTestCase::Tick, this);
+}
+
+void
+SimulationForkTestCase::DoRun()
+{
+    m_count = 0;
+    m_step = 1;
+    Simulator::Schedule(MicroSeconds(500), &SimulationForkTestCase::Tick, this);
+
+    SimulationFork fork;
+    fork.SetMaxChildren(2);
+    uint32_t child = fork.ForkAt(MilliSeconds(10), 5);
+    if (fork.IsChild())
+    {
+        // The checks of the test case run in the parent
+        m_step = child + 1;
+        Simulator::Stop(MilliSeconds(10));
+        Simulator::Run();
+        fork.Exit(std::to_string(m_count) + " " +
+                  std::to_string(Simulator::Now().GetMilliSeconds()));
+    }
+
+    NS_TEST_ASSERT_MSG_EQ(child, SimulationFork::PARENT, "ForkAt() returned a child index");
+    NS_TEST_EXPECT_MSG_EQ(Simulator::Now(),
+                          MilliSeconds(10),
+                          "The parent did not stop at the fork");
+    NS_TEST_EXPECT_MSG_EQ(m_count, 10, "The warm-up did not run once");
+    const auto& results = fork.GetResults();
+    NS_TEST_ASSERT_MSG_EQ(results.size(), 5, "Wrong number of results");
+    for (uint32_t i = 0; i < results.size(); i++)
+    {
+        std::string expected = std::to_string(10 + 10 * (i + 1)) + " 20";
+        NS_TEST_EXPECT_MSG_EQ(results[i], expected, "Wrong result of child " << i);
+    }
+
+    // The parent can go on from the fork time as well
+    Simulator::Stop(MilliSeconds(5));
+    Simulator::Run();
+    NS_TEST_EXPECT_MSG_EQ(m_count, 15, "The parent did not continue the warm-up");
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup simulation-fork-tests
+ *
+ * \brief The SimulationFork Test Suite.
+ */
+class SimulationForkTestSuite : public TestSuite
+{
+  public:
+    SimulationForkTestSuite()
+        : TestSuite("simulation-fork", Type::UNIT)
+    {
+        AddTestCase(new SimulationForkTestCase());
+    }
+};
+
+/// Static variable for test initialization.
+static SimulationForkTestSuite g_simulationForkTestSuite;
@@ -7,12 +7,18 @@
  */
 #include "ns3/calendar-scheduler.h"
 #include "ns3/heap-scheduler.h"
+#include "ns3/ladder-scheduler.h"
 #include "ns3/list-scheduler.h"
+#include "ns3/make-event.h"
 #include "ns3/map-scheduler.h"
 #include "ns3/priority-queue-scheduler.h"
+#include "ns3/random-variable-stream.h"
 #include "ns3/simulator.h"
 #include "ns3/test.h"
 
+#include <string>
+#include <vector>
+
 using namespace ns3;
 
 /**
@@ -696,6 +702,132 @@ SimulatorTemplateTestCase::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check the LadderScheduler against the MapScheduler.
+ *
+ * Both schedulers go through the same random sequence of insertions,
+ * removals of the next event and removals of arbitrary events, and must
+ * agree on every next event.  Thousands of pending events make the
+ * ladder spawn rungs; the time stamps are either heavy with ties, which
+ * crowd the bottom, or bursty, which crowd single buckets.
+ */
+class LadderSchedulerRandomTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     * \param bursty Whether the time stamps are bursty, rather than tied.
+     */
+    LadderSchedulerRandomTestCase(bool bursty);
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Draw the delay of a new event.
+     * \returns The delay, in time stamp units.
+     */
+    uint64_t NextDelay();
+
+    bool m_bursty;                     //!< Whether the time stamps are bursty
+    Ptr<UniformRandomVariable> m_rand; //!< Source of the operations and delays
+};
+
+LadderSchedulerRandomTestCase::LadderSchedulerRandomTestCase(bool bursty)
+    : TestCase(std::string("Ladder scheduler matches the map scheduler, ") +
+               (bursty ? "bursty" : "tied") + " time stamps"),
+      m_bursty(bursty)
+{
+}
+
+uint64_t
+LadderSchedulerRandomTestCase::NextDelay()
+{
+    if (!m_bursty)
+    {
+        // A handful of distinct time stamps, each shared by many events
+        return m_rand->GetInteger(0, 3) * 1000;
+    }
+    // Most events within a few units, a few far away
+    return m_rand->GetValue() < 0.99 ? m_rand->GetInteger(0, 10)
+                                     : m_rand->GetInteger(0, 1000000);
+}
+
+void
+LadderSchedulerRandomTestCase::DoRun()
+{
+    m_rand = CreateObject<UniformRandomVariable>();
+    m_rand->SetStream(m_bursty ? 1 : 2);
+
+    Ptr<Scheduler> ladder = CreateObject<LadderScheduler>();
+    Ptr<Scheduler> map = CreateObject<MapScheduler>();
+    // The schedulers never run the events, so they can all share one
+    Ptr<EventImpl> impl(MakeEvent([]() {}), false);
+    std::vector<Scheduler::Event> pending;
+    uint64_t now = 0;
+    uint32_t uid = 0;
+
+    for (uint32_t i = 0; i < 40000; i++)
+    {
+        // Build up a large population first, then drain it
+        double insertProbability = i < 20000 ? 0.7 : 0.3;
+        double draw = m_rand->GetValue();
+        if (pending.empty() || draw < insertProbability)
+        {
+            Scheduler::Event ev;
+            ev.impl = PeekPointer(impl);
+            ev.key.m_ts = now + NextDelay();
+            ev.key.m_uid = uid++;
+            ev.key.m_context = 0;
+            ladder->Insert(ev);
+            map->Insert(ev);
+            pending.push_back(ev);
+        }
+        else if (draw < insertProbability + 0.2)
+        {
+            // Remove an arbitrary pending event, wherever it sits in the ladder
+            uint32_t index = m_rand->GetInteger(0, pending.size() - 1);
+            ladder->Remove(pending[index]);
+            map->Remove(pending[index]);
+            pending[index] = pending.back();
+            pending.pop_back();
+        }
+        else
+        {
+            NS_TEST_ASSERT_MSG_EQ(ladder->PeekNext().key.m_uid,
+                                  map->PeekNext().key.m_uid,
+                                  "Different next events at operation " << i);
+            Scheduler::Event next = ladder->RemoveNext();
+            Scheduler::Event expected = map->RemoveNext();
+            NS_TEST_ASSERT_MSG_EQ(next.key.m_uid,
+                                  expected.key.m_uid,
+                                  "Different removed events at operation " << i);
+            NS_TEST_ASSERT_MSG_EQ(next.key.m_ts, expected.key.m_ts, "Different time stamps");
+            now = next.key.m_ts;
+            for (auto& ev : pending)
+            {
+                if (ev.key.m_uid == next.key.m_uid)
+                {
+                    ev = pending.back();
+                    pending.pop_back();
+                    break;
+                }
+            }
+        }
+        NS_TEST_ASSERT_MSG_EQ(ladder->IsEmpty(), pending.empty(), "Wrong emptiness");
+    }
+
+    while (!map->IsEmpty())
+    {
+        NS_TEST_ASSERT_MSG_EQ(ladder->RemoveNext().key.m_uid,
+                              map->RemoveNext().key.m_uid,
+                              "Different events while draining");
+    }
+    NS_TEST_ASSERT_MSG_EQ(ladder->IsEmpty(), true, "Ladder not empty after the map");
+}
+
 /**
  * \ingroup simulator-tests
  *
@@ -719,6 +851,10 @@ class SimulatorTestSuite : public TestSuite
         AddTestCase(new SimulatorEventsTestCase(factory), TestCase::Duration::QUICK);
         factory.SetTypeId(PriorityQueueScheduler::GetTypeId());
         AddTestCase(new SimulatorEventsTestCase(factory), TestCase::Duration::QUICK);
+        factory.SetTypeId(LadderScheduler::GetTypeId());
+        AddTestCase(new SimulatorEventsTestCase(factory), TestCase::Duration::QUICK);
+        AddTestCase(new LadderSchedulerRandomTestCase(false), TestCase::Duration::QUICK);
+        AddTestCase(new LadderSchedulerRandomTestCase(true), TestCase::Duration::QUICK);
     }
 };
 
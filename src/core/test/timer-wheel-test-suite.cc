@@ -0,0 +1,361 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "ns3/nstime.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+#include "ns3/timer-wheel.h"
+#include "ns3/timer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup timer-wheel-tests
+ * TimerWheel test suite
+ */
+
+/**
+ * \ingroup core-tests
+ * \defgroup timer-wheel-tests TimerWheel tests
+ */
+
+using namespace ns3;
+
+/**
+ * \ingroup timer-wheel-tests
+ *
+ * \brief Check that the timers of a TimerWheel expire at their exact time,
+ * in the order they were scheduled, unless cancelled.
+ *
+ * The timers span all the levels of the wheel and its overflow list, and
+ * the expiring timers schedule and cancel other timers.
+ */
+class TimerWheelExpireTestCase : public TestCase
+{
+  public:
+    TimerWheelExpireTestCase();
+
+  private:
+    void DoRun() override;
+
+    /** A timer of the test. */
+    struct TestTimer
+    {
+        WheelEventId id; //!< The id of the timer
+        Time expected;   //!< The expected expiration time
+        uint64_t order;  //!< The scheduling order
+        bool cancelled;  //!< Whether the timer was cancelled
+        bool expired;    //!< Whether the timer expired
+    };
+
+    /**
+     * Schedule a timer.
+     * \param [in] delay The delay of the timer.
+     */
+    void Add(Time delay);
+    /**
+     * Expire a timer.
+     * \param [in] index The index of the timer.
+     */
+    void Expire(uint32_t index);
+
+    Ptr<TimerWheel> m_wheel;             //!< The wheel
+    std::vector<TestTimer> m_timers;     //!< The timers
+    Ptr<UniformRandomVariable> m_random; //!< Random delays and cancellations
+    uint64_t m_order;                    //!< The next scheduling order
+    Time m_lastTime;                     //!< The time of the last expired timer
+    uint64_t m_lastOrder;                //!< The order of the last expired timer
+};
+
+TimerWheelExpireTestCase::TimerWheelExpireTestCase()
+    : TestCase("Check that the timers expire at their time, in order, unless cancelled")
+{
+}
+
+void
+TimerWheelExpireTestCase::Add(Time delay)
+{
+    auto index = static_cast<uint32_t>(m_timers.size());
+    m_timers.push_back({WheelEventId(), Simulator::Now() + delay, m_order++, false, false});
+    m_timers.back().id = m_wheel->Schedule(delay, &TimerWheelExpireTestCase::Expire, this, index);
+}
+
+void
+TimerWheelExpireTestCase::Expire(uint32_t index)
+{
+    TestTimer& timer = m_timers[index];
+    NS_TEST_EXPECT_MSG_EQ(timer.cancelled, false, "Cancelled timer " << index << " expired");
+    NS_TEST_EXPECT_MSG_EQ(timer.expired, false, "Timer " << index << " expired twice");
+    NS_TEST_EXPECT_MSG_EQ(Simulator::Now(), timer.expected, "Timer " << index << " expired late");
+    NS_TEST_EXPECT_MSG_EQ(timer.id.IsExpired(), true, "Timer " << index << " still pending");
+    if (Simulator::Now() == m_lastTime)
+    {
+        NS_TEST_EXPECT_MSG_GT(timer.order, m_lastOrder, "Timer " << index << " out of order");
+    }
+    m_lastTime = Simulator::Now();
+    m_lastOrder = timer.order;
+    timer.expired = true;
+
+    if (m_timers.size() < 4000)
+    {
+        // Schedule a timer, sometimes due now or at the same time as another
+        double draw = m_random->GetValue();
+        if (draw < 0.1)
+        {
+            Add(Time(0));
+        }
+        else if (draw < 0.2)
+        {
+            Add(NanoSeconds(1000 * m_random->GetInteger(1, 5)));
+        }
+        else
+        {
+            Add(NanoSeconds(m_random->GetInteger(1, 1000000)));
+        }
+    }
+    // Cancel a pending timer
+    auto other = static_cast<uint32_t>(m_random->GetInteger(0, m_timers.size() - 1));
+    if (!m_timers[other].expired && !m_timers[other].cancelled && m_random->GetValue() < 0.3)
+    {
+        m_timers[other].id.Cancel();
+        m_timers[other].cancelled = true;
+        NS_TEST_EXPECT_MSG_EQ(m_timers[other].id.IsPending(), false, "Timer not cancelled");
+    }
+}
+
+void
+TimerWheelExpireTestCase::DoRun()
+{
+    RngSeedManager::SetSeed(1);
+    RngSeedManager::SetRun(1);
+    m_random = CreateObject<UniformRandomVariable>();
+    m_wheel = Create<TimerWheel>(Simulator::NO_CONTEXT, NanoSeconds(1));
+    m_order = 0;
+    m_lastTime = Time(-1);
+    m_lastOrder = 0;
+
+    // Delays up to 2^(6 * k) ticks, for every level, and in the overflow list
+    for (uint32_t level = 0; level <= 8; level++)
+    {
+        for (uint32_t i = 0; i < 50; i++)
+        {
+            double range = std::pow(64.0, level + 1);
+            Add(NanoSeconds(static_cast<int64_t>(m_random->GetValue(0, range))));
+        }
+    }
+    for (uint32_t i = 0; i < 100; i++)
+    {
+        auto index = static_cast<uint32_t>(m_random->GetInteger(0, m_timers.size() - 1));
+        if (!m_timers[index].cancelled)
+        {
+            m_timers[index].id.Cancel();
+            m_timers[index].cancelled = true;
+        }
+    }
+    Simulator::Run();
+
+    uint32_t expired = 0;
+    for (uint32_t i = 0; i < m_timers.size(); i++)
+    {
+        NS_TEST_EXPECT_MSG_EQ(m_timers[i].expired || m_timers[i].cancelled,
+                              true,
+                              "Timer " << i << " did not expire");
+        expired += m_timers[i].expired;
+    }
+    NS_TEST_EXPECT_MSG_GT(expired, 3000, "Too few timers expired");
+    NS_TEST_EXPECT_MSG_EQ(m_wheel->GetNTimers(), 0, "Timers left in the wheel");
+    NS_TEST_EXPECT_MSG_EQ(m_wheel->GetScheduledCount(),
+                          m_wheel->GetCancelledCount() + expired,
+                          "Wrong timer counts");
+    Simulator::Destroy();
+    m_wheel = nullptr;
+    m_timers.clear();
+}
+
+/**
+ * \ingroup timer-wheel-tests
+ *
+ * \brief Check that the rescheduled timers of a wheel do not leave
+ * cancelled events in the event list.
+ */
+class TimerWheelRescheduleTestCase : public TestCase
+{
+  public:
+    TimerWheelRescheduleTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Reschedule all the timers.
+     * \param [in] round The number of rounds left.
+     */
+    void Reschedule(uint32_t round);
+    /** Count an expired timer. */
+    void Expire();
+
+    bool m_useWheel;                 //!< Whether to schedule the timers on the wheel
+    Ptr<TimerWheel> m_wheel;         //!< The wheel
+    std::vector<WheelEventId> m_ids; //!< The timers
+    uint64_t m_peakEvents;           //!< The peak number of events in the event list
+    uint32_t m_expired;              //!< The number of expired timers
+};
+
+TimerWheelRescheduleTestCase::TimerWheelRescheduleTestCase()
+    : TestCase("Check that rescheduled timers do not stay in the event list")
+{
+}
+
+void
+TimerWheelRescheduleTestCase::Expire()
+{
+    m_expired++;
+}
+
+void
+TimerWheelRescheduleTestCase::Reschedule(uint32_t round)
+{
+    m_peakEvents = std::max(m_peakEvents, Simulator::GetPendingEventCount());
+    for (auto& id : m_ids)
+    {
+        id.Cancel();
+        if (m_useWheel)
+        {
+            id = m_wheel->Schedule(MilliSeconds(200), &TimerWheelRescheduleTestCase::Expire, this);
+        }
+        else
+        {
+            id = Simulator::Schedule(MilliSeconds(200),
+                                     &TimerWheelRescheduleTestCase::Expire,
+                                     this);
+        }
+    }
+    if (round > 0)
+    {
+        Simulator::Schedule(MicroSeconds(100),
+                            &TimerWheelRescheduleTestCase::Reschedule,
+                            this,
+                            round - 1);
+    }
+}
+
+void
+TimerWheelRescheduleTestCase::DoRun()
+{
+    for (bool useWheel : {false, true})
+    {
+        m_useWheel = useWheel;
+        m_wheel = Create<TimerWheel>();
+        m_ids.assign(100, WheelEventId());
+        m_peakEvents = 0;
+        m_expired = 0;
+        Simulator::ScheduleNow(&TimerWheelRescheduleTestCase::Reschedule, this, 100);
+        Simulator::Run();
+        NS_TEST_EXPECT_MSG_EQ(m_expired, 100, "Every timer expires once");
+        if (useWheel)
+        {
+            // The rescheduling event and the event of the wheel
+            NS_TEST_EXPECT_MSG_LT_OR_EQ(m_peakEvents, 2, "Cancelled timers left in the list");
+            NS_TEST_EXPECT_MSG_EQ(m_wheel->GetCancelledCount(), 100 * 100, "Wrong cancellations");
+        }
+        else
+        {
+            NS_TEST_EXPECT_MSG_EQ(m_peakEvents, 100 * 100, "Cancelled events not counted");
+        }
+        Simulator::Destroy();
+        m_ids.clear();
+        m_wheel = nullptr;
+    }
+}
+
+/**
+ * \ingroup timer-wheel-tests
+ *
+ * \brief Check a Timer whose events are scheduled on a wheel.
+ */
+class TimerWheelTimerTestCase : public TestCase
+{
+  public:
+    TimerWheelTimerTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Expire the timer.
+     * \param [in] value The argument of the timer.
+     */
+    void Expire(int value);
+
+    Time m_expiredAt; //!< The expiration time
+    int m_value;      //!< The argument of the expired timer
+};
+
+TimerWheelTimerTestCase::TimerWheelTimerTestCase()
+    : TestCase("Check a Timer scheduled on a TimerWheel")
+{
+}
+
+void
+TimerWheelTimerTestCase::Expire(int value)
+{
+    m_expiredAt = Simulator::Now();
+    m_value = value;
+}
+
+void
+TimerWheelTimerTestCase::DoRun()
+{
+    m_expiredAt = Time(0);
+    m_value = 0;
+    Timer timer(Timer::CANCEL_ON_DESTROY);
+    timer.SetTimerWheel(TimerWheel::GetWheel(3));
+    timer.SetFunction(&TimerWheelTimerTestCase::Expire, this);
+    timer.SetArguments(7);
+    timer.Schedule(MilliSeconds(10));
+    NS_TEST_EXPECT_MSG_EQ(timer.GetState(), Timer::RUNNING, "Timer not running");
+    NS_TEST_EXPECT_MSG_EQ(timer.GetDelayLeft(), MilliSeconds(10), "Wrong delay left");
+    timer.Cancel();
+    NS_TEST_EXPECT_MSG_EQ(timer.GetState(), Timer::EXPIRED, "Timer not cancelled");
+    timer.Schedule(MilliSeconds(20));
+    Simulator::Schedule(MilliSeconds(5), &Timer::Suspend, &timer);
+    Simulator::Schedule(MilliSeconds(50), &Timer::Resume, &timer);
+    Simulator::Run();
+    NS_TEST_EXPECT_MSG_EQ(m_expiredAt, MilliSeconds(65), "Wrong expiration time");
+    NS_TEST_EXPECT_MSG_EQ(m_value, 7, "Wrong argument");
+    NS_TEST_EXPECT_MSG_EQ(timer.IsExpired(), true, "Timer still running");
+    NS_TEST_EXPECT_MSG_EQ(TimerWheel::GetWheel(3)->GetScheduledCount(),
+                          3,
+                          "Wrong number of scheduled timers");
+    Simulator::Destroy();
+    NS_TEST_EXPECT_MSG_EQ(TimerWheel::GetWheel(3)->GetScheduledCount(),
+                          0,
+                          "The wheels of the contexts were not released");
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup timer-wheel-tests
+ *
+ * \brief The TimerWheel Test Suite.
+ */
+class TimerWheelTestSuite : public TestSuite
+{
+  public:
+    TimerWheelTestSuite()
+        : TestSuite("timer-wheel", Type::UNIT)
+    {
+        AddTestCase(new TimerWheelExpireTestCase());
+        AddTestCase(new TimerWheelRescheduleTestCase());
+        AddTestCase(new TimerWheelTimerTestCase());
+    }
+};
+
+/// Static variable for test initialization.
+static TimerWheelTestSuite g_timerWheelTestSuite;
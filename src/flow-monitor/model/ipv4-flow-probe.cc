@@ -17,6 +17,11 @@
 #include "ns3/node.h"
 #include "ns3/packet.h"
 #include "ns3/pointer.h"
+#include "ns3/segmentation-offload.h"
+#include "ns3/tcp-header.h"
+#include "ns3/tcp-l4-protocol.h"
+
+#include <algorithm>
 
 namespace ns3
 {
@@ -333,6 +338,14 @@ Ipv4FlowProbe::SendOutgoingLogger(const Ipv4Header& ipHeader,
 
     if (m_classifier->Classify(ipHeader, ipPayload, &flowId, &packetId))
     {
+        SegmentationOffloadTag gso;
+        if (ipPayload->PeekPacketTag(gso) && gso.GetSegments() > 1 &&
+            ipHeader.GetProtocol() == TcpL4Protocol::PROT_NUMBER)
+        {
+            ReportSegmentsFirstTx(ipHeader, ipPayload, gso, flowId, packetId);
+            return;
+        }
+
         uint32_t size = (ipPayload->GetSize() + ipHeader.GetSerializedSize());
         NS_LOG_DEBUG("ReportFirstTx (" << this << ", " << flowId << ", " << packetId << ", " << size
                                        << "); " << ipHeader << *ipPayload);
@@ -349,6 +362,41 @@ Ipv4FlowProbe::SendOutgoingLogger(const Ipv4Header& ipHeader,
     }
 }
 
+void
+Ipv4FlowProbe::ReportSegmentsFirstTx(const Ipv4Header& ipHeader,
+                                     Ptr<const Packet> ipPayload,
+                                     const SegmentationOffloadTag& gso,
+                                     FlowId flowId,
+                                     FlowPacketId packetId)
+{
+    // The super-segment is split further down, and every segment keeps the
+    // byte tags of its own bytes only: each segment is counted as the packet
+    // it is on the wire
+    TcpHeader tcpHeader;
+    ipPayload->PeekHeader(tcpHeader);
+    uint32_t headerSize = tcpHeader.GetSerializedSize();
+    uint32_t dataSize = ipPayload->GetSize() - headerSize;
+    for (uint32_t offset = 0; offset < dataSize; offset += gso.GetSegmentSize())
+    {
+        if (offset > 0)
+        {
+            m_classifier->Classify(ipHeader, ipPayload, &flowId, &packetId);
+        }
+        uint32_t length = std::min<uint32_t>(gso.GetSegmentSize(), dataSize - offset);
+        uint32_t size = ipHeader.GetSerializedSize() + headerSize + length;
+        NS_LOG_DEBUG("ReportFirstTx (" << this << ", " << flowId << ", " << packetId << ", " << size
+                                       << "); segment at " << offset << " of " << ipHeader);
+        m_flowMonitor->ReportFirstTx(this, flowId, packetId, size);
+
+        Ipv4FlowProbeTag fTag(flowId,
+                              packetId,
+                              size,
+                              ipHeader.GetSource(),
+                              ipHeader.GetDestination());
+        ipPayload->AddByteTag(fTag, headerSize + offset, headerSize + offset + length);
+    }
+}
+
 void
 Ipv4FlowProbe::ForwardLogger(const Ipv4Header& ipHeader,
                              Ptr<const Packet> ipPayload,
@@ -485,43 +533,46 @@ Ipv4FlowProbe::DropLogger(const Ipv4Header& ipHeader,
 void
 Ipv4FlowProbe::QueueDropLogger(Ptr<const Packet> ipPayload)
 {
-    Ipv4FlowProbeTag fTag;
-    bool tagFound = ipPayload->FindFirstMatchingByteTag(fTag);
-
-    if (!tagFound)
-    {
-        return;
-    }
-
-    FlowId flowId = fTag.GetFlowId();
-    FlowPacketId packetId = fTag.GetPacketId();
-    uint32_t size = fTag.GetPacketSize();
-
-    NS_LOG_DEBUG("Drop (" << this << ", " << flowId << ", " << packetId << ", " << size << ", "
-                          << DROP_QUEUE << "); ");
-
-    m_flowMonitor->ReportDrop(this, flowId, packetId, size, DROP_QUEUE);
+    ReportQueueDrop(ipPayload, DROP_QUEUE);
 }
 
 void
 Ipv4FlowProbe::QueueDiscDropLogger(Ptr<const QueueDiscItem> item)
 {
-    Ipv4FlowProbeTag fTag;
-    bool tagFound = item->GetPacket()->FindFirstMatchingByteTag(fTag);
+    ReportQueueDrop(item->GetPacket(), DROP_QUEUE_DISC);
+}
+
+void
+Ipv4FlowProbe::ReportQueueDrop(Ptr<const Packet> packet, DropReason reason)
+{
+    // A super-segment carries one tag per segment, see ReportSegmentsFirstTx
+    SegmentationOffloadTag gso;
+    bool superSegment = packet->PeekPacketTag(gso);
 
-    if (!tagFound)
+    ByteTagIterator it = packet->GetByteTagIterator();
+    while (it.HasNext())
     {
-        return;
-    }
+        ByteTagIterator::Item item = it.Next();
+        if (item.GetTypeId() != Ipv4FlowProbeTag::GetTypeId())
+        {
+            continue;
+        }
+        Ipv4FlowProbeTag fTag;
+        item.GetTag(fTag);
 
-    FlowId flowId = fTag.GetFlowId();
-    FlowPacketId packetId = fTag.GetPacketId();
-    uint32_t size = fTag.GetPacketSize();
+        FlowId flowId = fTag.GetFlowId();
+        FlowPacketId packetId = fTag.GetPacketId();
+        uint32_t size = fTag.GetPacketSize();
 
-    NS_LOG_DEBUG("Drop (" << this << ", " << flowId << ", " << packetId << ", " << size << ", "
-                          << DROP_QUEUE_DISC << "); ");
+        NS_LOG_DEBUG("Drop (" << this << ", " << flowId << ", " << packetId << ", " << size << ", "
+                              << reason << "); ");
 
-    m_flowMonitor->ReportDrop(this, flowId, packetId, size, DROP_QUEUE_DISC);
+        m_flowMonitor->ReportDrop(this, flowId, packetId, size, reason);
+        if (!superSegment)
+        {
+            return;
+        }
+    }
 }
 
 } // namespace ns3
@@ -20,6 +20,7 @@ namespace ns3
 
 class FlowMonitor;
 class Node;
+class SegmentationOffloadTag;
 
 /// \ingroup flow-monitor
 /// \brief Class that monitors flows at the IPv4 layer of a Node
@@ -110,6 +111,23 @@ class Ipv4FlowProbe : public FlowProbe
     /// Log a packet being dropped by a queue disc
     /// \param item queue disc item
     void QueueDiscDropLogger(Ptr<const QueueDiscItem> item);
+    /// Report the first transmission of the segments of a super-segment,
+    /// and tag the bytes of every segment with its own packet id
+    /// \param ipHeader IP header
+    /// \param ipPayload IP payload
+    /// \param gso segmentation offload tag of the packet
+    /// \param flowId flow id of the packet
+    /// \param packetId packet id of the first segment
+    void ReportSegmentsFirstTx(const Ipv4Header& ipHeader,
+                               Ptr<const Packet> ipPayload,
+                               const SegmentationOffloadTag& gso,
+                               FlowId flowId,
+                               FlowPacketId packetId);
+    /// Report a packet dropped by a queue, or all the segments of a
+    /// super-segment
+    /// \param packet the dropped packet
+    /// \param reason drop reason
+    void ReportQueueDrop(Ptr<const Packet> packet, DropReason reason);
 
     Ptr<Ipv4FlowClassifier> m_classifier; //!< the Ipv4FlowClassifier this probe is associated with
     Ptr<Ipv4L3Protocol> m_ipv4;           //!< the Ipv4L3Protocol this probe is bound to
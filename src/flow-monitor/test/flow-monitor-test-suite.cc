@@ -0,0 +1,194 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "ns3/flow-monitor-helper.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-flow-classifier.h"
+#include "ns3/node-container.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/socket.h"
+#include "ns3/string.h"
+#include "ns3/tcp-socket-factory.h"
+#include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <string>
+
+using namespace ns3;
+
+/**
+ * \ingroup flow-monitor
+ * \defgroup flow-monitor-test FlowMonitor module tests
+ */
+
+/**
+ * \ingroup flow-monitor-test
+ *
+ * \brief Check the statistics of a TCP transfer which uses segmentation
+ * offload (TSO).
+ *
+ * The super-segments handed down by TCP are split into segments before
+ * they reach the wire: the FlowMonitor must count every segment, both when
+ * it is sent and when it is received.
+ */
+class FlowMonitorSegmentationOffloadTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor.
+     * \param tsoMaxSegments The TsoMaxSegments of the sender.
+     */
+    FlowMonitorSegmentationOffloadTestCase(uint32_t tsoMaxSegments);
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Send the data, as the send buffer of the socket allows.
+     * \param socket The socket.
+     * \param available Unused in the test.
+     */
+    void Send(Ptr<Socket> socket, uint32_t available);
+    /**
+     * \brief Drain the data received by an accepted socket.
+     * \param socket The socket.
+     * \param from The address of the sender.
+     */
+    void Accept(Ptr<Socket> socket, const Address& from);
+    /**
+     * \brief Drain the data received by a socket.
+     * \param socket The socket.
+     */
+    void Receive(Ptr<Socket> socket);
+
+    uint32_t m_tsoMaxSegments; //!< TsoMaxSegments of the sender
+    uint32_t m_sent{0};        //!< Bytes sent
+};
+
+/// Bytes sent by the test connection
+static const uint32_t FLOW_MONITOR_TEST_BYTES = 200000;
+/// Segment size of the test connection
+static const uint32_t FLOW_MONITOR_TEST_SEGMENT_SIZE = 1000;
+
+FlowMonitorSegmentationOffloadTestCase::FlowMonitorSegmentationOffloadTestCase(
+    uint32_t tsoMaxSegments)
+    : TestCase("FlowMonitor statistics of a TCP transfer with TsoMaxSegments=" +
+               std::to_string(tsoMaxSegments)),
+      m_tsoMaxSegments(tsoMaxSegments)
+{
+}
+
+void
+FlowMonitorSegmentationOffloadTestCase::Send(Ptr<Socket> socket, uint32_t available)
+{
+    while (socket->GetTxAvailable() > 0 && m_sent < FLOW_MONITOR_TEST_BYTES)
+    {
+        uint32_t size = std::min(FLOW_MONITOR_TEST_BYTES - m_sent, socket->GetTxAvailable());
+        int sent = socket->Send(Create<Packet>(size));
+        NS_TEST_EXPECT_MSG_NE(sent, -1, "Error during send");
+        m_sent += sent;
+    }
+    if (m_sent == FLOW_MONITOR_TEST_BYTES)
+    {
+        socket->Close();
+    }
+}
+
+void
+FlowMonitorSegmentationOffloadTestCase::Accept(Ptr<Socket> socket, const Address& from)
+{
+    socket->SetRecvCallback(MakeCallback(&FlowMonitorSegmentationOffloadTestCase::Receive, this));
+}
+
+void
+FlowMonitorSegmentationOffloadTestCase::Receive(Ptr<Socket> socket)
+{
+    while (socket->Recv())
+    {
+    }
+}
+
+void
+FlowMonitorSegmentationOffloadTestCase::DoRun()
+{
+    NodeContainer nodes;
+    nodes.Create(2);
+    InternetStackHelper internet;
+    internet.Install(nodes);
+    SimpleNetDeviceHelper devHelper;
+    devHelper.SetDeviceAttribute("DataRate", StringValue("1Gbps"));
+    devHelper.SetChannelAttribute("Delay", StringValue("20us"));
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.0.0.0", "255.255.255.0");
+    ipv4.Assign(devHelper.Install(nodes));
+
+    FlowMonitorHelper flowMonitorHelper;
+    Ptr<FlowMonitor> monitor = flowMonitorHelper.InstallAll();
+
+    uint16_t port = 50000;
+    Ptr<Socket> sink = nodes.Get(1)->GetObject<TcpSocketFactory>()->CreateSocket();
+    sink->SetAttribute("SegmentSize", UintegerValue(FLOW_MONITOR_TEST_SEGMENT_SIZE));
+    sink->Bind(InetSocketAddress(Ipv4Address::GetAny(), port));
+    sink->Listen();
+    sink->SetAcceptCallback(
+        MakeNullCallback<bool, Ptr<Socket>, const Address&>(),
+        MakeCallback(&FlowMonitorSegmentationOffloadTestCase::Accept, this));
+
+    Ptr<Socket> source = nodes.Get(0)->GetObject<TcpSocketFactory>()->CreateSocket();
+    source->SetAttribute("SegmentSize", UintegerValue(FLOW_MONITOR_TEST_SEGMENT_SIZE));
+    source->SetAttribute("TsoMaxSegments", UintegerValue(m_tsoMaxSegments));
+    source->SetSendCallback(MakeCallback(&FlowMonitorSegmentationOffloadTestCase::Send, this));
+    source->Connect(InetSocketAddress(Ipv4Address("10.0.0.2"), port));
+
+    Simulator::Stop(Seconds(10));
+    Simulator::Run();
+
+    monitor->CheckForLostPackets();
+    auto classifier = DynamicCast<Ipv4FlowClassifier>(flowMonitorHelper.GetClassifier());
+    bool found = false;
+    for (const auto& [flowId, stats] : monitor->GetFlowStats())
+    {
+        if (classifier->FindFlow(flowId).sourceAddress != Ipv4Address("10.0.0.1"))
+        {
+            continue;
+        }
+        found = true;
+        NS_TEST_EXPECT_MSG_GT_OR_EQ(stats.txPackets,
+                                    FLOW_MONITOR_TEST_BYTES / FLOW_MONITOR_TEST_SEGMENT_SIZE,
+                                    "A super-segment was counted as one packet");
+        NS_TEST_EXPECT_MSG_EQ(stats.rxPackets,
+                              stats.txPackets,
+                              "Segments not counted on receipt");
+        NS_TEST_EXPECT_MSG_EQ(stats.rxBytes, stats.txBytes, "Bytes not counted on receipt");
+        NS_TEST_EXPECT_MSG_EQ(stats.lostPackets, 0, "Segments counted as lost");
+    }
+    NS_TEST_EXPECT_MSG_EQ(found, true, "No statistics for the data flow");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup flow-monitor-test
+ *
+ * \brief FlowMonitor TestSuite
+ */
+class FlowMonitorTestSuite : public TestSuite
+{
+  public:
+    FlowMonitorTestSuite();
+};
+
+FlowMonitorTestSuite::FlowMonitorTestSuite()
+    : TestSuite("flow-monitor", Type::UNIT)
+{
+    AddTestCase(new FlowMonitorSegmentationOffloadTestCase(1), TestCase::Duration::QUICK);
+    AddTestCase(new FlowMonitorSegmentationOffloadTestCase(16), TestCase::Duration::QUICK);
+}
+
+/// Static variable for test initialization
+static FlowMonitorTestSuite g_flowMonitorTestSuite;
@@ -76,6 +76,9 @@ class Ipv4GlobalRoutingHelper : public Ipv4RoutingHelper
      * Users must first call PopulateRoutingTables() and then may subsequently
      * call RecomputeRoutingTables() at any later time in the simulation.
      *
+     * If the GlobalRoutingIncremental global value is set, only the routes
+     * of the routers affected by the topology changes are recomputed (see
+     * GlobalRouteManager::UpdateRoutes()).
      */
     static void RecomputeRoutingTables();
 };
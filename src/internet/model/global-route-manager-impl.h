@@ -19,7 +19,9 @@
 #include <list>
 #include <map>
 #include <queue>
+#include <set>
 #include <stdint.h>
+#include <utility>
 #include <vector>
 
 namespace ns3
@@ -28,6 +30,7 @@ namespace ns3
 const uint32_t SPF_INFINITY = 0xffffffff; //!< "infinite" distance between nodes
 
 class CandidateQueue;
+class Ipv4;
 class Ipv4GlobalRouting;
 
 /**
@@ -628,6 +631,46 @@ class GlobalRouteManagerLSDB
      */
     GlobalRoutingLSA* GetLSAByLinkData(Ipv4Address addr) const;
 
+    /**
+     * @brief Make a deep copy of the Link State Database.
+     *
+     * The SPF calculation marks the LSAs it explores, so the routers can only
+     * be processed concurrently if each thread uses its own copy.
+     *
+     * @returns a new database holding a copy of every LSA, to be deleted by
+     * the caller
+     */
+    GlobalRouteManagerLSDB* Copy() const;
+
+    /**
+     * @brief Compare the (non external) Link State Advertisements of two
+     * databases.
+     *
+     * @param other the database to compare with
+     * @returns the link state IDs of the LSAs whose contents differ, or that
+     * are only present in one of the databases
+     */
+    std::set<Ipv4Address> GetChangedLSAs(const GlobalRouteManagerLSDB& other) const;
+
+    /**
+     * @brief Compare the External Link State Advertisements of two databases.
+     *
+     * @param other the database to compare with
+     * @returns true if both databases hold the same External LSAs
+     */
+    bool HasSameExtLSAs(const GlobalRouteManagerLSDB& other) const;
+
+    /**
+     * @brief Get the links of the graph described by the database.
+     *
+     * Every point-to-point or transit network link record of a router LSA,
+     * and every attached router of a network LSA, is appended as a pair of
+     * link state IDs.
+     *
+     * @param links the container the links are appended to
+     */
+    void GetLinks(std::vector<std::pair<Ipv4Address, Ipv4Address>>& links) const;
+
     /**
      * @brief Set all LSA flags to an initialized state, for SPF computation
      *
@@ -668,6 +711,7 @@ class GlobalRouteManagerLSDB
         LSDBPair_t; //!< pair of IPv4 addresses / Link State Advertisements
 
     LSDBMap_t m_database; //!< database of IPv4 addresses / Link State Advertisements
+    LSDBMap_t m_transits; //!< LSAs indexed by the link data of their transit network links
     std::vector<GlobalRoutingLSA*>
         m_extdatabase; //!< database of External Link State Advertisements
 };
@@ -714,6 +758,22 @@ class GlobalRouteManagerImpl
      */
     virtual void InitializeRoutes();
 
+    /**
+     * @brief Recompute the routes after a topology change.
+     *
+     * Unless the GlobalRoutingIncremental global value is set, this is
+     * equivalent to DeleteGlobalRoutes, BuildGlobalRoutingDatabase and
+     * InitializeRoutes.  Otherwise, the routing database is rebuilt and
+     * compared with the previous one, and only the routers affected by the
+     * changed Link State Advertisements are recomputed:
+     *  - a router with a single point-to-point link (see CheckForStubNode), if
+     *    its own LSA or the LSA of its neighbor changed;
+     *  - any other router, if a changed LSA is connected to it.
+     *
+     * All the routes are recomputed if an External LSA changed.
+     */
+    virtual void UpdateRoutes();
+
     /**
      * @brief Debugging routine; allow client code to supply a pre-built LSDB
      * @param lsdb the pre-built LSDB
@@ -727,9 +787,76 @@ class GlobalRouteManagerImpl
     void DebugSPFCalculate(Ipv4Address root);
 
   private:
+    /// A router for which the routes are computed
+    struct SPFRoot
+    {
+        Ipv4Address routerId;           //!< router ID
+        uint32_t nodeId;                //!< ID of the node
+        Ptr<Ipv4> ipv4;                 //!< Ipv4 of the node
+        Ptr<Ipv4GlobalRouting> routing; //!< routing protocol the routes are written to
+    };
+
     SPFVertex* m_spfroot;           //!< the root node
     GlobalRouteManagerLSDB* m_lsdb; //!< the Link State DataBase (LSDB) of the Global Route Manager
 
+    Ptr<Ipv4> m_spfrootIpv4;                 //!< Ipv4 of the root node, if known
+    Ptr<Ipv4GlobalRouting> m_spfrootRouting; //!< routing protocol of the root node, if known
+    uint32_t m_spfrootNodeId;                //!< ID of the root node
+    bool m_routesInstalled;                  //!< true if the routes of m_lsdb are installed
+
+    /**
+     * \brief Get the routers of the local system taking part in the routing.
+     *
+     * \returns the routers, in node order
+     */
+    std::vector<SPFRoot> GetSPFRoots() const;
+
+    /**
+     * \brief Find a router from its router ID.
+     *
+     * \param routerId the router ID
+     * \returns the router; its Ipv4 and routing protocol are null if it is not
+     * found
+     */
+    SPFRoot FindSPFRoot(Ipv4Address routerId) const;
+
+    /**
+     * \brief Run the SPF calculation for a set of routers.
+     *
+     * The routers are spread over the number of threads set by the
+     * GlobalRoutingThreads global value.  Each thread works on its own copy of
+     * the LSDB and only writes to the routing tables of its routers.  The
+     * calculation runs serially if any log component is enabled.
+     *
+     * \param roots the routers
+     */
+    void SPFCalculate(const std::vector<SPFRoot>& roots);
+
+    /**
+     * \brief Calculate the shortest path first (SPF) tree of a router
+     *
+     * Equivalent to quagga ospf_spf_calculate
+     * \param root the root router
+     */
+    void SPFCalculate(const SPFRoot& root);
+
+    /**
+     * \brief Get the routers affected by a change of the LSDB.
+     *
+     * \param oldLsdb the LSDB the current routes were computed from
+     * \param roots the routers of the current LSDB
+     * \returns the routers whose routes must be recomputed
+     */
+    std::vector<SPFRoot> GetAffectedSPFRoots(const GlobalRouteManagerLSDB& oldLsdb,
+                                             const std::vector<SPFRoot>& roots) const;
+
+    /**
+     * \brief Delete all the routes of a routing protocol
+     *
+     * \param gr the routing protocol
+     */
+    static void DeleteRoutes(Ptr<Ipv4GlobalRouting> gr);
+
     /**
      * \brief Test if a node is a stub, from an OSPF sense.
      *
@@ -742,14 +869,6 @@ class GlobalRouteManagerImpl
      */
     bool CheckForStubNode(Ipv4Address root);
 
-    /**
-     * \brief Calculate the shortest path first (SPF) tree
-     *
-     * Equivalent to quagga ospf_spf_calculate
-     * \param root the root node
-     */
-    void SPFCalculate(Ipv4Address root);
-
     /**
      * \brief Process Stub nodes
      *
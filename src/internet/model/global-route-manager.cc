@@ -46,6 +46,13 @@ GlobalRouteManager::InitializeRoutes()
     SimulationSingleton<GlobalRouteManagerImpl>::Get()->InitializeRoutes();
 }
 
+void
+GlobalRouteManager::UpdateRoutes()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    SimulationSingleton<GlobalRouteManagerImpl>::Get()->UpdateRoutes();
+}
+
 uint32_t
 GlobalRouteManager::AllocateRouterId()
 {
@@ -59,6 +59,17 @@ class GlobalRouteManager
      * per-node forwarding tables
      */
     static void InitializeRoutes();
+
+    /**
+     * @brief Recompute the routes after a topology change.
+     *
+     * By default, all the routes are deleted, the routing database is rebuilt
+     * and the SPF computation is run again for every router.  If the
+     * GlobalRoutingIncremental global value is set, the new routing database is
+     * compared with the previous one and only the routers whose routes may
+     * depend on a changed Link State Advertisement are recomputed.
+     */
+    static void UpdateRoutes();
 };
 
 } // namespace ns3
@@ -13,6 +13,8 @@
 
 #include "ns3/log.h"
 
+#include <algorithm>
+
 namespace ns3
 {
 
@@ -35,26 +37,25 @@ Ipv4EndPointDemux::~Ipv4EndPointDemux()
         delete endPoint;
     }
     m_endPoints.clear();
+    m_index.clear();
+    m_localPorts.clear();
 }
 
 bool
 Ipv4EndPointDemux::LookupPortLocal(uint16_t port)
 {
     NS_LOG_FUNCTION(this << port);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
-    {
-        if ((*i)->GetLocalPort() == port)
-        {
-            return true;
-        }
-    }
-    return false;
+    return m_localPorts.find(port) != m_localPorts.end();
 }
 
 bool
 Ipv4EndPointDemux::LookupLocal(Ptr<NetDevice> boundNetDevice, Ipv4Address addr, uint16_t port)
 {
     NS_LOG_FUNCTION(this << addr << port);
+    if (!LookupPortLocal(port))
+    {
+        return false;
+    }
     for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
     {
         if ((*i)->GetLocalPort() == port && (*i)->GetLocalAddress() == addr &&
@@ -77,7 +78,7 @@ Ipv4EndPointDemux::Allocate()
         return nullptr;
     }
     auto endPoint = new Ipv4EndPoint(Ipv4Address::GetAny(), port);
-    m_endPoints.push_back(endPoint);
+    Insert(endPoint);
     NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
     return endPoint;
 }
@@ -93,7 +94,7 @@ Ipv4EndPointDemux::Allocate(Ipv4Address address)
         return nullptr;
     }
     auto endPoint = new Ipv4EndPoint(address, port);
-    m_endPoints.push_back(endPoint);
+    Insert(endPoint);
     NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
     return endPoint;
 }
@@ -116,7 +117,7 @@ Ipv4EndPointDemux::Allocate(Ptr<NetDevice> boundNetDevice, Ipv4Address address,
         return nullptr;
     }
     auto endPoint = new Ipv4EndPoint(address, port);
-    m_endPoints.push_back(endPoint);
+    Insert(endPoint);
     NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
     return endPoint;
 }
@@ -129,19 +130,22 @@ Ipv4EndPointDemux::Allocate(Ptr<NetDevice> boundNetDevice,
                             uint16_t peerPort)
 {
     NS_LOG_FUNCTION(this << localAddress << localPort << peerAddress << peerPort << boundNetDevice);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    auto bucket = m_index.find(GetKey(localPort, peerAddress, peerPort));
+    if (bucket != m_index.end())
     {
-        if ((*i)->GetLocalPort() == localPort && (*i)->GetLocalAddress() == localAddress &&
-            (*i)->GetPeerPort() == peerPort && (*i)->GetPeerAddress() == peerAddress &&
-            ((*i)->GetBoundNetDevice() == boundNetDevice || !(*i)->GetBoundNetDevice()))
+        for (auto i : bucket->second)
         {
-            NS_LOG_WARN("Duplicated endpoint.");
-            return nullptr;
+            if ((*i)->GetLocalAddress() == localAddress &&
+                ((*i)->GetBoundNetDevice() == boundNetDevice || !(*i)->GetBoundNetDevice()))
+            {
+                NS_LOG_WARN("Duplicated endpoint.");
+                return nullptr;
+            }
         }
     }
     auto endPoint = new Ipv4EndPoint(localAddress, localPort);
     endPoint->SetPeer(peerAddress, peerPort);
-    m_endPoints.push_back(endPoint);
+    Insert(endPoint);
 
     NS_LOG_DEBUG("Now have >>" << m_endPoints.size() << "<< endpoints.");
 
@@ -152,14 +156,16 @@ void
 Ipv4EndPointDemux::DeAllocate(Ipv4EndPoint* endPoint)
 {
     NS_LOG_FUNCTION(this << endPoint);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    auto i = RemoveFromIndex(endPoint);
+    if (i != m_endPoints.end())
     {
-        if (*i == endPoint)
+        auto port = m_localPorts.find(endPoint->GetLocalPort());
+        if (--port->second == 0)
         {
-            delete endPoint;
-            m_endPoints.erase(i);
-            break;
+            m_localPorts.erase(port);
         }
+        delete endPoint;
+        m_endPoints.erase(i);
     }
 }
 
@@ -200,131 +206,151 @@ Ipv4EndPointDemux::Lookup(Ipv4Address daddr,
     EndPoints retval4; // Exact match on all 4
 
     NS_LOG_DEBUG("Looking up endpoint for destination address " << daddr << ":" << dport);
-    for (auto i = m_endPoints.begin(); i != m_endPoints.end(); i++)
+    // Only the end points whose peer address and port are either those of
+    // the packet or wildcards can match
+    const uint64_t keys[] = {GetKey(dport, saddr, sport),
+                             GetKey(dport, saddr, 0),
+                             GetKey(dport, Ipv4Address::GetAny(), sport),
+                             GetKey(dport, Ipv4Address::GetAny(), 0)};
+    for (std::size_t k = 0; k < 4; k++)
     {
-        Ipv4EndPoint* endP = *i;
-
-        NS_LOG_DEBUG("Looking at endpoint dport="
-                     << endP->GetLocalPort() << " daddr=" << endP->GetLocalAddress()
-                     << " sport=" << endP->GetPeerPort() << " saddr=" << endP->GetPeerAddress());
-
-        if (!endP->IsRxEnabled())
+        if (std::find(keys, keys + k, keys[k]) != keys + k)
         {
-            NS_LOG_LOGIC("Skipping endpoint " << &endP
-                                              << " because endpoint can not receive packets");
-            continue;
+            continue; // Bucket already looked at, the packet has a wildcard
         }
-
-        if (endP->GetLocalPort() != dport)
+        auto bucket = m_index.find(keys[k]);
+        if (bucket == m_index.end())
         {
-            NS_LOG_LOGIC("Skipping endpoint " << &endP << " because endpoint dport "
-                                              << endP->GetLocalPort()
-                                              << " does not match packet dport " << dport);
             continue;
         }
-        if (endP->GetBoundNetDevice())
+        for (auto i : bucket->second)
         {
-            if (endP->GetBoundNetDevice() != incomingInterface->GetDevice())
+            Ipv4EndPoint* endP = *i;
+
+            NS_LOG_DEBUG("Looking at endpoint dport="
+                         << endP->GetLocalPort() << " daddr=" << endP->GetLocalAddress()
+                         << " sport=" << endP->GetPeerPort()
+                         << " saddr=" << endP->GetPeerAddress());
+
+            if (!endP->IsRxEnabled())
             {
-                NS_LOG_LOGIC("Skipping endpoint "
-                             << &endP << " because endpoint is bound to specific device and"
-                             << endP->GetBoundNetDevice() << " does not match packet device "
-                             << incomingInterface->GetDevice());
+                NS_LOG_LOGIC("Skipping endpoint " << &endP
+                                                  << " because endpoint can not receive packets");
                 continue;
             }
-        }
 
-        bool localAddressMatchesExact = false;
-        bool localAddressIsAny = false;
-        bool localAddressIsSubnetAny = false;
+            if (endP->GetLocalPort() != dport)
+            {
+                NS_LOG_LOGIC("Skipping endpoint " << &endP << " because endpoint dport "
+                                                  << endP->GetLocalPort()
+                                                  << " does not match packet dport " << dport);
+                continue;
+            }
+            if (endP->GetBoundNetDevice())
+            {
+                if (endP->GetBoundNetDevice() != incomingInterface->GetDevice())
+                {
+                    NS_LOG_LOGIC("Skipping endpoint "
+                                 << &endP << " because endpoint is bound to specific device and"
+                                 << endP->GetBoundNetDevice() << " does not match packet device "
+                                 << incomingInterface->GetDevice());
+                    continue;
+                }
+            }
 
-        // We have 3 cases:
-        // 1) Exact local / destination address match
-        // 2) Local endpoint bound to Any -> matches anything
-        // 3) Local endpoint bound to x.y.z.0 -> matches Subnet-directed broadcast packet (e.g.,
-        // x.y.z.255 in a /24 net) and direct destination match.
+            bool localAddressMatchesExact = false;
+            bool localAddressIsAny = false;
+            bool localAddressIsSubnetAny = false;
 
-        if (endP->GetLocalAddress() == daddr)
-        {
-            // Case 1:
-            localAddressMatchesExact = true;
-        }
-        else if (endP->GetLocalAddress() == Ipv4Address::GetAny())
-        {
-            // Case 2:
-            localAddressIsAny = true;
-        }
-        else
-        {
-            // Case 3:
-            for (uint32_t i = 0; i < incomingInterface->GetNAddresses(); i++)
-            {
-                Ipv4InterfaceAddress addr = incomingInterface->GetAddress(i);
+            // We have 3 cases:
+            // 1) Exact local / destination address match
+            // 2) Local endpoint bound to Any -> matches anything
+            // 3) Local endpoint bound to x.y.z.0 -> matches Subnet-directed broadcast packet (e.g.,
+            // x.y.z.255 in a /24 net) and direct destination match.
 
-                Ipv4Address addrNetpart = addr.GetLocal().CombineMask(addr.GetMask());
-                if (endP->GetLocalAddress() == addrNetpart)
+            if (endP->GetLocalAddress() == daddr)
+            {
+                // Case 1:
+                localAddressMatchesExact = true;
+            }
+            else if (endP->GetLocalAddress() == Ipv4Address::GetAny())
+            {
+                // Case 2:
+                localAddressIsAny = true;
+            }
+            else
+            {
+                // Case 3:
+                for (uint32_t i = 0; i < incomingInterface->GetNAddresses(); i++)
                 {
-                    NS_LOG_LOGIC("Endpoint is SubnetDirectedAny "
-                                 << endP->GetLocalAddress() << "/"
-                                 << addr.GetMask().GetPrefixLength());
+                    Ipv4InterfaceAddress addr = incomingInterface->GetAddress(i);
 
-                    Ipv4Address daddrNetPart = daddr.CombineMask(addr.GetMask());
-                    if (addrNetpart == daddrNetPart)
+                    Ipv4Address addrNetpart = addr.GetLocal().CombineMask(addr.GetMask());
+                    if (endP->GetLocalAddress() == addrNetpart)
                     {
-                        localAddressIsSubnetAny = true;
+                        NS_LOG_LOGIC("Endpoint is SubnetDirectedAny "
+                                     << endP->GetLocalAddress() << "/"
+                                     << addr.GetMask().GetPrefixLength());
+
+                        Ipv4Address daddrNetPart = daddr.CombineMask(addr.GetMask());
+                        if (addrNetpart == daddrNetPart)
+                        {
+                            localAddressIsSubnetAny = true;
+                        }
                     }
                 }
+
+                // if no match here, keep looking
+                if (!localAddressIsSubnetAny)
+                {
+                    continue;
+                }
             }
 
-            // if no match here, keep looking
-            if (!localAddressIsSubnetAny)
+            bool remotePortMatchesExact = endP->GetPeerPort() == sport;
+            bool remotePortMatchesWildCard = endP->GetPeerPort() == 0;
+            bool remoteAddressMatchesExact = endP->GetPeerAddress() == saddr;
+            bool remoteAddressMatchesWildCard = endP->GetPeerAddress() == Ipv4Address::GetAny();
+
+            // If remote does not match either with exact or wildcard,
+            // skip this one
+            if (!(remotePortMatchesExact || remotePortMatchesWildCard))
+            {
+                continue;
+            }
+            if (!(remoteAddressMatchesExact || remoteAddressMatchesWildCard))
             {
                 continue;
             }
-        }
-
-        bool remotePortMatchesExact = endP->GetPeerPort() == sport;
-        bool remotePortMatchesWildCard = endP->GetPeerPort() == 0;
-        bool remoteAddressMatchesExact = endP->GetPeerAddress() == saddr;
-        bool remoteAddressMatchesWildCard = endP->GetPeerAddress() == Ipv4Address::GetAny();
-
-        // If remote does not match either with exact or wildcard,
-        // skip this one
-        if (!(remotePortMatchesExact || remotePortMatchesWildCard))
-        {
-            continue;
-        }
-        if (!(remoteAddressMatchesExact || remoteAddressMatchesWildCard))
-        {
-            continue;
-        }
 
-        bool localAddressMatchesWildCard = localAddressIsAny || localAddressIsSubnetAny;
+            bool localAddressMatchesWildCard = localAddressIsAny || localAddressIsSubnetAny;
 
-        if (localAddressMatchesExact && remoteAddressMatchesExact && remotePortMatchesExact)
-        { // All 4 match - this is the case of an open TCP connection, for example.
-            NS_LOG_LOGIC("Found an endpoint for case 4, adding " << endP->GetLocalAddress() << ":"
-                                                                 << endP->GetLocalPort());
-            retval4.push_back(endP);
-        }
-        if (localAddressMatchesWildCard && remoteAddressMatchesExact && remotePortMatchesExact)
-        { // All but local address - no idea what this case could be.
-            NS_LOG_LOGIC("Found an endpoint for case 3, adding " << endP->GetLocalAddress() << ":"
-                                                                 << endP->GetLocalPort());
-            retval3.push_back(endP);
-        }
-        if (localAddressMatchesExact && remoteAddressMatchesWildCard && remotePortMatchesWildCard)
-        { // Only local port and local address matches exactly - Not yet opened connection
-            NS_LOG_LOGIC("Found an endpoint for case 2, adding " << endP->GetLocalAddress() << ":"
-                                                                 << endP->GetLocalPort());
-            retval2.push_back(endP);
-        }
-        if (localAddressMatchesWildCard && remoteAddressMatchesWildCard &&
-            remotePortMatchesWildCard)
-        { // Only local port matches exactly - Endpoint open to "any" connection
-            NS_LOG_LOGIC("Found an endpoint for case 1, adding " << endP->GetLocalAddress() << ":"
-                                                                 << endP->GetLocalPort());
-            retval1.push_back(endP);
+            if (localAddressMatchesExact && remoteAddressMatchesExact && remotePortMatchesExact)
+            { // All 4 match - this is the case of an open TCP connection, for example.
+                NS_LOG_LOGIC("Found an endpoint for case 4, adding "
+                             << endP->GetLocalAddress() << ":" << endP->GetLocalPort());
+                retval4.push_back(endP);
+            }
+            if (localAddressMatchesWildCard && remoteAddressMatchesExact && remotePortMatchesExact)
+            { // All but local address - no idea what this case could be.
+                NS_LOG_LOGIC("Found an endpoint for case 3, adding "
+                             << endP->GetLocalAddress() << ":" << endP->GetLocalPort());
+                retval3.push_back(endP);
+            }
+            if (localAddressMatchesExact && remoteAddressMatchesWildCard &&
+                remotePortMatchesWildCard)
+            { // Only local port and local address matches exactly - Not yet opened connection
+                NS_LOG_LOGIC("Found an endpoint for case 2, adding "
+                             << endP->GetLocalAddress() << ":" << endP->GetLocalPort());
+                retval2.push_back(endP);
+            }
+            if (localAddressMatchesWildCard && remoteAddressMatchesWildCard &&
+                remotePortMatchesWildCard)
+            { // Only local port matches exactly - Endpoint open to "any" connection
+                NS_LOG_LOGIC("Found an endpoint for case 1, adding "
+                             << endP->GetLocalAddress() << ":" << endP->GetLocalPort());
+                retval1.push_back(endP);
+            }
         }
     }
 
@@ -361,6 +387,19 @@ Ipv4EndPointDemux::SimpleLookup(Ipv4Address daddr,
 {
     NS_LOG_FUNCTION(this << daddr << dport << saddr << sport);
 
+    auto bucket = m_index.find(GetKey(dport, saddr, sport));
+    if (bucket != m_index.end())
+    {
+        for (auto i : bucket->second)
+        {
+            if ((*i)->GetLocalAddress() == daddr)
+            {
+                /* this is an exact match. */
+                return *i;
+            }
+        }
+    }
+
     // this code is a copy/paste version of an old BSD ip stack lookup
     // function.
     uint32_t genericity = 3;
@@ -418,4 +457,58 @@ Ipv4EndPointDemux::AllocateEphemeralPort()
     return port;
 }
 
+uint64_t
+Ipv4EndPointDemux::GetKey(uint16_t localPort, Ipv4Address peerAddress, uint16_t peerPort)
+{
+    return (static_cast<uint64_t>(localPort) << 48) |
+           (static_cast<uint64_t>(peerAddress.Get()) << 16) | peerPort;
+}
+
+void
+Ipv4EndPointDemux::Insert(Ipv4EndPoint* endPoint)
+{
+    NS_LOG_FUNCTION(this << endPoint);
+    auto i = m_endPoints.insert(m_endPoints.end(), endPoint);
+    uint16_t localPort = endPoint->GetLocalPort();
+    m_index[GetKey(localPort, endPoint->GetPeerAddress(), endPoint->GetPeerPort())].push_back(i);
+    m_localPorts[localPort]++;
+    endPoint->SetPeerChangeCallback(MakeCallback(&Ipv4EndPointDemux::ChangePeer, this));
+}
+
+Ipv4EndPointDemux::EndPointsI
+Ipv4EndPointDemux::RemoveFromIndex(Ipv4EndPoint* endPoint)
+{
+    NS_LOG_FUNCTION(this << endPoint);
+    auto bucket = m_index.find(
+        GetKey(endPoint->GetLocalPort(), endPoint->GetPeerAddress(), endPoint->GetPeerPort()));
+    if (bucket == m_index.end())
+    {
+        return m_endPoints.end();
+    }
+    std::vector<EndPointsI>& positions = bucket->second;
+    for (auto j = positions.begin(); j != positions.end(); j++)
+    {
+        if (**j == endPoint)
+        {
+            auto i = *j;
+            positions.erase(j);
+            if (positions.empty())
+            {
+                m_index.erase(bucket);
+            }
+            return i;
+        }
+    }
+    return m_endPoints.end();
+}
+
+void
+Ipv4EndPointDemux::ChangePeer(Ipv4EndPoint* endPoint, Ipv4Address peerAddress, uint16_t peerPort)
+{
+    NS_LOG_FUNCTION(this << endPoint << peerAddress << peerPort);
+    auto i = RemoveFromIndex(endPoint);
+    NS_ASSERT_MSG(i != m_endPoints.end(), "End point not found in the demux");
+    m_index[GetKey(endPoint->GetLocalPort(), peerAddress, peerPort)].push_back(i);
+}
+
 } // namespace ns3
@@ -15,6 +15,8 @@
 
 #include <list>
 #include <stdint.h>
+#include <unordered_map>
+#include <vector>
 
 namespace ns3
 {
@@ -31,6 +33,11 @@ class Ipv4EndPoint;
  * of endpoints, and has APIs to add and find endpoints in this demux.  This
  * code is shared in common to TCP and UDP protocols in ns3.  This demux
  * sits between ns3's layer four and the socket layer
+ *
+ * The endpoints are also indexed by hash on their local port, peer address
+ * and peer port, so that a lookup only looks at the endpoints whose peer is
+ * either the source of the packet or a wildcard, instead of at all the
+ * endpoints, e.g., all the connections accepted by a server.
  */
 
 class Ipv4EndPointDemux
@@ -166,6 +173,37 @@ class Ipv4EndPointDemux
      */
     uint16_t AllocateEphemeralPort();
 
+    /**
+     * \brief Get the key of an endpoint in the index.
+     * \param localPort local port
+     * \param peerAddress peer address
+     * \param peerPort peer port
+     * \return the key
+     */
+    static uint64_t GetKey(uint16_t localPort, Ipv4Address peerAddress, uint16_t peerPort);
+
+    /**
+     * \brief Add a new end point to the list and to the index.
+     * \param endPoint the end point
+     */
+    void Insert(Ipv4EndPoint* endPoint);
+
+    /**
+     * \brief Remove an end point from the index.
+     * \param endPoint the end point
+     * \return the position of the end point in the list, or the end of the
+     * list if it is not in this demux
+     */
+    EndPointsI RemoveFromIndex(Ipv4EndPoint* endPoint);
+
+    /**
+     * \brief Move an end point in the index, before its peer changes.
+     * \param endPoint the end point
+     * \param peerAddress new peer address
+     * \param peerPort new peer port
+     */
+    void ChangePeer(Ipv4EndPoint* endPoint, Ipv4Address peerAddress, uint16_t peerPort);
+
     /**
      * \brief The ephemeral port.
      */
@@ -185,6 +223,17 @@ class Ipv4EndPointDemux
      * \brief A list of IPv4 end points.
      */
     EndPoints m_endPoints;
+
+    /**
+     * \brief The position in the list of the end points, by their local
+     * port, peer address and peer port.
+     */
+    std::unordered_map<uint64_t, std::vector<EndPointsI>> m_index;
+
+    /**
+     * \brief The number of end points, by local port.
+     */
+    std::unordered_map<uint16_t, uint32_t> m_localPorts;
 };
 
 } // namespace ns3
@@ -37,6 +37,7 @@ Ipv4EndPoint::~Ipv4EndPoint()
     m_rxCallback.Nullify();
     m_icmpCallback.Nullify();
     m_destroyCallback.Nullify();
+    m_peerChangeCallback.Nullify();
 }
 
 Ipv4Address
@@ -78,6 +79,10 @@ void
 Ipv4EndPoint::SetPeer(Ipv4Address address, uint16_t port)
 {
     NS_LOG_FUNCTION(this << address << port);
+    if (!m_peerChangeCallback.IsNull())
+    {
+        m_peerChangeCallback(this, address, port);
+    }
     m_peerAddr = address;
     m_peerPort = port;
 }
@@ -119,6 +124,14 @@ Ipv4EndPoint::SetDestroyCallback(Callback<void> callback)
     m_destroyCallback = callback;
 }
 
+void
+Ipv4EndPoint::SetPeerChangeCallback(
+    Callback<void, Ipv4EndPoint*, Ipv4Address, uint16_t> callback)
+{
+    NS_LOG_FUNCTION(this << &callback);
+    m_peerChangeCallback = callback;
+}
+
 void
 Ipv4EndPoint::ForwardUp(Ptr<Packet> p,
                         const Ipv4Header& header,
@@ -133,6 +133,15 @@ class Ipv4EndPoint
      * \param callback callback function
      */
     void SetDestroyCallback(Callback<void> callback);
+    /**
+     * \brief Set the peer change callback.
+     *
+     * Called from the Ipv4EndPointDemux to keep its index up to date: the
+     * callback is invoked by SetPeer() before the peer changes, with the
+     * endpoint and its new peer address and port.
+     * \param callback callback function
+     */
+    void SetPeerChangeCallback(Callback<void, Ipv4EndPoint*, Ipv4Address, uint16_t> callback);
 
     /**
      * \brief Forward the packet to the upper level.
@@ -220,6 +229,11 @@ class Ipv4EndPoint
      */
     Callback<void> m_destroyCallback;
 
+    /**
+     * \brief The peer change callback.
+     */
+    Callback<void, Ipv4EndPoint*, Ipv4Address, uint16_t> m_peerChangeCallback;
+
     /**
      * \brief true if the endpoint can receive packets.
      */
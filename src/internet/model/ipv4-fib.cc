@@ -0,0 +1,64 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "ipv4-fib.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+void
+Ipv4Fib::Add(Ipv4RoutingTableEntry* route, uint32_t metric)
+{
+    Ipv4Mask mask = route->GetDestNetworkMask();
+    uint16_t length = mask.GetPrefixLength();
+    Entry entry{route, metric, m_nRoutes++};
+    if (mask.Get() != GetMask(length))
+    {
+        // Keep the list sorted by decreasing prefix length, then insertion order
+        auto it = std::find_if(m_nonContiguous.begin(), m_nonContiguous.end(), [=](const Entry& e) {
+            return e.route->GetDestNetworkMask().GetPrefixLength() < length;
+        });
+        m_nonContiguous.insert(it, entry);
+        return;
+    }
+
+    uint32_t network = route->GetDestNetwork().Get() & GetMask(length);
+    m_prefixes[length][network].push_back(entry);
+    m_prefixLengths |= uint64_t{1} << length;
+}
+
+void
+Ipv4Fib::Clear()
+{
+    for (auto& prefixes : m_prefixes)
+    {
+        prefixes.clear();
+    }
+    m_nonContiguous.clear();
+    m_prefixLengths = 0;
+    m_nRoutes = 0;
+}
+
+const Ipv4Fib::Bucket*
+Ipv4Fib::Find(Ipv4Address network, Ipv4Mask mask) const
+{
+    uint16_t prefixLength = mask.GetPrefixLength();
+    if (mask.Get() != GetMask(prefixLength))
+    {
+        return m_nonContiguous.empty() ? nullptr : &m_nonContiguous;
+    }
+    const auto& prefixes = m_prefixes[prefixLength];
+    auto it = prefixes.find(network.Get() & GetMask(prefixLength));
+    return it != prefixes.end() ? &it->second : nullptr;
+}
+
+uint32_t
+Ipv4Fib::GetN() const
+{
+    return m_nRoutes;
+}
+
+} // namespace ns3
@@ -0,0 +1,162 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef IPV4_FIB_H
+#define IPV4_FIB_H
+
+#include "ipv4-routing-table-entry.h"
+
+#include "ns3/ipv4-address.h"
+
+#include <array>
+#include <bit>
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup ipv4Routing
+ *
+ * \brief A compiled IPv4 forwarding table, for longest prefix match lookups.
+ *
+ * The routes are kept in one hash table per prefix length, keyed by the
+ * masked destination network.  A lookup probes the tables of the prefix
+ * lengths actually in use, from the longest to the shortest, so its cost
+ * depends on the number of distinct prefix lengths and not on the number of
+ * routes.
+ *
+ * The FIB does not own the routing table entries: it indexes the routes
+ * kept by a routing protocol, which must Clear and rebuild it whenever one
+ * of them is removed.  Within a prefix, routes are kept in insertion order.
+ *
+ * The routes with a non-contiguous network mask cannot be hashed: they are
+ * kept in a list, sorted by the prefix length Ipv4Mask::GetPrefixLength
+ * gives their mask, which is scanned along with the hash tables.
+ */
+class Ipv4Fib
+{
+  public:
+    /// A route of the FIB
+    struct Entry
+    {
+        Ipv4RoutingTableEntry* route; //!< Routing table entry
+        uint32_t metric;              //!< Metric of the route
+        uint32_t rank;                //!< Number of routes added before this one
+    };
+
+    /// The routes to a prefix
+    typedef std::vector<Entry> Bucket;
+
+    /**
+     * \brief Add a route to the FIB.
+     * \param route the routing table entry, which must outlive the FIB
+     * \param metric the metric of the route
+     */
+    void Add(Ipv4RoutingTableEntry* route, uint32_t metric = 0);
+
+    /**
+     * \brief Remove all the routes from the FIB.
+     */
+    void Clear();
+
+    /**
+     * \brief Get the routes to a prefix.
+     *
+     * A non-contiguous mask gets all the routes with a non-contiguous mask,
+     * which the caller has to filter.
+     *
+     * \param network network address of the prefix
+     * \param mask network mask of the prefix
+     * \return the routes to the prefix, or nullptr if there is none
+     */
+    const Bucket* Find(Ipv4Address network, Ipv4Mask mask) const;
+
+    /**
+     * \brief Visit the prefixes matching a destination, longest first.
+     *
+     * The matching routes with a non-contiguous mask are visited one at a
+     * time, with Ipv4Mask::GetPrefixLength of their mask as prefix length,
+     * after the contiguous prefixes of the same length.
+     *
+     * \param dest destination address
+     * \param visit callable invoked with the routes to every matching prefix
+     * and the length of the prefix; returning true stops the visit
+     */
+    template <class F>
+    void ForEachMatch(Ipv4Address dest, F visit) const;
+
+    /**
+     * \return the number of routes in the FIB
+     */
+    uint32_t GetN() const;
+
+  private:
+    /**
+     * \param prefixLength prefix length
+     * \return the contiguous network mask of the prefix length, in host order
+     */
+    static uint32_t GetMask(uint16_t prefixLength);
+
+    /// Routes indexed by masked network, for every prefix length
+    std::array<std::unordered_map<uint32_t, Bucket>, 33> m_prefixes;
+    Bucket m_nonContiguous;      //!< Routes with a non-contiguous network mask
+    uint64_t m_prefixLengths{0}; //!< Bit i is set if prefixes of length i are in use
+    uint32_t m_nRoutes{0};       //!< Number of routes
+};
+
+template <class F>
+void
+Ipv4Fib::ForEachMatch(Ipv4Address dest, F visit) const
+{
+    // Visit the routes with a non-contiguous mask longer than a prefix length
+    auto nonContiguous = m_nonContiguous.begin();
+    auto visitNonContiguous = [&](int32_t length) {
+        for (; nonContiguous != m_nonContiguous.end(); nonContiguous++)
+        {
+            Ipv4Mask mask = nonContiguous->route->GetDestNetworkMask();
+            uint16_t prefixLength = mask.GetPrefixLength();
+            if (prefixLength <= length)
+            {
+                return false;
+            }
+            if (mask.IsMatch(dest, nonContiguous->route->GetDestNetwork()) &&
+                visit(Bucket{*nonContiguous}, prefixLength))
+            {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    uint64_t lengths = m_prefixLengths;
+    while (lengths != 0)
+    {
+        auto length = static_cast<uint16_t>(63 - std::countl_zero(lengths));
+        lengths &= ~(uint64_t{1} << length);
+        if (visitNonContiguous(length))
+        {
+            return;
+        }
+        const auto& prefixes = m_prefixes[length];
+        auto it = prefixes.find(dest.Get() & GetMask(length));
+        if (it != prefixes.end() && visit(it->second, length))
+        {
+            return;
+        }
+    }
+    visitNonContiguous(-1);
+}
+
+inline uint32_t
+Ipv4Fib::GetMask(uint16_t prefixLength)
+{
+    return prefixLength == 0 ? 0 : ~uint32_t{0} << (32 - prefixLength);
+}
+
+} // namespace ns3
+
+#endif /* IPV4_FIB_H */
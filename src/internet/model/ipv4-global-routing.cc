@@ -11,6 +11,8 @@
 #include "ipv4-routing-table-entry.h"
 
 #include "ns3/boolean.h"
+#include "ns3/enum.h"
+#include "ns3/hash.h"
 #include "ns3/log.h"
 #include "ns3/names.h"
 #include "ns3/net-device.h"
@@ -19,6 +21,7 @@
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 
+#include <algorithm>
 #include <iomanip>
 #include <vector>
 
@@ -42,6 +45,23 @@ Ipv4GlobalRouting::GetTypeId()
                           BooleanValue(false),
                           MakeBooleanAccessor(&Ipv4GlobalRouting::m_randomEcmpRouting),
                           MakeBooleanChecker())
+            .AddAttribute("EcmpMode",
+                          "How a route is selected among equal-cost routes. RandomEcmpRouting "
+                          "set to true overrides this attribute",
+                          EnumValue(Ipv4GlobalRouting::ECMP_FIRST_ROUTE),
+                          MakeEnumAccessor<EcmpMode_e>(&Ipv4GlobalRouting::m_ecmpMode),
+                          MakeEnumChecker(Ipv4GlobalRouting::ECMP_FIRST_ROUTE,
+                                          "FirstRoute",
+                                          Ipv4GlobalRouting::ECMP_RANDOM,
+                                          "Random",
+                                          Ipv4GlobalRouting::ECMP_FLOW_HASH,
+                                          "FlowHash"))
+            .AddAttribute("FlowletGap",
+                          "In FlowHash mode, idle time after which a flow may be moved to a "
+                          "randomly chosen route. Zero disables flowlet switching",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&Ipv4GlobalRouting::m_flowletGap),
+                          MakeTimeChecker(Seconds(0)))
             .AddAttribute("RespondToInterfaceEvents",
                           "Set to true if you want to dynamically recompute the global routes upon "
                           "Interface notification events (up/down, or add/remove address)",
@@ -53,7 +73,10 @@ Ipv4GlobalRouting::GetTypeId()
 
 Ipv4GlobalRouting::Ipv4GlobalRouting()
     : m_randomEcmpRouting(false),
-      m_respondToInterfaceEvents(false)
+      m_ecmpMode(ECMP_FIRST_ROUTE),
+      m_respondToInterfaceEvents(false),
+      m_fibValid(true),
+      m_hashSalt(0)
 {
     NS_LOG_FUNCTION(this);
 
@@ -72,6 +95,10 @@ Ipv4GlobalRouting::AddHostRouteTo(Ipv4Address dest, Ipv4Address nextHop, uint32_
     auto route = new Ipv4RoutingTableEntry();
     *route = Ipv4RoutingTableEntry::CreateHostRouteTo(dest, nextHop, interface);
     m_hostRoutes.push_back(route);
+    if (m_fibValid)
+    {
+        m_hostFib.Add(route);
+    }
 }
 
 void
@@ -81,6 +108,10 @@ Ipv4GlobalRouting::AddHostRouteTo(Ipv4Address dest, uint32_t interface)
     auto route = new Ipv4RoutingTableEntry();
     *route = Ipv4RoutingTableEntry::CreateHostRouteTo(dest, interface);
     m_hostRoutes.push_back(route);
+    if (m_fibValid)
+    {
+        m_hostFib.Add(route);
+    }
 }
 
 void
@@ -93,6 +124,10 @@ Ipv4GlobalRouting::AddNetworkRouteTo(Ipv4Address network,
     auto route = new Ipv4RoutingTableEntry();
     *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo(network, networkMask, nextHop, interface);
     m_networkRoutes.push_back(route);
+    if (m_fibValid)
+    {
+        m_networkFib.Add(route);
+    }
 }
 
 void
@@ -102,6 +137,10 @@ Ipv4GlobalRouting::AddNetworkRouteTo(Ipv4Address network, Ipv4Mask networkMask,
     auto route = new Ipv4RoutingTableEntry();
     *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo(network, networkMask, interface);
     m_networkRoutes.push_back(route);
+    if (m_fibValid)
+    {
+        m_networkFib.Add(route);
+    }
 }
 
 void
@@ -116,9 +155,75 @@ Ipv4GlobalRouting::AddASExternalRouteTo(Ipv4Address network,
     m_ASexternalRoutes.push_back(route);
 }
 
+uint32_t
+Ipv4GlobalRouting::GetFlowHash(const Ipv4Header& header, Ptr<const Packet> p) const
+{
+    uint8_t prot = header.GetProtocol();
+    uint8_t buf[17] = {};
+    header.GetSource().Serialize(buf);
+    header.GetDestination().Serialize(buf + 4);
+    buf[8] = prot;
+    // The source and destination ports are the first four bytes of both
+    // the TCP and the UDP headers
+    if ((prot == 6 || prot == 17) && header.GetFragmentOffset() == 0 && p && p->GetSize() >= 4)
+    {
+        p->CopyData(buf + 9, 4);
+    }
+    buf[13] = (m_hashSalt >> 24) & 0xff;
+    buf[14] = (m_hashSalt >> 16) & 0xff;
+    buf[15] = (m_hashSalt >> 8) & 0xff;
+    buf[16] = m_hashSalt & 0xff;
+    return Hash32((char*)buf, 17);
+}
+
+uint32_t
+Ipv4GlobalRouting::SelectEcmpRoute(const Ipv4Header& header,
+                                   Ptr<const Packet> p,
+                                   uint32_t nRoutes)
+{
+    if (m_randomEcmpRouting || m_ecmpMode == ECMP_RANDOM)
+    {
+        return m_rand->GetInteger(0, nRoutes - 1);
+    }
+    if (m_ecmpMode == ECMP_FIRST_ROUTE)
+    {
+        return 0;
+    }
+
+    uint32_t hash = GetFlowHash(header, p);
+    if (m_flowletGap.IsZero())
+    {
+        return hash % nRoutes;
+    }
+
+    Time now = Simulator::Now();
+    if (now >= m_nextFlowletSweep)
+    {
+        // Forget the flowlets which would start anew anyway, so that the
+        // table only holds the recently active flows
+        for (auto it = m_flowlets.begin(); it != m_flowlets.end();)
+        {
+            it = now - it->second.lastSeen > m_flowletGap ? m_flowlets.erase(it) : std::next(it);
+        }
+        m_nextFlowletSweep = now + m_flowletGap;
+    }
+    auto [it, inserted] = m_flowlets.try_emplace(hash);
+    Flowlet& flowlet = it->second;
+    if (inserted || now - flowlet.lastSeen > m_flowletGap || flowlet.index >= nRoutes)
+    {
+        flowlet.index = m_rand->GetInteger(0, nRoutes - 1);
+        NS_LOG_LOGIC("New flowlet for flow hash " << hash << " on route " << flowlet.index);
+    }
+    flowlet.lastSeen = now;
+    return flowlet.index;
+}
+
 Ptr<Ipv4Route>
-Ipv4GlobalRouting::LookupGlobal(Ipv4Address dest, Ptr<NetDevice> oif)
+Ipv4GlobalRouting::LookupGlobal(const Ipv4Header& header,
+                                Ptr<const Packet> p,
+                                Ptr<NetDevice> oif)
 {
+    Ipv4Address dest = header.GetDestination();
     NS_LOG_FUNCTION(this << dest << oif);
     NS_LOG_LOGIC("Looking for route for destination " << dest);
     Ptr<Ipv4Route> rtentry = nullptr;
@@ -126,44 +231,59 @@ Ipv4GlobalRouting::LookupGlobal(Ipv4Address dest, Ptr<NetDevice> oif)
     typedef std::vector<Ipv4RoutingTableEntry*> RouteVec_t;
     RouteVec_t allRoutes;
 
+    if (!m_fibValid)
+    {
+        BuildFib();
+    }
+
     NS_LOG_LOGIC("Number of m_hostRoutes = " << m_hostRoutes.size());
-    for (auto i = m_hostRoutes.begin(); i != m_hostRoutes.end(); i++)
+    const Ipv4Fib::Bucket* hostRoutes = m_hostFib.Find(dest, Ipv4Mask::GetOnes());
+    if (hostRoutes)
     {
-        NS_ASSERT((*i)->IsHost());
-        if ((*i)->GetDest() == dest)
+        for (const auto& entry : *hostRoutes)
         {
-            if (oif)
+            NS_ASSERT(entry.route->IsHost());
+            if (oif && oif != m_ipv4->GetNetDevice(entry.route->GetInterface()))
             {
-                if (oif != m_ipv4->GetNetDevice((*i)->GetInterface()))
-                {
-                    NS_LOG_LOGIC("Not on requested interface, skipping");
-                    continue;
-                }
+                NS_LOG_LOGIC("Not on requested interface, skipping");
+                continue;
             }
-            allRoutes.push_back(*i);
-            NS_LOG_LOGIC(allRoutes.size() << "Found global host route" << *i);
+            allRoutes.push_back(entry.route);
+            NS_LOG_LOGIC(allRoutes.size() << "Found global host route" << entry.route);
         }
     }
     if (allRoutes.empty()) // if no host route is found
     {
+        // All the matching network routes are candidates, whatever their
+        // prefix length, in the order they were added: the FIB visits them
+        // longest prefix first, so they are sorted back when several prefixes
+        // match
         NS_LOG_LOGIC("Number of m_networkRoutes" << m_networkRoutes.size());
-        for (auto j = m_networkRoutes.begin(); j != m_networkRoutes.end(); j++)
-        {
-            Ipv4Mask mask = (*j)->GetDestNetworkMask();
-            Ipv4Address entry = (*j)->GetDestNetwork();
-            if (mask.IsMatch(dest, entry))
+        std::vector<Ipv4Fib::Entry> matches;
+        uint32_t nPrefixes = 0;
+        m_networkFib.ForEachMatch(dest, [&](const Ipv4Fib::Bucket& routes, uint16_t) {
+            nPrefixes++;
+            for (const auto& entry : routes)
             {
-                if (oif)
+                if (oif && oif != m_ipv4->GetNetDevice(entry.route->GetInterface()))
                 {
-                    if (oif != m_ipv4->GetNetDevice((*j)->GetInterface()))
-                    {
-                        NS_LOG_LOGIC("Not on requested interface, skipping");
-                        continue;
-                    }
+                    NS_LOG_LOGIC("Not on requested interface, skipping");
+                    continue;
                 }
-                allRoutes.push_back(*j);
-                NS_LOG_LOGIC(allRoutes.size() << "Found global network route" << *j);
+                matches.push_back(entry);
             }
+            return false;
+        });
+        if (nPrefixes > 1)
+        {
+            std::sort(matches.begin(), matches.end(), [](const auto& a, const auto& b) {
+                return a.rank < b.rank;
+            });
+        }
+        for (const auto& entry : matches)
+        {
+            allRoutes.push_back(entry.route);
+            NS_LOG_LOGIC(allRoutes.size() << "Found global network route" << entry.route);
         }
     }
     if (allRoutes.empty()) // consider external if no host/network found
@@ -190,17 +310,11 @@ Ipv4GlobalRouting::LookupGlobal(Ipv4Address dest, Ptr<NetDevice> oif)
     }
     if (!allRoutes.empty()) // if route(s) is found
     {
-        // pick up one of the routes uniformly at random if random
-        // ECMP routing is enabled, or always select the first route
-        // consistently if random ECMP routing is disabled
-        uint32_t selectIndex;
-        if (m_randomEcmpRouting)
-        {
-            selectIndex = m_rand->GetInteger(0, allRoutes.size() - 1);
-        }
-        else
+        // pick up one of the routes according to the ECMP mode
+        uint32_t selectIndex = 0;
+        if (allRoutes.size() > 1)
         {
-            selectIndex = 0;
+            selectIndex = SelectEcmpRoute(header, p, allRoutes.size());
         }
         Ipv4RoutingTableEntry* route = allRoutes.at(selectIndex);
         // create a Ipv4Route object from the selected routing table entry
@@ -219,6 +333,23 @@ Ipv4GlobalRouting::LookupGlobal(Ipv4Address dest, Ptr<NetDevice> oif)
     }
 }
 
+void
+Ipv4GlobalRouting::BuildFib()
+{
+    NS_LOG_FUNCTION(this);
+    m_hostFib.Clear();
+    for (auto route : m_hostRoutes)
+    {
+        m_hostFib.Add(route);
+    }
+    m_networkFib.Clear();
+    for (auto route : m_networkRoutes)
+    {
+        m_networkFib.Add(route);
+    }
+    m_fibValid = true;
+}
+
 uint32_t
 Ipv4GlobalRouting::GetNRoutes() const
 {
@@ -288,6 +419,7 @@ Ipv4GlobalRouting::RemoveRoute(uint32_t index)
                 NS_LOG_LOGIC("Removing route " << index << "; size = " << m_hostRoutes.size());
                 delete *i;
                 m_hostRoutes.erase(i);
+                m_fibValid = false;
                 NS_LOG_LOGIC("Done removing host route "
                              << index << "; host route remaining size = " << m_hostRoutes.size());
                 return;
@@ -304,6 +436,7 @@ Ipv4GlobalRouting::RemoveRoute(uint32_t index)
             NS_LOG_LOGIC("Removing route " << index << "; size = " << m_networkRoutes.size());
             delete *j;
             m_networkRoutes.erase(j);
+            m_fibValid = false;
             NS_LOG_LOGIC("Done removing network route "
                          << index << "; network route remaining size = " << m_networkRoutes.size());
             return;
@@ -353,6 +486,9 @@ Ipv4GlobalRouting::DoDispose()
     {
         delete (*l);
     }
+    m_hostFib.Clear();
+    m_networkFib.Clear();
+    m_flowlets.clear();
 
     Ipv4RoutingProtocol::DoDispose();
 }
@@ -445,7 +581,10 @@ Ipv4GlobalRouting::RouteOutput(Ptr<Packet> p,
     // See if this is a unicast packet we have a route for.
     //
     NS_LOG_LOGIC("Unicast destination- looking up");
-    Ptr<Ipv4Route> rtentry = LookupGlobal(header.GetDestination(), oif);
+    // The TCP layer routes its segments with their header, but the UDP
+    // sockets route their bare payload: without a transport header, the
+    // flow hash is only built from the addresses and the protocol
+    Ptr<Ipv4Route> rtentry = LookupGlobal(header, header.GetProtocol() == 6 ? p : nullptr, oif);
     if (rtentry)
     {
         sockerr = Socket::ERROR_NOTERROR;
@@ -500,7 +639,7 @@ Ipv4GlobalRouting::RouteInput(Ptr<const Packet> p,
     }
     // Next, try to find a route
     NS_LOG_LOGIC("Unicast destination- looking up global route");
-    Ptr<Ipv4Route> rtentry = LookupGlobal(header.GetDestination());
+    Ptr<Ipv4Route> rtentry = LookupGlobal(header, p);
     if (rtentry)
     {
         NS_LOG_LOGIC("Found unicast destination- calling unicast callback");
@@ -521,9 +660,7 @@ Ipv4GlobalRouting::NotifyInterfaceUp(uint32_t i)
     NS_LOG_FUNCTION(this << i);
     if (m_respondToInterfaceEvents && Simulator::Now().GetSeconds() > 0) // avoid startup events
     {
-        GlobalRouteManager::DeleteGlobalRoutes();
-        GlobalRouteManager::BuildGlobalRoutingDatabase();
-        GlobalRouteManager::InitializeRoutes();
+        GlobalRouteManager::UpdateRoutes();
     }
 }
 
@@ -533,9 +670,7 @@ Ipv4GlobalRouting::NotifyInterfaceDown(uint32_t i)
     NS_LOG_FUNCTION(this << i);
     if (m_respondToInterfaceEvents && Simulator::Now().GetSeconds() > 0) // avoid startup events
     {
-        GlobalRouteManager::DeleteGlobalRoutes();
-        GlobalRouteManager::BuildGlobalRoutingDatabase();
-        GlobalRouteManager::InitializeRoutes();
+        GlobalRouteManager::UpdateRoutes();
     }
 }
 
@@ -545,9 +680,7 @@ Ipv4GlobalRouting::NotifyAddAddress(uint32_t interface, Ipv4InterfaceAddress add
     NS_LOG_FUNCTION(this << interface << address);
     if (m_respondToInterfaceEvents && Simulator::Now().GetSeconds() > 0) // avoid startup events
     {
-        GlobalRouteManager::DeleteGlobalRoutes();
-        GlobalRouteManager::BuildGlobalRoutingDatabase();
-        GlobalRouteManager::InitializeRoutes();
+        GlobalRouteManager::UpdateRoutes();
     }
 }
 
@@ -557,9 +690,7 @@ Ipv4GlobalRouting::NotifyRemoveAddress(uint32_t interface, Ipv4InterfaceAddress
     NS_LOG_FUNCTION(this << interface << address);
     if (m_respondToInterfaceEvents && Simulator::Now().GetSeconds() > 0) // avoid startup events
     {
-        GlobalRouteManager::DeleteGlobalRoutes();
-        GlobalRouteManager::BuildGlobalRoutingDatabase();
-        GlobalRouteManager::InitializeRoutes();
+        GlobalRouteManager::UpdateRoutes();
     }
 }
 
@@ -569,6 +700,11 @@ Ipv4GlobalRouting::SetIpv4(Ptr<Ipv4> ipv4)
     NS_LOG_FUNCTION(this << ipv4);
     NS_ASSERT(!m_ipv4 && ipv4);
     m_ipv4 = ipv4;
+    Ptr<Node> node = ipv4->GetObject<Node>();
+    if (node)
+    {
+        m_hashSalt = node->GetId();
+    }
 }
 
 } // namespace ns3
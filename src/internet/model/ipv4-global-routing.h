@@ -7,16 +7,19 @@
 #ifndef IPV4_GLOBAL_ROUTING_H
 #define IPV4_GLOBAL_ROUTING_H
 
+#include "ipv4-fib.h"
 #include "ipv4-header.h"
 #include "ipv4-routing-protocol.h"
 #include "ipv4.h"
 
 #include "ns3/ipv4-address.h"
+#include "ns3/nstime.h"
 #include "ns3/ptr.h"
 #include "ns3/random-variable-stream.h"
 
 #include <list>
 #include <stdint.h>
+#include <unordered_map>
 
 namespace ns3
 {
@@ -54,6 +57,14 @@ class Node;
  *
  * This class deals with Ipv4 unicast routes only.
  *
+ * When several equal-cost routes lead to a destination, the EcmpMode
+ * attribute selects how one of them is picked.  In FlowHash mode the route
+ * is chosen by hashing the 5-tuple of the packet together with the node id,
+ * so that all the packets of a flow follow the same path and neighbouring
+ * switches do not polarize onto the same links.  If FlowletGap is non-zero,
+ * a flow may instead move to a new, randomly chosen, path whenever it has
+ * been idle for longer than the gap (flowlet switching).
+ *
  * \see Ipv4RoutingProtocol
  * \see GlobalRouteManager
  */
@@ -65,6 +76,15 @@ class Ipv4GlobalRouting : public Ipv4RoutingProtocol
      * \return the object TypeId
      */
     static TypeId GetTypeId();
+
+    /// How a route is selected among equal-cost routes
+    enum EcmpMode_e
+    {
+        ECMP_FIRST_ROUTE, //!< Always use the first route
+        ECMP_RANDOM,      //!< Pick a route at random for every packet
+        ECMP_FLOW_HASH,   //!< Pick a route by hashing the 5-tuple of the packet
+    };
+
     /**
      * \brief Construct an empty Ipv4GlobalRouting routing protocol,
      *
@@ -227,12 +247,28 @@ class Ipv4GlobalRouting : public Ipv4RoutingProtocol
     /// Set to true if packets are randomly routed among ECMP; set to false for using only one route
     /// consistently
     bool m_randomEcmpRouting;
+    /// ECMP route selection mode
+    EcmpMode_e m_ecmpMode;
+    /// Idle time after which a flow may switch to another ECMP route; zero disables flowlets
+    Time m_flowletGap;
     /// Set to true if this interface should respond to interface events by globally recomputing
     /// routes
     bool m_respondToInterfaceEvents;
     /// A uniform random number generator for randomly routing packets among ECMP
     Ptr<UniformRandomVariable> m_rand;
 
+    /// State of a flowlet
+    struct Flowlet
+    {
+        Time lastSeen;  //!< Time the last packet of the flowlet was routed
+        uint32_t index; //!< Index of the route used by the flowlet
+    };
+
+    /// Flowlets, indexed by flow hash
+    std::unordered_map<uint32_t, Flowlet> m_flowlets;
+    /// Time after which the flowlets idle for longer than the gap are removed
+    Time m_nextFlowletSweep;
+
     /// container of Ipv4RoutingTableEntry (routes to hosts)
     typedef std::list<Ipv4RoutingTableEntry*> HostRoutes;
     /// const iterator of container of Ipv4RoutingTableEntry (routes to hosts)
@@ -256,17 +292,53 @@ class Ipv4GlobalRouting : public Ipv4RoutingProtocol
 
     /**
      * \brief Lookup in the forwarding table for destination.
-     * \param dest destination address
+     * \param header IPv4 header of the packet
+     * \param p packet to route, starting with its transport header; may be null
      * \param oif output interface if any (put 0 otherwise)
      * \return Ipv4Route to route the packet to reach dest address
      */
-    Ptr<Ipv4Route> LookupGlobal(Ipv4Address dest, Ptr<NetDevice> oif = nullptr);
+    Ptr<Ipv4Route> LookupGlobal(const Ipv4Header& header,
+                                Ptr<const Packet> p,
+                                Ptr<NetDevice> oif = nullptr);
+
+    /**
+     * \brief Select one of several equal-cost routes.
+     * \param header IPv4 header of the packet
+     * \param p packet to route, starting with its transport header; may be null
+     * \param nRoutes number of equal-cost routes
+     * \return the index of the selected route
+     */
+    uint32_t SelectEcmpRoute(const Ipv4Header& header, Ptr<const Packet> p, uint32_t nRoutes);
+
+    /**
+     * \brief Hash the 5-tuple of a packet, salted with the node id.
+     *
+     * The ports are only included for unfragmented TCP and UDP packets
+     * whose transport header is given; otherwise only the addresses and the
+     * protocol are hashed.
+     *
+     * \param header IPv4 header of the packet
+     * \param p packet, starting with its transport header; null if the
+     *        packet has no transport header yet
+     * \return the flow hash
+     */
+    uint32_t GetFlowHash(const Ipv4Header& header, Ptr<const Packet> p) const;
+
+    /**
+     * \brief Rebuild the compiled forwarding tables from the host and network routes.
+     */
+    void BuildFib();
 
     HostRoutes m_hostRoutes;             //!< Routes to hosts
     NetworkRoutes m_networkRoutes;       //!< Routes to networks
     ASExternalRoutes m_ASexternalRoutes; //!< External routes imported
 
-    Ptr<Ipv4> m_ipv4; //!< associated IPv4 instance
+    Ipv4Fib m_hostFib;    //!< Compiled forwarding table of the routes to hosts
+    Ipv4Fib m_networkFib; //!< Compiled forwarding table of the routes to networks
+    bool m_fibValid;      //!< True if the compiled forwarding tables hold all the routes
+
+    Ptr<Ipv4> m_ipv4;    //!< associated IPv4 instance
+    uint32_t m_hashSalt; //!< Flow hash salt, the id of the node
 };
 
 } // Namespace ns3
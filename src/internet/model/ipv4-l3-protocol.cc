@@ -7,7 +7,6 @@
 //
 
 #include "ipv4-l3-protocol.h"
-#include "../../scratch/Swift/my-delay-tag.h" // Include the custom tag header
 
 #include "arp-cache.h"
 #include "arp-l3-protocol.h"
@@ -18,6 +17,7 @@
 #include "ipv4-route.h"
 #include "loopback-net-device.h"
 
+#include "ns3/abort.h"
 #include "ns3/boolean.h"
 #include "ns3/callback.h"
 #include "ns3/ipv4-address.h"
@@ -26,6 +26,7 @@
 #include "ns3/node.h"
 #include "ns3/object-vector.h"
 #include "ns3/packet.h"
+#include "ns3/segmentation-offload.h"
 #include "ns3/socket.h"
 #include "ns3/string.h"
 #include "ns3/trace-source-accessor.h"
@@ -641,41 +642,8 @@ Ipv4L3Protocol::Receive(Ptr<NetDevice> device,
         socket->ForwardUp(packet, ipHeader, ipv4Interface);
     }
 
-    // ********** TAG HANDLING **********
-    Time now = Simulator::Now();
-    MyDelayTag delayTag;
-    if (!packet->PeekPacketTag(delayTag))
-    {
-        // No tag present, first hop:
-        // Initialize lastHopTimestamp to now, and maxDelay = 0
-        delayTag.SetLastHopTimestamp(now.GetNanoSeconds());
-        delayTag.SetMaxDelay(0);
-        packet->AddPacketTag(delayTag);
-        delayTag.AddHops();
-    }
-    else
-    {
-        // Tag present, compute per-hop delay
-        uint64_t lastHopTs = delayTag.GetLastHopTimestamp();
-        Time lastHopTime = NanoSeconds(lastHopTs);
-        Time perHopDelay = now - lastHopTime;
-
-        // Update max delay if needed
-        uint64_t currentMax = delayTag.GetMaxDelay();
-        uint64_t newDelay = perHopDelay.GetNanoSeconds();
-        if (newDelay > currentMax)
-        {
-            currentMax = newDelay;
-        }
-
-        // Update tag values
-        delayTag.SetLastHopTimestamp(now.GetNanoSeconds());
-        delayTag.SetMaxDelay(currentMax);
-        delayTag.AddHops();
-        // Replace existing tag with updated values
-        packet->ReplacePacketTag(delayTag);
-    }
-    // ********** END TAG HANDLING **********
+    // Stamp the in-band telemetry record (hop count and max per-hop delay)
+    packet->RecordTelemetryHop(Simulator::Now());
 
     if (m_enableDpd && ipHeader.GetDestination().IsMulticast() && UpdateDuplicate(packet, ipHeader))
     {
@@ -830,6 +798,13 @@ Ipv4L3Protocol::Send(Ptr<Packet> packet,
         {
             UpdateDuplicate(packet, ipHeader);
         }
+        SegmentationOffloadTag gso;
+        if (packet->PeekPacketTag(gso) && gso.GetSegments() > 1)
+        {
+            // The segments of a super-segment take the next identifications
+            uint64_t srcDst = destination.Get() | (static_cast<uint64_t>(source.Get()) << 32);
+            m_identification[std::make_pair(srcDst, protocol)] += gso.GetSegments() - 1;
+        }
         SendRealOut(route, packet->Copy(), ipHeader);
         return;
     }
@@ -1017,7 +992,33 @@ Ipv4L3Protocol::SendRealOut(Ptr<Ipv4Route> route, Ptr<Packet> packet, const Ipv4
     if (outInterface->IsUp())
     {
         NS_LOG_LOGIC("Send to " << targetLabel << " " << target);
-        if (packet->GetSize() + ipHeader.GetSerializedSize() > outInterface->GetDevice()->GetMtu())
+        SegmentationOffloadTag gso;
+        bool isSuperSegment = packet->PeekPacketTag(gso);
+        if (isSuperSegment && !outInterface->GetDevice()->SupportsSegmentationOffload())
+        {
+            // The device can not split the super-segment, so it is split here
+            // (generic segmentation offload)
+            Ptr<Packet> superSegment = packet->Copy();
+            superSegment->AddHeader(ipHeader);
+            std::list<Ptr<Packet>> segments;
+            bool split = SegmentationOffload::Segment(PROT_NUMBER, superSegment, segments);
+            NS_ABORT_MSG_IF(!split, "Unable to split a super-segment");
+            for (auto& segment : segments)
+            {
+                Ipv4Header segmentHeader;
+                segment->RemoveHeader(segmentHeader);
+                if (Node::ChecksumEnabled())
+                {
+                    segmentHeader.EnableChecksum();
+                }
+                NS_LOG_LOGIC("Sending segment " << *segment);
+                CallTxTrace(segmentHeader, segment, this, interface);
+                outInterface->Send(segment, segmentHeader, target);
+            }
+        }
+        else if (!isSuperSegment &&
+                 packet->GetSize() + ipHeader.GetSerializedSize() >
+                     outInterface->GetDevice()->GetMtu())
         {
             std::list<Ipv4PayloadHeaderPair> listFragments;
             DoFragmentation(packet, ipHeader, outInterface->GetDevice()->GetMtu(), listFragments);
@@ -47,7 +47,8 @@ Ipv4StaticRouting::GetTypeId()
 }
 
 Ipv4StaticRouting::Ipv4StaticRouting()
-    : m_ipv4(nullptr)
+    : m_fibValid(true),
+      m_ipv4(nullptr)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -67,8 +68,7 @@ Ipv4StaticRouting::AddNetworkRouteTo(Ipv4Address network,
 
     if (!LookupRoute(route, metric))
     {
-        auto routePtr = new Ipv4RoutingTableEntry(route);
-        m_networkRoutes.emplace_back(routePtr, metric);
+        AddRoute(new Ipv4RoutingTableEntry(route), metric);
     }
 }
 
@@ -84,9 +84,7 @@ Ipv4StaticRouting::AddNetworkRouteTo(Ipv4Address network,
         Ipv4RoutingTableEntry::CreateNetworkRouteTo(network, networkMask, interface);
     if (!LookupRoute(route, metric))
     {
-        auto routePtr = new Ipv4RoutingTableEntry(route);
-
-        m_networkRoutes.emplace_back(routePtr, metric);
+        AddRoute(new Ipv4RoutingTableEntry(route), metric);
     }
 }
 
@@ -141,7 +139,7 @@ Ipv4StaticRouting::SetDefaultMulticastRoute(uint32_t outputInterface)
     Ipv4Address network("224.0.0.0");
     Ipv4Mask networkMask("240.0.0.0");
     *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo(network, networkMask, outputInterface);
-    m_networkRoutes.emplace_back(route, 0);
+    AddRoute(route, 0);
 }
 
 uint32_t
@@ -210,17 +208,48 @@ Ipv4StaticRouting::RemoveMulticastRoute(uint32_t index)
     }
 }
 
+void
+Ipv4StaticRouting::AddRoute(Ipv4RoutingTableEntry* route, uint32_t metric)
+{
+    m_networkRoutes.emplace_back(route, metric);
+    if (m_fibValid)
+    {
+        m_fib.Add(route, metric);
+    }
+}
+
+void
+Ipv4StaticRouting::BuildFib()
+{
+    NS_LOG_FUNCTION(this);
+    m_fib.Clear();
+    for (const auto& [route, metric] : m_networkRoutes)
+    {
+        m_fib.Add(route, metric);
+    }
+    m_fibValid = true;
+}
+
 bool
 Ipv4StaticRouting::LookupRoute(const Ipv4RoutingTableEntry& route, uint32_t metric)
 {
-    for (auto j = m_networkRoutes.begin(); j != m_networkRoutes.end(); j++)
+    if (!m_fibValid)
+    {
+        BuildFib();
+    }
+    const Ipv4Fib::Bucket* routes = m_fib.Find(route.GetDestNetwork(), route.GetDestNetworkMask());
+    if (!routes)
     {
-        Ipv4RoutingTableEntry* rtentry = j->first;
+        return false;
+    }
+    for (const auto& entry : *routes)
+    {
+        Ipv4RoutingTableEntry* rtentry = entry.route;
 
         if (rtentry->GetDest() == route.GetDest() &&
             rtentry->GetDestNetworkMask() == route.GetDestNetworkMask() &&
             rtentry->GetGateway() == route.GetGateway() &&
-            rtentry->GetInterface() == route.GetInterface() && j->second == metric)
+            rtentry->GetInterface() == route.GetInterface() && entry.metric == metric)
         {
             return true;
         }
@@ -233,8 +262,6 @@ Ipv4StaticRouting::LookupStatic(Ipv4Address dest, Ptr<NetDevice> oif)
 {
     NS_LOG_FUNCTION(this << dest << " " << oif);
     Ptr<Ipv4Route> rtentry = nullptr;
-    uint16_t longest_mask = 0;
-    uint32_t shortest_metric = 0xffffffff;
     /* when sending on local multicast, there have to be interface specified */
     if (dest.IsLocalMulticast())
     {
@@ -250,55 +277,47 @@ Ipv4StaticRouting::LookupStatic(Ipv4Address dest, Ptr<NetDevice> oif)
         return rtentry;
     }
 
-    for (auto i = m_networkRoutes.begin(); i != m_networkRoutes.end(); i++)
+    if (!m_fibValid)
     {
-        Ipv4RoutingTableEntry* j = i->first;
-        uint32_t metric = i->second;
-        Ipv4Mask mask = (j)->GetDestNetworkMask();
-        uint16_t masklen = mask.GetPrefixLength();
-        Ipv4Address entry = (j)->GetDestNetwork();
-        NS_LOG_LOGIC("Searching for route to " << dest << ", checking against route to " << entry
-                                               << "/" << masklen);
-        if (mask.IsMatch(dest, entry))
+        BuildFib();
+    }
+
+    // Among the routes to the longest matching prefix, pick the last one
+    // with the lowest metric, or the first one for host routes
+    Ipv4RoutingTableEntry* route = nullptr;
+    m_fib.ForEachMatch(dest, [&](const Ipv4Fib::Bucket& routes, uint16_t masklen) {
+        uint32_t shortest_metric = 0xffffffff;
+        for (const auto& entry : routes)
         {
-            NS_LOG_LOGIC("Found global network route " << j << ", mask length " << masklen
-                                                       << ", metric " << metric);
-            if (oif)
+            NS_LOG_LOGIC("Found global network route " << entry.route << ", mask length "
+                                                       << masklen << ", metric " << entry.metric);
+            if (oif && oif != m_ipv4->GetNetDevice(entry.route->GetInterface()))
             {
-                if (oif != m_ipv4->GetNetDevice(j->GetInterface()))
-                {
-                    NS_LOG_LOGIC("Not on requested interface, skipping");
-                    continue;
-                }
-            }
-            if (masklen < longest_mask) // Not interested if got shorter mask
-            {
-                NS_LOG_LOGIC("Previous match longer, skipping");
+                NS_LOG_LOGIC("Not on requested interface, skipping");
                 continue;
             }
-            if (masklen > longest_mask) // Reset metric if longer masklen
-            {
-                shortest_metric = 0xffffffff;
-            }
-            longest_mask = masklen;
-            if (metric > shortest_metric)
+            if (entry.metric > shortest_metric)
             {
                 NS_LOG_LOGIC("Equal mask length, but previous metric shorter, skipping");
                 continue;
             }
-            shortest_metric = metric;
-            Ipv4RoutingTableEntry* route = (j);
-            uint32_t interfaceIdx = route->GetInterface();
-            rtentry = Create<Ipv4Route>();
-            rtentry->SetDestination(route->GetDest());
-            rtentry->SetSource(m_ipv4->SourceAddressSelection(interfaceIdx, route->GetDest()));
-            rtentry->SetGateway(route->GetGateway());
-            rtentry->SetOutputDevice(m_ipv4->GetNetDevice(interfaceIdx));
+            shortest_metric = entry.metric;
+            route = entry.route;
             if (masklen == 32)
             {
                 break;
             }
         }
+        return route != nullptr;
+    });
+    if (route)
+    {
+        uint32_t interfaceIdx = route->GetInterface();
+        rtentry = Create<Ipv4Route>();
+        rtentry->SetDestination(route->GetDest());
+        rtentry->SetSource(m_ipv4->SourceAddressSelection(interfaceIdx, route->GetDest()));
+        rtentry->SetGateway(route->GetGateway());
+        rtentry->SetOutputDevice(m_ipv4->GetNetDevice(interfaceIdx));
     }
     if (rtentry)
     {
@@ -448,6 +467,7 @@ Ipv4StaticRouting::RemoveRoute(uint32_t index)
         {
             delete j->first;
             m_networkRoutes.erase(j);
+            m_fibValid = false;
             return;
         }
         tmp++;
@@ -581,6 +601,7 @@ Ipv4StaticRouting::DoDispose()
     {
         delete (j->first);
     }
+    m_fib.Clear();
     for (auto i = m_multicastRoutes.begin(); i != m_multicastRoutes.end();
          i = m_multicastRoutes.erase(i))
     {
@@ -622,6 +643,7 @@ Ipv4StaticRouting::NotifyInterfaceDown(uint32_t i)
         {
             delete it->first;
             it = m_networkRoutes.erase(it);
+            m_fibValid = false;
         }
         else
         {
@@ -667,6 +689,7 @@ Ipv4StaticRouting::NotifyRemoveAddress(uint32_t interface, Ipv4InterfaceAddress
         {
             delete it->first;
             it = m_networkRoutes.erase(it);
+            m_fibValid = false;
         }
         else
         {
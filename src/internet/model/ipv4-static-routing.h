@@ -10,6 +10,7 @@
 #ifndef IPV4_STATIC_ROUTING_H
 #define IPV4_STATIC_ROUTING_H
 
+#include "ipv4-fib.h"
 #include "ipv4-header.h"
 #include "ipv4-routing-protocol.h"
 #include "ipv4.h"
@@ -395,11 +396,36 @@ class Ipv4StaticRouting : public Ipv4RoutingProtocol
      */
     Ptr<Ipv4MulticastRoute> LookupStatic(Ipv4Address origin, Ipv4Address group, uint32_t interface);
 
+    /**
+     * \brief Add a network route to the forwarding tables.
+     * \param route route, owned by the forwarding table from now on
+     * \param metric metric of route
+     */
+    void AddRoute(Ipv4RoutingTableEntry* route, uint32_t metric);
+
+    /**
+     * \brief Rebuild the compiled forwarding table from the network routes.
+     */
+    void BuildFib();
+
     /**
      * \brief the forwarding table for network.
      */
     NetworkRoutes m_networkRoutes;
 
+    /**
+     * \brief the compiled forwarding table for network, used for lookups.
+     *
+     * It is updated as routes are added, and rebuilt on the next lookup
+     * after routes have been removed.
+     */
+    Ipv4Fib m_fib;
+
+    /**
+     * \brief true if m_fib holds all the network routes.
+     */
+    bool m_fibValid;
+
     /**
      * \brief the forwarding table for multicast.
      */
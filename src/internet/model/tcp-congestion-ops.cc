@@ -6,7 +6,11 @@
  */
 #include "tcp-congestion-ops.h"
 
+#include "tcp-congestion-trace-sink.h"
+
+#include "ns3/boolean.h"
 #include "ns3/log.h"
+#include "ns3/uinteger.h"
 
 namespace ns3
 {
@@ -19,7 +23,25 @@ TypeId
 TcpCongestionOps::GetTypeId()
 {
     static TypeId tid =
-        TypeId("ns3::TcpCongestionOps").SetParent<Object>().SetGroupName("Internet");
+        TypeId("ns3::TcpCongestionOps")
+            .SetParent<Object>()
+            .SetGroupName("Internet")
+            .AddAttribute("CcTrace",
+                          "Record the congestion control state of this flow in the shared "
+                          "TcpCongestionTraceSink",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&TcpCongestionOps::m_ccTraceEnabled),
+                          MakeBooleanChecker())
+            .AddAttribute("CcTraceDecimation",
+                          "Record only one congestion control state update every N",
+                          UintegerValue(1),
+                          MakeUintegerAccessor(&TcpCongestionOps::m_ccTraceDecimation),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("CcTraceFlowId",
+                          "Flow identifier written with the congestion control state records",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&TcpCongestionOps::m_ccTraceFlowId),
+                          MakeUintegerChecker<uint32_t>());
     return tid;
 }
 
@@ -29,7 +51,10 @@ TcpCongestionOps::TcpCongestionOps()
 }
 
 TcpCongestionOps::TcpCongestionOps(const TcpCongestionOps& other)
-    : Object(other)
+    : Object(other),
+      m_ccTraceEnabled(other.m_ccTraceEnabled),
+      m_ccTraceDecimation(other.m_ccTraceDecimation),
+      m_ccTraceFlowId(other.m_ccTraceFlowId)
 {
 }
 
@@ -37,6 +62,25 @@ TcpCongestionOps::~TcpCongestionOps()
 {
 }
 
+void
+TcpCongestionOps::TraceCongestionState(Ptr<const TcpSocketState> tcb,
+                                       Time measuredDelay,
+                                       Time targetDelay)
+{
+    if (!m_ccTraceEnabled)
+    {
+        return;
+    }
+    if (m_ccTraceCount++ % m_ccTraceDecimation != 0)
+    {
+        return;
+    }
+    TcpCongestionTraceSink::GetDefault()->Record(m_ccTraceFlowId,
+                                                 tcb->m_cWnd,
+                                                 measuredDelay,
+                                                 targetDelay);
+}
+
 void
 TcpCongestionOps::IncreaseWindow(Ptr<TcpSocketState> tcb, uint32_t segmentsAcked)
 {
@@ -187,6 +187,25 @@ class TcpCongestionOps : public Object
      * \return a pointer of the copied object
      */
     virtual Ptr<TcpCongestionOps> Fork() = 0;
+
+  protected:
+    /**
+     * \brief Record the congestion control state of this flow
+     *
+     * Does nothing unless the CcTrace attribute is enabled; otherwise one
+     * call every CcTraceDecimation is recorded, together with the current
+     * time and congestion window, in the shared TcpCongestionTraceSink.
+     *
+     * \param tcb internal congestion state
+     * \param measuredDelay the delay measured by the algorithm
+     * \param targetDelay the delay targeted by the algorithm
+     */
+    void TraceCongestionState(Ptr<const TcpSocketState> tcb, Time measuredDelay, Time targetDelay);
+
+    bool m_ccTraceEnabled{false};    //!< Whether the congestion control state is traced
+    uint32_t m_ccTraceDecimation{1}; //!< Record one state update every m_ccTraceDecimation
+    uint32_t m_ccTraceFlowId{0};     //!< Flow id written with the trace records
+    uint32_t m_ccTraceCount{0};      //!< Number of state updates seen so far
 };
 
 /**
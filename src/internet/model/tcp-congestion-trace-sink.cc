@@ -0,0 +1,240 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "tcp-congestion-trace-sink.h"
+
+#include "ns3/abort.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("TcpCongestionTraceSink");
+
+NS_OBJECT_ENSURE_REGISTERED(TcpCongestionTraceSink);
+
+Ptr<TcpCongestionTraceSink> TcpCongestionTraceSink::g_default = nullptr;
+
+TypeId
+TcpCongestionTraceSink::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::TcpCongestionTraceSink")
+            .SetParent<Object>()
+            .SetGroupName("Internet")
+            .AddConstructor<TcpCongestionTraceSink>()
+            .AddAttribute("FileName",
+                          "Name of the binary trace file",
+                          StringValue("cc-trace.bin"),
+                          MakeStringAccessor(&TcpCongestionTraceSink::m_fileName),
+                          MakeStringChecker())
+            .AddAttribute("BatchSize",
+                          "Number of records buffered before a batch is written",
+                          UintegerValue(65536),
+                          MakeUintegerAccessor(&TcpCongestionTraceSink::m_batchSize),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("RingSize",
+                          "Number of batches that can wait to be written",
+                          UintegerValue(4),
+                          MakeUintegerAccessor(&TcpCongestionTraceSink::m_ringSize),
+                          MakeUintegerChecker<uint32_t>(2));
+    return tid;
+}
+
+TcpCongestionTraceSink::TcpCongestionTraceSink()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TcpCongestionTraceSink::~TcpCongestionTraceSink()
+{
+    NS_LOG_FUNCTION(this);
+    Stop();
+}
+
+Ptr<TcpCongestionTraceSink>
+TcpCongestionTraceSink::GetDefault()
+{
+    if (!g_default)
+    {
+        g_default = CreateObject<TcpCongestionTraceSink>();
+        Simulator::ScheduleDestroy(&TcpCongestionTraceSink::DestroyDefault);
+    }
+    return g_default;
+}
+
+void
+TcpCongestionTraceSink::DestroyDefault()
+{
+    if (g_default)
+    {
+        g_default->Dispose();
+        g_default = nullptr;
+    }
+}
+
+void
+TcpCongestionTraceSink::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    Stop();
+    Object::DoDispose();
+}
+
+void
+TcpCongestionTraceSink::Start()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(!m_started);
+
+    m_file.open(m_fileName, std::ios::out | std::ios::binary | std::ios::trunc);
+    NS_ABORT_MSG_UNLESS(m_file.is_open(), "Unable to open " << m_fileName);
+    m_file.write("NS3CCTR1", 8);
+
+    m_ring.resize(m_ringSize);
+    for (auto& batch : m_ring)
+    {
+        batch.time.reserve(m_batchSize);
+        batch.flowId.reserve(m_batchSize);
+        batch.cwnd.reserve(m_batchSize);
+        batch.delay.reserve(m_batchSize);
+        batch.target.reserve(m_batchSize);
+    }
+    m_fill = 0;
+    m_write = 0;
+    m_pending = 0;
+    m_stop = false;
+    m_started = true;
+    m_thread = std::thread(&TcpCongestionTraceSink::Run, this);
+}
+
+void
+TcpCongestionTraceSink::Stop()
+{
+    if (!m_started)
+    {
+        return;
+    }
+    NS_LOG_FUNCTION(this);
+
+    Flush();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+    m_file.close();
+    m_ring.clear();
+    m_started = false;
+}
+
+void
+TcpCongestionTraceSink::Record(uint32_t flowId, uint32_t cwnd, Time measuredDelay, Time targetDelay)
+{
+    if (!m_started)
+    {
+        Start();
+    }
+
+    Batch& batch = m_ring[m_fill];
+    batch.time.push_back(Simulator::Now().GetNanoSeconds());
+    batch.flowId.push_back(flowId);
+    batch.cwnd.push_back(cwnd);
+    batch.delay.push_back(measuredDelay.GetNanoSeconds());
+    batch.target.push_back(targetDelay.GetNanoSeconds());
+    ++m_records;
+
+    if (batch.time.size() >= m_batchSize)
+    {
+        Submit();
+    }
+}
+
+void
+TcpCongestionTraceSink::Submit()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    ++m_pending;
+    m_cv.notify_all();
+    // Wait for the writer thread only if every batch of the ring is full
+    m_cv.wait(lock, [this] { return m_pending < m_ringSize; });
+    m_fill = (m_fill + 1) % m_ringSize;
+}
+
+void
+TcpCongestionTraceSink::Flush()
+{
+    if (!m_started)
+    {
+        return;
+    }
+    NS_LOG_FUNCTION(this);
+
+    if (!m_ring[m_fill].time.empty())
+    {
+        Submit();
+    }
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [this] { return m_pending == 0; });
+    m_file.flush();
+    NS_ABORT_MSG_IF(m_file.fail(), "Unable to write to " << m_fileName);
+}
+
+uint64_t
+TcpCongestionTraceSink::GetRecordCount() const
+{
+    return m_records;
+}
+
+void
+TcpCongestionTraceSink::Run()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_cv.wait(lock, [this] { return m_pending > 0 || m_stop; });
+        if (m_pending == 0)
+        {
+            // Stopping, and nothing left to write
+            return;
+        }
+        Batch& batch = m_ring[m_write];
+        // The simulation thread never touches a pending batch: write it unlocked
+        lock.unlock();
+        WriteBatch(batch);
+        lock.lock();
+        m_write = (m_write + 1) % m_ringSize;
+        --m_pending;
+        m_cv.notify_all();
+    }
+}
+
+void
+TcpCongestionTraceSink::WriteBatch(Batch& batch)
+{
+    auto count = static_cast<uint32_t>(batch.time.size());
+    m_file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    m_file.write(reinterpret_cast<const char*>(batch.time.data()), count * sizeof(int64_t));
+    m_file.write(reinterpret_cast<const char*>(batch.flowId.data()), count * sizeof(uint32_t));
+    m_file.write(reinterpret_cast<const char*>(batch.cwnd.data()), count * sizeof(uint32_t));
+    m_file.write(reinterpret_cast<const char*>(batch.delay.data()), count * sizeof(int64_t));
+    m_file.write(reinterpret_cast<const char*>(batch.target.data()), count * sizeof(int64_t));
+    // A full disk would otherwise silently truncate the trace
+    NS_ABORT_MSG_IF(m_file.fail(), "Unable to write to " << m_fileName);
+
+    batch.time.clear();
+    batch.flowId.clear();
+    batch.cwnd.clear();
+    batch.delay.clear();
+    batch.target.clear();
+}
+
+} // namespace ns3
@@ -0,0 +1,147 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef TCP_CONGESTION_TRACE_SINK_H
+#define TCP_CONGESTION_TRACE_SINK_H
+
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup congestionOps
+ *
+ * \brief Buffered binary sink for congestion control state traces
+ *
+ * Congestion control algorithms record, for each traced flow, the time,
+ * the congestion window, the measured delay and the target delay. Records
+ * are accumulated in a ring of fixed-size batches; a full batch is handed
+ * to a background thread which writes it to disk, so that the simulation
+ * never waits for the file system unless every batch of the ring is full.
+ * A failure to write the file, e.g., on a full disk, aborts the simulation
+ * rather than leaving a truncated trace.
+ *
+ * The output file starts with the 8-byte magic string "NS3CCTR1". Each
+ * batch is then written as a uint32_t record count N followed by the
+ * columns, in host byte order:
+ *   - N int64_t timestamps (ns),
+ *   - N uint32_t flow ids,
+ *   - N uint32_t congestion windows (bytes),
+ *   - N int64_t measured delays (ns),
+ *   - N int64_t target delays (ns).
+ *
+ * Algorithms usually do not use this class directly, but enable tracing
+ * per flow through the TcpCongestionOps::CcTrace attribute, which records
+ * to the shared sink returned by GetDefault().
+ */
+class TcpCongestionTraceSink : public Object
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    TcpCongestionTraceSink();
+    ~TcpCongestionTraceSink() override;
+
+    /**
+     * \brief Get the sink shared by all the congestion control algorithms
+     *
+     * The sink is created on first use, with the default attribute values,
+     * and it is flushed and closed when the simulator is destroyed.
+     *
+     * \return the shared sink
+     */
+    static Ptr<TcpCongestionTraceSink> GetDefault();
+
+    /**
+     * \brief Record the congestion control state of a flow at the current time
+     *
+     * \param flowId the flow identifier
+     * \param cwnd the congestion window, in bytes
+     * \param measuredDelay the delay measured by the algorithm
+     * \param targetDelay the delay targeted by the algorithm
+     */
+    void Record(uint32_t flowId, uint32_t cwnd, Time measuredDelay, Time targetDelay);
+
+    /**
+     * \brief Write all the buffered records to the file
+     *
+     * Blocks until the background thread has written every record
+     * recorded so far.
+     */
+    void Flush();
+
+    /**
+     * \return the number of records recorded so far
+     */
+    uint64_t GetRecordCount() const;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /// A batch of records, stored by column
+    struct Batch
+    {
+        std::vector<int64_t> time;    //!< Timestamps (ns)
+        std::vector<uint32_t> flowId; //!< Flow ids
+        std::vector<uint32_t> cwnd;   //!< Congestion windows (bytes)
+        std::vector<int64_t> delay;   //!< Measured delays (ns)
+        std::vector<int64_t> target;  //!< Target delays (ns)
+    };
+
+    /// Open the file and start the writer thread
+    void Start();
+    /// Write the pending batches, then stop the writer thread and close the file
+    void Stop();
+    /// Hand the batch being filled to the writer thread
+    void Submit();
+    /// Writer thread main loop
+    void Run();
+    /**
+     * \brief Write a batch to the file and clear it, or abort if the
+     * file cannot be written
+     * \param batch the batch
+     */
+    void WriteBatch(Batch& batch);
+
+    /// Destroy the shared sink, at simulator destruction
+    static void DestroyDefault();
+
+    std::string m_fileName; //!< Output file name
+    uint32_t m_batchSize;   //!< Records per batch
+    uint32_t m_ringSize;    //!< Number of batches in the ring
+
+    std::vector<Batch> m_ring; //!< Ring of batches
+    std::size_t m_fill{0};     //!< Batch being filled by the simulation
+    std::size_t m_write{0};    //!< Next batch to be written by the writer thread
+    std::size_t m_pending{0};  //!< Number of full batches waiting to be written
+    uint64_t m_records{0};     //!< Number of records recorded so far
+
+    std::ofstream m_file;         //!< Output file
+    std::thread m_thread;         //!< Writer thread
+    std::mutex m_mutex;           //!< Protects m_write, m_pending and m_stop
+    std::condition_variable m_cv; //!< Signals changes to m_pending and m_stop
+    bool m_stop{false};           //!< Whether the writer thread has to exit
+    bool m_started{false};        //!< Whether the file and thread are active
+
+    static Ptr<TcpCongestionTraceSink> g_default; //!< Shared sink
+};
+
+} // namespace ns3
+
+#endif /* TCP_CONGESTION_TRACE_SINK_H */
@@ -10,6 +10,7 @@
 
 #include "ipv4-end-point-demux.h"
 #include "ipv4-end-point.h"
+#include "ipv4-l3-protocol.h"
 #include "ipv4-route.h"
 #include "ipv4-routing-protocol.h"
 #include "ipv6-end-point-demux.h"
@@ -33,6 +34,7 @@
 #include "ns3/nstime.h"
 #include "ns3/object-map.h"
 #include "ns3/packet.h"
+#include "ns3/segmentation-offload.h"
 #include "ns3/simulator.h"
 
 #include <iomanip>
@@ -97,6 +99,8 @@ TcpL4Protocol::TcpL4Protocol()
       m_endPoints6(new Ipv6EndPointDemux())
 {
     NS_LOG_FUNCTION(this);
+    SegmentationOffload::Register(Ipv4L3Protocol::PROT_NUMBER,
+                                  MakeCallback(&TcpL4Protocol::SegmentIpv4));
 }
 
 TcpL4Protocol::~TcpL4Protocol()
@@ -682,6 +686,66 @@ TcpL4Protocol::SendPacketV6(Ptr<Packet> packet,
     }
 }
 
+bool
+TcpL4Protocol::SegmentIpv4(Ptr<const Packet> packet, std::list<Ptr<Packet>>& segments)
+{
+    SegmentationOffloadTag gso;
+    Ipv4Header ipHeader;
+    packet->PeekHeader(ipHeader);
+    if (!packet->PeekPacketTag(gso) || gso.GetSegmentSize() == 0 ||
+        ipHeader.GetProtocol() != PROT_NUMBER || ipHeader.GetFragmentOffset() != 0 ||
+        !ipHeader.IsLastFragment())
+    {
+        return false;
+    }
+
+    Ptr<Packet> payload = packet->Copy();
+    payload->RemovePacketTag(gso);
+    payload->RemoveHeader(ipHeader);
+    TcpHeader tcpHeader;
+    payload->RemoveHeader(tcpHeader);
+
+    uint32_t size = payload->GetSize();
+    uint16_t identification = ipHeader.GetIdentification();
+    for (uint32_t offset = 0; offset < size; offset += gso.GetSegmentSize())
+    {
+        uint32_t length = std::min<uint32_t>(gso.GetSegmentSize(), size - offset);
+        Ptr<Packet> segment = payload->CreateFragment(offset, length);
+
+        TcpHeader segmentTcpHeader = tcpHeader;
+        segmentTcpHeader.SetSequenceNumber(tcpHeader.GetSequenceNumber() + offset);
+        uint8_t flags = tcpHeader.GetFlags();
+        if (offset > 0)
+        {
+            flags &= ~TcpHeader::CWR;
+        }
+        if (offset + length < size)
+        {
+            flags &= ~(TcpHeader::FIN | TcpHeader::PSH);
+        }
+        segmentTcpHeader.SetFlags(flags);
+        if (Node::ChecksumEnabled())
+        {
+            segmentTcpHeader.EnableChecksums();
+        }
+        segmentTcpHeader.InitializeChecksum(ipHeader.GetSource(),
+                                            ipHeader.GetDestination(),
+                                            PROT_NUMBER);
+        segment->AddHeader(segmentTcpHeader);
+
+        Ipv4Header segmentIpHeader = ipHeader;
+        segmentIpHeader.SetPayloadSize(segment->GetSize());
+        segmentIpHeader.SetIdentification(identification++);
+        if (Node::ChecksumEnabled())
+        {
+            segmentIpHeader.EnableChecksum();
+        }
+        segment->AddHeader(segmentIpHeader);
+        segments.push_back(segment);
+    }
+    return true;
+}
+
 void
 TcpL4Protocol::SendPacket(Ptr<Packet> pkt,
                           const TcpHeader& outgoing,
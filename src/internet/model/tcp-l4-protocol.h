@@ -15,6 +15,7 @@
 #include "ns3/ipv6-address.h"
 #include "ns3/sequence-number.h"
 
+#include <list>
 #include <stdint.h>
 #include <unordered_map>
 
@@ -365,6 +366,20 @@ class TcpL4Protocol : public IpL4Protocol
                       const Ipv6Address& saddr,
                       const Ipv6Address& daddr,
                       Ptr<NetDevice> oif = nullptr) const;
+
+    /**
+     * \brief Split an IPv4 packet which holds a TCP super-segment
+     *
+     * This is the segmenter of IPv4 packets registered to SegmentationOffload.
+     * Each segment gets a copy of the headers, with its own sequence number,
+     * IPv4 payload size and identification; the FIN and PSH flags are kept
+     * on the last segment only, and the CWR flag on the first one only.
+     *
+     * \param packet The packet, starting with its IPv4 header
+     * \param segments The list the segments are appended to
+     * \return false if the packet is not a TCP super-segment
+     */
+    static bool SegmentIpv4(Ptr<const Packet> packet, std::list<Ptr<Packet>>& segments);
 };
 
 } // namespace ns3
@@ -0,0 +1,112 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "tcp-option-host-delay.h"
+
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("TcpOptionHostDelay");
+
+NS_OBJECT_ENSURE_REGISTERED(TcpOptionHostDelay);
+
+TcpOptionHostDelay::TcpOptionHostDelay()
+    : TcpOption(),
+      m_hostDelay(0)
+{
+}
+
+TcpOptionHostDelay::~TcpOptionHostDelay()
+{
+}
+
+TypeId
+TcpOptionHostDelay::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::TcpOptionHostDelay")
+                            .SetParent<TcpOption>()
+                            .SetGroupName("Internet")
+                            .AddConstructor<TcpOptionHostDelay>();
+    return tid;
+}
+
+TypeId
+TcpOptionHostDelay::GetInstanceTypeId() const
+{
+    return GetTypeId();
+}
+
+void
+TcpOptionHostDelay::Print(std::ostream& os) const
+{
+    os << m_hostDelay << "ns";
+}
+
+uint32_t
+TcpOptionHostDelay::GetSerializedSize() const
+{
+    return 6;
+}
+
+void
+TcpOptionHostDelay::Serialize(Buffer::Iterator start) const
+{
+    Buffer::Iterator i = start;
+    i.WriteU8(GetKind());        // Kind
+    i.WriteU8(6);                // Length
+    i.WriteHtonU32(m_hostDelay); // Host delay
+}
+
+uint32_t
+TcpOptionHostDelay::Deserialize(Buffer::Iterator start)
+{
+    Buffer::Iterator i = start;
+
+    uint8_t readKind = i.ReadU8();
+    if (readKind != GetKind())
+    {
+        NS_LOG_WARN("Malformed Host Delay option");
+        return 0;
+    }
+
+    uint8_t size = i.ReadU8();
+    if (size != 6)
+    {
+        NS_LOG_WARN("Malformed Host Delay option");
+        return 0;
+    }
+    m_hostDelay = i.ReadNtohU32();
+    return GetSerializedSize();
+}
+
+uint8_t
+TcpOptionHostDelay::GetKind() const
+{
+    return TcpOption::HOSTDELAY;
+}
+
+Time
+TcpOptionHostDelay::GetHostDelay() const
+{
+    return NanoSeconds(m_hostDelay);
+}
+
+void
+TcpOptionHostDelay::SetHostDelay(Time delay)
+{
+    int64_t delayNs = delay.GetNanoSeconds();
+    if (delayNs < 0)
+    {
+        delayNs = 0;
+    }
+    m_hostDelay = static_cast<uint32_t>(
+        std::min<int64_t>(delayNs, std::numeric_limits<uint32_t>::max()));
+}
+
+} // namespace ns3
@@ -0,0 +1,70 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef TCP_OPTION_HOST_DELAY_H
+#define TCP_OPTION_HOST_DELAY_H
+
+#include "tcp-option.h"
+
+#include "ns3/nstime.h"
+
+namespace ns3
+{
+
+/**
+ * \ingroup tcp
+ *
+ * Defines an experimental TCP option (kind 253, \RFC{4727}) that echoes the
+ * receiver host delay, as used by Swift to separate the endpoint delay from
+ * the fabric delay.
+ *
+ * The host delay is the time elapsed between the arrival of the most recent
+ * data segment at the receiving host (its NIC receive timestamp) and the
+ * transmission of the acknowledgment carrying this option. It is encoded in
+ * nanoseconds and saturates at the largest 32-bit value (about 4.29 s).
+ *
+ * The option is sent with a zero delay in SYN segments to negotiate its use.
+ */
+class TcpOptionHostDelay : public TcpOption
+{
+  public:
+    TcpOptionHostDelay();
+    ~TcpOptionHostDelay() override;
+
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+    TypeId GetInstanceTypeId() const override;
+
+    void Print(std::ostream& os) const override;
+    void Serialize(Buffer::Iterator start) const override;
+    uint32_t Deserialize(Buffer::Iterator start) override;
+
+    uint8_t GetKind() const override;
+    uint32_t GetSerializedSize() const override;
+
+    /**
+     * \brief Get the host delay stored in the Option
+     * \return the host delay
+     */
+    Time GetHostDelay() const;
+    /**
+     * \brief Set the host delay stored in the Option
+     *
+     * Negative delays are stored as zero, and delays that do not fit in
+     * 32 bits of nanoseconds are saturated.
+     *
+     * \param delay the host delay
+     */
+    void SetHostDelay(Time delay);
+
+  protected:
+    uint32_t m_hostDelay; //!< host delay, in nanoseconds
+};
+
+} // namespace ns3
+
+#endif /* TCP_OPTION_HOST_DELAY_H */
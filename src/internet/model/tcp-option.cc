@@ -8,6 +8,7 @@
 
 #include "tcp-option.h"
 
+#include "tcp-option-host-delay.h"
 #include "tcp-option-rfc793.h"
 #include "tcp-option-sack-permitted.h"
 #include "tcp-option-sack.h"
@@ -65,6 +66,7 @@ TcpOption::CreateOption(uint8_t kind)
         {TcpOption::WINSCALE, TcpOptionWinScale::GetTypeId()},
         {TcpOption::SACKPERMITTED, TcpOptionSackPermitted::GetTypeId()},
         {TcpOption::SACK, TcpOptionSack::GetTypeId()},
+        {TcpOption::HOSTDELAY, TcpOptionHostDelay::GetTypeId()},
         {TcpOption::UNKNOWN, TcpOptionUnknown::GetTypeId()},
     };
 
@@ -92,6 +94,7 @@ TcpOption::IsKindKnown(uint8_t kind)
     case SACKPERMITTED:
     case SACK:
     case TS:
+    case HOSTDELAY:
         // Do not add UNKNOWN here
         return true;
     }
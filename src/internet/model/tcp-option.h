@@ -51,6 +51,7 @@ class TcpOption : public Object
         SACKPERMITTED = 4, //!< SACKPERMITTED
         SACK = 5,          //!< SACK
         TS = 8,            //!< TS
+        HOSTDELAY = 253,   //!< Swift host delay echo (experimental kind, RFC 4727)
         UNKNOWN = 255      //!< not a standardized value; for unknown recv'd options
     };
 
@@ -11,6 +11,8 @@
 #include "ns3/log.h"
 #include "ns3/packet.h"
 
+#include <algorithm>
+
 namespace ns3
 {
 
@@ -106,9 +108,9 @@ TcpRxBuffer::MaxRxSequence() const
     { // No data allowed beyond FIN
         return m_finSeq;
     }
-    else if (!m_data.empty() && m_nextRxSeq > m_data.begin()->first)
+    else if (!m_data.empty() && m_nextRxSeq > m_data.front().first)
     { // No data allowed beyond Rx window allowed
-        return m_data.begin()->first + SequenceNumber32(m_maxBuffer);
+        return m_data.front().first + SequenceNumber32(m_maxBuffer);
     }
     return m_nextRxSeq + SequenceNumber32(m_maxBuffer);
 }
@@ -150,7 +152,7 @@ TcpRxBuffer::Add(Ptr<Packet> p, const TcpHeader& tcph)
     }
     if (!m_data.empty())
     {
-        SequenceNumber32 maxSeq = m_data.begin()->first + SequenceNumber32(m_maxBuffer);
+        SequenceNumber32 maxSeq = m_data.front().first + SequenceNumber32(m_maxBuffer);
         if (maxSeq < tailSeq)
         {
             tailSeq = maxSeq;
@@ -160,8 +162,16 @@ TcpRxBuffer::Add(Ptr<Packet> p, const TcpHeader& tcph)
             headSeq = tailSeq;
         }
     }
-    // Remove overlapped bytes from packet
-    auto i = m_data.begin();
+    // Remove overlapped bytes from packet. The segments which end before
+    // headSeq cannot overlap: skip them, unless the packet is appended at
+    // the end, as in-order data and most out-of-order data are.
+    auto i = m_data.end();
+    if (!m_data.empty() && m_data.back().first + m_data.back().second->GetSize() > headSeq)
+    {
+        i = std::partition_point(m_data.begin(), m_data.end(), [&headSeq](const Segment& s) {
+            return s.first + s.second->GetSize() <= headSeq;
+        });
+    }
     while (i != m_data.end() && i->first <= tailSeq)
     {
         SequenceNumber32 lastByteSeq = i->first + SequenceNumber32(i->second->GetSize());
@@ -170,7 +180,7 @@ TcpRxBuffer::Add(Ptr<Packet> p, const TcpHeader& tcph)
             if (i->first > headSeq && lastByteSeq < tailSeq)
             { // Rare case: Existing packet is embedded fully in the new packet
                 m_size -= i->second->GetSize();
-                m_data.erase(i++);
+                i = m_data.erase(i);
                 continue;
             }
             if (i->first <= headSeq)
@@ -198,8 +208,15 @@ TcpRxBuffer::Add(Ptr<Packet> p, const TcpHeader& tcph)
         NS_ASSERT(length == p->GetSize());
     }
     // Insert packet into buffer
-    NS_ASSERT(m_data.find(headSeq) == m_data.end()); // Shouldn't be there yet
-    m_data[headSeq] = p;
+    i = m_data.end();
+    if (!m_data.empty() && m_data.back().first > headSeq)
+    {
+        i = std::partition_point(m_data.begin(), m_data.end(), [&headSeq](const Segment& s) {
+            return s.first < headSeq;
+        });
+        NS_ASSERT(i->first != headSeq); // Shouldn't be there yet
+    }
+    i = m_data.emplace(i, headSeq, p);
 
     if (headSeq > m_nextRxSeq)
     {
@@ -210,16 +227,10 @@ TcpRxBuffer::Add(Ptr<Packet> p, const TcpHeader& tcph)
     NS_LOG_LOGIC("Buffered packet of seqno=" << headSeq << " len=" << p->GetSize());
     // Update variables
     m_size += p->GetSize(); // Occupancy
-    for (i = m_data.begin(); i != m_data.end(); ++i)
+    // Only the new packet can fill the hole at m_nextRxSeq; the in-order
+    // data then extends over the segments that follow it
+    for (; i != m_data.end() && i->first == m_nextRxSeq; ++i)
     {
-        if (i->first < m_nextRxSeq)
-        {
-            continue;
-        }
-        else if (i->first > m_nextRxSeq)
-        {
-            break;
-        };
         m_nextRxSeq = i->first + SequenceNumber32(i->second->GetSize());
         m_availBytes += i->second->GetSize();
         ClearSackList(m_nextRxSeq);
@@ -388,7 +399,7 @@ TcpRxBuffer::Extract(uint32_t maxSize)
         if (pktSize <= extractSize)
         { // Whole packet is extracted
             outPkt->AddAtEnd(i->second);
-            m_data.erase(i);
+            m_data.pop_front();
             m_size -= pktSize;
             m_availBytes -= pktSize;
             extractSize -= pktSize;
@@ -396,9 +407,8 @@ TcpRxBuffer::Extract(uint32_t maxSize)
         else
         { // Partial is extracted and done
             outPkt->AddAtEnd(i->second->CreateFragment(0, extractSize));
-            m_data[i->first + SequenceNumber32(extractSize)] =
-                i->second->CreateFragment(extractSize, pktSize - extractSize);
-            m_data.erase(i);
+            i->second = i->second->CreateFragment(extractSize, pktSize - extractSize);
+            i->first += extractSize;
             m_size -= extractSize;
             m_availBytes -= extractSize;
             extractSize = 0;
@@ -17,7 +17,7 @@
 #include "ns3/trace-source-accessor.h"
 #include "ns3/traced-value.h"
 
-#include <map>
+#include <deque>
 
 namespace ns3
 {
@@ -211,8 +211,10 @@ class TcpRxBuffer : public Object
 
     TcpOptionSack::SackList m_sackList; //!< Sack list (updated constantly)
 
+    /// A segment stored in the buffer, and the sequence number of its first byte
+    typedef std::pair<SequenceNumber32, Ptr<Packet>> Segment;
     /// container for data stored in the buffer
-    typedef std::map<SequenceNumber32, Ptr<Packet>>::iterator BufIterator;
+    typedef std::deque<Segment>::iterator BufIterator;
     TracedValue<SequenceNumber32>
         m_nextRxSeq;           //!< Seqnum of the first missing byte in data (RCV.NXT)
     SequenceNumber32 m_finSeq; //!< Seqnum of the FIN packet
@@ -220,7 +222,13 @@ class TcpRxBuffer : public Object
     uint32_t m_size;       //!< Number of total data bytes in the buffer, not necessarily contiguous
     uint32_t m_maxBuffer;  //!< Upper bound of the number of data bytes in buffer (RCV.WND)
     uint32_t m_availBytes; //!< Number of bytes available to read, i.e. contiguous block at head
-    std::map<SequenceNumber32, Ptr<Packet>> m_data; //!< Corresponding data (may be null)
+    /**
+     * Corresponding data, in sequence order and without overlaps.  The
+     * in-order data is at the front, and most out-of-order segments are
+     * appended at the back, so that both are O(1); the others are placed
+     * by a binary search.
+     */
+    std::deque<Segment> m_data;
 };
 
 } // namespace ns3
@@ -14,7 +14,6 @@
     }
 
 #include "tcp-socket-base.h"
-#include "../../scratch/Swift/my-delay-tag.h"
 #include "ipv4-end-point.h"
 #include "ipv4-route.h"
 #include "ipv4-routing-protocol.h"
@@ -27,6 +26,7 @@
 #include "tcp-congestion-ops.h"
 #include "tcp-header.h"
 #include "tcp-l4-protocol.h"
+#include "tcp-option-host-delay.h"
 #include "tcp-option-sack-permitted.h"
 #include "tcp-option-sack.h"
 #include "tcp-option-ts.h"
@@ -46,6 +46,7 @@
 #include "ns3/object.h"
 #include "ns3/packet.h"
 #include "ns3/pointer.h"
+#include "ns3/segmentation-offload.h"
 #include "ns3/simulation-singleton.h"
 #include "ns3/simulator.h"
 #include "ns3/trace-source-accessor.h"
@@ -57,6 +58,12 @@
 namespace
 {
 
+/**
+ * \brief Largest payload of a super-segment, or of the segments coalesced by
+ * GRO, so that the IPv4 total length with the largest TCP header fits in 16 bits
+ */
+const uint32_t OFFLOAD_MAX_PAYLOAD = 65535 - 20 - 60;
+
 /**
  * \brief map TcpPacketType and EcnMode to boolean value to check whether ECN-marking is allowed or
  * not
@@ -148,6 +155,32 @@ TcpSocketBase::GetTypeId()
                           BooleanValue(true),
                           MakeBooleanAccessor(&TcpSocketBase::m_timestampEnabled),
                           MakeBooleanChecker())
+            .AddAttribute("HostDelay",
+                          "Enable or disable the Swift host delay echo option",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&TcpSocketBase::m_hostDelayEnabled),
+                          MakeBooleanChecker())
+            .AddAttribute("TimerWheel",
+                          "Run the retransmission, delayed ACK, persist, close and pacing "
+                          "timers on the TimerWheel of the node, which cancels them in "
+                          "constant time instead of leaving them in the event list",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&TcpSocketBase::SetTimerWheelStatus),
+                          MakeBooleanChecker())
+            .AddAttribute("TsoMaxSegments",
+                          "Maximum number of segments of new data handed down at once, as "
+                          "one super-segment which the net device splits (segmentation "
+                          "offload, IPv4 only); 1 disables it",
+                          UintegerValue(1),
+                          MakeUintegerAccessor(&TcpSocketBase::m_tsoMaxSegments),
+                          MakeUintegerChecker<uint32_t>(1, 65535))
+            .AddAttribute("GroTimeout",
+                          "Maximum time an in-order segment is held to be coalesced with the "
+                          "next ones before it is processed (generic receive offload, IPv4 "
+                          "only); zero disables it",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&TcpSocketBase::m_groTimeout),
+                          MakeTimeChecker())
             .AddAttribute(
                 "MinRto",
                 "Minimum retransmit timeout value",
@@ -408,11 +441,18 @@ TcpSocketBase::TcpSocketBase(const TcpSocketBase& sock)
       m_sndWindShift(sock.m_sndWindShift),
       m_timestampEnabled(sock.m_timestampEnabled),
       m_timestampToEcho(sock.m_timestampToEcho),
+      m_hostDelayEnabled(sock.m_hostDelayEnabled),
+      m_hostDelayRxTime(sock.m_hostDelayRxTime),
+      m_hostDelayPending(sock.m_hostDelayPending),
       m_recover(sock.m_recover),
       m_recoverActive(sock.m_recoverActive),
       m_retxThresh(sock.m_retxThresh),
       m_limitedTx(sock.m_limitedTx),
       m_isFirstPartialAck(sock.m_isFirstPartialAck),
+      m_timerWheelEnabled(sock.m_timerWheelEnabled),
+      m_timerWheel(sock.m_timerWheel),
+      m_tsoMaxSegments(sock.m_tsoMaxSegments),
+      m_groTimeout(sock.m_groTimeout),
       m_txTrace(sock.m_txTrace),
       m_rxTrace(sock.m_rxTrace),
       m_pacingTimer(Timer::CANCEL_ON_DESTROY),
@@ -443,6 +483,7 @@ TcpSocketBase::TcpSocketBase(const TcpSocketBase& sock)
 
     m_tcb->m_pacingRate = m_tcb->m_maxPacingRate;
     m_pacingTimer.SetFunction(&TcpSocketBase::NotifyPacingPerformed, this);
+    m_pacingTimer.SetTimerWheel(m_timerWheel);
 
     if (sock.m_congestionControl)
     {
@@ -542,6 +583,10 @@ void
 TcpSocketBase::SetNode(Ptr<Node> node)
 {
     m_node = node;
+    if (m_timerWheelEnabled)
+    {
+        SetTimerWheelStatus(true);
+    }
 }
 
 /* Associate the L4 protocol (e.g. mux/demux) with this socket */
@@ -1239,6 +1284,16 @@ TcpSocketBase::ForwardUp(Ptr<Packet> packet,
         return;
     }
 
+    // The coalesced segments are processed before a segment which can not
+    // join them
+    uint32_t payloadSize = packet->GetSize() - bytesRemoved;
+    bool coalesce = !m_groTimeout.IsZero() && CanCoalesce(tcpHeader, header.GetEcn(), payloadSize);
+    if (m_groPacket && !coalesce)
+    {
+        FlushGro();
+        coalesce = !m_groTimeout.IsZero() && CanCoalesce(tcpHeader, header.GetEcn(), payloadSize);
+    }
+
     if (header.GetEcn() == Ipv4Header::ECN_CE && m_ecnCESeq < tcpHeader.GetSequenceNumber())
     {
         NS_LOG_INFO("Received CE flag is valid");
@@ -1253,25 +1308,131 @@ TcpSocketBase::ForwardUp(Ptr<Packet> packet,
         m_congestionControl->CwndEvent(m_tcb, TcpSocketState::CA_EVENT_ECN_NO_CE);
     }
 
-    MyDelayTag delayTag;
-    if (packet->PeekPacketTag(delayTag))
+    const PacketTelemetry& telemetry = packet->GetTelemetry();
+    if (telemetry.IsStamped())
     {
-        uint64_t maxDelayNs = delayTag.GetMaxDelay();
-        // Since we have m_tcb available here, we can update m_maxDelay
-        if (m_tcb)
+        uint64_t maxDelayNs = telemetry.GetMaxHopDelay().GetNanoSeconds();
+        if (maxDelayNs > m_tcb->m_maxDelay)
         {
-            if (maxDelayNs > m_tcb->m_maxDelay)
-            {
-                m_tcb->m_maxDelay = maxDelayNs;
-            }
-
-            m_tcb->m_hops = delayTag.GetHops();
+            m_tcb->m_maxDelay = maxDelayNs;
         }
+        m_tcb->m_hops = telemetry.GetHops();
     }
 
+    if (coalesce)
+    {
+        Coalesce(packet, header.GetEcn(), fromAddress, toAddress);
+        return;
+    }
     DoForwardUp(packet, fromAddress, toAddress);
 }
 
+bool
+TcpSocketBase::CanCoalesce(const TcpHeader& tcpHeader,
+                           Ipv4Header::EcnType ecn,
+                           uint32_t payloadSize) const
+{
+    // As tcp_gro_receive() in Linux, only in-order data segments with the ACK
+    // and PSH flags are coalesced, and only if their headers differ by their
+    // sequence numbers alone
+    if (m_state != ESTABLISHED || payloadSize == 0 ||
+        (tcpHeader.GetFlags() & ~TcpHeader::PSH) != TcpHeader::ACK)
+    {
+        return false;
+    }
+    if (!m_groPacket)
+    {
+        return tcpHeader.GetSequenceNumber() == m_tcb->m_rxBuffer->NextRxSequence();
+    }
+    if (tcpHeader.GetSequenceNumber() != m_groHeader.GetSequenceNumber() + m_groPacket->GetSize() ||
+        tcpHeader.GetAckNumber() != m_groHeader.GetAckNumber() ||
+        tcpHeader.GetWindowSize() != m_groHeader.GetWindowSize() || ecn != m_groEcn ||
+        m_groPacket->GetSize() + payloadSize > OFFLOAD_MAX_PAYLOAD ||
+        tcpHeader.GetSerializedSize() != m_groHeader.GetSerializedSize())
+    {
+        return false;
+    }
+
+    // The options, e.g. the timestamps, must be the same
+    Buffer options;
+    Buffer groOptions;
+    options.AddAtStart(tcpHeader.GetSerializedSize());
+    groOptions.AddAtStart(m_groHeader.GetSerializedSize());
+    tcpHeader.Serialize(options.Begin());
+    m_groHeader.Serialize(groOptions.Begin());
+    Buffer::Iterator i = options.Begin();
+    Buffer::Iterator j = groOptions.Begin();
+    i.Next(20);
+    j.Next(20);
+    while (!i.IsEnd())
+    {
+        if (i.ReadU8() != j.ReadU8())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void
+TcpSocketBase::Coalesce(Ptr<Packet> packet,
+                        Ipv4Header::EcnType ecn,
+                        const Address& fromAddress,
+                        const Address& toAddress)
+{
+    NS_LOG_FUNCTION(this << packet);
+    TcpHeader tcpHeader;
+    packet->RemoveHeader(tcpHeader);
+    uint32_t payloadSize = packet->GetSize();
+    if (!m_groPacket)
+    {
+        m_groPacket = packet;
+        m_groHeader = tcpHeader;
+        m_groEcn = ecn;
+        m_groFromAddress = fromAddress;
+        m_groToAddress = toAddress;
+        m_groSegments = 1;
+        m_groFlushEvent = ScheduleTimer(m_groTimeout, &TcpSocketBase::FlushGro, this);
+    }
+    else
+    {
+        m_groPacket->AddAtEnd(packet);
+        m_groSegments++;
+    }
+    NS_LOG_LOGIC("Coalesced " << m_groSegments << " segments, " << m_groPacket->GetSize()
+                              << " bytes");
+
+    // A pushed segment ends the coalescing, as does a full packet
+    if (tcpHeader.GetFlags() & TcpHeader::PSH)
+    {
+        m_groHeader.SetFlags(m_groHeader.GetFlags() | TcpHeader::PSH);
+        FlushGro();
+    }
+    else if (m_groPacket->GetSize() + payloadSize > OFFLOAD_MAX_PAYLOAD)
+    {
+        FlushGro();
+    }
+}
+
+void
+TcpSocketBase::FlushGro()
+{
+    NS_LOG_FUNCTION(this);
+    m_groFlushEvent.Cancel();
+    if (!m_groPacket)
+    {
+        return;
+    }
+    Ptr<Packet> packet = m_groPacket;
+    packet->AddHeader(m_groHeader);
+    m_groPacket = nullptr;
+
+    // The delayed ACKs count the coalesced segments, as if they had been
+    // received one by one
+    m_delAckCount += m_groSegments - 1;
+    DoForwardUp(packet, m_groFromAddress, m_groToAddress);
+}
+
 void
 TcpSocketBase::ForwardUp6(Ptr<Packet> packet,
                           Ipv6Header header,
@@ -1436,6 +1597,11 @@ TcpSocketBase::DoForwardUp(Ptr<Packet> packet, const Address& fromAddress, const
             m_timestampEnabled = false;
         }
 
+        if (!tcpHeader.HasOption(TcpOption::HOSTDELAY))
+        {
+            m_hostDelayEnabled = false;
+        }
+
         // Initialize cWnd and ssThresh
         m_tcb->m_cWnd = GetInitialCwnd() * GetSegSize();
         m_tcb->m_cWndInfl = m_tcb->m_cWnd;
@@ -1468,6 +1634,15 @@ TcpSocketBase::DoForwardUp(Ptr<Packet> packet, const Address& fromAddress, const
         }
 
         EstimateRtt(tcpHeader);
+        if (m_hostDelayEnabled && tcpHeader.HasOption(TcpOption::HOSTDELAY))
+        {
+            ProcessOptionHostDelay(tcpHeader.GetOption(TcpOption::HOSTDELAY));
+        }
+        else
+        {
+            // The host delay of an earlier ACK does not apply to this one
+            m_tcb->m_lastHostDelay = Seconds(0);
+        }
         UpdateWindowSize(tcpHeader);
     }
 
@@ -1476,14 +1651,13 @@ TcpSocketBase::DoForwardUp(Ptr<Packet> packet, const Address& fromAddress, const
         NS_LOG_LOGIC(this << " Enter zerowindow persist state");
         NS_LOG_LOGIC(
             this << " Cancelled ReTxTimeout event which was set to expire at "
-                 << (Simulator::Now() + Simulator::GetDelayLeft(m_retxEvent)).GetSeconds());
+                 << (Simulator::Now() + m_retxEvent.GetDelayLeft()).GetSeconds());
         m_retxEvent.Cancel();
         NS_LOG_LOGIC("Schedule persist timeout at time "
                      << Simulator::Now().GetSeconds() << " to expire at time "
                      << (Simulator::Now() + m_persistTimeout).GetSeconds());
-        m_persistEvent =
-            Simulator::Schedule(m_persistTimeout, &TcpSocketBase::PersistTimeout, this);
-        NS_ASSERT(m_persistTimeout == Simulator::GetDelayLeft(m_persistEvent));
+        m_persistEvent = ScheduleTimer(m_persistTimeout, &TcpSocketBase::PersistTimeout, this);
+        NS_ASSERT(m_persistTimeout == m_persistEvent.GetDelayLeft());
     }
 
     // TCP state machine code in different process functions
@@ -1646,6 +1820,8 @@ TcpSocketBase::IsTcpOptionEnabled(uint8_t kind) const
     case TcpOption::SACKPERMITTED:
     case TcpOption::SACK:
         return m_sackEnabled;
+    case TcpOption::HOSTDELAY:
+        return m_hostDelayEnabled;
     default:
         break;
     }
@@ -2763,7 +2939,7 @@ TcpSocketBase::DoPeerClose()
         m_dataRetrCount = m_dataRetries; // prevent endless FINs
         NS_LOG_LOGIC("TcpSocketBase " << this << " scheduling LATO1");
         Time lastRto = m_rtt->GetEstimate() + Max(m_clockGranularity, m_rtt->GetVariation() * 4);
-        m_lastAckEvent = Simulator::Schedule(lastRto, &TcpSocketBase::LastAckTimeout, this);
+        m_lastAckEvent = ScheduleTimer(lastRto, &TcpSocketBase::LastAckTimeout, this);
     }
 }
 
@@ -2779,7 +2955,7 @@ TcpSocketBase::Destroy()
         m_tcp->RemoveSocket(this);
     }
     NS_LOG_LOGIC(this << " Cancelled ReTxTimeout event which was set to expire at "
-                      << (Simulator::Now() + Simulator::GetDelayLeft(m_retxEvent)).GetSeconds());
+                      << (Simulator::Now() + m_retxEvent.GetDelayLeft()).GetSeconds());
     CancelAllTimers();
 }
 
@@ -2795,7 +2971,7 @@ TcpSocketBase::Destroy6()
         m_tcp->RemoveSocket(this);
     }
     NS_LOG_LOGIC(this << " Cancelled ReTxTimeout event which was set to expire at "
-                      << (Simulator::Now() + Simulator::GetDelayLeft(m_retxEvent)).GetSeconds());
+                      << (Simulator::Now() + m_retxEvent.GetDelayLeft()).GetSeconds());
     CancelAllTimers();
 }
 
@@ -2950,7 +3126,7 @@ TcpSocketBase::SendEmptyPacket(uint8_t flags)
         NS_LOG_LOGIC("Schedule retransmission timeout at time "
                      << Simulator::Now().GetSeconds() << " to expire at time "
                      << (Simulator::Now() + m_rto.Get()).GetSeconds());
-        m_retxEvent = Simulator::Schedule(m_rto, &TcpSocketBase::SendEmptyPacket, this, flags);
+        m_retxEvent = ScheduleTimer(m_rto, &TcpSocketBase::SendEmptyPacket, this, flags);
     }
 }
 
@@ -3217,12 +3393,28 @@ TcpSocketBase::SendDataPacket(SequenceNumber32 seq, uint32_t maxSize, bool withA
     NS_LOG_FUNCTION(this << seq << maxSize << withAck);
 
     bool isStartOfTransmission = BytesInFlight() == 0U;
-    TcpTxItem* outItem = m_txBuffer->CopyFromSequence(maxSize, seq);
+    // A super-segment (TSO) is still sent as one item of the Tx buffer per
+    // segment, so that its segments are SACKed and retransmitted one by one
+    uint32_t segmentSize =
+        m_tsoMaxSegments > 1 ? std::min(maxSize, m_tcb->m_segmentSize) : maxSize;
+    TcpTxItem* outItem = m_txBuffer->CopyFromSequence(segmentSize, seq);
 
     m_rateOps->SkbSent(outItem, isStartOfTransmission);
 
     bool isRetransmission = outItem->IsRetrans();
     Ptr<Packet> p = outItem->GetPacketCopy();
+    uint16_t segments = 1;
+    while (segmentSize < maxSize && p->GetSize() < maxSize &&
+           m_txBuffer->SizeFromSequence(seq + p->GetSize()) > 0)
+    {
+        TcpTxItem* item =
+            m_txBuffer->CopyFromSequence(std::min(segmentSize, maxSize - p->GetSize()),
+                                         seq + p->GetSize());
+        NS_ASSERT_MSG(!isRetransmission && !item->IsRetrans(), "Retransmission in a super-segment");
+        m_rateOps->SkbSent(item, false);
+        p->AddAtEnd(item->GetPacketCopy());
+        segments++;
+    }
     uint32_t sz = p->GetSize(); // Size of packet
     uint8_t flags = withAck ? TcpHeader::ACK : 0;
     uint32_t remainingData = m_txBuffer->SizeFromSequence(seq + SequenceNumber32(sz));
@@ -3238,9 +3430,8 @@ TcpSocketBase::SendDataPacket(SequenceNumber32 seq, uint32_t maxSize, bool withA
         if (m_pacingTimer.IsExpired())
         {
             NS_LOG_DEBUG("Current Pacing Rate " << m_tcb->m_pacingRate);
-            NS_LOG_DEBUG("Timer is in expired state, activate it "
-                         << m_tcb->m_pacingRate.Get().CalculateBytesTxTime(sz));
-            m_pacingTimer.Schedule(m_tcb->m_pacingRate.Get().CalculateBytesTxTime(sz));
+            NS_LOG_DEBUG("Timer is in expired state, activate it " << GetPacingDelay(sz));
+            m_pacingTimer.Schedule(GetPacingDelay(sz));
         }
         else
         {
@@ -3270,6 +3461,10 @@ TcpSocketBase::SendDataPacket(SequenceNumber32 seq, uint32_t maxSize, bool withA
 
     bool isEct = IsEct(isRetransmission ? TcpPacketType_t::RE_XMT : TcpPacketType_t::DATA);
     AddSocketTags(p, isEct);
+    if (segments > 1)
+    {
+        p->AddPacketTag(SegmentationOffloadTag(segmentSize, segments));
+    }
 
     if (m_closeOnEmpty && (remainingData == 0))
     {
@@ -3309,7 +3504,7 @@ TcpSocketBase::SendDataPacket(SequenceNumber32 seq, uint32_t maxSize, bool withA
         NS_LOG_LOGIC(this << " SendDataPacket Schedule ReTxTimeout at time "
                           << Simulator::Now().GetSeconds() << " to expire at time "
                           << (Simulator::Now() + m_rto.Get()).GetSeconds());
-        m_retxEvent = Simulator::Schedule(m_rto, &TcpSocketBase::ReTxTimeout, this);
+        m_retxEvent = ScheduleTimer(m_rto, &TcpSocketBase::ReTxTimeout, this);
     }
 
     m_txTrace(p, header, this);
@@ -3363,7 +3558,18 @@ TcpSocketBase::SendDataPacket(SequenceNumber32 seq, uint32_t maxSize, bool withA
     // send will also be cwnd limited if less then one segment of cwnd is available
     m_tcb->m_isCwndLimited = (m_tcb->m_cWnd < BytesInFlight() + m_tcb->m_segmentSize);
 
-    UpdateRttHistory(seq, sz, isRetransmission);
+    if (segments > 1)
+    {
+        // The segments of a super-segment are timed one by one
+        for (uint32_t offset = 0; offset < sz; offset += segmentSize)
+        {
+            UpdateRttHistory(seq + offset, std::min(segmentSize, sz - offset), isRetransmission);
+        }
+    }
+    else
+    {
+        UpdateRttHistory(seq, sz, isRetransmission);
+    }
 
     // Update bytes sent during recovery phase
     if (m_tcb->m_congState == TcpSocketState::CA_RECOVERY ||
@@ -3497,6 +3703,21 @@ TcpSocketBase::SendPendingData(bool withAck)
             auto maxSizeToSend = static_cast<uint32_t>(nextHigh - next);
             s = std::min(s, maxSizeToSend);
 
+            // With segmentation offload (TSO), the whole segments of new data
+            // which fit in the window are handed down as one super-segment
+            if (m_tsoMaxSegments > 1 && m_endPoint && s == m_tcb->m_segmentSize &&
+                next >= m_tcb->m_highTxMark)
+            {
+                uint32_t segments =
+                    std::min({availableWindow, availableData, OFFLOAD_MAX_PAYLOAD}) /
+                    m_tcb->m_segmentSize;
+                segments = std::min(segments, m_tsoMaxSegments);
+                if (segments > 1)
+                {
+                    s = segments * m_tcb->m_segmentSize;
+                }
+            }
+
             // (C.2) If any of the data octets sent in (C.1) are below HighData,
             //       HighRxt MUST be set to the highest sequence number of the
             //       retransmitted segment unless NextSeg () rule (4) was
@@ -3531,9 +3752,8 @@ TcpSocketBase::SendPendingData(bool withAck)
                 if (m_pacingTimer.IsExpired())
                 {
                     NS_LOG_DEBUG("Current Pacing Rate " << m_tcb->m_pacingRate);
-                    NS_LOG_DEBUG("Timer is in expired state, activate it "
-                                 << m_tcb->m_pacingRate.Get().CalculateBytesTxTime(sz));
-                    m_pacingTimer.Schedule(m_tcb->m_pacingRate.Get().CalculateBytesTxTime(sz));
+                    NS_LOG_DEBUG("Timer is in expired state, activate it " << GetPacingDelay(sz));
+                    m_pacingTimer.Schedule(GetPacingDelay(sz));
                     break;
                 }
             }
@@ -3650,6 +3870,16 @@ TcpSocketBase::ReceivedData(Ptr<Packet> p, const TcpHeader& tcpHeader)
     NS_LOG_DEBUG("Data segment, seq=" << tcpHeader.GetSequenceNumber()
                                       << " pkt size=" << p->GetSize());
 
+    if (m_hostDelayEnabled)
+    {
+        // The time the segment reached this host is the NIC receive timestamp
+        // recorded by the IP layer in the packet telemetry, when available
+        const PacketTelemetry& telemetry = p->GetTelemetry();
+        m_hostDelayRxTime =
+            telemetry.IsStamped() ? telemetry.GetLastHopTimestamp() : Simulator::Now();
+        m_hostDelayPending = true;
+    }
+
     // Put into Rx buffer
     SequenceNumber32 expectedSeq = m_tcb->m_rxBuffer->NextRxSequence();
     if (!m_tcb->m_rxBuffer->Add(p, tcpHeader))
@@ -3732,11 +3962,10 @@ TcpSocketBase::ReceivedData(Ptr<Packet> p, const TcpHeader& tcpHeader)
         else if (m_delAckEvent.IsExpired())
         {
             m_congestionControl->CwndEvent(m_tcb, TcpSocketState::CA_EVENT_DELAYED_ACK);
-            m_delAckEvent =
-                Simulator::Schedule(m_delAckTimeout, &TcpSocketBase::DelAckTimeout, this);
+            m_delAckEvent = ScheduleTimer(m_delAckTimeout, &TcpSocketBase::DelAckTimeout, this);
             NS_LOG_LOGIC(
                 this << " scheduled delayed ACK at "
-                     << (Simulator::Now() + Simulator::GetDelayLeft(m_delAckEvent)).GetSeconds());
+                     << (Simulator::Now() + m_delAckEvent.GetDelayLeft()).GetSeconds());
         }
     }
 }
@@ -3849,7 +4078,7 @@ TcpSocketBase::NewAck(const SequenceNumber32& ack, bool resetRTO)
     { // Set RTO unless the ACK is received in SYN_RCVD state
         NS_LOG_LOGIC(
             this << " Cancelled ReTxTimeout event which was set to expire at "
-                 << (Simulator::Now() + Simulator::GetDelayLeft(m_retxEvent)).GetSeconds());
+                 << (Simulator::Now() + m_retxEvent.GetDelayLeft()).GetSeconds());
         m_retxEvent.Cancel();
         // On receiving a "New" ack we restart retransmission timer .. RFC 6298
         // RFC 6298, clause 2.4
@@ -3859,7 +4088,7 @@ TcpSocketBase::NewAck(const SequenceNumber32& ack, bool resetRTO)
         NS_LOG_LOGIC(this << " Schedule ReTxTimeout at time " << Simulator::Now().GetSeconds()
                           << " to expire at time "
                           << (Simulator::Now() + m_rto.Get()).GetSeconds());
-        m_retxEvent = Simulator::Schedule(m_rto, &TcpSocketBase::ReTxTimeout, this);
+        m_retxEvent = ScheduleTimer(m_rto, &TcpSocketBase::ReTxTimeout, this);
     }
 
     // Note the highest ACK and tell app to send more
@@ -3878,7 +4107,7 @@ TcpSocketBase::NewAck(const SequenceNumber32& ack, bool resetRTO)
     { // No retransmit timer if no data to retransmit
         NS_LOG_LOGIC(
             this << " Cancelled ReTxTimeout event which was set to expire at "
-                 << (Simulator::Now() + Simulator::GetDelayLeft(m_retxEvent)).GetSeconds());
+                 << (Simulator::Now() + m_retxEvent.GetDelayLeft()).GetSeconds());
         m_retxEvent.Cancel();
     }
 }
@@ -4050,7 +4279,7 @@ TcpSocketBase::LastAckTimeout()
         SendEmptyPacket(TcpHeader::FIN | TcpHeader::ACK);
         NS_LOG_LOGIC("TcpSocketBase " << this << " rescheduling LATO1");
         Time lastRto = m_rtt->GetEstimate() + Max(m_clockGranularity, m_rtt->GetVariation() * 4);
-        m_lastAckEvent = Simulator::Schedule(lastRto, &TcpSocketBase::LastAckTimeout, this);
+        m_lastAckEvent = ScheduleTimer(lastRto, &TcpSocketBase::LastAckTimeout, this);
     }
 }
 
@@ -4107,7 +4336,7 @@ TcpSocketBase::PersistTimeout()
     NS_LOG_LOGIC("Schedule persist timeout at time "
                  << Simulator::Now().GetSeconds() << " to expire at time "
                  << (Simulator::Now() + m_persistTimeout).GetSeconds());
-    m_persistEvent = Simulator::Schedule(m_persistTimeout, &TcpSocketBase::PersistTimeout, this);
+    m_persistEvent = ScheduleTimer(m_persistTimeout, &TcpSocketBase::PersistTimeout, this);
 }
 
 void
@@ -4155,6 +4384,9 @@ TcpSocketBase::CancelAllTimers()
     m_timewaitEvent.Cancel();
     m_sendPendingDataEvent.Cancel();
     m_pacingTimer.Cancel();
+    // The segments held for coalescing are dropped with their flush
+    m_groFlushEvent.Cancel();
+    m_groPacket = nullptr;
 }
 
 /* Move TCP to Time_Wait state and schedule a transition to Closed state */
@@ -4174,7 +4406,7 @@ TcpSocketBase::TimeWait()
     }
     // Move from TIME_WAIT to CLOSED after 2*MSL. Max segment lifetime is 2 min
     // according to RFC793, p.28
-    m_timewaitEvent = Simulator::Schedule(Seconds(2 * m_msl), &TcpSocketBase::CloseAndNotify, this);
+    m_timewaitEvent = ScheduleTimer(Seconds(2 * m_msl), &TcpSocketBase::CloseAndNotify, this);
 }
 
 /* Below are the attribute get/set functions */
@@ -4355,6 +4587,11 @@ TcpSocketBase::AddOptions(TcpHeader& header)
     {
         AddOptionTimestamp(header);
     }
+
+    if (m_hostDelayEnabled)
+    {
+        AddOptionHostDelay(header);
+    }
 }
 
 void
@@ -4526,6 +4763,42 @@ TcpSocketBase::AddOptionTimestamp(TcpHeader& header)
                                 << " echo=" << m_timestampToEcho);
 }
 
+void
+TcpSocketBase::ProcessOptionHostDelay(const Ptr<const TcpOption> option)
+{
+    NS_LOG_FUNCTION(this << option);
+
+    Ptr<const TcpOptionHostDelay> hd = DynamicCast<const TcpOptionHostDelay>(option);
+
+    m_tcb->m_lastHostDelay = hd->GetHostDelay();
+
+    NS_LOG_INFO(m_node->GetId() << " Got host delay=" << m_tcb->m_lastHostDelay);
+}
+
+void
+TcpSocketBase::AddOptionHostDelay(TcpHeader& header)
+{
+    NS_LOG_FUNCTION(this << header);
+
+    bool hasSyn = header.GetFlags() & TcpHeader::SYN;
+    if (!hasSyn && !m_hostDelayPending)
+    {
+        // Nothing received since the last echo
+        return;
+    }
+
+    Ptr<TcpOptionHostDelay> option = CreateObject<TcpOptionHostDelay>();
+
+    if (m_hostDelayPending)
+    {
+        option->SetHostDelay(Simulator::Now() - m_hostDelayRxTime);
+        m_hostDelayPending = false;
+    }
+
+    header.AppendOption(option);
+    NS_LOG_INFO(m_node->GetId() << " Add option HostDelay, delay=" << option->GetHostDelay());
+}
+
 void
 TcpSocketBase::UpdateWindowSize(const TcpHeader& header)
 {
@@ -4725,9 +4998,25 @@ TcpSocketBase::NotifyPacingPerformed()
     SendPendingData(m_connected);
 }
 
+Time
+TcpSocketBase::GetPacingGap() const
+{
+    // A gap is set for a window below one segment: it is stale once the
+    // stack itself raised the window, e.g. when leaving the recovery
+    if (m_tcb->m_cWnd > m_tcb->m_segmentSize)
+    {
+        return Seconds(0);
+    }
+    return m_tcb->m_pacingGap;
+}
+
 bool
 TcpSocketBase::IsPacingEnabled() const
 {
+    if (GetPacingGap().IsStrictlyPositive())
+    {
+        return true;
+    }
     if (!m_tcb->m_pacing)
     {
         return false;
@@ -4747,6 +5036,13 @@ TcpSocketBase::IsPacingEnabled() const
     return false;
 }
 
+Time
+TcpSocketBase::GetPacingDelay(uint32_t size) const
+{
+    Time delay = m_tcb->m_pacingRate.Get().CalculateBytesTxTime(size);
+    return std::max(delay, GetPacingGap());
+}
+
 void
 TcpSocketBase::UpdatePacingRate()
 {
@@ -4837,6 +5133,19 @@ TcpSocketBase::SetUseEcn(TcpSocketState::UseEcn_t useEcn)
     m_tcb->m_useEcn = useEcn;
 }
 
+void
+TcpSocketBase::SetTimerWheelStatus(bool timerWheel)
+{
+    NS_LOG_FUNCTION(this << timerWheel);
+    m_timerWheelEnabled = timerWheel;
+    m_timerWheel = nullptr;
+    if (timerWheel && m_node)
+    {
+        m_timerWheel = TimerWheel::GetWheel(m_node->GetId());
+    }
+    m_pacingTimer.SetTimerWheel(m_timerWheel);
+}
+
 uint32_t
 TcpSocketBase::GetRWnd() const
 {
@@ -11,12 +11,14 @@
 
 #include "ipv4-header.h"
 #include "ipv6-header.h"
+#include "tcp-header.h"
 #include "tcp-socket-state.h"
 #include "tcp-socket.h"
 
 #include "ns3/data-rate.h"
 #include "ns3/node.h"
 #include "ns3/sequence-number.h"
+#include "ns3/timer-wheel.h"
 #include "ns3/timer.h"
 #include "ns3/traced-value.h"
 
@@ -31,7 +33,6 @@ class Ipv6EndPoint;
 class Node;
 class Packet;
 class TcpL4Protocol;
-class TcpHeader;
 class TcpCongestionOps;
 class TcpRecoveryOps;
 class RttEstimator;
@@ -593,6 +594,16 @@ class TcpSocketBase : public TcpSocket
      */
     void SetPacingStatus(bool pacing);
 
+    /**
+     * \brief Run the timers on the TimerWheel of the node, or as simulator
+     * events
+     *
+     * The timers already running are not moved.
+     *
+     * \param timerWheel Boolean to enable or disable the timer wheel
+     */
+    void SetTimerWheelStatus(bool timerWheel);
+
     /**
      * \brief Enable or disable pacing of the initial window
      * \param paceWindow Boolean to enable or disable pacing of the initial window
@@ -809,6 +820,38 @@ class TcpSocketBase : public TcpSocket
                              const Address& fromAddress,
                              const Address& toAddress);
 
+    /**
+     * \brief Check whether a received segment can join the segments held
+     * for coalescing (generic receive offload), or start them.
+     *
+     * \param tcpHeader the TCP header of the segment
+     * \param ecn the ECN codepoint of the segment
+     * \param payloadSize the size of the payload of the segment
+     * \return true if the segment can be coalesced
+     */
+    bool CanCoalesce(const TcpHeader& tcpHeader,
+                     Ipv4Header::EcnType ecn,
+                     uint32_t payloadSize) const;
+
+    /**
+     * \brief Hold a received segment, to be processed with the next ones as a
+     * single segment (generic receive offload).
+     *
+     * \param packet the segment, with its TCP header
+     * \param ecn the ECN codepoint of the segment
+     * \param fromAddress the address of the sender of the segment
+     * \param toAddress the address of the receiver of the segment
+     */
+    void Coalesce(Ptr<Packet> packet,
+                  Ipv4Header::EcnType ecn,
+                  const Address& fromAddress,
+                  const Address& toAddress);
+
+    /**
+     * \brief Process the segments held for coalescing, if any, as a single segment.
+     */
+    void FlushGro();
+
     /**
      * \brief Called by the L3 protocol when it received an ICMP packet to pass on to TCP.
      *
@@ -934,6 +977,19 @@ class TcpSocketBase : public TcpSocket
      */
     void CancelAllTimers();
 
+    /**
+     * \brief Schedule a timer, on the timer wheel of the node if enabled
+     *
+     * \tparam FUNC \deduced The type of the member function.
+     * \tparam Ts \deduced Argument types.
+     * \param [in] delay The relative expiration time of the timer.
+     * \param [in] f The member function to invoke.
+     * \param [in] args Arguments to pass to the invoked function.
+     * \returns The id of the timer.
+     */
+    template <typename FUNC, typename... Ts>
+    WheelEventId ScheduleTimer(const Time& delay, FUNC f, Ts&&... args);
+
     /**
      * \brief Move from CLOSING or FIN_WAIT_2 to TIME_WAIT state
      */
@@ -1295,6 +1351,26 @@ class TcpSocketBase : public TcpSocket
      */
     void AddOptionTimestamp(TcpHeader& header);
 
+    /**
+     * \brief Process the host delay option from other side
+     *
+     * Save the echoed receiver host delay in the socket state, so that
+     * congestion control can separate it from the fabric delay.
+     *
+     * \param option Option from the segment
+     */
+    void ProcessOptionHostDelay(const Ptr<const TcpOption> option);
+    /**
+     * \brief Add the host delay option to the header
+     *
+     * The option carries the time elapsed since the most recent data
+     * segment reached this host. It is added to SYN segments (to negotiate
+     * its use) and to segments that acknowledge newly received data.
+     *
+     * \param header TcpHeader to which add the option to
+     */
+    void AddOptionHostDelay(TcpHeader& header);
+
     /**
      * \brief Performs a safe subtraction between a and b (a-b)
      *
@@ -1311,12 +1387,34 @@ class TcpSocketBase : public TcpSocket
      */
     void NotifyPacingPerformed();
 
+    /**
+     * \brief Get the pacing gap set by the congestion control
+     *
+     * The congestion control sets the gap when its window falls below one
+     * segment, and then writes a window of one segment. The gap is stale,
+     * and ignored, once the window is larger, e.g. after the recovery.
+     *
+     * \return the pacing gap, or zero
+     */
+    Time GetPacingGap() const;
+
     /**
      * \brief Return true if packets in the current window should be paced
      * \return true if pacing is currently enabled
      */
     bool IsPacingEnabled() const;
 
+    /**
+     * \brief Compute the time the pacing timer waits after sending a segment
+     *
+     * This is the transmission time of the segment at the current pacing
+     * rate, and at least the pacing gap set by the congestion control.
+     *
+     * \param size size of the segment, in bytes
+     * \return the pacing delay
+     */
+    Time GetPacingDelay(uint32_t size) const;
+
     /**
      * \brief Dynamically update the pacing rate
      */
@@ -1345,11 +1443,13 @@ class TcpSocketBase : public TcpSocket
 
   protected:
     // Counters and events
-    EventId m_retxEvent{};     //!< Retransmission event
-    EventId m_lastAckEvent{};  //!< Last ACK timeout event
-    EventId m_delAckEvent{};   //!< Delayed ACK timeout event
-    EventId m_persistEvent{};  //!< Persist event: Send 1 byte to probe for a non-zero Rx window
-    EventId m_timewaitEvent{}; //!< TIME_WAIT expiration event: Move this socket to CLOSED state
+    WheelEventId m_retxEvent{};     //!< Retransmission event
+    WheelEventId m_lastAckEvent{};  //!< Last ACK timeout event
+    WheelEventId m_delAckEvent{};   //!< Delayed ACK timeout event
+    WheelEventId m_persistEvent{};  //!< Persist event: Send 1 byte to probe for a non-zero Rx
+                                    //!< window
+    WheelEventId m_timewaitEvent{}; //!< TIME_WAIT expiration event: Move this socket to CLOSED
+                                    //!< state
 
     // ACK management
     uint32_t m_dupAckCount{0};    //!< Dupack counter
@@ -1413,12 +1513,15 @@ class TcpSocketBase : public TcpSocket
     TracedValue<SequenceNumber32> m_highRxAckMark{0}; //!< Highest ack received
 
     // Options
-    bool m_sackEnabled{true};       //!< RFC SACK option enabled
-    bool m_winScalingEnabled{true}; //!< Window Scale option enabled (RFC 7323)
-    uint8_t m_rcvWindShift{0};      //!< Window shift to apply to outgoing segments
-    uint8_t m_sndWindShift{0};      //!< Window shift to apply to incoming segments
-    bool m_timestampEnabled{true};  //!< Timestamp option enabled
-    uint32_t m_timestampToEcho{0};  //!< Timestamp to echo
+    bool m_sackEnabled{true};           //!< RFC SACK option enabled
+    bool m_winScalingEnabled{true};     //!< Window Scale option enabled (RFC 7323)
+    uint8_t m_rcvWindShift{0};          //!< Window shift to apply to outgoing segments
+    uint8_t m_sndWindShift{0};          //!< Window shift to apply to incoming segments
+    bool m_timestampEnabled{true};      //!< Timestamp option enabled
+    uint32_t m_timestampToEcho{0};      //!< Timestamp to echo
+    bool m_hostDelayEnabled{false};     //!< Host delay option enabled
+    Time m_hostDelayRxTime{Seconds(0)}; //!< Arrival time of the last data segment to echo
+    bool m_hostDelayPending{false};     //!< Whether a host delay has to be echoed
 
     EventId m_sendPendingDataEvent{}; //!< micro-delay event to send pending data
 
@@ -1440,6 +1543,21 @@ class TcpSocketBase : public TcpSocket
     // Guesses over the other connection end
     bool m_isFirstPartialAck{true}; //!< First partial ACK during RECOVERY
 
+    // Timer wheel
+    bool m_timerWheelEnabled{false}; //!< Whether the timers run on the wheel of the node
+    Ptr<TimerWheel> m_timerWheel;    //!< Timer wheel of the node, if enabled
+
+    // Segmentation offload (TSO) and generic receive offload (GRO)
+    uint32_t m_tsoMaxSegments{1};   //!< Maximum number of segments of a super-segment
+    Time m_groTimeout{Seconds(0)};  //!< Maximum time a segment is held for coalescing
+    Ptr<Packet> m_groPacket;        //!< Payload of the segments held for coalescing
+    TcpHeader m_groHeader;          //!< TCP header of the first segment held for coalescing
+    Ipv4Header::EcnType m_groEcn{}; //!< ECN codepoint of the held segments
+    Address m_groFromAddress;       //!< Source address of the held segments
+    Address m_groToAddress;         //!< Destination address of the held segments
+    uint32_t m_groSegments{0};      //!< Number of segments held for coalescing
+    WheelEventId m_groFlushEvent{}; //!< Processing of the held segments
+
     // The following three traces pass a packet with a TCP header
     TracedCallback<Ptr<const Packet>,
                    const TcpHeader&,
@@ -1469,6 +1587,17 @@ class TcpSocketBase : public TcpSocket
     TracedValue<SequenceNumber32> m_ecnCWRSeq{0}; //!< Sequence number of the last sent CWR
 };
 
+template <typename FUNC, typename... Ts>
+WheelEventId
+TcpSocketBase::ScheduleTimer(const Time& delay, FUNC f, Ts&&... args)
+{
+    if (m_timerWheel)
+    {
+        return m_timerWheel->Schedule(delay, f, std::forward<Ts>(args)...);
+    }
+    return Simulator::Schedule(delay, f, std::forward<Ts>(args)...);
+}
+
 /**
  * \ingroup tcp
  * TracedValue Callback signature for TcpCongState_t
@@ -110,6 +110,7 @@ TcpSocketState::TcpSocketState(const TcpSocketState& other)
       m_pacingSsRatio(other.m_pacingSsRatio),
       m_pacingCaRatio(other.m_pacingCaRatio),
       m_paceInitialWindow(other.m_paceInitialWindow),
+      m_pacingGap(other.m_pacingGap),
       m_minRtt(other.m_minRtt),
       m_bytesInFlight(other.m_bytesInFlight),
       m_isCwndLimited(other.m_isCwndLimited),
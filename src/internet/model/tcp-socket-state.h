@@ -193,6 +193,13 @@ class TcpSocketState : public Object
     uint16_t m_pacingSsRatio{0};           //!< SS pacing ratio
     uint16_t m_pacingCaRatio{0};           //!< CA pacing ratio
     bool m_paceInitialWindow{false};       //!< Enable/Disable pacing for the initial window
+    /**
+     * Minimum gap between two data segments, or zero. Set by congestion
+     * controls whose window falls below one segment: the socket then paces
+     * segments at least this far apart, whatever m_pacing, as long as the
+     * window is one segment.
+     */
+    Time m_pacingGap{Seconds(0)};
 
     Time m_minRtt{Time::Max()}; //!< Minimum RTT observed throughout the connection
 
@@ -236,9 +243,12 @@ class TcpSocketState : public Object
      * Callback to send an empty packet
      */
     Callback<void, uint8_t> m_sendEmptyPacketCallback;
-    uint64_t m_maxDelay;
-    uint64_t m_target_delay;
-    uint64_t m_hops;
+
+    uint64_t m_maxDelay{0};     //!< Max per-hop delay (ns) read from the packet telemetry
+    uint64_t m_target_delay{0}; //!< Target delay (ns) computed by delay-based congestion control
+    uint64_t m_hops{0};         //!< Hop count read from the packet telemetry
+    /// Receiver host delay echoed with the last ACK, zero if it echoed none (Swift)
+    Time m_lastHostDelay{Seconds(0)};
 };
 
 namespace TracedValueCallback
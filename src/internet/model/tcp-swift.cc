@@ -1,6 +1,9 @@
 #include "tcp-swift.h"
 #include "ns3/simulator.h"
 #include "ns3/log.h"
+#include "ns3/rtt-estimator.h"
+
+#include <algorithm>
 
 namespace ns3 {
 
@@ -25,6 +28,16 @@ TcpSwift::GetTypeId (void)
                    TimeValue (MicroSeconds (300)),
                    MakeTimeAccessor (&TcpSwift::m_baseTarget),
                    MakeTimeChecker ())
+    .AddAttribute ("EndpointTarget", "Target delay for the receiver host (endpoint) delay",
+                   TimeValue (MicroSeconds (100)),
+                   MakeTimeAccessor (&TcpSwift::m_endpointTarget),
+                   MakeTimeChecker ())
+    .AddAttribute ("MinCwnd",
+                   "Minimum congestion window, in segments. Below one segment, "
+                   "transmissions are paced one RTT/cwnd apart",
+                   DoubleValue (0.001),
+                   MakeDoubleAccessor (&TcpSwift::m_minCwnd),
+                   MakeDoubleChecker<double> (0.0001, 1.0))
     .AddAttribute ("RetrxResetThreshold", "Reset threshold for retransmissions",
                    UintegerValue (3),
                    MakeUintegerAccessor (&TcpSwift::m_retxResetThreshold),
@@ -35,12 +48,23 @@ TcpSwift::GetTypeId (void)
 TcpSwift::TcpSwift ()
   : m_retransmitCount (0),
     m_canDecrease (false),
-    m_tLastDecrease (Seconds (0))
+    m_tLastDecrease (Seconds (0)),
+    m_fabricCwnd (0),
+    m_endpointCwnd (0),
+    m_cwndSet (0)
 {
   double denom = (1.0 / std::sqrt(0.1)) - (1.0 / std::sqrt(32.0));
   m_alpha = 4.0 / denom;
   m_beta = -1.0 * m_alpha / std::sqrt(32.0);
 
+  // The initial estimate of the RTT estimators, read once rather than
+  // whenever the window falls below one segment
+  TypeId::AttributeInformation info;
+  if (RttEstimator::GetTypeId ().LookupAttributeByName ("InitialEstimation", &info))
+    {
+      m_initialRtt = DynamicCast<const TimeValue> (info.initialValue)->Get ();
+    }
+
   NS_LOG_INFO("TcpSwift: alpha=" << m_alpha << ", beta=" << m_beta);
 }
 
@@ -49,13 +73,21 @@ TcpSwift::TcpSwift (const TcpSwift &other)
     m_ai (other.m_ai),
     m_beta (other.m_beta),
     m_maxMdf (other.m_maxMdf),
+    m_minCwnd (other.m_minCwnd),
     m_baseTarget (other.m_baseTarget),
+    m_endpointTarget (other.m_endpointTarget),
     m_retxResetThreshold (other.m_retxResetThreshold),
     m_retransmitCount (other.m_retransmitCount),
     m_alpha (other.m_alpha),
     m_rtt (other.m_rtt),
+    m_initialRtt (other.m_initialRtt),
     m_canDecrease (other.m_canDecrease),
-    m_tLastDecrease (other.m_tLastDecrease)
+    m_tLastDecrease (other.m_tLastDecrease),
+    m_fabricCwnd (other.m_fabricCwnd),
+    m_endpointCwnd (other.m_endpointCwnd),
+    m_cwndSet (other.m_cwndSet),
+    m_fabricDelay (other.m_fabricDelay),
+    m_endpointDelay (other.m_endpointDelay)
 {
 }
 
@@ -78,6 +110,7 @@ TcpSwift::Init (Ptr<TcpSocketState> tcb)
   m_retransmitCount = 0;
   m_canDecrease = false;
   m_tLastDecrease = Simulator::Now();
+  m_cwndSet = 0;
 }
 
 bool
@@ -101,7 +134,8 @@ TcpSwift::CanDecrease ()
 void
 TcpSwift::ComputeTargetDelay (Ptr<TcpSocketState> tcb, double &targetDelay)
 {
-  double cwnd = (double) tcb->GetCwndInSegments();
+  // Flow scaling is driven by the fabric window
+  double cwnd = std::max (m_fabricCwnd, 1.0);
   double term = (m_alpha / std::sqrt(cwnd)) + m_beta;
 
   term = std::min(4.0, term); // clamp at 0 minimum
@@ -109,7 +143,7 @@ TcpSwift::ComputeTargetDelay (Ptr<TcpSocketState> tcb, double &targetDelay)
   targetDelay = baseTarget * (1. + term) + (tcb->m_hops) * 8.25e-5 ;  // Simplified; add more logic if needed
   // targetDelay = baseTarget;
   // std::cout << "Computed target delay: " << targetDelay << std::endl;
-  tcb->m_target_delay =  targetDelay;
+  tcb->m_target_delay = static_cast<uint64_t> (targetDelay * 1e9);
 }
 
 void
@@ -121,28 +155,12 @@ TcpSwift::PktsAcked (Ptr<TcpSocketState> tcb, uint32_t packetsAcked, const Time
     }
 }
 
-void
-TcpSwift::SwiftUpdateCwndOnAck (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked)
+double
+TcpSwift::UpdateWindow (double cwnd, double delay, double targetDelay,
+                        uint32_t segmentsAcked, bool &decreased) const
 {
-  // On Receiving ACK:
-  // retransmit_cnt <-0
-  m_retransmitCount = 0;
-
-  // double measuredDelay = (tcb->m_maxDelay);
-  // measuredDelay = measuredDelay / 1e9; // Convert to seconds
-  // measuredDelay = std::min(measuredDelay, 0.0001); // Clamp at 0
-  double measuredDelay = m_rtt.GetSeconds();
-  // std::cout << "Measured delay: " << measuredDelay << std::endl;
-  double targetDelay = 0.0;
-  ComputeTargetDelay(tcb, targetDelay);
-
-  double cwnd = (double) tcb->GetCwndInSegments();
-  m_canDecrease = CanDecrease();
-
-  if (measuredDelay < targetDelay)
+  if (delay < targetDelay)
     {
-      // std::cout << "Increased Measured delay: " << measuredDelay << ", target delay: " << targetDelay << " Max Delay: " << tcb->m_maxDelay / 1e9  << std::endl;
-
       // Additive Increase
       if (cwnd >= 1.0)
         {
@@ -152,52 +170,119 @@ TcpSwift::SwiftUpdateCwndOnAck (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked)
         {
           cwnd += (m_ai * segmentsAcked);
         }
+    }
+  else if (m_canDecrease)
+    {
+      // Multiplicative Decrease (only if can_decrease)
+      double factor = (1.0 - 0.4 * (delay - targetDelay) / delay);
+      double lowerBound = (1.0 - m_maxMdf);
+      factor = std::max(factor, lowerBound);
+      cwnd = cwnd * factor;
+      decreased = true;
+    }
+  return cwnd;
+}
 
+void
+TcpSwift::SwiftUpdateCwndOnAck (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked)
+{
+  // On Receiving ACK:
+  // retransmit_cnt <-0
+  m_retransmitCount = 0;
+
+  // The stack (loss recovery, RTO) or a loss event changed cwnd behind our
+  // back: restart both windows from the current value
+  if (tcb->m_cWnd != m_cwndSet)
+    {
+      m_fabricCwnd = static_cast<double> (tcb->m_cWnd) / tcb->m_segmentSize;
+      m_endpointCwnd = m_fabricCwnd;
     }
-  else
+
+  // Decompose the raw per-ACK RTT sample (not the smoothed RTT) into the
+  // receiver host delay and the fabric delay
+  Time rtt = tcb->m_lastRtt.Get ();
+  if (rtt.IsZero ())
     {
-        // std::cout << "Decreased Measured delay: " << measuredDelay << ", target delay: " << targetDelay << " Max Delay: " << tcb->m_maxDelay / 1e9  << std::endl;
+      rtt = m_rtt;
+    }
+  m_endpointDelay = std::min (tcb->m_lastHostDelay, rtt);
+  m_fabricDelay = rtt - m_endpointDelay;
 
-      // Multiplicative Decrease (only if can_decrease)
-      if (m_canDecrease)
-        {
+  double fabricDelay = m_fabricDelay.GetSeconds ();
+  double endpointDelay = m_endpointDelay.GetSeconds ();
+  double targetDelay = 0.0;
+  ComputeTargetDelay(tcb, targetDelay);
 
-          double factor = (1.0 - 0.4 * (measuredDelay - targetDelay) / measuredDelay);
-          double lowerBound = (1.0 - m_maxMdf);
-          factor = std::max(factor, lowerBound);
-          cwnd = cwnd * factor;
+  m_canDecrease = CanDecrease();
 
-          // Perform MD once per RTT
-          m_tLastDecrease = Simulator::Now();
-        }
+  // A window that is not the limiting one may not grow more than one
+  // additive increment above the effective window
+  double maxCwnd = std::min (m_fabricCwnd, m_endpointCwnd) + m_ai;
+  bool decreased = false;
+  m_fabricCwnd = UpdateWindow (m_fabricCwnd, fabricDelay, targetDelay,
+                               segmentsAcked, decreased);
+  m_endpointCwnd = UpdateWindow (m_endpointCwnd, endpointDelay,
+                                 m_endpointTarget.GetSeconds (),
+                                 segmentsAcked, decreased);
+  m_fabricCwnd = std::max (std::min (m_fabricCwnd, maxCwnd), m_minCwnd);
+  m_endpointCwnd = std::max (std::min (m_endpointCwnd, maxCwnd), m_minCwnd);
+
+  if (decreased)
+    {
+      // Perform MD once per RTT
+      m_tLastDecrease = Simulator::Now();
     }
 
-  // After computing new cwnd:
-  double time = ns3::Simulator::Now().GetSeconds();
-
-  // Log to the corresponding file based on m_flowIndex.
-  // Ensure g_cwndFiles is accessible here. If not, you might need a global map or a static pointer.
-  if (!g_cwndFiles.is_open())
-  {
-    std::ostringstream fname;
-    fname << "./scratch/cwnd-flow" << m_flowIndex << ".dat";
-    g_cwndFiles.open(fname.str().c_str(), std::ios::out);
-  }
-  if (g_cwndFiles.is_open())
-  {
-    g_cwndFiles << time << " " << cwnd << " " << measuredDelay << " " << targetDelay << std::endl;
-  }
-
-  // std::cout << "Cwnd before AI: " << tcb->m_cWnd << " ";
-  // std::cout << "cwnd: " << cwnd << " segmentSize: " << tcb->m_segmentSize << " ";
-  uint32_t newCwnd = (uint32_t)(cwnd * (double)tcb->m_segmentSize);
-  // std::cout << "Cwnd after AIMD: " << newCwnd << std::endl;
-
-  tcb->m_cWnd = newCwnd;
+  SetCwnd (tcb, std::min (m_fabricCwnd, m_endpointCwnd));
+
+  TraceCongestionState (tcb, m_fabricDelay, Seconds (targetDelay));
 
   tcb->m_maxDelay = 0.0;
 }
 
+double
+TcpSwift::EffectiveCwnd (Ptr<const TcpSocketState> tcb) const
+{
+  if (tcb->m_cWnd != m_cwndSet)
+    {
+      return static_cast<double> (tcb->m_cWnd) / tcb->m_segmentSize;
+    }
+  return std::min (m_fabricCwnd, m_endpointCwnd);
+}
+
+void
+TcpSwift::SetCwnd (Ptr<TcpSocketState> tcb, double cwnd)
+{
+  if (cwnd < 1.0)
+    {
+      // Keep one segment in the window, but send it only every RTT/cwnd
+      Time rtt = m_rtt.IsZero () ? tcb->m_srtt.Get () : m_rtt;
+      if (rtt.IsZero ())
+        {
+          // No smoothed RTT yet: use the minimum RTT, or the initial
+          // estimate of the RTT estimators before any sample
+          rtt = tcb->m_minRtt != Time::Max () ? tcb->m_minRtt : m_initialRtt;
+        }
+      tcb->m_cWnd = tcb->m_segmentSize;
+      tcb->m_pacingGap = Seconds (rtt.GetSeconds () / cwnd);
+    }
+  else
+    {
+      tcb->m_cWnd = static_cast<uint32_t> (cwnd * tcb->m_segmentSize);
+      tcb->m_pacingGap = Seconds (0);
+    }
+  m_cwndSet = tcb->m_cWnd;
+}
+
+void
+TcpSwift::DecreaseWindows (Ptr<TcpSocketState> tcb, double cwnd)
+{
+  m_fabricCwnd = std::max (cwnd, m_minCwnd);
+  m_endpointCwnd = m_fabricCwnd;
+  SetCwnd (tcb, m_fabricCwnd);
+  m_tLastDecrease = Simulator::Now ();
+}
+
 void
 TcpSwift::IncreaseWindow (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked)
 {
@@ -232,47 +317,25 @@ TcpSwift::CwndEvent (Ptr<TcpSocketState> tcb, const TcpSocketState::TcpCAEvent_t
 
   if (event == TcpSocketState::CA_EVENT_LOSS)
     {
-      std::cout << "Loss event detected" << std::endl;
+      NS_LOG_INFO ("Loss event detected");
       // This typically corresponds to a retransmission timeout or a fast loss detection
       m_retransmitCount += 1;
 
       if (m_retransmitCount >= m_retxResetThreshold)
         {
-          tcb->m_cWnd = MinCwnd(tcb);
+          DecreaseWindows (tcb, m_minCwnd);
         }
       else
         {
           if (m_canDecrease)
             {
-              double cwnd = (double) tcb->GetCwndInSegments();
-              cwnd *= (1.0 - m_maxMdf);
-              tcb->m_cWnd = std::max<uint32_t>(1, (uint32_t) cwnd) * tcb->m_segmentSize;
-
-              m_tLastDecrease = Simulator::Now();
+              DecreaseWindows (tcb, EffectiveCwnd (tcb) * (1.0 - m_maxMdf));
             }
         }
 
-      double time = ns3::Simulator::Now().GetSeconds();
-      double cwnd = (double) tcb->GetCwndInSegments();
-
-      double measuredDelay = m_rtt.GetSeconds();
-      // std::cout << "Measured delay: " << measuredDelay << std::endl;
       double targetDelay = 0.0;
       ComputeTargetDelay(tcb, targetDelay);
-
-      // Log to the corresponding file based on m_flowIndex.
-      // Ensure g_cwndFiles is accessible here. If not, you might need a global map or a static pointer.
-      if (!g_cwndFiles.is_open())
-      {
-        std::ostringstream fname;
-        fname << "./scratch/cwnd-flow" << m_flowIndex << ".dat";
-        g_cwndFiles.open(fname.str().c_str(), std::ios::out);
-      }
-
-      if (g_cwndFiles.is_open())
-      {
-        g_cwndFiles << time << " " << cwnd << " " << measuredDelay << " " << targetDelay << std::endl;
-      }
+      TraceCongestionState (tcb, m_rtt, Seconds (targetDelay));
     }
   // If ECN or other events are defined, handle them similarly.
 }
@@ -296,31 +359,11 @@ TcpSwift::CongestionStateSet (Ptr<TcpSocketState> tcb, const TcpSocketState::Tcp
       m_canDecrease = CanDecrease();
       if (m_canDecrease)
         {
-          double cwnd = (double) tcb->GetCwndInSegments();
-          cwnd *= (1.0 - m_maxMdf);
-          tcb->m_cWnd = std::max<uint32_t>(1, (uint32_t) cwnd) * tcb->m_segmentSize;
+          DecreaseWindows (tcb, EffectiveCwnd (tcb) * (1.0 - m_maxMdf));
 
-          m_tLastDecrease = Simulator::Now();
-
-          // After computing new cwnd:
-          double time = ns3::Simulator::Now().GetSeconds();
-          double measuredDelay = m_rtt.GetSeconds();
-          // std::cout << "Measured delay: " << measuredDelay << std::endl;
           double targetDelay = 0.0;
           ComputeTargetDelay(tcb, targetDelay);
-
-          // Log to the corresponding file based on m_flowIndex.
-          // Ensure g_cwndFiles is accessible here. If not, you might need a global map or a static pointer.
-          if (!g_cwndFiles.is_open())
-          {
-            std::ostringstream fname;
-            fname << "./scratch/cwnd-flow" << m_flowIndex << ".dat";
-            g_cwndFiles.open(fname.str().c_str(), std::ios::out);
-          }
-          if (g_cwndFiles.is_open())
-          {
-            g_cwndFiles << time << " " << cwnd << " " << measuredDelay << " " << targetDelay << std::endl;
-          }
+          TraceCongestionState (tcb, m_rtt, Seconds (targetDelay));
         }
     }
     
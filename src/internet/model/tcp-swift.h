@@ -9,7 +9,29 @@
 
 namespace ns3 {
 
-
+/**
+ * \ingroup congestionOps
+ *
+ * \brief Swift delay-based congestion control
+ *
+ * Swift keeps two congestion windows, and the effective window is the
+ * minimum of the two:
+ *   - the fabric window reacts to the fabric delay, i.e. the raw RTT
+ *     sample of the last ACK minus the receiver host delay, compared
+ *     against a target scaled by the flow window and the hop count;
+ *   - the endpoint window reacts to the receiver host delay, echoed by
+ *     the peer in the TcpOptionHostDelay option (enable the
+ *     TcpSocketBase::HostDelay attribute on both ends), compared against
+ *     a fixed endpoint target.
+ *
+ * When an ACK does not echo the host delay, e.g. because the peer does
+ * not support the option, its whole RTT sample is attributed to the fabric.
+ *
+ * Both windows may fall below one segment, down to the MinCwnd attribute.
+ * The socket then keeps one segment in the window but sends it only every
+ * RTT/cwnd, through the pacing timer (TcpSocketState::m_pacingGap), so
+ * that large incasts do not overflow the switch buffers.
+ */
 class TcpSwift : public TcpCongestionOps
 {
 public:
@@ -27,29 +49,63 @@ public:
   virtual void CongestionStateSet (Ptr<TcpSocketState> tcb, const TcpSocketState::TcpCongState_t newState) override;
   virtual void CwndEvent (Ptr<TcpSocketState> tcb, const TcpSocketState::TcpCAEvent_t event) override;
   virtual void Init (Ptr<TcpSocketState> tcb) override;
-  void SetFlowIndex (uint32_t flowIndex) { m_flowIndex = flowIndex; }
-  uint32_t GetFlowIndex () const { return m_flowIndex; }
+  /**
+   * \brief Set the flow id written in the congestion control trace
+   * \param flowIndex the flow id
+   */
+  void SetFlowIndex (uint32_t flowIndex) { m_ccTraceFlowId = flowIndex; }
+  /**
+   * \return the flow id written in the congestion control trace
+   */
+  uint32_t GetFlowIndex () const { return m_ccTraceFlowId; }
 
 private:
   void ComputeTargetDelay (Ptr<TcpSocketState> tcb, double &targetDelay);
   void SwiftUpdateCwndOnAck (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked);
+  double UpdateWindow (double cwnd, double delay, double targetDelay,
+                       uint32_t segmentsAcked, bool &decreased) const;
   bool CanDecrease ();
-  uint32_t m_flowIndex;
+  /**
+   * \brief Write a window, in segments, in the tcb
+   *
+   * A window below one segment is written as one segment, and the
+   * segments are paced one RTT/cwnd apart through the pacing gap.
+   *
+   * \param tcb internal congestion state
+   * \param cwnd the window, in segments
+   */
+  void SetCwnd (Ptr<TcpSocketState> tcb, double cwnd);
+  /**
+   * \brief Decrease both windows to the same value, on a loss
+   * \param tcb internal congestion state
+   * \param cwnd the new window, in segments, before the MinCwnd clamp
+   */
+  void DecreaseWindows (Ptr<TcpSocketState> tcb, double cwnd);
+  /**
+   * \param tcb internal congestion state
+   * \return the effective window, in segments, possibly below one
+   */
+  double EffectiveCwnd (Ptr<const TcpSocketState> tcb) const;
 
   double m_ai;          // Additive increment
   double m_beta;        // Multiplicative decrease factor (for delay-based MD)
   double m_maxMdf;      // Maximum multiplicative decrease factor
-  Time m_baseTarget;    // Base target delay
+  double m_minCwnd;     // Minimum window, in segments (may be below one)
+  Time m_baseTarget;    // Base target delay (fabric)
+  Time m_endpointTarget; // Target for the receiver host delay
   uint32_t m_retxResetThreshold; 
   uint32_t m_retransmitCount;
-  std::ofstream g_cwndFiles;
   double m_alpha;
   Time m_rtt;           
+  Time m_initialRtt;    // RTT assumed before any RTT sample
   bool m_canDecrease;   
   Time m_tLastDecrease; // Last time we performed MD
+  double m_fabricCwnd;   // Fabric congestion window, in segments
+  double m_endpointCwnd; // Endpoint congestion window, in segments
+  uint32_t m_cwndSet;    // Last cwnd (bytes) we wrote in the tcb
+  Time m_fabricDelay;    // Fabric delay of the last ACK
+  Time m_endpointDelay;  // Endpoint delay of the last ACK
   
-  // Minimum cwnd in segments, usually 1 segment
-  uint32_t MinCwnd (Ptr<TcpSocketState> tcb) const { return tcb->m_segmentSize; }
 };
 
 } // namespace ns3
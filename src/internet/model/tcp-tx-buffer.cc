@@ -50,7 +50,9 @@ TcpTxBuffer::TcpTxBuffer(uint32_t n)
     : m_maxBuffer(32768),
       m_size(0),
       m_sentSize(0),
-      m_firstByteSeq(n)
+      m_firstByteSeq(n),
+      m_lostUpTo(n),
+      m_nextSegFrom(n)
 {
     m_rWndCallback = MakeNullCallback<uint32_t>();
 }
@@ -164,7 +166,8 @@ TcpTxBuffer::SetHeadSequence(const SequenceNumber32& seq)
     // if you change the head with data already sent, something bad will happen
     NS_ASSERT(m_sentList.empty());
     m_sackSeen = false;
-    m_highestSack = std::make_pair(m_sentList.end(), SequenceNumber32(0));
+    m_highestSack = SequenceNumber32(0);
+    ResetScoreboardHints();
 }
 
 bool
@@ -299,13 +302,13 @@ TcpTxBuffer::GetTransmittedSegment(uint32_t numBytes, const SequenceNumber32& se
     NS_ASSERT(numBytes <= m_sentSize);
     NS_ASSERT(!m_sentList.empty());
 
-    auto it = m_sentList.begin();
+    auto it = FindSentItem(seq);
     bool listEdited = false;
     uint32_t s = numBytes;
 
     // Avoid to merge different packet for this retransmission if flags are
     // different.
-    for (; it != m_sentList.end(); ++it)
+    if (it != m_sentList.end())
     {
         if ((*it)->m_startSeq == seq)
         {
@@ -329,7 +332,6 @@ TcpTxBuffer::GetTransmittedSegment(uint32_t numBytes, const SequenceNumber32& se
             {
                 s = std::min(s, (*it)->m_packet->GetSize());
             }
-            break;
         }
     }
 
@@ -344,26 +346,21 @@ TcpTxBuffer::GetTransmittedSegment(uint32_t numBytes, const SequenceNumber32& se
     return item;
 }
 
-std::pair<TcpTxBuffer::PacketList::const_iterator, SequenceNumber32>
-TcpTxBuffer::FindHighestSacked() const
+TcpTxBuffer::PacketList::const_iterator
+TcpTxBuffer::FindSentItem(const SequenceNumber32& seq) const
 {
-    NS_LOG_FUNCTION(this);
-
-    SequenceNumber32 beginOfCurrentPacket = m_firstByteSeq;
-
-    auto ret = std::make_pair(m_sentList.end(), SequenceNumber32(0));
-
-    for (auto it = m_sentList.begin(); it != m_sentList.end(); ++it)
-    {
-        const TcpTxItem* item = *it;
-        if (item->m_sacked)
-        {
-            ret = std::make_pair(it, beginOfCurrentPacket);
-        }
-        beginOfCurrentPacket += item->m_packet->GetSize();
-    }
+    return std::partition_point(m_sentList.begin(),
+                                m_sentList.end(),
+                                [&seq](const TcpTxItem* item) {
+                                    return item->m_startSeq + item->m_packet->GetSize() <= seq;
+                                });
+}
 
-    return ret;
+void
+TcpTxBuffer::ResetScoreboardHints() const
+{
+    m_lostUpTo = m_firstByteSeq;
+    m_nextSegFrom = m_firstByteSeq;
 }
 
 void
@@ -428,11 +425,21 @@ TcpTxBuffer::GetPacketFromList(PacketList& list,
     auto it = list.begin();
     SequenceNumber32 beginOfCurrentPacket = listStartFrom;
 
+    if (&list == &m_sentList && !list.empty())
+    {
+        // The start of the sent items is known: skip the items before seq
+        it += FindSentItem(seq) - m_sentList.begin();
+        if (it != list.end())
+        {
+            beginOfCurrentPacket = (*it)->m_startSeq;
+        }
+    }
+
     while (it != list.end())
     {
         currentItem = *it;
         currentPacket = currentItem->m_packet;
-        NS_ASSERT_MSG(list != m_sentList || currentItem->m_startSeq >= m_firstByteSeq,
+        NS_ASSERT_MSG(&list != &m_sentList || currentItem->m_startSeq >= m_firstByteSeq,
                       "start: " << m_firstByteSeq
                                 << " currentItem start: " << currentItem->m_startSeq);
 
@@ -589,6 +596,7 @@ TcpTxBuffer::MergeItems(TcpTxItem* t1, TcpTxItem* t2) const
     // be updated in MarkTransmittedSegment.
     if (t1->m_retrans != t2->m_retrans)
     {
+        m_nextSegFrom = m_firstByteSeq;
         if (t1->m_retrans)
         {
             auto self = const_cast<TcpTxBuffer*>(this);
@@ -640,16 +648,14 @@ bool
 TcpTxBuffer::IsRetransmittedDataAcked(const SequenceNumber32& ack) const
 {
     NS_LOG_FUNCTION(this);
-    for (const auto& it : m_sentList)
+    auto it = FindSentItem(ack - 1);
+    if (it == m_sentList.end())
     {
-        TcpTxItem* item = it;
-        Ptr<Packet> p = item->m_packet;
-        if (item->m_startSeq + p->GetSize() == ack && !item->m_sacked && item->m_retrans)
-        {
-            return true;
-        }
+        return false;
     }
-    return false;
+    TcpTxItem* item = *it;
+    return item->m_startSeq + item->m_packet->GetSize() == ack && !item->m_sacked &&
+           item->m_retrans;
 }
 
 void
@@ -755,10 +761,20 @@ TcpTxBuffer::DiscardUpTo(const SequenceNumber32& seq, const Callback<void, TcpTx
                                               << " this is the result: " << *this);
     }
 
-    if (m_highestSack.second <= m_firstByteSeq)
+    if (m_highestSack <= m_firstByteSeq)
     {
         m_sackSeen = false;
-        m_highestSack = std::make_pair(m_sentList.end(), SequenceNumber32(0));
+        m_highestSack = SequenceNumber32(0);
+    }
+    // Keep the hints inside the sent list, so that they are never compared
+    // with sequence numbers too far away
+    if (m_lostUpTo < m_firstByteSeq)
+    {
+        m_lostUpTo = m_firstByteSeq;
+    }
+    if (m_nextSegFrom < m_firstByteSeq)
+    {
+        m_nextSegFrom = m_firstByteSeq;
     }
 
     NS_LOG_DEBUG("Discarded up to " << seq << " lost: " << m_lostOut << " retrans: " << m_retrans
@@ -779,15 +795,20 @@ TcpTxBuffer::Update(const TcpOptionSack::SackList& list, const Callback<void, Tc
 
     for (auto option_it = list.begin(); option_it != list.end(); ++option_it)
     {
-        auto item_it = m_sentList.begin();
-        SequenceNumber32 beginOfCurrentPacket = m_firstByteSeq;
-
         if (m_firstByteSeq + m_sentSize < (*option_it).first)
         {
             NS_LOG_INFO("Not updating scoreboard, the option block is outside the sent list");
             return bytesSacked;
         }
 
+        // Start from the item which holds the beginning of the block
+        auto item_it = FindSentItem((*option_it).first);
+        if (item_it == m_sentList.end())
+        {
+            continue;
+        }
+        SequenceNumber32 beginOfCurrentPacket = (*item_it)->m_startSeq;
+
         while (item_it != m_sentList.end())
         {
             uint32_t pktSize = (*item_it)->m_packet->GetSize();
@@ -819,17 +840,16 @@ TcpTxBuffer::Update(const TcpOptionSack::SackList& list, const Callback<void, Tc
                     m_sackedOut += (*item_it)->m_packet->GetSize();
                     bytesSacked += (*item_it)->m_packet->GetSize();
 
-                    if (m_highestSack.first == m_sentList.end() ||
-                        m_highestSack.second <= beginOfCurrentPacket + pktSize)
+                    if (!m_sackSeen || m_highestSack <= beginOfCurrentPacket + pktSize)
                     {
                         m_sackSeen = true;
-                        m_highestSack = std::make_pair(item_it, beginOfCurrentPacket);
+                        m_highestSack = beginOfCurrentPacket;
                     }
 
                     NS_LOG_INFO("Received block "
                                 << *option_it << ", checking sentList for block " << *(*item_it)
                                 << ", found in the sackboard, sacking, current highSack: "
-                                << m_highestSack.second);
+                                << m_highestSack);
 
                     if (!sackedCb.IsNull())
                     {
@@ -852,7 +872,7 @@ TcpTxBuffer::Update(const TcpOptionSack::SackList& list, const Callback<void, Tc
 
     if (bytesSacked > 0)
     {
-        NS_ASSERT_MSG(m_highestSack.first != m_sentList.end(), "Buffer status: " << *this);
+        NS_ASSERT_MSG(m_sackSeen, "Buffer status: " << *this);
         UpdateLostCount();
     }
 
@@ -868,22 +888,23 @@ void
 TcpTxBuffer::UpdateLostCount()
 {
     NS_LOG_FUNCTION(this);
+    NS_ASSERT(m_sackSeen);
     uint32_t sacked = 0;
-    SequenceNumber32 beginOfCurrentPacket = m_highestSack.second;
-    if (m_highestSack.first == m_sentList.end())
-    {
-        NS_LOG_INFO("Status before the update: " << *this
-                                                 << ", will start from the latest sent item");
-    }
-    else
-    {
-        NS_LOG_INFO("Status before the update: " << *this << ", will start from item "
-                                                 << *(*m_highestSack.first));
-    }
-
-    for (auto it = m_highestSack.first; it != m_sentList.begin(); --it)
+    auto highest = FindSentItem(m_highestSack);
+    NS_ASSERT(highest != m_sentList.end() && (*highest)->m_sacked);
+    NS_LOG_INFO("Status before the update: " << *this << ", will start from item "
+                                             << *(*highest) << " down to " << m_lostUpTo);
+
+    // The items below m_lostUpTo are all lost or sacked already, and so is
+    // the head when the loop stops there
+    SequenceNumber32 lostUpTo = m_lostUpTo;
+    for (auto it = highest; it != m_sentList.begin(); --it)
     {
         TcpTxItem* item = *it;
+        if (item->m_startSeq < lostUpTo)
+        {
+            break;
+        }
         if (item->m_sacked)
         {
             sacked++;
@@ -896,8 +917,12 @@ TcpTxBuffer::UpdateLostCount()
                 item->m_lost = true;
                 m_lostOut += item->m_packet->GetSize();
             }
+            if (m_lostUpTo < item->m_startSeq + item->m_packet->GetSize())
+            {
+                // Every item from here down to the head is now lost or sacked
+                m_lostUpTo = item->m_startSeq + item->m_packet->GetSize();
+            }
         }
-        beginOfCurrentPacket -= item->m_packet->GetSize();
     }
 
     if (sacked >= m_dupAckThresh)
@@ -918,17 +943,15 @@ TcpTxBuffer::IsLost(const SequenceNumber32& seq) const
 {
     NS_LOG_FUNCTION(this << seq);
 
-    if (seq >= m_highestSack.second)
+    if (seq >= m_highestSack)
     {
         return false;
     }
 
-    // In theory, using a map and hints when inserting elements can improve
-    // performance
-    for (auto it = m_sentList.begin(); it != m_sentList.end(); ++it)
+    auto it = FindSentItem(seq);
+    if (it != m_sentList.end())
     {
-        // Search for the right iterator before calling IsLost()
-        if ((*it)->m_startSeq <= seq && seq < (*it)->m_startSeq + (*it)->m_packet->GetSize())
+        if ((*it)->m_startSeq <= seq)
         {
             if ((*it)->m_lost)
             {
@@ -968,15 +991,31 @@ TcpTxBuffer::NextSeg(SequenceNumber32* seq, SequenceNumber32* seqHigh, bool isRe
     TcpTxItem* item;
     SequenceNumber32 seqPerRule3;
     bool isSeqPerRule3Valid = false;
-    SequenceNumber32 beginOfCurrentPkt = m_firstByteSeq;
+    bool advanceHint = true;
 
-    for (auto it = m_sentList.begin(); it != m_sentList.end(); ++it)
+    // Skip the items which are all retransmitted or sacked: none of the rules
+    // below can select them
+    for (auto it = FindSentItem(m_nextSegFrom); it != m_sentList.end(); ++it)
     {
         item = *it;
+        SequenceNumber32 beginOfCurrentPkt = item->m_startSeq;
+
+        if (advanceHint && (item->m_retrans || item->m_sacked))
+        {
+            m_nextSegFrom = beginOfCurrentPkt + item->m_packet->GetSize();
+            continue;
+        }
+        advanceHint = false;
+
+        if (m_sackSeen && item->m_startSeq >= m_highestSack)
+        {
+            // Neither rule (1) nor rule (3) applies above the highest SACK
+            break;
+        }
 
         // Condition 1.a , 1.b , and 1.c
         if (!item->m_retrans && !item->m_sacked &&
-            ((m_sackSeen && item->m_startSeq < m_highestSack.second) || !m_sackSeen))
+            ((m_sackSeen && item->m_startSeq < m_highestSack) || !m_sackSeen))
         {
             if (item->m_lost)
             {
@@ -992,9 +1031,6 @@ TcpTxBuffer::NextSeg(SequenceNumber32* seq, SequenceNumber32* seqHigh, bool isRe
                 seqPerRule3 = beginOfCurrentPkt;
             }
         }
-
-        // Nothing found, iterate
-        beginOfCurrentPkt += item->m_packet->GetSize();
     }
 
     /* (2) If no sequence number 'S2' per rule (1) exists but there
@@ -1173,7 +1209,7 @@ TcpTxBuffer::IsLostRFC(const SequenceNumber32& seq, const PacketList::const_iter
             }
         }
 
-        if (beginOfCurrentPacket >= m_highestSack.second)
+        if (beginOfCurrentPacket >= m_highestSack)
         {
             if (item->m_lost && !item->m_retrans)
             {
@@ -1186,11 +1222,8 @@ TcpTxBuffer::IsLostRFC(const SequenceNumber32& seq, const PacketList::const_iter
 
         beginOfCurrentPacket += current->GetSize();
     }
-    if (it == m_highestSack.first)
-    {
-        NS_LOG_INFO("seq=" << seq << " is not lost because there are no sacked segment ahead "
-                           << m_highestSack.second);
-    }
+    NS_LOG_INFO("seq=" << seq << " is not lost because there are no sacked segment ahead "
+                       << m_highestSack);
     return false;
 }
 
@@ -1205,8 +1238,9 @@ TcpTxBuffer::ResetRenoSack()
         (*it)->m_sacked = false;
     }
 
-    m_highestSack = std::make_pair(m_sentList.end(), SequenceNumber32(0));
+    m_highestSack = SequenceNumber32(0);
     m_sackSeen = false;
+    ResetScoreboardHints();
 }
 
 void
@@ -1236,7 +1270,8 @@ TcpTxBuffer::ResetSentList()
     m_retrans = 0;
     m_sackedOut = 0;
     m_sackSeen = false;
-    m_highestSack = std::make_pair(m_sentList.end(), SequenceNumber32(0));
+    m_highestSack = SequenceNumber32(0);
+    ResetScoreboardHints();
 }
 
 void
@@ -1254,6 +1289,7 @@ TcpTxBuffer::ResetLastSegmentSent()
             m_retrans -= item->m_packet->GetSize();
         }
         m_appList.insert(m_appList.begin(), item);
+        ResetScoreboardHints();
     }
     ConsistencyCheck();
 }
@@ -1269,12 +1305,14 @@ TcpTxBuffer::SetSentListLost(bool resetSack)
         m_sackedOut = 0;
         m_lostOut = m_sentSize;
         m_sackSeen = false;
-        m_highestSack = std::make_pair(m_sentList.end(), SequenceNumber32(0));
+        m_highestSack = SequenceNumber32(0);
     }
     else
     {
         m_lostOut = 0;
     }
+    // The items become lost or sacked, but not retransmitted anymore
+    m_nextSegFrom = m_firstByteSeq;
 
     for (auto it = m_sentList.begin(); it != m_sentList.end(); ++it)
     {
@@ -1333,6 +1371,7 @@ TcpTxBuffer::DeleteRetransmittedFlagFromHead()
     {
         m_sentList.front()->m_retrans = false;
         m_retrans -= m_sentList.front()->m_packet->GetSize();
+        m_nextSegFrom = m_firstByteSeq;
     }
     ConsistencyCheck();
 }
@@ -1362,6 +1401,8 @@ TcpTxBuffer::MarkHeadAsLost()
             m_sentList.front()->m_lost = true;
             m_lostOut += m_sentList.front()->m_packet->GetSize();
         }
+        // The head is lost, but not retransmitted anymore
+        m_nextSegFrom = m_firstByteSeq;
     }
     ConsistencyCheck();
 }
@@ -1397,7 +1438,7 @@ TcpTxBuffer::AddRenoSack()
         (*it)->m_sacked = true;
         m_sackedOut += (*it)->m_packet->GetSize();
         m_sackSeen = true;
-        m_highestSack = std::make_pair(it, (*it)->m_startSeq);
+        m_highestSack = (*it)->m_startSeq;
         NS_LOG_INFO("Added a Reno SACK, status: " << *this);
     }
     else
@@ -1422,9 +1463,14 @@ TcpTxBuffer::ConsistencyCheck() const
     uint32_t sacked = 0;
     uint32_t lost = 0;
     uint32_t retrans = 0;
+    SequenceNumber32 beginOfCurrentPacket = m_firstByteSeq;
 
     for (auto it = m_sentList.begin(); it != m_sentList.end(); ++it)
     {
+        // FindSentItem() relies on the sent items being contiguous
+        NS_ASSERT_MSG((*it)->m_startSeq == beginOfCurrentPacket,
+                      "Item " << *(*it) << " should start at " << beginOfCurrentPacket);
+        beginOfCurrentPacket += (*it)->m_packet->GetSize();
         if ((*it)->m_sacked)
         {
             sacked += (*it)->m_packet->GetSize();
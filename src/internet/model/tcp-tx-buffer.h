@@ -17,6 +17,8 @@
 #include "ns3/sequence-number.h"
 #include "ns3/traced-value.h"
 
+#include <deque>
+
 namespace ns3
 {
 class Packet;
@@ -400,7 +402,12 @@ class TcpTxBuffer : public Object
   private:
     friend std::ostream& operator<<(std::ostream& os, const TcpTxBuffer& tcpTxBuf);
 
-    typedef std::list<TcpTxItem*> PacketList; //!< container for data stored in the buffer
+    /**
+     * Container for data stored in the buffer.  The items of the sent list
+     * are kept in sequence order, with contiguous m_startSeq, so that the
+     * item holding a sequence number is found by a binary search.
+     */
+    typedef std::deque<TcpTxItem*> PacketList;
 
     /**
      * \brief Update the lost count
@@ -417,8 +424,9 @@ class TcpTxBuffer : public Object
      * The {New}Reno cases, for now, are managed in TcpSocketBase through the
      * call to MarkHeadAsLost.
      * This function is, therefore, called after a SACK option has been received,
-     * and updates the lost count. It can be probably optimized by not walking
-     * the entire list, but a subset.
+     * and updates the lost count. It walks the sent list down from the highest
+     * SACKed item, and stops at m_lostUpTo: the items below it were marked
+     * lost (or were SACKed) by a previous call.
      *
      */
     void UpdateLostCount();
@@ -586,10 +594,22 @@ class TcpTxBuffer : public Object
     void ConsistencyCheck() const;
 
     /**
-     * \brief Find the highest SACK byte
-     * \return a pair with the highest byte and an iterator inside m_sentList
+     * \brief Find the sent item which holds a sequence number
+     *
+     * \param seq Sequence number
+     * \return the first item of m_sentList which ends after seq, i.e., the
+     * item that holds seq if seq is in the sent list
+     */
+    PacketList::const_iterator FindSentItem(const SequenceNumber32& seq) const;
+
+    /**
+     * \brief Forget the items which UpdateLostCount() and NextSeg() skip
+     *
+     * To be called whenever the sacked flags of the sent items are cleared,
+     * or sent items are moved back to the application list.  When only the
+     * retransmitted flags are cleared, resetting m_nextSegFrom is enough.
      */
-    std::pair<TcpTxBuffer::PacketList::const_iterator, SequenceNumber32> FindHighestSacked() const;
+    void ResetScoreboardHints() const;
 
     PacketList m_appList;              //!< Buffer for application data
     PacketList m_sentList;             //!< Buffer for sent (but not acked) data
@@ -600,7 +620,17 @@ class TcpTxBuffer : public Object
 
     TracedValue<SequenceNumber32>
         m_firstByteSeq; //!< Sequence number of the first byte in data (SND.UNA)
-    std::pair<PacketList::const_iterator, SequenceNumber32> m_highestSack; //!< Highest SACK byte
+    SequenceNumber32 m_highestSack{0}; //!< Start of the highest SACKed item, if m_sackSeen
+    /**
+     * The sent items starting before this sequence number are all lost or
+     * SACKed: UpdateLostCount() does not walk them again.
+     */
+    mutable SequenceNumber32 m_lostUpTo{0};
+    /**
+     * The sent items starting before this sequence number are all
+     * retransmitted or SACKed: NextSeg() does not walk them again.
+     */
+    mutable SequenceNumber32 m_nextSegFrom{0};
 
     uint32_t m_lostOut{0};   //!< Number of lost bytes
     uint32_t m_sackedOut{0}; //!< Number of sacked bytes
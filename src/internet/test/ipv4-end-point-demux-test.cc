@@ -0,0 +1,169 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "ns3/ipv4-end-point-demux.h"
+#include "ns3/ipv4-end-point.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/test.h"
+
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Check the lookups of the Ipv4EndPointDemux, with wildcards, and
+ * after the peer of an endpoint changes.
+ */
+class Ipv4EndPointDemuxLookupTest : public TestCase
+{
+  public:
+    Ipv4EndPointDemuxLookupTest();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Look up the endpoint of a packet received on the test interface.
+     *
+     * \param demux the demux
+     * \param daddr destination address of the packet
+     * \param dport destination port of the packet
+     * \param saddr source address of the packet
+     * \param sport source port of the packet
+     * \return the endpoint found, or nullptr
+     */
+    Ipv4EndPoint* Lookup(Ipv4EndPointDemux& demux,
+                         Ipv4Address daddr,
+                         uint16_t dport,
+                         Ipv4Address saddr,
+                         uint16_t sport);
+
+    Ptr<Ipv4Interface> m_interface; //!< Incoming interface of the packets
+};
+
+Ipv4EndPointDemuxLookupTest::Ipv4EndPointDemuxLookupTest()
+    : TestCase("Check the lookups of the Ipv4EndPointDemux")
+{
+}
+
+Ipv4EndPoint*
+Ipv4EndPointDemuxLookupTest::Lookup(Ipv4EndPointDemux& demux,
+                                    Ipv4Address daddr,
+                                    uint16_t dport,
+                                    Ipv4Address saddr,
+                                    uint16_t sport)
+{
+    Ipv4EndPointDemux::EndPoints endPoints = demux.Lookup(daddr, dport, saddr, sport, m_interface);
+    return endPoints.empty() ? nullptr : endPoints.front();
+}
+
+void
+Ipv4EndPointDemuxLookupTest::DoRun()
+{
+    m_interface = CreateObject<Ipv4Interface>();
+    Ipv4Address local("10.0.0.1");
+    Ipv4Address peer("10.0.0.2");
+    Ipv4Address other("10.0.0.3");
+
+    Ipv4EndPointDemux demux;
+    Ipv4EndPoint* listener = demux.Allocate(nullptr, 80);
+    Ipv4EndPoint* bound = demux.Allocate(nullptr, local, 81);
+    NS_TEST_ASSERT_MSG_NE(listener, nullptr, "Allocation failed");
+    NS_TEST_ASSERT_MSG_NE(bound, nullptr, "Allocation failed");
+    NS_TEST_EXPECT_MSG_EQ(demux.Allocate(nullptr, local, 81), nullptr, "Duplicated endpoint");
+
+    // Many connections accepted on the same local port
+    std::vector<Ipv4EndPoint*> connections;
+    for (uint16_t port = 5000; port < 5100; port++)
+    {
+        connections.push_back(demux.Allocate(nullptr, local, 80, peer, port));
+        NS_TEST_ASSERT_MSG_NE(connections.back(), nullptr, "Allocation failed");
+    }
+    NS_TEST_EXPECT_MSG_EQ(demux.Allocate(nullptr, local, 80, peer, 5042),
+                          nullptr,
+                          "Duplicated endpoint");
+    NS_TEST_EXPECT_MSG_EQ(demux.GetAllEndPoints().size(), 102, "Wrong number of endpoints");
+
+    for (uint16_t i = 0; i < connections.size(); i++)
+    {
+        NS_TEST_EXPECT_MSG_EQ(Lookup(demux, local, 80, peer, 5000 + i),
+                              connections[i],
+                              "The connection was not found");
+    }
+    NS_TEST_EXPECT_MSG_EQ(Lookup(demux, local, 80, other, 5000),
+                          listener,
+                          "A new peer must reach the listener");
+    NS_TEST_EXPECT_MSG_EQ(Lookup(demux, local, 81, other, 5000),
+                          bound,
+                          "A new peer must reach the bound listener");
+    NS_TEST_EXPECT_MSG_EQ(Lookup(demux, other, 81, peer, 5000),
+                          nullptr,
+                          "The local address of the bound listener must match");
+    NS_TEST_EXPECT_MSG_EQ(Lookup(demux, local, 82, peer, 5000), nullptr, "No endpoint on the port");
+
+    NS_TEST_EXPECT_MSG_EQ(demux.SimpleLookup(local, 80, peer, 5001),
+                          connections[1],
+                          "The connection was not found");
+    NS_TEST_EXPECT_MSG_EQ(demux.SimpleLookup(local, 81, other, 5001),
+                          bound,
+                          "A new peer must reach the bound listener");
+
+    // An endpoint whose peer is set after its allocation, as by
+    // TcpSocketBase::Connect, is found under its new peer
+    Ipv4EndPoint* client = demux.Allocate(local);
+    NS_TEST_ASSERT_MSG_NE(client, nullptr, "Allocation failed");
+    uint16_t clientPort = client->GetLocalPort();
+    NS_TEST_EXPECT_MSG_EQ(demux.LookupPortLocal(clientPort), true, "The port is not in use");
+    NS_TEST_EXPECT_MSG_EQ(Lookup(demux, local, clientPort, other, 80),
+                          client,
+                          "The unconnected endpoint was not found");
+    client->SetPeer(other, 80);
+    NS_TEST_EXPECT_MSG_EQ(Lookup(demux, local, clientPort, other, 80),
+                          client,
+                          "The connected endpoint was not found");
+    NS_TEST_EXPECT_MSG_EQ(Lookup(demux, local, clientPort, peer, 80),
+                          nullptr,
+                          "The connected endpoint must only match its peer");
+
+    // Endpoints which can not receive are skipped, in favour of the listener
+    connections[7]->SetRxEnabled(false);
+    NS_TEST_EXPECT_MSG_EQ(Lookup(demux, local, 80, peer, 5007),
+                          listener,
+                          "A disabled endpoint was found");
+
+    // Deallocated endpoints are removed from the index
+    demux.DeAllocate(connections[3]);
+    NS_TEST_EXPECT_MSG_EQ(Lookup(demux, local, 80, peer, 5003),
+                          listener,
+                          "A deallocated endpoint was found");
+    NS_TEST_EXPECT_MSG_EQ(Lookup(demux, local, 80, peer, 5004),
+                          connections[4],
+                          "The connection was not found");
+    demux.DeAllocate(client);
+    NS_TEST_EXPECT_MSG_EQ(demux.LookupPortLocal(clientPort), false, "The port is still in use");
+    NS_TEST_EXPECT_MSG_EQ(demux.LookupPortLocal(80), true, "The port is not in use");
+    NS_TEST_EXPECT_MSG_EQ(demux.GetAllEndPoints().size(), 101, "Wrong number of endpoints");
+
+    m_interface = nullptr;
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Ipv4EndPointDemux TestSuite
+ */
+class Ipv4EndPointDemuxTestSuite : public TestSuite
+{
+  public:
+    Ipv4EndPointDemuxTestSuite()
+        : TestSuite("ipv4-end-point-demux", Type::UNIT)
+    {
+        AddTestCase(new Ipv4EndPointDemuxLookupTest, TestCase::Duration::QUICK);
+    }
+};
+
+static Ipv4EndPointDemuxTestSuite
+    g_ipv4EndPointDemuxTestSuite; //!< Static variable for test initialization
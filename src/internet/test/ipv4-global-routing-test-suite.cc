@@ -5,6 +5,8 @@
 #include "ns3/boolean.h"
 #include "ns3/bridge-helper.h"
 #include "ns3/config.h"
+#include "ns3/enum.h"
+#include "ns3/global-value.h"
 #include "ns3/inet-socket-address.h"
 #include "ns3/internet-stack-helper.h"
 #include "ns3/ipv4-address-helper.h"
@@ -26,10 +28,15 @@
 #include "ns3/simulator.h"
 #include "ns3/socket-factory.h"
 #include "ns3/string.h"
+#include "ns3/tcp-header.h"
 #include "ns3/test.h"
 #include "ns3/udp-socket-factory.h"
 #include "ns3/uinteger.h"
 
+#include <algorithm>
+#include <set>
+#include <sstream>
+#include <string>
 #include <vector>
 
 using namespace ns3;
@@ -1300,6 +1307,393 @@ Ipv4GlobalRoutingSlash32TestCase::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup internet-test
+ *
+ * \brief IPv4 GlobalRouting flow hash and flowlet ECMP test
+ */
+class Ipv4GlobalRoutingEcmpTestCase : public TestCase
+{
+  public:
+    Ipv4GlobalRoutingEcmpTestCase();
+
+  private:
+    void DoSetup() override;
+    void DoRun() override;
+
+    /**
+     * \brief Route a TCP segment from n0 to the stub address of n3.
+     * \param sourcePort TCP source port of the segment
+     * \return the output device of the route
+     */
+    Ptr<NetDevice> Route(uint16_t sourcePort);
+
+    /**
+     * \brief Route a UDP payload, without its header, from n0 to the stub
+     * address of n3, as the UDP sockets do.
+     * \param payload first byte of the payload
+     * \return the output device of the route
+     */
+    Ptr<NetDevice> RouteUdpPayload(uint8_t payload);
+
+    /**
+     * \brief Route a packet of a flow and record whether its route changed.
+     * \param sourcePort TCP source port of the flow
+     */
+    void RouteFlowlet(uint16_t sourcePort);
+
+    NodeContainer m_nodes;            //!< Nodes used in the test
+    Ptr<Ipv4GlobalRouting> m_routing; //!< Global routing of n0
+    Ptr<NetDevice> m_lastDevice;      //!< Output device of the last routed packet
+    uint32_t m_routeChanges{0};       //!< Number of route changes of the flow
+};
+
+Ipv4GlobalRoutingEcmpTestCase::Ipv4GlobalRoutingEcmpTestCase()
+    : TestCase("Global routing flow hash and flowlet ECMP")
+{
+}
+
+// Diamond topology, n3 owning a /32 stub address:
+//
+//     n0 ---- n1 ---- n3 (192.168.1.1/32)
+//      |               |
+//      +----- n2 ------+
+//
+void
+Ipv4GlobalRoutingEcmpTestCase::DoSetup()
+{
+    m_nodes.Create(4);
+
+    InternetStackHelper internet;
+    Ipv4GlobalRoutingHelper ipv4RoutingHelper;
+    internet.SetRoutingHelper(ipv4RoutingHelper);
+    internet.Install(m_nodes);
+
+    SimpleNetDeviceHelper devHelper;
+    devHelper.SetNetDevicePointToPointMode(true);
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.1.1.0", "255.255.255.252");
+    const uint32_t links[4][2] = {{0, 1}, {0, 2}, {1, 3}, {2, 3}};
+    for (const auto& link : links)
+    {
+        ipv4.Assign(devHelper.Install(NodeContainer(m_nodes.Get(link[0]), m_nodes.Get(link[1]))));
+        ipv4.NewNetwork();
+    }
+
+    Ptr<SimpleNetDevice> stub = CreateObject<SimpleNetDevice>();
+    stub->SetAddress(Mac48Address::Allocate());
+    m_nodes.Get(3)->AddDevice(stub);
+    Ptr<Ipv4> ipv43 = m_nodes.Get(3)->GetObject<Ipv4>();
+    int32_t ifIndex = ipv43->AddInterface(stub);
+    ipv43->AddAddress(ifIndex, Ipv4InterfaceAddress(Ipv4Address("192.168.1.1"), Ipv4Mask("/32")));
+    ipv43->SetMetric(ifIndex, 1);
+    ipv43->SetUp(ifIndex);
+
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+    Ptr<Ipv4RoutingProtocol> routing = m_nodes.Get(0)->GetObject<Ipv4>()->GetRoutingProtocol();
+    m_routing = routing->GetObject<Ipv4GlobalRouting>();
+}
+
+Ptr<NetDevice>
+Ipv4GlobalRoutingEcmpTestCase::Route(uint16_t sourcePort)
+{
+    Ptr<Packet> p = Create<Packet>(100);
+    TcpHeader tcpHeader;
+    tcpHeader.SetSourcePort(sourcePort);
+    tcpHeader.SetDestinationPort(9);
+    p->AddHeader(tcpHeader);
+
+    Ipv4Header header;
+    header.SetSource(Ipv4Address("10.1.1.1"));
+    header.SetDestination(Ipv4Address("192.168.1.1"));
+    header.SetProtocol(6); // TCP
+
+    Socket::SocketErrno sockerr;
+    Ptr<Ipv4Route> route = m_routing->RouteOutput(p, header, nullptr, sockerr);
+    NS_TEST_EXPECT_MSG_NE(route, nullptr, "No route to 192.168.1.1");
+    return route ? route->GetOutputDevice() : nullptr;
+}
+
+Ptr<NetDevice>
+Ipv4GlobalRoutingEcmpTestCase::RouteUdpPayload(uint8_t payload)
+{
+    std::vector<uint8_t> buffer(100, payload);
+    Ptr<Packet> p = Create<Packet>(buffer.data(), buffer.size());
+
+    Ipv4Header header;
+    header.SetSource(Ipv4Address("10.1.1.1"));
+    header.SetDestination(Ipv4Address("192.168.1.1"));
+    header.SetProtocol(17); // UDP
+
+    Socket::SocketErrno sockerr;
+    Ptr<Ipv4Route> route = m_routing->RouteOutput(p, header, nullptr, sockerr);
+    NS_TEST_EXPECT_MSG_NE(route, nullptr, "No route to 192.168.1.1");
+    return route ? route->GetOutputDevice() : nullptr;
+}
+
+void
+Ipv4GlobalRoutingEcmpTestCase::RouteFlowlet(uint16_t sourcePort)
+{
+    Ptr<NetDevice> device = Route(sourcePort);
+    if (m_lastDevice && device != m_lastDevice)
+    {
+        m_routeChanges++;
+    }
+    m_lastDevice = device;
+}
+
+void
+Ipv4GlobalRoutingEcmpTestCase::DoRun()
+{
+    // Flow hash: the route of a flow never changes, and flows use both routes
+    m_routing->SetAttribute("EcmpMode", EnumValue(Ipv4GlobalRouting::ECMP_FLOW_HASH));
+    std::set<Ptr<NetDevice>> devices;
+    for (uint16_t port = 1000; port < 1032; port++)
+    {
+        Ptr<NetDevice> device = Route(port);
+        for (uint32_t i = 0; i < 8; i++)
+        {
+            NS_TEST_ASSERT_MSG_EQ(Route(port), device, "Flow " << port << " changed route");
+        }
+        devices.insert(device);
+    }
+    NS_TEST_ASSERT_MSG_EQ(devices.size(), 2, "Flows not spread over both equal-cost routes");
+
+    // The payload of the UDP packets, routed before their header is added,
+    // must not be mistaken for their ports
+    Ptr<NetDevice> udpDevice = RouteUdpPayload(0);
+    for (uint32_t payload = 1; payload < 32; payload++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(RouteUdpPayload(payload),
+                              udpDevice,
+                              "UDP flow changed route with its payload");
+    }
+
+    // Flowlets: packets 10 us apart stay on the same route, flowlets 1 ms
+    // apart are spread at random over both routes
+    m_routing->SetAttribute("FlowletGap", TimeValue(MicroSeconds(100)));
+    for (uint32_t i = 0; i < 64; i++)
+    {
+        Simulator::Schedule(MicroSeconds(10 * i),
+                            &Ipv4GlobalRoutingEcmpTestCase::RouteFlowlet,
+                            this,
+                            1000);
+    }
+    Simulator::Run();
+    NS_TEST_ASSERT_MSG_EQ(m_routeChanges, 0, "Route changed within a flowlet");
+
+    for (uint32_t i = 0; i < 64; i++)
+    {
+        Simulator::Schedule(MilliSeconds(i + 1),
+                            &Ipv4GlobalRoutingEcmpTestCase::RouteFlowlet,
+                            this,
+                            1000);
+    }
+    Simulator::Run();
+    NS_TEST_ASSERT_MSG_GT(m_routeChanges, 0, "Flowlets never changed route");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief IPv4 GlobalRouting network route order test
+ *
+ * All the network routes matching a destination are equal-cost candidates,
+ * whatever their prefix length: FirstRoute picks the first one added, and the
+ * routes with a non-contiguous mask are matched too.
+ */
+class Ipv4GlobalRoutingNetworkRouteOrderTestCase : public TestCase
+{
+  public:
+    Ipv4GlobalRoutingNetworkRouteOrderTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Get the output interface of the route to a destination.
+     * \param dest Destination address.
+     * \return the output interface, or -1 if there is no route
+     */
+    int32_t Route(std::string dest);
+
+    Ptr<Ipv4> m_ipv4;                 //!< IPv4 stack of the node
+    Ptr<Ipv4GlobalRouting> m_routing; //!< Global routing of the node
+};
+
+Ipv4GlobalRoutingNetworkRouteOrderTestCase::Ipv4GlobalRoutingNetworkRouteOrderTestCase()
+    : TestCase("Global routing network route order and non-contiguous masks")
+{
+}
+
+int32_t
+Ipv4GlobalRoutingNetworkRouteOrderTestCase::Route(std::string dest)
+{
+    Ipv4Header header;
+    header.SetDestination(Ipv4Address(dest.c_str()));
+    Socket::SocketErrno sockerr;
+    Ptr<Ipv4Route> route = m_routing->RouteOutput(nullptr, header, nullptr, sockerr);
+    return route ? m_ipv4->GetInterfaceForDevice(route->GetOutputDevice()) : -1;
+}
+
+void
+Ipv4GlobalRoutingNetworkRouteOrderTestCase::DoRun()
+{
+    Ptr<Node> node = CreateObject<Node>();
+    InternetStackHelper internet;
+    internet.SetRoutingHelper(Ipv4GlobalRoutingHelper());
+    internet.Install(node);
+
+    SimpleNetDeviceHelper devHelper;
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("172.16.1.0", "255.255.255.0");
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        ipv4.Assign(devHelper.Install(node));
+        ipv4.NewNetwork();
+    }
+    m_ipv4 = node->GetObject<Ipv4>();
+    m_routing = m_ipv4->GetRoutingProtocol()->GetObject<Ipv4GlobalRouting>();
+
+    m_routing->AddNetworkRouteTo(Ipv4Address("10.0.0.0"), Ipv4Mask("/8"), 2);
+    m_routing->AddNetworkRouteTo(Ipv4Address("10.1.0.0"), Ipv4Mask("/16"), 1);
+    m_routing->AddNetworkRouteTo(Ipv4Address("10.0.0.1"), Ipv4Mask("255.0.0.255"), 3);
+    m_routing->AddNetworkRouteTo(Ipv4Address("20.0.0.1"), Ipv4Mask("255.0.0.255"), 3);
+
+    NS_TEST_EXPECT_MSG_EQ(Route("10.1.2.3"), 2, "Not the first route added among /8 and /16");
+    NS_TEST_EXPECT_MSG_EQ(Route("10.1.2.1"), 2, "Not the first route added among three");
+    NS_TEST_EXPECT_MSG_EQ(Route("10.2.2.3"), 2, "Wrong /8 route");
+    NS_TEST_EXPECT_MSG_EQ(Route("20.5.6.1"), 3, "Non-contiguous mask not matched");
+    NS_TEST_EXPECT_MSG_EQ(Route("20.5.6.2"), -1, "Non-contiguous mask wrongly matched");
+
+    // The FIB rebuilt after a removal keeps the order
+    m_routing->RemoveRoute(m_routing->GetNRoutes() - 1);
+    NS_TEST_EXPECT_MSG_EQ(Route("10.1.2.1"), 2, "Order lost on rebuild");
+    NS_TEST_EXPECT_MSG_EQ(Route("20.5.6.1"), -1, "Removed route still used");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief IPv4 GlobalRouting parallel and incremental route computation test
+ *
+ * The routes computed by several threads, and the routes recomputed
+ * incrementally after a link failure, must be the same as the routes computed
+ * from scratch by a single thread.
+ */
+class Ipv4GlobalRoutingParallelIncrementalTestCase : public TestCase
+{
+  public:
+    Ipv4GlobalRoutingParallelIncrementalTestCase();
+
+  private:
+    void DoSetup() override;
+    void DoRun() override;
+    void DoTeardown() override;
+
+    /**
+     * \brief Get the global routes of all the nodes.
+     * \return the routes, sorted
+     */
+    std::vector<std::string> GetRoutes() const;
+
+    NodeContainer m_nodes; //!< Nodes used in the test
+};
+
+Ipv4GlobalRoutingParallelIncrementalTestCase::Ipv4GlobalRoutingParallelIncrementalTestCase()
+    : TestCase("Global routing parallel and incremental route computation")
+{
+}
+
+// Ring of routers n0-n3, with host n4 on n0 and host n5 on n2:
+//
+//     n4 -- n0 -- n1
+//           |      |
+//           n3 -- n2 -- n5
+//
+void
+Ipv4GlobalRoutingParallelIncrementalTestCase::DoSetup()
+{
+    m_nodes.Create(6);
+
+    InternetStackHelper internet;
+    Ipv4GlobalRoutingHelper ipv4RoutingHelper;
+    internet.SetRoutingHelper(ipv4RoutingHelper);
+    internet.Install(m_nodes);
+
+    SimpleNetDeviceHelper devHelper;
+    devHelper.SetNetDevicePointToPointMode(true);
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.1.1.0", "255.255.255.252");
+    const uint32_t links[6][2] = {{0, 1}, {1, 2}, {2, 3}, {3, 0}, {4, 0}, {5, 2}};
+    for (const auto& link : links)
+    {
+        ipv4.Assign(devHelper.Install(NodeContainer(m_nodes.Get(link[0]), m_nodes.Get(link[1]))));
+        ipv4.NewNetwork();
+    }
+}
+
+std::vector<std::string>
+Ipv4GlobalRoutingParallelIncrementalTestCase::GetRoutes() const
+{
+    std::vector<std::string> routes;
+    for (uint32_t i = 0; i < m_nodes.GetN(); i++)
+    {
+        Ptr<Ipv4RoutingProtocol> protocol = m_nodes.Get(i)->GetObject<Ipv4>()->GetRoutingProtocol();
+        Ptr<Ipv4GlobalRouting> routing = protocol->GetObject<Ipv4GlobalRouting>();
+        for (uint32_t j = 0; j < routing->GetNRoutes(); j++)
+        {
+            std::ostringstream oss;
+            oss << "n" << i << " " << *routing->GetRoute(j);
+            routes.push_back(oss.str());
+        }
+    }
+    std::sort(routes.begin(), routes.end());
+    return routes;
+}
+
+void
+Ipv4GlobalRoutingParallelIncrementalTestCase::DoRun()
+{
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+    std::vector<std::string> serial = GetRoutes();
+    NS_TEST_ASSERT_MSG_GT(serial.size(), 0, "No global routes");
+
+    GlobalValue::Bind("GlobalRoutingThreads", UintegerValue(4));
+    Ipv4GlobalRoutingHelper::RecomputeRoutingTables();
+    NS_TEST_ASSERT_MSG_EQ((GetRoutes() == serial), true, "Parallel routes differ");
+
+    // Fail the n1-n2 link, and recompute the routes incrementally
+    Ptr<Ipv4> ipv41 = m_nodes.Get(1)->GetObject<Ipv4>();
+    ipv41->SetDown(ipv41->GetInterfaceForAddress(Ipv4Address("10.1.1.5")));
+    GlobalValue::Bind("GlobalRoutingIncremental", BooleanValue(true));
+    Ipv4GlobalRoutingHelper::RecomputeRoutingTables();
+    std::vector<std::string> incremental = GetRoutes();
+    NS_TEST_ASSERT_MSG_EQ((incremental != serial), true, "Link failure not taken into account");
+
+    GlobalValue::Bind("GlobalRoutingIncremental", BooleanValue(false));
+    GlobalValue::Bind("GlobalRoutingThreads", UintegerValue(1));
+    Ipv4GlobalRoutingHelper::RecomputeRoutingTables();
+    NS_TEST_ASSERT_MSG_EQ((GetRoutes() == incremental), true, "Incremental routes differ");
+
+    // Nothing changed: incremental recomputation keeps the routes
+    GlobalValue::Bind("GlobalRoutingIncremental", BooleanValue(true));
+    Ipv4GlobalRoutingHelper::RecomputeRoutingTables();
+    NS_TEST_ASSERT_MSG_EQ((GetRoutes() == incremental), true, "Unchanged routes differ");
+}
+
+void
+Ipv4GlobalRoutingParallelIncrementalTestCase::DoTeardown()
+{
+    GlobalValue::Bind("GlobalRoutingIncremental", BooleanValue(false));
+    GlobalValue::Bind("GlobalRoutingThreads", UintegerValue(1));
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup internet-test
  *
@@ -1322,6 +1716,9 @@ Ipv4GlobalRoutingTestSuite::Ipv4GlobalRoutingTestSuite()
     AddTestCase(new TwoBridgeTest, TestCase::Duration::QUICK);
     AddTestCase(new Ipv4DynamicGlobalRoutingTestCase, TestCase::Duration::QUICK);
     AddTestCase(new Ipv4GlobalRoutingSlash32TestCase, TestCase::Duration::QUICK);
+    AddTestCase(new Ipv4GlobalRoutingEcmpTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new Ipv4GlobalRoutingNetworkRouteOrderTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new Ipv4GlobalRoutingParallelIncrementalTestCase, TestCase::Duration::QUICK);
 }
 
 static Ipv4GlobalRoutingTestSuite
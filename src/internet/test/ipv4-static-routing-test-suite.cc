@@ -9,7 +9,9 @@
 #include "ns3/inet-socket-address.h"
 #include "ns3/internet-stack-helper.h"
 #include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-routing-table-entry.h"
 #include "ns3/ipv4-static-routing-helper.h"
+#include "ns3/ipv4-static-routing.h"
 #include "ns3/node-container.h"
 #include "ns3/node.h"
 #include "ns3/packet.h"
@@ -196,6 +198,104 @@ Ipv4StaticRoutingSlash32TestCase::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup internet-test
+ *
+ * \brief IPv4 StaticRouting longest prefix match Test
+ */
+class Ipv4StaticRoutingLongestPrefixMatchTestCase : public TestCase
+{
+  public:
+    Ipv4StaticRoutingLongestPrefixMatchTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Check the output interface of the route to a destination.
+     * \param dest Destination address.
+     * \param interface Expected output interface.
+     */
+    void CheckRoute(std::string dest, uint32_t interface);
+
+    Ptr<Ipv4> m_ipv4;                       //!< IPv4 stack of the node
+    Ptr<Ipv4StaticRouting> m_staticRouting; //!< Static routing of the node
+};
+
+Ipv4StaticRoutingLongestPrefixMatchTestCase::Ipv4StaticRoutingLongestPrefixMatchTestCase()
+    : TestCase("Static routing longest prefix match and metrics")
+{
+}
+
+void
+Ipv4StaticRoutingLongestPrefixMatchTestCase::CheckRoute(std::string dest, uint32_t interface)
+{
+    Ipv4Header header;
+    header.SetDestination(Ipv4Address(dest.c_str()));
+    Socket::SocketErrno sockerr;
+    Ptr<Ipv4Route> route = m_staticRouting->RouteOutput(nullptr, header, nullptr, sockerr);
+    NS_TEST_ASSERT_MSG_NE(route, nullptr, "No route to " << dest);
+    NS_TEST_EXPECT_MSG_EQ(route->GetOutputDevice(),
+                          m_ipv4->GetNetDevice(interface),
+                          "Wrong output interface for " << dest);
+}
+
+void
+Ipv4StaticRoutingLongestPrefixMatchTestCase::DoRun()
+{
+    Ptr<Node> node = CreateObject<Node>();
+    InternetStackHelper internet;
+    internet.Install(node);
+
+    SimpleNetDeviceHelper devHelper;
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("172.16.1.0", "255.255.255.0");
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        ipv4.Assign(devHelper.Install(node));
+        ipv4.NewNetwork();
+    }
+
+    m_ipv4 = node->GetObject<Ipv4>();
+    Ipv4StaticRoutingHelper staticRoutingHelper;
+    m_staticRouting = staticRoutingHelper.GetStaticRouting(m_ipv4);
+
+    m_staticRouting->SetDefaultRoute(Ipv4Address("172.16.3.2"), 3);
+    m_staticRouting->AddNetworkRouteTo(Ipv4Address("10.0.0.0"), Ipv4Mask("/8"), 1);
+    m_staticRouting->AddNetworkRouteTo(Ipv4Address("10.1.0.0"), Ipv4Mask("/16"), 2, 5);
+    m_staticRouting->AddNetworkRouteTo(Ipv4Address("10.1.0.0"), Ipv4Mask("/16"), 3, 1);
+    m_staticRouting->AddHostRouteTo(Ipv4Address("10.1.2.3"), 1);
+    // A non-contiguous mask is matched as a prefix of Ipv4Mask::GetPrefixLength
+    m_staticRouting->AddNetworkRouteTo(Ipv4Address("192.168.0.1"), Ipv4Mask("255.255.0.255"), 2);
+    uint32_t nRoutes = m_staticRouting->GetNRoutes();
+    m_staticRouting->AddNetworkRouteTo(Ipv4Address("192.168.0.1"), Ipv4Mask("255.255.0.255"), 2);
+    NS_TEST_EXPECT_MSG_EQ(m_staticRouting->GetNRoutes(),
+                          nRoutes,
+                          "Duplicate route with a non-contiguous mask added");
+
+    CheckRoute("10.1.2.3", 1);
+    CheckRoute("10.1.9.9", 3);
+    CheckRoute("10.9.9.9", 1);
+    CheckRoute("192.168.0.2", 3);
+    CheckRoute("192.168.7.1", 2);
+    CheckRoute("172.16.2.7", 2);
+
+    // Removing the lowest metric route falls back to the other one
+    for (uint32_t i = 0; i < m_staticRouting->GetNRoutes(); i++)
+    {
+        Ipv4RoutingTableEntry route = m_staticRouting->GetRoute(i);
+        if (route.GetDestNetworkMask() == Ipv4Mask("/16") && route.GetInterface() == 3)
+        {
+            m_staticRouting->RemoveRoute(i);
+            break;
+        }
+    }
+    CheckRoute("10.1.9.9", 2);
+    CheckRoute("10.1.2.3", 1);
+
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup internet-test
  *
@@ -211,6 +311,7 @@ Ipv4StaticRoutingTestSuite::Ipv4StaticRoutingTestSuite()
     : TestSuite("ipv4-static-routing", Type::UNIT)
 {
     AddTestCase(new Ipv4StaticRoutingSlash32TestCase, TestCase::Duration::QUICK);
+    AddTestCase(new Ipv4StaticRoutingLongestPrefixMatchTestCase, TestCase::Duration::QUICK);
 }
 
 static Ipv4StaticRoutingTestSuite
@@ -0,0 +1,264 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "ns3/boolean.h"
+#include "ns3/config.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/tcp-congestion-ops.h"
+#include "ns3/tcp-congestion-trace-sink.h"
+#include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+#include <cstring>
+#include <fstream>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("TcpCongestionTraceSinkTestSuite");
+
+/// A record read back from a congestion control trace file
+struct TcpCongestionTraceRecord
+{
+    int64_t time;    //!< Timestamp (ns)
+    uint32_t flowId; //!< Flow id
+    uint32_t cwnd;   //!< Congestion window (bytes)
+    int64_t delay;   //!< Measured delay (ns)
+    int64_t target;  //!< Target delay (ns)
+};
+
+/**
+ * \brief Read back a congestion control trace file
+ * \param fileName the file name
+ * \param [out] batches the number of batches found in the file
+ * \return the records, or an empty vector if the file is not a valid trace
+ */
+static std::vector<TcpCongestionTraceRecord>
+ReadTrace(const std::string& fileName, uint32_t& batches)
+{
+    std::vector<TcpCongestionTraceRecord> records;
+    batches = 0;
+    std::ifstream file(fileName, std::ios::binary);
+    char magic[8];
+    if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, "NS3CCTR1", sizeof(magic)) != 0)
+    {
+        return records;
+    }
+    uint32_t count;
+    while (file.read(reinterpret_cast<char*>(&count), sizeof(count)))
+    {
+        std::size_t first = records.size();
+        records.resize(first + count);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            file.read(reinterpret_cast<char*>(&records[first + i].time), sizeof(int64_t));
+        }
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            file.read(reinterpret_cast<char*>(&records[first + i].flowId), sizeof(uint32_t));
+        }
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            file.read(reinterpret_cast<char*>(&records[first + i].cwnd), sizeof(uint32_t));
+        }
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            file.read(reinterpret_cast<char*>(&records[first + i].delay), sizeof(int64_t));
+        }
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            file.read(reinterpret_cast<char*>(&records[first + i].target), sizeof(int64_t));
+        }
+        ++batches;
+    }
+    return records;
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Check that the records of the sink are written, in order, in batches
+ */
+class TcpCongestionTraceSinkRecordTest : public TestCase
+{
+  public:
+    TcpCongestionTraceSinkRecordTest();
+
+  private:
+    void DoRun() override;
+    /**
+     * \brief Record one state update
+     * \param i index of the record
+     */
+    void Record(uint32_t i);
+
+    Ptr<TcpCongestionTraceSink> m_sink; //!< Sink under test
+};
+
+TcpCongestionTraceSinkRecordTest::TcpCongestionTraceSinkRecordTest()
+    : TestCase("Records are written in order, in batches")
+{
+}
+
+void
+TcpCongestionTraceSinkRecordTest::Record(uint32_t i)
+{
+    m_sink->Record(i % 3, 1000 * i, MicroSeconds(i), MicroSeconds(2 * i));
+}
+
+void
+TcpCongestionTraceSinkRecordTest::DoRun()
+{
+    const uint32_t records = 10;
+    std::string fileName = CreateTempDirFilename("cc-trace-record.bin");
+
+    m_sink = CreateObject<TcpCongestionTraceSink>();
+    m_sink->SetAttribute("FileName", StringValue(fileName));
+    m_sink->SetAttribute("BatchSize", UintegerValue(4));
+    m_sink->SetAttribute("RingSize", UintegerValue(2));
+    for (uint32_t i = 0; i < records; ++i)
+    {
+        Simulator::Schedule(MicroSeconds(10 * i), &TcpCongestionTraceSinkRecordTest::Record, this, i);
+    }
+    Simulator::Run();
+    m_sink->Flush();
+    NS_TEST_EXPECT_MSG_EQ(m_sink->GetRecordCount(), records, "Unexpected record count");
+
+    uint32_t batches;
+    auto trace = ReadTrace(fileName, batches);
+    NS_TEST_ASSERT_MSG_EQ(trace.size(), records, "Unexpected number of records in the file");
+    NS_TEST_EXPECT_MSG_EQ(batches, 3, "Records should be written in batches of 4");
+    for (uint32_t i = 0; i < records; ++i)
+    {
+        NS_TEST_EXPECT_MSG_EQ(trace[i].time, MicroSeconds(10 * i).GetNanoSeconds(), "Bad time");
+        NS_TEST_EXPECT_MSG_EQ(trace[i].flowId, i % 3, "Bad flow id");
+        NS_TEST_EXPECT_MSG_EQ(trace[i].cwnd, 1000 * i, "Bad cwnd");
+        NS_TEST_EXPECT_MSG_EQ(trace[i].delay, MicroSeconds(i).GetNanoSeconds(), "Bad delay");
+        NS_TEST_EXPECT_MSG_EQ(trace[i].target, MicroSeconds(2 * i).GetNanoSeconds(), "Bad target");
+    }
+
+    m_sink->Dispose();
+    m_sink = nullptr;
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Congestion control that traces its state on every window increase
+ */
+class TcpTracedNewReno : public TcpNewReno
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    Ptr<TcpCongestionOps> Fork() override
+    {
+        return CopyObject<TcpTracedNewReno>(this);
+    }
+
+    void IncreaseWindow(Ptr<TcpSocketState> tcb, uint32_t segmentsAcked) override
+    {
+        TcpNewReno::IncreaseWindow(tcb, segmentsAcked);
+        TraceCongestionState(tcb, MicroSeconds(10), MicroSeconds(20));
+    }
+};
+
+TypeId
+TcpTracedNewReno::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::TcpTracedNewReno")
+                            .SetParent<TcpNewReno>()
+                            .AddConstructor<TcpTracedNewReno>()
+                            .SetGroupName("Internet");
+    return tid;
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Check the CcTrace, CcTraceDecimation and CcTraceFlowId attributes
+ */
+class TcpCongestionTraceDecimationTest : public TestCase
+{
+  public:
+    TcpCongestionTraceDecimationTest();
+
+  private:
+    void DoRun() override;
+};
+
+TcpCongestionTraceDecimationTest::TcpCongestionTraceDecimationTest()
+    : TestCase("Congestion control state is traced per flow, with decimation")
+{
+}
+
+void
+TcpCongestionTraceDecimationTest::DoRun()
+{
+    std::string fileName = CreateTempDirFilename("cc-trace-decimation.bin");
+    Config::SetDefault("ns3::TcpCongestionTraceSink::FileName", StringValue(fileName));
+
+    Ptr<TcpSocketState> state = CreateObject<TcpSocketState>();
+    state->m_segmentSize = 1000;
+    state->m_cWnd = 10000;
+    state->m_ssThresh = 5000;
+
+    Ptr<TcpTracedNewReno> traced = CreateObject<TcpTracedNewReno>();
+    traced->SetAttribute("CcTrace", BooleanValue(true));
+    traced->SetAttribute("CcTraceDecimation", UintegerValue(3));
+    traced->SetAttribute("CcTraceFlowId", UintegerValue(7));
+    Ptr<TcpTracedNewReno> untraced = CreateObject<TcpTracedNewReno>();
+
+    for (uint32_t i = 0; i < 10; ++i)
+    {
+        traced->IncreaseWindow(state, 1);
+        untraced->IncreaseWindow(state, 1);
+    }
+    Ptr<TcpTracedNewReno> forked = DynamicCast<TcpTracedNewReno>(traced->Fork());
+    NS_TEST_ASSERT_MSG_NE(forked, nullptr, "Fork should keep the type");
+    forked->IncreaseWindow(state, 1);
+
+    // Updates 0, 3, 6 and 9 of the traced flow, and the first of the fork
+    NS_TEST_EXPECT_MSG_EQ(TcpCongestionTraceSink::GetDefault()->GetRecordCount(),
+                          5,
+                          "Unexpected record count");
+    Simulator::Destroy();
+
+    uint32_t batches;
+    auto trace = ReadTrace(fileName, batches);
+    NS_TEST_ASSERT_MSG_EQ(trace.size(), 5, "Unexpected number of records in the file");
+    for (const auto& record : trace)
+    {
+        NS_TEST_EXPECT_MSG_EQ(record.flowId, 7, "Bad flow id");
+        NS_TEST_EXPECT_MSG_EQ(record.delay, MicroSeconds(10).GetNanoSeconds(), "Bad delay");
+        NS_TEST_EXPECT_MSG_EQ(record.target, MicroSeconds(20).GetNanoSeconds(), "Bad target");
+    }
+    Config::Reset();
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief TcpCongestionTraceSink TestSuite
+ */
+class TcpCongestionTraceSinkTestSuite : public TestSuite
+{
+  public:
+    TcpCongestionTraceSinkTestSuite()
+        : TestSuite("tcp-congestion-trace-sink", Type::UNIT)
+    {
+        AddTestCase(new TcpCongestionTraceSinkRecordTest(), TestCase::Duration::QUICK);
+        AddTestCase(new TcpCongestionTraceDecimationTest(), TestCase::Duration::QUICK);
+    }
+};
+
+static TcpCongestionTraceSinkTestSuite
+    g_tcpCongestionTraceSinkTestSuite; //!< Static variable for test initialization
+
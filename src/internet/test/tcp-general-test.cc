@@ -816,7 +816,7 @@ TcpGeneralTest::GetRWnd(SocketWho who)
     }
 }
 
-EventId
+WheelEventId
 TcpGeneralTest::GetPersistentEvent(SocketWho who)
 {
     if (who == SENDER)
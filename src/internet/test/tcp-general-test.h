@@ -546,7 +546,7 @@ class TcpGeneralTest : public TestCase
      * \param who socket where check the parameter
      * \return the persistent event in the selected socket
      */
-    EventId GetPersistentEvent(SocketWho who);
+    WheelEventId GetPersistentEvent(SocketWho who);
 
     /**
      * \brief Get the persistent timeout of the selected socket
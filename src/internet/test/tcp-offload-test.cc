@@ -0,0 +1,404 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "ns3/arp-l3-protocol.h"
+#include "ns3/data-rate.h"
+#include "ns3/error-model.h"
+#include "ns3/icmpv4-l4-protocol.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/ipv4-list-routing.h"
+#include "ns3/ipv4-static-routing.h"
+#include "ns3/node.h"
+#include "ns3/nstime.h"
+#include "ns3/pointer.h"
+#include "ns3/segmentation-offload.h"
+#include "ns3/simple-channel.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simulator.h"
+#include "ns3/socket-factory.h"
+#include "ns3/tcp-header.h"
+#include "ns3/tcp-l4-protocol.h"
+#include "ns3/tcp-socket-base.h"
+#include "ns3/tcp-socket-factory.h"
+#include "ns3/test.h"
+#include "ns3/traffic-control-layer.h"
+#include "ns3/udp-l4-protocol.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <list>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Check the split of an IPv4 packet which holds a TCP super-segment.
+ */
+class TcpSegmentationTest : public TestCase
+{
+  public:
+    TcpSegmentationTest();
+
+  private:
+    void DoRun() override;
+};
+
+TcpSegmentationTest::TcpSegmentationTest()
+    : TestCase("Check the split of a TCP super-segment")
+{
+}
+
+void
+TcpSegmentationTest::DoRun()
+{
+    // The segmenter is registered by the TCP protocol
+    Ptr<TcpL4Protocol> tcp = CreateObject<TcpL4Protocol>();
+
+    std::vector<uint8_t> data(3500);
+    for (uint32_t i = 0; i < data.size(); i++)
+    {
+        data[i] = i % 251;
+    }
+    Ptr<Packet> packet = Create<Packet>(data.data(), data.size());
+    TcpHeader tcpHeader;
+    tcpHeader.SetSequenceNumber(SequenceNumber32(1000));
+    tcpHeader.SetAckNumber(SequenceNumber32(42));
+    tcpHeader.SetFlags(TcpHeader::ACK | TcpHeader::PSH | TcpHeader::CWR | TcpHeader::FIN);
+    packet->AddHeader(tcpHeader);
+    Ipv4Header ipHeader;
+    ipHeader.SetSource(Ipv4Address("10.0.0.1"));
+    ipHeader.SetDestination(Ipv4Address("10.0.0.2"));
+    ipHeader.SetProtocol(TcpL4Protocol::PROT_NUMBER);
+    ipHeader.SetIdentification(7);
+    ipHeader.SetPayloadSize(packet->GetSize());
+    packet->AddHeader(ipHeader);
+
+    std::list<Ptr<Packet>> segments;
+    NS_TEST_EXPECT_MSG_EQ(SegmentationOffload::Segment(Ipv4L3Protocol::PROT_NUMBER,
+                                                       packet,
+                                                       segments),
+                          false,
+                          "A packet without SegmentationOffloadTag was split");
+    NS_TEST_EXPECT_MSG_EQ(segments.size(), 0, "Segments were added");
+
+    packet->AddPacketTag(SegmentationOffloadTag(1000, 4));
+    NS_TEST_ASSERT_MSG_EQ(SegmentationOffload::Segment(Ipv4L3Protocol::PROT_NUMBER,
+                                                       packet,
+                                                       segments),
+                          true,
+                          "The super-segment was not split");
+    NS_TEST_ASSERT_MSG_EQ(segments.size(), 4, "Wrong number of segments");
+
+    uint32_t offset = 0;
+    uint16_t identification = 7;
+    for (const auto& segment : segments)
+    {
+        SegmentationOffloadTag gso;
+        NS_TEST_EXPECT_MSG_EQ(segment->PeekPacketTag(gso), false, "The tag was kept");
+        Ipv4Header segmentIpHeader;
+        segment->RemoveHeader(segmentIpHeader);
+        TcpHeader segmentTcpHeader;
+        segment->RemoveHeader(segmentTcpHeader);
+        uint32_t length = offset + 1000 < data.size() ? 1000 : data.size() - offset;
+        bool last = offset + length == data.size();
+
+        NS_TEST_EXPECT_MSG_EQ(segment->GetSize(), length, "Wrong segment size");
+        NS_TEST_EXPECT_MSG_EQ(segmentIpHeader.GetPayloadSize(),
+                              length + segmentTcpHeader.GetSerializedSize(),
+                              "Wrong IPv4 payload size");
+        NS_TEST_EXPECT_MSG_EQ(segmentIpHeader.GetIdentification(),
+                              identification++,
+                              "Wrong IPv4 identification");
+        NS_TEST_EXPECT_MSG_EQ(segmentTcpHeader.GetSequenceNumber(),
+                              SequenceNumber32(1000 + offset),
+                              "Wrong sequence number");
+        NS_TEST_EXPECT_MSG_EQ(segmentTcpHeader.GetAckNumber(),
+                              SequenceNumber32(42),
+                              "Wrong ACK number");
+        NS_TEST_EXPECT_MSG_EQ(bool(segmentTcpHeader.GetFlags() & TcpHeader::ACK),
+                              true,
+                              "ACK must be set on every segment");
+        NS_TEST_EXPECT_MSG_EQ(bool(segmentTcpHeader.GetFlags() & TcpHeader::CWR),
+                              (offset == 0),
+                              "CWR must be set on the first segment only");
+        NS_TEST_EXPECT_MSG_EQ(bool(segmentTcpHeader.GetFlags() & TcpHeader::FIN),
+                              last,
+                              "FIN must be set on the last segment only");
+        NS_TEST_EXPECT_MSG_EQ(bool(segmentTcpHeader.GetFlags() & TcpHeader::PSH),
+                              last,
+                              "PSH must be set on the last segment only");
+
+        std::vector<uint8_t> payload(length);
+        segment->CopyData(payload.data(), length);
+        NS_TEST_EXPECT_MSG_EQ(std::equal(payload.begin(), payload.end(), data.begin() + offset),
+                              true,
+                              "Wrong payload");
+        offset += length;
+    }
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Check a bulk transfer with segmentation offload (TSO) at the
+ * sender and generic receive offload (GRO) at the receiver.
+ *
+ * The SimpleNetDevice does not support segmentation offload, so the
+ * super-segments are split by the IPv4 layer of the sender.  The data
+ * must arrive intact, in fewer TCP packets than IPv4 packets at both ends,
+ * and no IPv4 packet may be larger than a segment.
+ */
+class TcpOffloadTransferTest : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor.
+     * \param lossy Whether some packets are lost.
+     */
+    TcpOffloadTransferTest(bool lossy);
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Create a node with the Internet stack.
+     * \param address the address of its SimpleNetDevice
+     * \param channel the channel of its SimpleNetDevice
+     * \returns The node.
+     */
+    Ptr<Node> CreateInternetNode(Ipv4Address address, Ptr<SimpleChannel> channel);
+
+    /**
+     * \brief Server: Handle connection created.
+     * \param s The socket.
+     * \param addr The other party address.
+     */
+    void ServerHandleConnectionCreated(Ptr<Socket> s, const Address& addr);
+    /**
+     * \brief Server: Receive data.
+     * \param sock The socket.
+     */
+    void ServerHandleRecv(Ptr<Socket> sock);
+    /**
+     * \brief Client: Send data.
+     * \param sock The socket.
+     * \param available Unused in the test.
+     */
+    void SourceHandleSend(Ptr<Socket> sock, uint32_t available);
+
+    /**
+     * \brief Count the TCP packets with data.
+     * \param counter The counter.
+     * \param p The packet, without its TCP header.
+     * \param h The TCP header.
+     * \param socket The socket.
+     */
+    void CountTcp(uint32_t* counter,
+                  Ptr<const Packet> p,
+                  const TcpHeader& h,
+                  Ptr<const TcpSocketBase> socket);
+    /**
+     * \brief Count the IPv4 packets with data.
+     * \param counter The counter.
+     * \param p The packet, with its IPv4 header.
+     * \param ipv4 The IPv4 stack.
+     * \param interface The interface.
+     */
+    void CountIpv4(uint32_t* counter, Ptr<const Packet> p, Ptr<Ipv4> ipv4, uint32_t interface);
+
+    bool m_lossy;                //!< Whether some packets are lost.
+    std::vector<uint8_t> m_data; //!< Data to transfer.
+    uint32_t m_sent{0};          //!< Bytes sent by the client.
+    std::vector<uint8_t> m_rx;   //!< Data received by the server.
+    uint32_t m_tcpTx{0};         //!< TCP data packets sent.
+    uint32_t m_ipv4Tx{0};        //!< IPv4 data packets sent.
+    uint32_t m_tcpRx{0};         //!< TCP data packets received.
+    uint32_t m_ipv4Rx{0};        //!< IPv4 data packets received.
+    uint32_t m_maxIpv4Size{0};   //!< Size of the largest IPv4 packet.
+};
+
+/// Segment size of the test connection
+static const uint32_t OFFLOAD_TEST_SEGMENT_SIZE = 1000;
+
+TcpOffloadTransferTest::TcpOffloadTransferTest(bool lossy)
+    : TestCase(std::string("Check a bulk transfer with TSO and GRO") +
+               (lossy ? ", with losses" : "")),
+      m_lossy(lossy)
+{
+}
+
+Ptr<Node>
+TcpOffloadTransferTest::CreateInternetNode(Ipv4Address address, Ptr<SimpleChannel> channel)
+{
+    Ptr<Node> node = CreateObject<Node>();
+    Ptr<TrafficControlLayer> tc = CreateObject<TrafficControlLayer>();
+    node->AggregateObject(tc);
+    Ptr<ArpL3Protocol> arp = CreateObject<ArpL3Protocol>();
+    node->AggregateObject(arp);
+    arp->SetTrafficControl(tc);
+    Ptr<Ipv4L3Protocol> ipv4 = CreateObject<Ipv4L3Protocol>();
+    Ptr<Ipv4ListRouting> ipv4Routing = CreateObject<Ipv4ListRouting>();
+    ipv4->SetRoutingProtocol(ipv4Routing);
+    ipv4Routing->AddRoutingProtocol(CreateObject<Ipv4StaticRouting>(), 0);
+    node->AggregateObject(ipv4);
+    node->AggregateObject(CreateObject<Icmpv4L4Protocol>());
+    node->AggregateObject(CreateObject<UdpL4Protocol>());
+    node->AggregateObject(CreateObject<TcpL4Protocol>());
+
+    Ptr<SimpleNetDevice> dev = CreateObject<SimpleNetDevice>();
+    dev->SetAddress(Mac48Address::ConvertFrom(Mac48Address::Allocate()));
+    dev->SetAttribute("DataRate", DataRateValue(DataRate("1Gbps")));
+    dev->SetChannel(channel);
+    node->AddDevice(dev);
+    uint32_t ndid = ipv4->AddInterface(dev);
+    ipv4->AddAddress(ndid, Ipv4InterfaceAddress(address, Ipv4Mask("255.255.255.0")));
+    ipv4->SetUp(ndid);
+    return node;
+}
+
+void
+TcpOffloadTransferTest::ServerHandleConnectionCreated(Ptr<Socket> s, const Address& addr)
+{
+    s->SetRecvCallback(MakeCallback(&TcpOffloadTransferTest::ServerHandleRecv, this));
+    s->TraceConnectWithoutContext("Rx",
+                                  MakeCallback(&TcpOffloadTransferTest::CountTcp, this)
+                                      .Bind(&m_tcpRx));
+}
+
+void
+TcpOffloadTransferTest::ServerHandleRecv(Ptr<Socket> sock)
+{
+    while (sock->GetRxAvailable() > 0)
+    {
+        Ptr<Packet> p = sock->Recv(sock->GetRxAvailable(), 0);
+        std::vector<uint8_t> data(p->GetSize());
+        p->CopyData(data.data(), data.size());
+        m_rx.insert(m_rx.end(), data.begin(), data.end());
+    }
+}
+
+void
+TcpOffloadTransferTest::SourceHandleSend(Ptr<Socket> sock, uint32_t available)
+{
+    while (sock->GetTxAvailable() > 0 && m_sent < m_data.size())
+    {
+        uint32_t toSend = std::min<uint32_t>(m_data.size() - m_sent, sock->GetTxAvailable());
+        int sent = sock->Send(Create<Packet>(&m_data[m_sent], toSend));
+        NS_TEST_EXPECT_MSG_NE(sent, -1, "Error during send");
+        m_sent += sent;
+    }
+    if (m_sent == m_data.size())
+    {
+        sock->Close();
+    }
+}
+
+void
+TcpOffloadTransferTest::CountTcp(uint32_t* counter,
+                                 Ptr<const Packet> p,
+                                 const TcpHeader& h,
+                                 Ptr<const TcpSocketBase> socket)
+{
+    if (p->GetSize() > 0)
+    {
+        (*counter)++;
+    }
+}
+
+void
+TcpOffloadTransferTest::CountIpv4(uint32_t* counter,
+                                  Ptr<const Packet> p,
+                                  Ptr<Ipv4> ipv4,
+                                  uint32_t interface)
+{
+    // Only the data segments are counted, not the pure ACKs
+    if (p->GetSize() > 20 + 60)
+    {
+        (*counter)++;
+    }
+    m_maxIpv4Size = std::max(m_maxIpv4Size, p->GetSize());
+}
+
+void
+TcpOffloadTransferTest::DoRun()
+{
+    m_data.resize(500000);
+    for (uint32_t i = 0; i < m_data.size(); i++)
+    {
+        m_data[i] = i % 251;
+    }
+
+    Ptr<SimpleChannel> channel = CreateObject<SimpleChannel>();
+    channel->SetAttribute("Delay", TimeValue(MicroSeconds(20)));
+    Ptr<Node> server = CreateInternetNode(Ipv4Address("10.0.0.1"), channel);
+    Ptr<Node> source = CreateInternetNode(Ipv4Address("10.0.0.2"), channel);
+    if (m_lossy)
+    {
+        Ptr<ReceiveListErrorModel> errorModel = CreateObject<ReceiveListErrorModel>();
+        errorModel->SetList({40, 41, 97, 200});
+        server->GetDevice(1)->SetAttribute("ReceiveErrorModel", PointerValue(errorModel));
+    }
+    source->GetObject<Ipv4L3Protocol>()->TraceConnectWithoutContext(
+        "Tx",
+        MakeCallback(&TcpOffloadTransferTest::CountIpv4, this).Bind(&m_ipv4Tx));
+    server->GetObject<Ipv4L3Protocol>()->TraceConnectWithoutContext(
+        "Rx",
+        MakeCallback(&TcpOffloadTransferTest::CountIpv4, this).Bind(&m_ipv4Rx));
+
+    uint16_t port = 50000;
+    Ptr<Socket> listener = server->GetObject<TcpSocketFactory>()->CreateSocket();
+    listener->SetAttribute("SegmentSize", UintegerValue(OFFLOAD_TEST_SEGMENT_SIZE));
+    listener->SetAttribute("GroTimeout", TimeValue(MicroSeconds(10)));
+    listener->Bind(InetSocketAddress(Ipv4Address::GetAny(), port));
+    listener->Listen();
+    listener->SetAcceptCallback(
+        MakeNullCallback<bool, Ptr<Socket>, const Address&>(),
+        MakeCallback(&TcpOffloadTransferTest::ServerHandleConnectionCreated, this));
+
+    Ptr<Socket> client = source->GetObject<TcpSocketFactory>()->CreateSocket();
+    client->SetAttribute("SegmentSize", UintegerValue(OFFLOAD_TEST_SEGMENT_SIZE));
+    client->SetAttribute("TsoMaxSegments", UintegerValue(16));
+    client->SetSendCallback(MakeCallback(&TcpOffloadTransferTest::SourceHandleSend, this));
+    client->TraceConnectWithoutContext(
+        "Tx",
+        MakeCallback(&TcpOffloadTransferTest::CountTcp, this).Bind(&m_tcpTx));
+    client->Connect(InetSocketAddress(Ipv4Address("10.0.0.1"), port));
+
+    Simulator::Stop(Seconds(10));
+    Simulator::Run();
+
+    NS_TEST_ASSERT_MSG_EQ(m_rx.size(), m_data.size(), "The server did not receive all the data");
+    NS_TEST_EXPECT_MSG_EQ((m_rx == m_data), true, "The server received corrupted data");
+    NS_TEST_EXPECT_MSG_LT(m_tcpTx, m_ipv4Tx, "The sender did not use super-segments");
+    NS_TEST_EXPECT_MSG_LT(m_tcpRx, m_ipv4Rx, "The receiver did not coalesce segments");
+    NS_TEST_EXPECT_MSG_LT_OR_EQ(m_maxIpv4Size,
+                                OFFLOAD_TEST_SEGMENT_SIZE + 20 + 60,
+                                "A super-segment was sent on the wire");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief TCP segmentation and receive offloads TestSuite
+ */
+class TcpOffloadTestSuite : public TestSuite
+{
+  public:
+    TcpOffloadTestSuite()
+        : TestSuite("tcp-offload", Type::UNIT)
+    {
+        AddTestCase(new TcpSegmentationTest, TestCase::Duration::QUICK);
+        AddTestCase(new TcpOffloadTransferTest(false), TestCase::Duration::QUICK);
+        AddTestCase(new TcpOffloadTransferTest(true), TestCase::Duration::QUICK);
+    }
+};
+
+static TcpOffloadTestSuite g_tcpOffloadTestSuite; //!< Static variable for test initialization
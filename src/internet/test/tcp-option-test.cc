@@ -6,11 +6,13 @@
  */
 
 #include "ns3/core-module.h"
+#include "ns3/tcp-option-host-delay.h"
 #include "ns3/tcp-option-ts.h"
 #include "ns3/tcp-option-winscale.h"
 #include "ns3/tcp-option.h"
 #include "ns3/test.h"
 
+#include <limits>
 #include <string.h>
 
 using namespace ns3;
@@ -183,6 +185,63 @@ TcpOptionTSTestCase::DoTeardown()
 {
 }
 
+/**
+ * \ingroup internet-test
+ *
+ * \brief TCP host delay option Test
+ */
+class TcpOptionHostDelayTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor.
+     * \param name Test description.
+     */
+    TcpOptionHostDelayTestCase(std::string name);
+
+  private:
+    void DoRun() override;
+};
+
+TcpOptionHostDelayTestCase::TcpOptionHostDelayTestCase(std::string name)
+    : TestCase(name)
+{
+}
+
+void
+TcpOptionHostDelayTestCase::DoRun()
+{
+    Ptr<UniformRandomVariable> x = CreateObject<UniformRandomVariable>();
+
+    for (uint32_t i = 0; i < 1000; ++i)
+    {
+        Time delay = NanoSeconds(x->GetInteger());
+        Buffer buffer;
+
+        TcpOptionHostDelay opt;
+        opt.SetHostDelay(delay);
+        NS_TEST_EXPECT_MSG_EQ(opt.GetHostDelay(), delay, "Host delay isn't saved correctly");
+
+        buffer.AddAtStart(opt.GetSerializedSize());
+        opt.Serialize(buffer.Begin());
+
+        Buffer::Iterator start = buffer.Begin();
+        NS_TEST_EXPECT_MSG_EQ(start.PeekU8(), TcpOption::HOSTDELAY, "Different kind found");
+
+        TcpOptionHostDelay read;
+        NS_TEST_EXPECT_MSG_EQ(read.Deserialize(start), 6, "Wrong deserialized size");
+        NS_TEST_EXPECT_MSG_EQ(read.GetHostDelay(), delay, "Different host delay found");
+    }
+
+    TcpOptionHostDelay opt;
+    opt.SetHostDelay(Seconds(10));
+    NS_TEST_EXPECT_MSG_EQ(opt.GetHostDelay(),
+                          NanoSeconds(std::numeric_limits<uint32_t>::max()),
+                          "Host delay should saturate");
+    opt.SetHostDelay(NanoSeconds(-5));
+    NS_TEST_EXPECT_MSG_EQ(opt.GetHostDelay(), Seconds(0), "Negative host delay should be zero");
+}
+
 /**
  * \ingroup internet-test
  *
@@ -201,6 +260,8 @@ class TcpOptionTestSuite : public TestSuite
         }
         AddTestCase(new TcpOptionTSTestCase("Testing serialization of random values for timestamp"),
                     TestCase::Duration::QUICK);
+        AddTestCase(new TcpOptionHostDelayTestCase("Testing serialization of host delay values"),
+                    TestCase::Duration::QUICK);
     }
 };
 
@@ -312,9 +312,10 @@ class TcpTimeRtoTest : public TcpGeneralTest
     /**
      * \brief Constructor.
      * \param congControl Congestion control type.
+     * \param timerWheel Whether the sender runs its timers on the timer wheel.
      * \param msg Test description.
      */
-    TcpTimeRtoTest(const TypeId& congControl, const std::string& msg);
+    TcpTimeRtoTest(const TypeId& congControl, bool timerWheel, const std::string& msg);
 
   protected:
     Ptr<TcpSocketMsgBase> CreateSenderSocket(Ptr<Node> node) override;
@@ -335,13 +336,17 @@ class TcpTimeRtoTest : public TcpGeneralTest
     void PktDropped(const Ipv4Header& ipH, const TcpHeader& tcpH, Ptr<const Packet> p);
 
   private:
+    bool m_timerWheel;             //!< True if the sender runs its timers on the wheel.
     uint32_t m_senderSentSegments; //!< Number of segments sent.
     Time m_previousRTO;            //!< Previous RTO.
     bool m_closed;                 //!< True if the connection is closed.
 };
 
-TcpTimeRtoTest::TcpTimeRtoTest(const TypeId& congControl, const std::string& desc)
+TcpTimeRtoTest::TcpTimeRtoTest(const TypeId& congControl,
+                               bool timerWheel,
+                               const std::string& desc)
     : TcpGeneralTest(desc),
+      m_timerWheel(timerWheel),
       m_senderSentSegments(0),
       m_closed(false)
 {
@@ -360,6 +365,7 @@ TcpTimeRtoTest::CreateSenderSocket(Ptr<Node> node)
 {
     Ptr<TcpSocketMsgBase> s = TcpGeneralTest::CreateSenderSocket(node);
     s->SetAttribute("DataRetries", UintegerValue(6));
+    s->SetAttribute("TimerWheel", BooleanValue(m_timerWheel));
 
     return s;
 }
@@ -531,7 +537,11 @@ class TcpRtoTestSuite : public TestSuite
                             t.GetName() + " RTO ssthresh testing, set to half of BytesInFlight"),
                         TestCase::Duration::QUICK);
 
-            AddTestCase(new TcpTimeRtoTest(t, t.GetName() + " RTO timing testing"),
+            AddTestCase(new TcpTimeRtoTest(t, false, t.GetName() + " RTO timing testing"),
+                        TestCase::Duration::QUICK);
+            AddTestCase(new TcpTimeRtoTest(t,
+                                           true,
+                                           t.GetName() + " RTO timing testing on the timer wheel"),
                         TestCase::Duration::QUICK);
         }
     }
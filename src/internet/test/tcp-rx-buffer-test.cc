@@ -8,6 +8,9 @@
 #include "ns3/tcp-rx-buffer.h"
 #include "ns3/test.h"
 
+#include <algorithm>
+#include <vector>
+
 using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE("TcpRxBufferTestSuite");
@@ -31,6 +34,12 @@ class TcpRxBufferTestCase : public TestCase
      * \brief Test the SACK list update.
      */
     void TestUpdateSACKList();
+
+    /**
+     * \brief Test the reassembly of segments received far out of order,
+     * with overlaps, and extracted in pieces.
+     */
+    void TestReordering();
 };
 
 TcpRxBufferTestCase::TcpRxBufferTestCase()
@@ -42,6 +51,7 @@ void
 TcpRxBufferTestCase::DoRun()
 {
     TestUpdateSACKList();
+    TestReordering();
 }
 
 void
@@ -277,6 +287,89 @@ TcpRxBufferTestCase::TestUpdateSACKList()
     NS_TEST_ASSERT_MSG_EQ(sackList.size(), 0, "SACK list should contain no element");
 }
 
+void
+TcpRxBufferTestCase::TestReordering()
+{
+    TcpRxBuffer rxBuf;
+    TcpHeader h;
+    rxBuf.SetMaxBufferSize(100000);
+    rxBuf.SetNextRxSequence(SequenceNumber32(1));
+
+    // The bytes of the i-th segment of 100 bytes are all equal to i.  The
+    // odd segments arrive first, then the even ones in reverse order, so
+    // that each of them is inserted in the middle of the buffer
+    for (uint32_t i = 1; i < 100; i += 2)
+    {
+        std::vector<uint8_t> data(100, static_cast<uint8_t>(i));
+        h.SetSequenceNumber(SequenceNumber32(1 + i * 100));
+        rxBuf.Add(Create<Packet>(data.data(), data.size()), h);
+    }
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.NextRxSequence(),
+                          SequenceNumber32(1),
+                          "Sequence number differs from expected");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Size(), 5000, "Wrong number of buffered bytes");
+    // Only the most recent blocks are reported, the newest first
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.GetSackList().size(), 4, "Wrong number of SACK blocks");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.GetSackList().front().first,
+                          SequenceNumber32(9901),
+                          "SACK block different than expected");
+
+    for (uint32_t i = 98; i >= 2; i -= 2)
+    {
+        // Each segment also overlaps half of its neighbours, which are
+        // already buffered and must be kept
+        std::vector<uint8_t> data(200, static_cast<uint8_t>(i));
+        h.SetSequenceNumber(SequenceNumber32(1 + i * 100 - 50));
+        rxBuf.Add(Create<Packet>(data.data(), data.size()), h);
+    }
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.NextRxSequence(),
+                          SequenceNumber32(1),
+                          "Sequence number differs from expected");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Size(), 9900, "Overlapping bytes were buffered twice");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.GetSackList().front().first,
+                          SequenceNumber32(201),
+                          "SACK block different than expected");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.GetSackList().front().second,
+                          SequenceNumber32(301),
+                          "SACK block different than expected");
+
+    // A duplicate of buffered data changes nothing
+    std::vector<uint8_t> duplicate(500, 0xff);
+    h.SetSequenceNumber(SequenceNumber32(2001));
+    rxBuf.Add(Create<Packet>(duplicate.data(), duplicate.size()), h);
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Size(), 9900, "Duplicate bytes were buffered");
+
+    // Filling the first hole makes the whole buffer available, which is
+    // extracted in pieces that do not follow the segment boundaries
+    h.SetSequenceNumber(SequenceNumber32(1));
+    rxBuf.Add(Create<Packet>(100), h);
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.NextRxSequence(),
+                          SequenceNumber32(10001),
+                          "Sequence number differs from expected");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Available(), 10000, "Wrong number of available bytes");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.GetSackList().size(), 0, "SACK list should contain no element");
+
+    std::vector<uint8_t> stream;
+    while (rxBuf.Available() > 0)
+    {
+        Ptr<Packet> p = rxBuf.Extract(333);
+        NS_TEST_ASSERT_MSG_EQ(p->GetSize(),
+                              std::min<uint32_t>(333, 10000 - stream.size()),
+                              "Wrong size of the extracted data");
+        stream.resize(stream.size() + p->GetSize());
+        p->CopyData(stream.data() + stream.size() - p->GetSize(), p->GetSize());
+    }
+    NS_TEST_ASSERT_MSG_EQ(stream.size(), 10000, "Wrong number of extracted bytes");
+    for (uint32_t k = 0; k < stream.size(); k += 50)
+    {
+        NS_TEST_ASSERT_MSG_EQ(static_cast<uint32_t>(stream[k]),
+                              k / 100,
+                              "Wrong byte at offset " << k << " of the stream");
+    }
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Size(), 0, "Data left in the buffer");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Extract(100), nullptr, "Extracted data from an empty buffer");
+}
+
 void
 TcpRxBufferTestCase::DoTeardown()
 {
@@ -0,0 +1,343 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "tcp-general-test.h"
+
+#include "ns3/config.h"
+#include "ns3/double.h"
+#include "ns3/log.h"
+#include "ns3/rtt-estimator.h"
+#include "ns3/simulator.h"
+#include "ns3/tcp-socket-state.h"
+#include "ns3/tcp-swift.h"
+#include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("TcpSwiftTestSuite");
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Check that Swift paces windows below one segment
+ *
+ * A loss resets the window to MinCwnd: the tcb must keep one segment in the
+ * window, with a pacing gap of RTT/MinCwnd. Acknowledgments with a low delay
+ * then grow the window above one segment, and the pacing gap is removed.
+ */
+class TcpSwiftSubPacketWindowTest : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor
+     * \param minCwnd the MinCwnd attribute, in segments
+     * \param name description of the test
+     */
+    TcpSwiftSubPacketWindowTest(double minCwnd, const std::string& name);
+
+  private:
+    void DoRun() override;
+
+    double m_minCwnd; //!< Minimum window, in segments
+};
+
+TcpSwiftSubPacketWindowTest::TcpSwiftSubPacketWindowTest(double minCwnd, const std::string& name)
+    : TestCase(name),
+      m_minCwnd(minCwnd)
+{
+}
+
+void
+TcpSwiftSubPacketWindowTest::DoRun()
+{
+    const uint32_t segmentSize = 1000;
+    const Time rtt = MicroSeconds(50);
+
+    Ptr<TcpSocketState> state = CreateObject<TcpSocketState>();
+    state->m_segmentSize = segmentSize;
+    state->m_cWnd = 10 * segmentSize;
+    state->m_ssThresh = 5 * segmentSize;
+    state->m_srtt = rtt;
+    state->m_lastRtt = rtt;
+
+    Ptr<TcpSwift> cong = CreateObject<TcpSwift>();
+    cong->SetAttribute("MinCwnd", DoubleValue(m_minCwnd));
+    cong->SetAttribute("RetrxResetThreshold", UintegerValue(1));
+    cong->Init(state);
+    cong->PktsAcked(state, 1, rtt);
+
+    cong->CwndEvent(state, TcpSocketState::CA_EVENT_LOSS);
+    if (m_minCwnd < 1.0)
+    {
+        NS_TEST_EXPECT_MSG_EQ(state->m_cWnd.Get(),
+                              segmentSize,
+                              "A sub-segment window keeps one segment in the tcb");
+        NS_TEST_EXPECT_MSG_EQ(state->m_pacingGap,
+                              Seconds(rtt.GetSeconds() / m_minCwnd),
+                              "Segments should be paced RTT/cwnd apart");
+    }
+    else
+    {
+        NS_TEST_EXPECT_MSG_EQ(state->m_cWnd.Get(),
+                              static_cast<uint32_t>(m_minCwnd * segmentSize),
+                              "The window should be reset to MinCwnd");
+        NS_TEST_EXPECT_MSG_EQ(state->m_pacingGap, Seconds(0), "No pacing gap expected");
+    }
+
+    // Delays well below the target: additive increase of AI segments
+    cong->IncreaseWindow(state, 1);
+    NS_TEST_EXPECT_MSG_GT(state->m_cWnd.Get(), segmentSize, "The window should grow");
+    NS_TEST_EXPECT_MSG_EQ(state->m_pacingGap, Seconds(0), "The pacing gap should be removed");
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Check the pacing gap of a loss before the first RTT sample
+ *
+ * Without any RTT sample, the gap of a window below one segment is based
+ * on the initial estimate of the RTT estimators, rather than being zero.
+ */
+class TcpSwiftNoRttSampleTest : public TestCase
+{
+  public:
+    TcpSwiftNoRttSampleTest();
+
+  private:
+    void DoRun() override;
+};
+
+TcpSwiftNoRttSampleTest::TcpSwiftNoRttSampleTest()
+    : TestCase("Swift paces a sub-segment window before the first RTT sample")
+{
+}
+
+void
+TcpSwiftNoRttSampleTest::DoRun()
+{
+    const double minCwnd = 0.5;
+    Ptr<TcpSocketState> state = CreateObject<TcpSocketState>();
+    state->m_segmentSize = 1000;
+    state->m_cWnd = 10 * state->m_segmentSize;
+
+    Ptr<TcpSwift> cong = CreateObject<TcpSwift>();
+    cong->SetAttribute("MinCwnd", DoubleValue(minCwnd));
+    cong->SetAttribute("RetrxResetThreshold", UintegerValue(1));
+    cong->Init(state);
+    cong->CwndEvent(state, TcpSocketState::CA_EVENT_LOSS);
+
+    TypeId::AttributeInformation info;
+    RttEstimator::GetTypeId().LookupAttributeByName("InitialEstimation", &info);
+    Time initialRtt = DynamicCast<const TimeValue>(info.initialValue)->Get();
+    NS_TEST_EXPECT_MSG_EQ(state->m_cWnd.Get(), state->m_segmentSize, "One segment expected");
+    NS_TEST_EXPECT_MSG_EQ(state->m_pacingGap,
+                          Seconds(initialRtt.GetSeconds() / minCwnd),
+                          "The gap should be based on the initial RTT estimate");
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Check that a socket spaces its segments by the Swift pacing gap
+ *
+ * The RTT, well above the Swift targets, shrinks the window down to a
+ * MinCwnd below one segment.  Each data segment sent while the pacing gap
+ * is set must then follow the previous one by at least that gap, which is
+ * longer than the RTT which would otherwise clock the segments.
+ */
+class TcpSwiftPacingGapTest : public TcpGeneralTest
+{
+  public:
+    /**
+     * \brief Constructor
+     * \param desc description of the test
+     */
+    TcpSwiftPacingGapTest(const std::string& desc);
+
+  protected:
+    void ConfigureEnvironment() override;
+    void ConfigureProperties() override;
+    void Tx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who) override;
+    void FinalChecks() override;
+
+  private:
+    Time m_lastTx;            //!< Time of the last data segment of the sender
+    Time m_lastGap;           //!< Pacing gap when the last data segment was sent
+    uint32_t m_pacedSegments; //!< Data segments sent after a pacing gap
+};
+
+TcpSwiftPacingGapTest::TcpSwiftPacingGapTest(const std::string& desc)
+    : TcpGeneralTest(desc),
+      m_pacedSegments(0)
+{
+    m_congControlTypeId = TcpSwift::GetTypeId();
+}
+
+void
+TcpSwiftPacingGapTest::ConfigureEnvironment()
+{
+    TcpGeneralTest::ConfigureEnvironment();
+    SetAppPktSize(500);
+    SetAppPktCount(100);
+    SetAppPktInterval(NanoSeconds(10));
+    SetPropagationDelay(MilliSeconds(1));
+    Config::SetDefault("ns3::TcpSwift::MinCwnd", DoubleValue(0.25));
+}
+
+void
+TcpSwiftPacingGapTest::ConfigureProperties()
+{
+    TcpGeneralTest::ConfigureProperties();
+    SetSegmentSize(SENDER, 500);
+}
+
+void
+TcpSwiftPacingGapTest::Tx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who)
+{
+    if (who != SENDER || p->GetSize() == 0)
+    {
+        return;
+    }
+    if (m_lastGap.IsStrictlyPositive())
+    {
+        NS_TEST_ASSERT_MSG_GT_OR_EQ(Simulator::Now() - m_lastTx,
+                                    m_lastGap,
+                                    "Segment sent before the end of the pacing gap");
+        m_pacedSegments++;
+    }
+    Ptr<TcpSocketState> tcb = GetTcb(SENDER);
+    m_lastTx = Simulator::Now();
+    m_lastGap = tcb->m_cWnd <= tcb->m_segmentSize ? tcb->m_pacingGap : Seconds(0);
+}
+
+void
+TcpSwiftPacingGapTest::FinalChecks()
+{
+    NS_TEST_ASSERT_MSG_GT(m_pacedSegments, 0, "The window never fell below one segment");
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Check that the fabric and endpoint windows react to their own delay
+ *
+ * The same RTT sample, split differently between the fabric and the
+ * receiver host, grows the window when both shares are below their
+ * targets, and shrinks it when either share is above its target.
+ */
+class TcpSwiftWindowSplitTest : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor
+     * \param rtt the RTT sample of the ACK
+     * \param hostDelay the receiver host delay echoed with the ACK
+     * \param decrease true if the window should decrease
+     * \param name description of the test
+     */
+    TcpSwiftWindowSplitTest(Time rtt, Time hostDelay, bool decrease, const std::string& name);
+
+  private:
+    void DoRun() override;
+
+    /// Acknowledge one segment, once the window may decrease
+    void Ack();
+
+    Time m_rtt;                  //!< RTT sample of the ACK
+    Time m_hostDelay;            //!< Receiver host delay echoed with the ACK
+    bool m_decrease;             //!< True if the window should decrease
+    Ptr<TcpSocketState> m_state; //!< Congestion state
+    Ptr<TcpSwift> m_cong;        //!< Congestion control
+};
+
+TcpSwiftWindowSplitTest::TcpSwiftWindowSplitTest(Time rtt,
+                                                 Time hostDelay,
+                                                 bool decrease,
+                                                 const std::string& name)
+    : TestCase(name),
+      m_rtt(rtt),
+      m_hostDelay(hostDelay),
+      m_decrease(decrease)
+{
+}
+
+void
+TcpSwiftWindowSplitTest::DoRun()
+{
+    m_state = CreateObject<TcpSocketState>();
+    m_state->m_segmentSize = 1000;
+    m_state->m_cWnd = 10 * m_state->m_segmentSize;
+    m_state->m_ssThresh = 5 * m_state->m_segmentSize;
+    m_state->m_srtt = m_rtt;
+    m_state->m_lastRtt = m_rtt;
+
+    m_cong = CreateObject<TcpSwift>();
+    m_cong->Init(m_state);
+    m_cong->PktsAcked(m_state, 1, m_rtt);
+
+    // The windows may decrease once per RTT after the initialization
+    Simulator::Schedule(MilliSeconds(1), &TcpSwiftWindowSplitTest::Ack, this);
+    Simulator::Run();
+    Simulator::Destroy();
+}
+
+void
+TcpSwiftWindowSplitTest::Ack()
+{
+    uint32_t cWnd = m_state->m_cWnd;
+    m_state->m_lastHostDelay = m_hostDelay;
+    m_cong->IncreaseWindow(m_state, 1);
+    if (m_decrease)
+    {
+        NS_TEST_EXPECT_MSG_LT(m_state->m_cWnd.Get(), cWnd, "The window should decrease");
+    }
+    else
+    {
+        NS_TEST_EXPECT_MSG_GT(m_state->m_cWnd.Get(), cWnd, "The window should grow");
+    }
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief TcpSwift TestSuite
+ */
+class TcpSwiftTestSuite : public TestSuite
+{
+  public:
+    TcpSwiftTestSuite()
+        : TestSuite("tcp-swift-test", Type::UNIT)
+    {
+        AddTestCase(new TcpSwiftSubPacketWindowTest(0.01, "Swift paces a 0.01 segment window"),
+                    TestCase::Duration::QUICK);
+        AddTestCase(new TcpSwiftSubPacketWindowTest(0.5, "Swift paces a 0.5 segment window"),
+                    TestCase::Duration::QUICK);
+        AddTestCase(new TcpSwiftSubPacketWindowTest(1.0, "Swift does not pace a 1 segment window"),
+                    TestCase::Duration::QUICK);
+        AddTestCase(new TcpSwiftNoRttSampleTest(), TestCase::Duration::QUICK);
+        AddTestCase(new TcpSwiftPacingGapTest("Swift paces the segments of a socket"),
+                    TestCase::Duration::QUICK);
+        // The fabric target is about 356 us for a 10 segment window, and the
+        // endpoint target 100 us
+        AddTestCase(new TcpSwiftWindowSplitTest(MicroSeconds(300),
+                                                Seconds(0),
+                                                false,
+                                                "Swift grows with a low fabric delay"),
+                    TestCase::Duration::QUICK);
+        AddTestCase(new TcpSwiftWindowSplitTest(MicroSeconds(300),
+                                                MicroSeconds(250),
+                                                true,
+                                                "Swift shrinks with a high host delay"),
+                    TestCase::Duration::QUICK);
+        AddTestCase(new TcpSwiftWindowSplitTest(MicroSeconds(600),
+                                                MicroSeconds(50),
+                                                true,
+                                                "Swift shrinks with a high fabric delay"),
+                    TestCase::Duration::QUICK);
+    }
+};
+
+static TcpSwiftTestSuite g_tcpSwiftTest; //!< Static variable for test initialization
+
@@ -42,6 +42,8 @@ class TcpTxBufferTestCase : public TestCase
     /** \brief Test the logic of merging items in GetTransmittedSegment()
      * which is triggered by CopyFromSequence()*/
     void TestMergeItemsWhenGetTransmittedSegment();
+    /** \brief Test the scoreboard of a 10000-segment window with many losses */
+    void TestLargeWindow();
     /**
      * \brief Callback to provide a value of receiver window
      * \returns the receiver window size
@@ -89,6 +91,14 @@ TcpTxBufferTestCase::DoRun()
                         &TcpTxBufferTestCase::TestMergeItemsWhenGetTransmittedSegment,
                         this);
 
+    /*
+     * Case for a large window:
+     *  -> one segment out of ten is lost, and the others are SACKed one by one
+     *  -> the lost segments are marked as the SACKs arrive
+     *  -> NextSeg returns the lost segments in order
+     */
+    Simulator::Schedule(Seconds(0.0), &TcpTxBufferTestCase::TestLargeWindow, this);
+
     Simulator::Run();
     Simulator::Destroy();
 }
@@ -409,6 +419,97 @@ TcpTxBufferTestCase::TestMergeItemsWhenGetTransmittedSegment()
     txBuf.CopyFromSequence(2000, SequenceNumber32(1));
 }
 
+void
+TcpTxBufferTestCase::TestLargeWindow()
+{
+    const uint32_t segmentSize = 100;
+    const uint32_t window = 10000;
+    const uint32_t lossEvery = 10;
+    Ptr<TcpTxBuffer> txBuf = CreateObject<TcpTxBuffer>();
+    txBuf->SetRWndCallback(MakeCallback(&TcpTxBufferTestCase::GetRWnd, this));
+    SequenceNumber32 head(1);
+    txBuf->SetHeadSequence(head);
+    txBuf->SetMaxBufferSize(window * segmentSize);
+    txBuf->SetSegmentSize(segmentSize);
+    txBuf->SetDupAckThresh(3);
+    Ptr<TcpOptionSack> sack = CreateObject<TcpOptionSack>();
+
+    txBuf->Add(Create<Packet>(window * segmentSize));
+    for (uint32_t i = 0; i < window; ++i)
+    {
+        txBuf->CopyFromSequence(segmentSize, head + segmentSize * i);
+    }
+
+    for (uint32_t i = 1; i < window; ++i)
+    {
+        if (i % lossEvery == 0)
+        {
+            continue;
+        }
+        sack->ClearSackList();
+        sack->AddSackBlock(TcpOptionSack::SackBlock(head + segmentSize * i,
+                                                    head + segmentSize * (i + 1)));
+        txBuf->Update(sack->GetSackList());
+
+        if (i == window / 2 + 3)
+        {
+            // Three segments are SACKed above the hole in the middle
+            NS_TEST_ASSERT_MSG_EQ(txBuf->GetLost(),
+                                  (window / 2 / lossEvery + 1) * segmentSize,
+                                  "Wrong lost count in the middle of the window");
+            NS_TEST_ASSERT_MSG_EQ(txBuf->IsLost(head + segmentSize * (window / 2)),
+                                  true,
+                                  "The hole in the middle is not lost");
+            NS_TEST_ASSERT_MSG_EQ(txBuf->IsLost(head + segmentSize * (window / 2 + lossEvery)),
+                                  false,
+                                  "A segment above the highest SACK is lost");
+        }
+    }
+
+    const uint32_t holes = window / lossEvery;
+    NS_TEST_ASSERT_MSG_EQ(txBuf->GetSacked(),
+                          (window - holes) * segmentSize,
+                          "Wrong sacked count");
+    // The last hole has only SACKed segments above it
+    NS_TEST_ASSERT_MSG_EQ(txBuf->GetLost(), holes * segmentSize, "Wrong lost count");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->BytesInFlight(), 0, "Wrong bytes in flight");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->IsLost(head + segmentSize * (window - lossEvery)),
+                          true,
+                          "The last hole is not lost");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->IsLost(head + segmentSize * (window - 1)),
+                          false,
+                          "A SACKed segment is lost");
+
+    SequenceNumber32 ret;
+    SequenceNumber32 retHigh;
+    for (uint32_t i = 0; i < holes; ++i)
+    {
+        NS_TEST_ASSERT_MSG_EQ(txBuf->NextSeg(&ret, &retHigh, true),
+                              true,
+                              "No NextSeq with lost segments");
+        NS_TEST_ASSERT_MSG_EQ(ret,
+                              head + segmentSize * lossEvery * i,
+                              "Different NextSeq than the next hole");
+        txBuf->CopyFromSequence(segmentSize, ret);
+    }
+    NS_TEST_ASSERT_MSG_EQ(txBuf->NextSeg(&ret, &retHigh, true),
+                          false,
+                          "NextSeq returned with every hole retransmitted");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->BytesInFlight(),
+                          holes * segmentSize,
+                          "Wrong bytes in flight after the retransmissions");
+
+    // The retransmission of the first hole is acknowledged
+    txBuf->DiscardUpTo(head + segmentSize * lossEvery);
+    NS_TEST_ASSERT_MSG_EQ(txBuf->IsRetransmittedDataAcked(head + segmentSize * (lossEvery + 1)),
+                          true,
+                          "The retransmitted hole is not found");
+    txBuf->DiscardUpTo(head + segmentSize * window);
+    NS_TEST_ASSERT_MSG_EQ(txBuf->Size(), 0, "Data inside the buffer");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->GetLost(), 0, "Lost data left");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->GetRetransmitsCount(), 0, "Retransmitted data left");
+}
+
 void
 TcpTxBufferTestCase::TestTransmittedBlock()
 {
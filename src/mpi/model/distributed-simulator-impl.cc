@@ -622,4 +622,10 @@ DistributedSimulatorImpl::GetEventCount() const
     return m_eventCount;
 }
 
+uint64_t
+DistributedSimulatorImpl::GetPendingEventCount() const
+{
+    return m_unscheduledEvents;
+}
+
 } // namespace ns3
@@ -127,6 +127,7 @@ class DistributedSimulatorImpl : public SimulatorImpl
     uint32_t GetSystemId() const override;
     uint32_t GetContext() const override;
     uint64_t GetEventCount() const override;
+    uint64_t GetPendingEventCount() const override;
 
     /**
      * Add additional bound to lookahead constraints.
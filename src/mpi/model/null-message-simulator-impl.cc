@@ -545,6 +545,12 @@ NullMessageSimulatorImpl::GetEventCount() const
     return m_eventCount;
 }
 
+uint64_t
+NullMessageSimulatorImpl::GetPendingEventCount() const
+{
+    return m_unscheduledEvents;
+}
+
 Time
 NullMessageSimulatorImpl::CalculateGuaranteeTime(uint32_t nodeSysId)
 {
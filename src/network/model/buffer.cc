@@ -7,6 +7,8 @@
  */
 #include "buffer.h"
 
+#include "packet-pool.h"
+
 #include "ns3/assert.h"
 #include "ns3/log.h"
 
@@ -43,7 +45,11 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("Buffer");
 
+#ifdef NS3_MULTITHREADING
+thread_local uint32_t Buffer::g_recommendedStart = 0;
+#else
 uint32_t Buffer::g_recommendedStart = 0;
+#endif
 #ifdef BUFFER_FREE_LIST
 /* The following macros are pretty evil but they are needed to allow us to
  * keep track of 3 possible states for the g_freeList variable:
@@ -91,7 +97,16 @@ Buffer::Recycle(Buffer::Data* data)
 {
     NS_LOG_FUNCTION(data);
     NS_ASSERT(data->m_count == 0);
-    NS_ASSERT(!IS_UNINITIALIZED(g_freeList));
+    if (PacketPool::IsEnabled())
+    {
+        Buffer::Deallocate(data);
+        return;
+    }
+    if (IS_UNINITIALIZED(g_freeList))
+    {
+        // The buffers were all created while the packet pool was enabled
+        g_freeList = new Buffer::FreeList();
+    }
     g_maxSize = std::max(g_maxSize, data->m_size);
     /* feed into free list */
     if (data->m_size < g_maxSize || IS_DESTROYED(g_freeList) || g_freeList->size() > 1000)
@@ -110,6 +125,10 @@ Buffer::Create(uint32_t dataSize)
 {
     NS_LOG_FUNCTION(dataSize);
     /* try to find a buffer correctly sized. */
+    if (PacketPool::IsEnabled())
+    {
+        return Buffer::Allocate(dataSize);
+    }
     if (IS_UNINITIALIZED(g_freeList))
     {
         g_freeList = new Buffer::FreeList();
@@ -161,10 +180,10 @@ Buffer::Allocate(uint32_t reqSize)
     }
     NS_ASSERT(reqSize >= 1);
     reqSize += ALLOC_OVER_PROVISION;
-    uint32_t size = reqSize - 1 + sizeof(Buffer::Data);
-    auto b = new uint8_t[size];
-    auto data = reinterpret_cast<Buffer::Data*>(b);
-    data->m_size = reqSize;
+    // The slack of the size class of the block is usable data
+    std::size_t size = PacketPool::GetBlockSize(reqSize - 1 + sizeof(Buffer::Data));
+    auto data = static_cast<Buffer::Data*>(PacketPool::Allocate(size));
+    data->m_size = static_cast<uint32_t>(size + 1 - sizeof(Buffer::Data));
     data->m_count = 1;
     return data;
 }
@@ -174,8 +193,7 @@ Buffer::Deallocate(Buffer::Data* data)
 {
     NS_LOG_FUNCTION(data);
     NS_ASSERT(data->m_count == 0);
-    auto buf = reinterpret_cast<uint8_t*>(data);
-    delete[] buf;
+    PacketPool::Release(data, data->m_size - 1 + sizeof(Buffer::Data));
 }
 
 Buffer::Buffer()
@@ -396,15 +414,33 @@ Buffer::AddAtEnd(const Buffer& o)
 {
     NS_LOG_FUNCTION(this << &o);
 
-    if (m_data->m_count == 1 && (m_end == m_zeroAreaEnd || m_zeroAreaStart == m_zeroAreaEnd) &&
-        m_end == m_data->m_dirtyEnd && o.m_start == o.m_zeroAreaStart &&
-        o.m_zeroAreaEnd - o.m_zeroAreaStart > 0)
+    if ((m_end == m_zeroAreaEnd || m_zeroAreaStart == m_zeroAreaEnd) &&
+        o.m_start == o.m_zeroAreaStart && o.m_zeroAreaEnd - o.m_zeroAreaStart > 0)
     {
         /**
          * This is an optimization which kicks in when
          * we attempt to aggregate two buffers which contain
          * adjacent zero areas.
          */
+        if (m_data->m_count != 1 || m_end != m_data->m_dirtyEnd)
+        {
+            /**
+             * The data is shared with other buffers, typically the
+             * fragments of the same payload: move our bytes to data
+             * of our own, but keep our zero area virtual rather than
+             * making a full copy.
+             */
+            Buffer tmp(m_zeroAreaEnd - m_zeroAreaStart);
+            uint32_t dataStart = m_zeroAreaStart - m_start;
+            tmp.AddAtStart(dataStart);
+            tmp.Begin().Write(m_data->m_data + m_start, dataStart);
+            uint32_t dataEnd = m_end - m_zeroAreaEnd;
+            tmp.AddAtEnd(dataEnd);
+            Buffer::Iterator i = tmp.End();
+            i.Prev(dataEnd);
+            i.Write(m_data->m_data + m_zeroAreaStart, dataEnd);
+            *this = tmp;
+        }
         if (m_zeroAreaStart == m_zeroAreaEnd)
         {
             m_zeroAreaStart = m_end;
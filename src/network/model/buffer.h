@@ -14,7 +14,11 @@
 #include <stdint.h>
 #include <vector>
 
+// The free list is shared by all the threads, so the multithreaded builds
+// leave the recycling of the buffers to the allocator
+#ifndef NS3_MULTITHREADING
 #define BUFFER_FREE_LIST 1
+#endif
 
 namespace ns3
 {
@@ -55,10 +59,11 @@ namespace ns3
  * contains real data bytes in its BufferData instance but it also
  * contains "virtual zero data" which typically is used to represent
  * application-level payload. No memory is allocated to store the
- * zero bytes of application-level payload unless the user fragments
- * a Buffer: this application-level payload is kept track of with
- * a pair of integers which describe where in the buffer content
- * the "virtual zero area" starts and ends.
+ * zero bytes of application-level payload, even when the user fragments
+ * a Buffer and concatenates the fragments again, unless real data ends
+ * up on both sides of the zero bytes: this application-level payload
+ * is kept track of with a pair of integers which describe where in the
+ * buffer content the "virtual zero area" starts and ends.
  *
  * \verbatim
  * ***: unused bytes
@@ -758,7 +763,11 @@ class Buffer
      * writing data. i.e., m_start should be initialized to this
      * value.
      */
+#ifdef NS3_MULTITHREADING
+    static thread_local uint32_t g_recommendedStart;
+#else
     static uint32_t g_recommendedStart;
+#endif
 
     /**
      * offset to the start of the virtual zero area from the start
@@ -7,13 +7,17 @@
  */
 #include "byte-tag-list.h"
 
+#include "packet-pool.h"
+
 #include "ns3/log.h"
 
 #include <cstring>
 #include <limits>
 #include <vector>
 
+#ifndef NS3_MULTITHREADING
 #define USE_FREE_LIST 1
+#endif
 #define FREE_LIST_SIZE 1000
 #define OFFSET_MAX (std::numeric_limits<int32_t>::max())
 
@@ -37,6 +41,34 @@ struct ByteTagListData
     uint8_t data[4]; //!< data
 };
 
+/**
+ * Allocate the data of a ByteTagList.
+ *
+ * \param [in] size The size of the data area.
+ * \returns The data, whose size is at least \pname{size}.
+ */
+static ByteTagListData*
+NewByteTagListData(uint32_t size)
+{
+    std::size_t blockSize = PacketPool::GetBlockSize(size + sizeof(ByteTagListData) - 4);
+    auto data = static_cast<ByteTagListData*>(PacketPool::Allocate(blockSize));
+    data->size = static_cast<uint32_t>(blockSize + 4 - sizeof(ByteTagListData));
+    data->count = 1;
+    data->dirty = 0;
+    return data;
+}
+
+/**
+ * Release the data of a ByteTagList.
+ *
+ * \param [in] data The data.
+ */
+static void
+DeleteByteTagListData(ByteTagListData* data)
+{
+    PacketPool::Release(data, data->size + sizeof(ByteTagListData) - 4);
+}
+
 #ifdef USE_FREE_LIST
 /**
  * \ingroup packet
@@ -58,8 +90,7 @@ ByteTagListDataFreeList::~ByteTagListDataFreeList()
     NS_LOG_FUNCTION(this);
     for (auto i = begin(); i != end(); i++)
     {
-        auto buffer = (uint8_t*)(*i);
-        delete[] buffer;
+        DeleteByteTagListData(*i);
     }
 }
 #endif /* USE_FREE_LIST */
@@ -344,6 +375,10 @@ ByteTagListData*
 ByteTagList::Allocate(uint32_t size)
 {
     NS_LOG_FUNCTION(this << size);
+    if (PacketPool::IsEnabled())
+    {
+        return NewByteTagListData(size);
+    }
     while (!g_freeList.empty())
     {
         ByteTagListData* data = g_freeList.back();
@@ -355,15 +390,9 @@ ByteTagList::Allocate(uint32_t size)
             data->dirty = 0;
             return data;
         }
-        auto buffer = (uint8_t*)data;
-        delete[] buffer;
+        DeleteByteTagListData(data);
     }
-    auto buffer = new uint8_t[std::max(size, g_maxSize) + sizeof(ByteTagListData) - 4];
-    auto data = (ByteTagListData*)buffer;
-    data->count = 1;
-    data->size = size;
-    data->dirty = 0;
-    return data;
+    return NewByteTagListData(std::max(size, g_maxSize));
 }
 
 void
@@ -378,10 +407,14 @@ ByteTagList::Deallocate(ByteTagListData* data)
     data->count--;
     if (data->count == 0)
     {
+        if (PacketPool::IsEnabled())
+        {
+            DeleteByteTagListData(data);
+            return;
+        }
         if (g_freeList.size() > FREE_LIST_SIZE || data->size < g_maxSize)
         {
-            auto buffer = (uint8_t*)data;
-            delete[] buffer;
+            DeleteByteTagListData(data);
         }
         else
         {
@@ -396,12 +429,7 @@ ByteTagListData*
 ByteTagList::Allocate(uint32_t size)
 {
     NS_LOG_FUNCTION(this << size);
-    uint8_t* buffer = new uint8_t[size + sizeof(ByteTagListData) - 4];
-    ByteTagListData* data = (ByteTagListData*)buffer;
-    data->count = 1;
-    data->size = size;
-    data->dirty = 0;
-    return data;
+    return NewByteTagListData(size);
 }
 
 void
@@ -415,8 +443,7 @@ ByteTagList::Deallocate(ByteTagListData* data)
     data->count--;
     if (data->count == 0)
     {
-        uint8_t* buffer = (uint8_t*)data;
-        delete[] buffer;
+        DeleteByteTagListData(data);
     }
 }
 
@@ -29,4 +29,10 @@ NetDevice::~NetDevice()
     NS_LOG_FUNCTION(this);
 }
 
+bool
+NetDevice::SupportsSegmentationOffload() const
+{
+    return false;
+}
+
 } // namespace ns3
@@ -356,6 +356,15 @@ class NetDevice : public Object
      * \return true if this interface supports a bridging mode, false otherwise.
      */
     virtual bool SupportsSendFrom() const = 0;
+
+    /**
+     * \return true if this interface splits the packets marked with a
+     * SegmentationOffloadTag into segments, false otherwise.
+     *
+     * The packets sent to the interfaces which do not support segmentation
+     * offload are split by the upper layers.
+     */
+    virtual bool SupportsSegmentationOffload() const;
 };
 
 } // namespace ns3
@@ -9,11 +9,13 @@
 
 #include "buffer.h"
 #include "header.h"
+#include "packet-pool.h"
 #include "trailer.h"
 
 #include "ns3/assert.h"
 #include "ns3/fatal-error.h"
 #include "ns3/log.h"
+#include "ns3/simulator.h"
 
 #include <list>
 #include <utility>
@@ -26,9 +28,16 @@ NS_LOG_COMPONENT_DEFINE("PacketMetadata");
 bool PacketMetadata::m_enable = false;
 bool PacketMetadata::m_enableChecking = false;
 bool PacketMetadata::m_metadataSkipped = false;
+std::vector<bool> PacketMetadata::m_enabledNodes;
+#ifdef NS3_MULTITHREADING
+thread_local uint32_t PacketMetadata::m_maxSize = 0;
+thread_local uint16_t PacketMetadata::m_chunkUid = 0;
+thread_local PacketMetadata::DataFreeList PacketMetadata::m_freeList;
+#else
 uint32_t PacketMetadata::m_maxSize = 0;
 uint16_t PacketMetadata::m_chunkUid = 0;
 PacketMetadata::DataFreeList PacketMetadata::m_freeList;
+#endif
 
 PacketMetadata::DataFreeList::~DataFreeList()
 {
@@ -44,7 +53,9 @@ void
 PacketMetadata::Enable()
 {
     NS_LOG_FUNCTION_NOARGS();
-    NS_ASSERT_MSG(!m_metadataSkipped,
+    // The packets created before this call do not record their metadata, but
+    // without EnableForNode() this is most likely a mistake.
+    NS_ASSERT_MSG(!m_metadataSkipped || !m_enabledNodes.empty(),
                   "Error: attempting to enable the packet metadata "
                   "subsystem too late in the simulation, which is not allowed.\n"
                   "A common cause for this problem is to enable ASCII tracing "
@@ -62,17 +73,52 @@ PacketMetadata::EnableChecking()
     m_enableChecking = true;
 }
 
+void
+PacketMetadata::EnableForNode(uint32_t nodeId)
+{
+    NS_LOG_FUNCTION(nodeId);
+    if (m_enabledNodes.empty())
+    {
+        Simulator::ScheduleDestroy(&PacketMetadata::ClearEnabledNodes);
+    }
+    if (nodeId >= m_enabledNodes.size())
+    {
+        m_enabledNodes.resize(nodeId + 1, false);
+    }
+    m_enabledNodes[nodeId] = true;
+}
+
+void
+PacketMetadata::ClearEnabledNodes()
+{
+    NS_LOG_FUNCTION_NOARGS();
+    m_enabledNodes.clear();
+    // The packets skipped so far were expected to be: only a later
+    // simulation can enable the packet metadata too late.
+    m_metadataSkipped = false;
+}
+
+bool
+PacketMetadata::IsContextEnabled()
+{
+    uint32_t context = Simulator::GetContext();
+    return context < m_enabledNodes.size() && m_enabledNodes[context];
+}
+
 void
 PacketMetadata::ReserveCopy(uint32_t size)
 {
     NS_LOG_FUNCTION(this << size);
     PacketMetadata::Data* newData = PacketMetadata::Create(m_used + size);
-    memcpy(newData->m_data, m_data->m_data, m_used);
     newData->m_dirtyEnd = m_used;
-    m_data->m_count--;
-    if (m_data->m_count == 0)
+    if (m_data != nullptr)
     {
-        PacketMetadata::Recycle(m_data);
+        memcpy(newData->m_data, m_data->m_data, m_used);
+        m_data->m_count--;
+        if (m_data->m_count == 0)
+        {
+            PacketMetadata::Recycle(m_data);
+        }
     }
     m_data = newData;
     if (m_head != 0xffff)
@@ -125,6 +171,10 @@ bool
 PacketMetadata::IsStateOk() const
 {
     NS_LOG_FUNCTION(this);
+    if (m_data == nullptr)
+    {
+        return m_head == 0xffff && m_tail == 0xffff && m_used == 0;
+    }
     bool ok = m_used <= m_data->m_size;
     ok &= IsPointerOk(m_head);
     ok &= IsPointerOk(m_tail);
@@ -368,12 +418,11 @@ PacketMetadata::AddSmall(const PacketMetadata::SmallItem* item)
 {
     NS_LOG_FUNCTION(this << item->next << item->prev << item->typeUid << item->size
                          << item->chunkUid);
-    NS_ASSERT(m_data != nullptr);
     NS_ASSERT(m_used != item->prev && m_used != item->next);
     uint32_t typeUidSize = GetUleb128Size(item->typeUid);
     uint32_t sizeSize = GetUleb128Size(item->size);
     uint32_t n = 2 + 2 + typeUidSize + sizeSize + 2;
-    if (m_used + n > m_data->m_size ||
+    if (m_data == nullptr || m_used + n > m_data->m_size ||
         (m_head != 0xffff && m_data->m_count != 1 && m_used != m_data->m_dirtyEnd))
     {
         ReserveCopy(n);
@@ -400,7 +449,6 @@ PacketMetadata::AddBig(uint32_t next,
     NS_LOG_FUNCTION(this << next << prev << item->next << item->prev << item->typeUid << item->size
                          << item->chunkUid << extraItem->fragmentStart << extraItem->fragmentEnd
                          << extraItem->packetUid);
-    NS_ASSERT(m_data != nullptr);
     uint32_t typeUid = ((item->typeUid & 0x1) == 0x1) ? item->typeUid : item->typeUid + 1;
     NS_ASSERT(m_used != prev && m_used != next);
 
@@ -410,7 +458,7 @@ PacketMetadata::AddBig(uint32_t next,
     uint32_t fragEndSize = GetUleb128Size(extraItem->fragmentEnd);
     uint32_t n = 2 + 2 + typeUidSize + sizeSize + 2 + fragStartSize + fragEndSize + 4;
 
-    if (m_used + n > m_data->m_size ||
+    if (m_data == nullptr || m_used + n > m_data->m_size ||
         (m_head != 0xffff && m_data->m_count != 1 && m_used != m_data->m_dirtyEnd))
     {
         ReserveCopy(n);
@@ -609,9 +657,10 @@ PacketMetadata::Allocate(uint32_t n)
         n = PACKET_METADATA_DATA_M_DATA_SIZE;
     }
     size += n - PACKET_METADATA_DATA_M_DATA_SIZE;
-    auto buf = new uint8_t[size];
-    auto data = (PacketMetadata::Data*)buf;
-    data->m_size = n;
+    // The slack of the size class of the block is usable data
+    std::size_t blockSize = PacketPool::GetBlockSize(size);
+    auto data = static_cast<PacketMetadata::Data*>(PacketPool::Allocate(blockSize));
+    data->m_size = static_cast<uint32_t>(n + blockSize - size);
     data->m_count = 1;
     data->m_dirtyEnd = 0;
     return data;
@@ -621,8 +670,8 @@ void
 PacketMetadata::Deallocate(PacketMetadata::Data* data)
 {
     NS_LOG_FUNCTION(data);
-    auto buf = (uint8_t*)data;
-    delete[] buf;
+    PacketPool::Release(data,
+                        sizeof(Data) + data->m_size - PACKET_METADATA_DATA_M_DATA_SIZE);
 }
 
 PacketMetadata
@@ -648,7 +697,7 @@ void
 PacketMetadata::DoAddHeader(uint32_t uid, uint32_t size)
 {
     NS_LOG_FUNCTION(this << uid << size);
-    if (!m_enable)
+    if (m_data == nullptr)
     {
         m_metadataSkipped = true;
         return;
@@ -670,7 +719,7 @@ PacketMetadata::RemoveHeader(const Header& header, uint32_t size)
 {
     uint32_t uid = header.GetInstanceTypeId().GetUid() << 1;
     NS_LOG_FUNCTION(this << &header << size);
-    if (!m_enable)
+    if (m_data == nullptr)
     {
         m_metadataSkipped = true;
         return;
@@ -715,7 +764,7 @@ PacketMetadata::AddTrailer(const Trailer& trailer, uint32_t size)
 {
     uint32_t uid = trailer.GetInstanceTypeId().GetUid() << 1;
     NS_LOG_FUNCTION(this << &trailer << size);
-    if (!m_enable)
+    if (m_data == nullptr)
     {
         m_metadataSkipped = true;
         return;
@@ -737,7 +786,7 @@ PacketMetadata::RemoveTrailer(const Trailer& trailer, uint32_t size)
 {
     uint32_t uid = trailer.GetInstanceTypeId().GetUid() << 1;
     NS_LOG_FUNCTION(this << &trailer << size);
-    if (!m_enable)
+    if (m_data == nullptr)
     {
         m_metadataSkipped = true;
         return;
@@ -781,11 +830,27 @@ void
 PacketMetadata::AddAtEnd(const PacketMetadata& o)
 {
     NS_LOG_FUNCTION(this << &o);
-    if (!m_enable)
+    if (m_data == nullptr)
     {
         m_metadataSkipped = true;
         return;
     }
+    if (o.m_data == nullptr)
+    {
+        // The metadata of the other packet is not recorded, e.g., it was
+        // created before Enable(), so this packet can no longer describe
+        // all its bytes.
+        m_data->m_count--;
+        if (m_data->m_count == 0)
+        {
+            PacketMetadata::Recycle(m_data);
+        }
+        m_data = nullptr;
+        m_head = 0xffff;
+        m_tail = 0xffff;
+        m_used = 0;
+        return;
+    }
     if (m_tail == 0xffff)
     {
         // We have no items so 'AddAtEnd' is
@@ -857,7 +922,7 @@ void
 PacketMetadata::AddPaddingAtEnd(uint32_t end)
 {
     NS_LOG_FUNCTION(this << end);
-    if (!m_enable)
+    if (m_data == nullptr)
     {
         m_metadataSkipped = true;
         return;
@@ -868,12 +933,11 @@ void
 PacketMetadata::RemoveAtStart(uint32_t start)
 {
     NS_LOG_FUNCTION(this << start);
-    if (!m_enable)
+    if (m_data == nullptr)
     {
         m_metadataSkipped = true;
         return;
     }
-    NS_ASSERT(m_data != nullptr);
     uint32_t leftToRemove = start;
     uint16_t current = m_head;
     while (current != 0xffff && leftToRemove > 0)
@@ -929,12 +993,11 @@ void
 PacketMetadata::RemoveAtEnd(uint32_t end)
 {
     NS_LOG_FUNCTION(this << end);
-    if (!m_enable)
+    if (m_data == nullptr)
     {
         m_metadataSkipped = true;
         return;
     }
-    NS_ASSERT(m_data != nullptr);
 
     uint32_t leftToRemove = end;
     uint16_t current = m_tail;
@@ -1113,7 +1176,7 @@ PacketMetadata::GetSerializedSize() const
     // if packet-metadata not enabled, total size
     // is simply 4-bytes for itself plus 8-bytes
     // for packet uid
-    if (!m_enable)
+    if (m_data == nullptr)
     {
         return totalSize;
     }
@@ -65,6 +65,14 @@ class Trailer;
  * integers, and some others as variable-size 32-bit integers.
  * The variable-size 32 bit integers are stored using the uleb128
  * encoding.
+ *
+ * The byte buffer is allocated only for the packets whose metadata is
+ * recorded, i.e., all the packets after Enable(), or the packets created
+ * by the nodes selected with EnableForNode().  The other packets carry
+ * no buffer, and their operations return at once.  The copies and
+ * fragments of a packet keep recording its metadata, so selecting the
+ * node which sends a flow records the metadata of that flow along its
+ * whole path, without slowing down the other packets.
  */
 class PacketMetadata
 {
@@ -158,6 +166,17 @@ class PacketMetadata
      * \brief Enable the packet metadata checking
      */
     static void EnableChecking();
+    /**
+     * \brief Enable the packet metadata of the packets created by a node
+     *
+     * The packets created while the simulator runs an event of the node,
+     * see Simulator::GetContext(), record their metadata, and so do their
+     * copies and fragments.  The other packets do not, unless Enable()
+     * is called.  The selection lasts until Simulator::Destroy().
+     *
+     * \param nodeId the id of the node
+     */
+    static void EnableForNode(uint32_t nodeId);
 
     /**
      * \brief Constructor
@@ -221,6 +240,10 @@ class PacketMetadata
 
     /**
      * \brief Add a metadata at the metadata start
+     *
+     * If the other metadata is not recorded, this one stops recording,
+     * since it could no longer describe all the bytes of the packet.
+     *
      * \param o the metadata to add
      */
     void AddAtEnd(const PacketMetadata& o);
@@ -601,6 +624,22 @@ class PacketMetadata
      */
     void ReserveCopy(uint32_t n);
 
+    /**
+     * \brief Check if the packets created in the current context record
+     *        their metadata
+     * \returns true if the node of the current context was selected by
+     *          EnableForNode()
+     */
+    static bool IsContextEnabled();
+
+    /**
+     * \brief Forget the nodes selected by EnableForNode()
+     *
+     * Scheduled with Simulator::ScheduleDestroy() so that the selection does not
+     * leak into the next simulation of the same process.
+     */
+    static void ClearEnabledNodes();
+
     /**
      * \brief Get the total size used by the metadata
      * \return the metadata used size
@@ -664,21 +703,31 @@ class PacketMetadata
      */
     static void Deallocate(PacketMetadata::Data* data);
 
+#ifdef NS3_MULTITHREADING
+    static thread_local DataFreeList m_freeList; //!< the metadata data storage
+#else
     static DataFreeList m_freeList; //!< the metadata data storage
-    static bool m_enable;           //!< Enable the packet metadata
-    static bool m_enableChecking;   //!< Enable the packet metadata checking
+#endif
+    static bool m_enable;                    //!< Enable the packet metadata
+    static bool m_enableChecking;            //!< Enable the packet metadata checking
+    static std::vector<bool> m_enabledNodes; //!< Nodes selected by EnableForNode()
 
     /**
      * Set to true when adding metadata to a packet is skipped because
-     * m_enable is false; used to detect enabling of metadata in the
+     * the metadata of the packet is not recorded; used to detect enabling of metadata in the
      * middle of a simulation, which isn't allowed.
      */
     static bool m_metadataSkipped;
 
+#ifdef NS3_MULTITHREADING
+    static thread_local uint32_t m_maxSize;  //!< maximum metadata size
+    static thread_local uint16_t m_chunkUid; //!< Chunk Uid
+#else
     static uint32_t m_maxSize;  //!< maximum metadata size
     static uint16_t m_chunkUid; //!< Chunk Uid
+#endif
 
-    Data* m_data; //!< Metadata storage
+    Data* m_data; //!< Metadata storage, null if the metadata is not recorded
     /*
        head -(next)-> tail
          ^             |
@@ -696,13 +745,17 @@ namespace ns3
 {
 
 PacketMetadata::PacketMetadata(uint64_t uid, uint32_t size)
-    : m_data(PacketMetadata::Create(10)),
+    : m_data(nullptr),
       m_head(0xffff),
       m_tail(0xffff),
       m_used(0),
       m_packetUid(uid)
 {
-    memset(m_data->m_data, 0xff, 4);
+    if (m_enable || (!m_enabledNodes.empty() && IsContextEnabled()))
+    {
+        m_data = PacketMetadata::Create(10);
+        memset(m_data->m_data, 0xff, 4);
+    }
     if (size > 0)
     {
         DoAddHeader(0, size);
@@ -716,9 +769,11 @@ PacketMetadata::PacketMetadata(const PacketMetadata& o)
       m_used(o.m_used),
       m_packetUid(o.m_packetUid)
 {
-    NS_ASSERT(m_data != nullptr);
-    NS_ASSERT(m_data->m_count < std::numeric_limits<uint32_t>::max());
-    m_data->m_count++;
+    if (m_data != nullptr)
+    {
+        NS_ASSERT(m_data->m_count < std::numeric_limits<uint32_t>::max());
+        m_data->m_count++;
+    }
 }
 
 PacketMetadata&
@@ -727,15 +782,19 @@ PacketMetadata::operator=(const PacketMetadata& o)
     if (m_data != o.m_data)
     {
         // not self assignment
-        NS_ASSERT(m_data != nullptr);
-        m_data->m_count--;
-        if (m_data->m_count == 0)
+        if (m_data != nullptr)
         {
-            PacketMetadata::Recycle(m_data);
+            m_data->m_count--;
+            if (m_data->m_count == 0)
+            {
+                PacketMetadata::Recycle(m_data);
+            }
         }
         m_data = o.m_data;
-        NS_ASSERT(m_data != nullptr);
-        m_data->m_count++;
+        if (m_data != nullptr)
+        {
+            m_data->m_count++;
+        }
     }
     m_head = o.m_head;
     m_tail = o.m_tail;
@@ -746,11 +805,13 @@ PacketMetadata::operator=(const PacketMetadata& o)
 
 PacketMetadata::~PacketMetadata()
 {
-    NS_ASSERT(m_data != nullptr);
-    m_data->m_count--;
-    if (m_data->m_count == 0)
+    if (m_data != nullptr)
     {
-        PacketMetadata::Recycle(m_data);
+        m_data->m_count--;
+        if (m_data->m_count == 0)
+        {
+            PacketMetadata::Recycle(m_data);
+        }
     }
 }
 
@@ -0,0 +1,242 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "packet-pool.h"
+
+#include "ns3/assert.h"
+#include "ns3/boolean.h"
+#include "ns3/global-value.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <new>
+
+namespace ns3
+{
+
+/**
+ * \relates PacketPool
+ * \anchor GlobalValuePacketPool
+ * \brief A global switch to enable the pool of the memory of packets.
+ */
+static GlobalValue g_packetPool =
+    GlobalValue("PacketPool",
+                "A global switch to keep the memory of released packets in "
+                "per-thread free lists, and reuse it for the next packets",
+                BooleanValue(false),
+                MakeBooleanChecker());
+
+namespace
+{
+
+/**
+ * Whether the pool is enabled: -1 until the PacketPool global value is
+ * read, then 0 or 1.
+ */
+std::atomic<int> g_enabled{-1};
+
+/**
+ * \ingroup packet
+ * Per-thread free lists of packet memory blocks.
+ */
+class PacketPoolCache
+{
+  public:
+    /** Number of size classes per power of two. */
+    static constexpr std::size_t STEPS = 4;
+    /** Number of size classes. */
+    static constexpr std::size_t N_CLASSES =
+        (std::bit_width(PacketPool::MAX_BLOCK_SIZE) - std::bit_width(PacketPool::MIN_BLOCK_SIZE)) *
+            STEPS +
+        1;
+    /** Maximum number of bytes kept in the free list of a size class. */
+    static constexpr std::size_t MAX_FREE_BYTES = 4 * 1024 * 1024;
+    /** Minimum and maximum number of blocks kept per size class. */
+    static constexpr uint32_t MIN_FREE = 16;
+    static constexpr uint32_t MAX_FREE = 4096; //!< \copydoc MIN_FREE
+
+    /** Release the blocks of the free lists. */
+    ~PacketPoolCache();
+
+    /**
+     * \param [in] size The size of a block, at most MAX_BLOCK_SIZE.
+     * \returns The smallest size class whose blocks hold \pname{size} bytes.
+     */
+    static constexpr std::size_t GetClass(std::size_t size)
+    {
+        if (size <= PacketPool::MIN_BLOCK_SIZE)
+        {
+            return 0;
+        }
+        // Index of the class of the largest size below size, plus one
+        std::size_t exponent = std::bit_width(size - 1) - 1;
+        std::size_t step = ((size - 1) >> (exponent - 2)) & (STEPS - 1);
+        return (exponent + 1 - std::bit_width(PacketPool::MIN_BLOCK_SIZE)) * STEPS + step + 1;
+    }
+
+    /**
+     * \param [in] sizeClass The size class.
+     * \returns The size of the blocks of the size class.
+     */
+    static constexpr std::size_t GetClassSize(std::size_t sizeClass)
+    {
+        std::size_t exponent = std::bit_width(PacketPool::MIN_BLOCK_SIZE) - 1 + sizeClass / STEPS;
+        return (STEPS + sizeClass % STEPS) << (exponent - 2);
+    }
+
+    /**
+     * Get a block from a free list, or from the heap if the list is empty.
+     * \param [in] sizeClass The size class.
+     * \returns The block.
+     */
+    void* Allocate(std::size_t sizeClass);
+
+    /**
+     * Put a block on a free list, or release it if the list is full.
+     * \param [in] p The block.
+     * \param [in] sizeClass The size class.
+     */
+    void Release(void* p, std::size_t sizeClass);
+
+  private:
+    /** A free block. */
+    struct Block
+    {
+        Block* next; //!< Next free block of the size class
+    };
+
+    std::array<Block*, N_CLASSES> m_free{};    //!< Free lists
+    std::array<uint32_t, N_CLASSES> m_nFree{}; //!< Lengths of the free lists
+};
+
+static_assert(PacketPoolCache::GetClassSize(PacketPoolCache::N_CLASSES - 1) ==
+                  PacketPool::MAX_BLOCK_SIZE,
+              "The largest size class must be MAX_BLOCK_SIZE");
+
+/** Free lists of the thread. */
+thread_local PacketPoolCache t_packetPool;
+/**
+ * Whether the free lists of the thread were destroyed.  Packets released
+ * during the destruction of static objects, after the thread_local objects
+ * of the main thread, go straight back to the heap.
+ */
+thread_local bool t_packetPoolDestroyed = false;
+
+PacketPoolCache::~PacketPoolCache()
+{
+    for (std::size_t i = 0; i < N_CLASSES; ++i)
+    {
+        while (m_free[i])
+        {
+            Block* block = m_free[i];
+            m_free[i] = block->next;
+            ::operator delete(block);
+        }
+    }
+    t_packetPoolDestroyed = true;
+}
+
+void*
+PacketPoolCache::Allocate(std::size_t sizeClass)
+{
+    Block* block = m_free[sizeClass];
+    if (block)
+    {
+        m_free[sizeClass] = block->next;
+        --m_nFree[sizeClass];
+        return block;
+    }
+    return ::operator new(GetClassSize(sizeClass));
+}
+
+void
+PacketPoolCache::Release(void* p, std::size_t sizeClass)
+{
+    auto maxFree = static_cast<uint32_t>(
+        std::clamp<std::size_t>(MAX_FREE_BYTES / GetClassSize(sizeClass), MIN_FREE, MAX_FREE));
+    if (m_nFree[sizeClass] >= maxFree)
+    {
+        ::operator delete(p);
+        return;
+    }
+    auto block = static_cast<Block*>(p);
+    block->next = m_free[sizeClass];
+    m_free[sizeClass] = block;
+    ++m_nFree[sizeClass];
+}
+
+} // unnamed namespace
+
+bool
+PacketPool::IsEnabled()
+{
+    int enabled = g_enabled.load(std::memory_order_relaxed);
+    if (enabled < 0)
+    {
+        // Packets allocated by static constructors may come before the
+        // registration of the global value, in which case it is read later.
+        BooleanValue value;
+        if (!GlobalValue::GetValueByNameFailSafe("PacketPool", value))
+        {
+            return false;
+        }
+        enabled = value.Get() ? 1 : 0;
+        g_enabled.store(enabled, std::memory_order_relaxed);
+    }
+#ifdef NS3_ASSERT_ENABLE
+    else
+    {
+        // The global value is only read once, which is too late for a
+        // change made after the first packet
+        BooleanValue value;
+        g_packetPool.GetValue(value);
+        NS_ASSERT_MSG(value.Get() == (enabled > 0),
+                      "The PacketPool global value was changed after the first packet was "
+                      "created; change it before, or call PacketPool::SetEnabled()");
+    }
+#endif
+    return enabled > 0;
+}
+
+void
+PacketPool::SetEnabled(bool enabled)
+{
+    g_packetPool.SetValue(BooleanValue(enabled));
+    g_enabled.store(enabled ? 1 : 0, std::memory_order_relaxed);
+}
+
+std::size_t
+PacketPool::GetBlockSize(std::size_t size)
+{
+    if (size > MAX_BLOCK_SIZE)
+    {
+        return size;
+    }
+    return PacketPoolCache::GetClassSize(PacketPoolCache::GetClass(size));
+}
+
+void*
+PacketPool::Allocate(std::size_t size)
+{
+    if (size > MAX_BLOCK_SIZE || !IsEnabled() || t_packetPoolDestroyed)
+    {
+        return ::operator new(GetBlockSize(size));
+    }
+    return t_packetPool.Allocate(PacketPoolCache::GetClass(size));
+}
+
+void
+PacketPool::Release(void* p, std::size_t size)
+{
+    if (size > MAX_BLOCK_SIZE || !IsEnabled() || t_packetPoolDestroyed)
+    {
+        ::operator delete(p);
+        return;
+    }
+    t_packetPool.Release(p, PacketPoolCache::GetClass(size));
+}
+
+} // namespace ns3
@@ -0,0 +1,88 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef PACKET_POOL_H
+#define PACKET_POOL_H
+
+#include <cstddef>
+#include <stdint.h>
+
+namespace ns3
+{
+
+/**
+ * \ingroup packet
+ *
+ * \brief Size-class pool of the memory of packets.
+ *
+ * The Packet objects, the data of their Buffer, the nodes of their
+ * PacketTagList and the data of their ByteTagList are allocated through
+ * this pool.  When the pool is enabled, the blocks released by packets
+ * are kept in per-thread free lists, one per size class, and handed out
+ * again to the next packets, so that forwarding a packet does not usually
+ * reach malloc.
+ *
+ * The size classes are four per power of two, from 32 bytes to 128 KiB;
+ * larger blocks bypass the pool.  Since a block released by a thread
+ * joins the free lists of that thread, packets may be freed by another
+ * thread than the one which allocated them.
+ *
+ * The blocks are always rounded up to their size class, so that the blocks
+ * allocated while the pool is disabled can be released to it after it is
+ * enabled, and conversely.  The pool is disabled by default, in which case
+ * the blocks come straight from the heap.  It is enabled by the
+ * \ref GlobalValuePacketPool "PacketPool" global value, e.g.,
+ * \c --PacketPool=1 on the command line, or at any time with SetEnabled().
+ * The global value is only read when the first block is allocated, so it
+ * must be set before the first packet is created; debug builds abort if
+ * it changes afterwards.
+ */
+class PacketPool
+{
+  public:
+    /** Size of the smallest size class, in bytes. */
+    static constexpr std::size_t MIN_BLOCK_SIZE = 32;
+    /** Size of the largest size class, in bytes. */
+    static constexpr std::size_t MAX_BLOCK_SIZE = 128 * 1024;
+
+    /**
+     * \returns Whether the pool is enabled.
+     */
+    static bool IsEnabled();
+    /**
+     * Enable or disable the pool, and set the PacketPool global value
+     * accordingly.
+     *
+     * \param [in] enabled Whether the pool is enabled.
+     */
+    static void SetEnabled(bool enabled);
+
+    /**
+     * \param [in] size The number of bytes requested.
+     * \returns The number of usable bytes of the block allocated by
+     * Allocate() for \pname{size} bytes, i.e., \pname{size} rounded up to
+     * its size class.
+     */
+    static std::size_t GetBlockSize(std::size_t size);
+
+    /**
+     * Allocate a block.
+     *
+     * \param [in] size The number of bytes requested.
+     * \returns A block of GetBlockSize(size) bytes.
+     */
+    static void* Allocate(std::size_t size);
+    /**
+     * Release a block.
+     *
+     * \param [in] p The block.
+     * \param [in] size The size of the block, i.e., any size between the
+     * size passed to Allocate() and the usable size of the block.
+     */
+    static void Release(void* p, std::size_t size);
+};
+
+} // namespace ns3
+
+#endif /* PACKET_POOL_H */
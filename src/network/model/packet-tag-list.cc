@@ -13,19 +13,178 @@
 
 #include "packet-tag-list.h"
 
+#include "packet-pool.h"
 #include "tag-buffer.h"
 #include "tag.h"
 
 #include "ns3/fatal-error.h"
 #include "ns3/log.h"
 
+#include <algorithm>
 #include <cstring>
+#include <limits>
 
 namespace ns3
 {
 
 NS_LOG_COMPONENT_DEFINE("PacketTagList");
 
+#ifdef NS3_FLAT_PACKET_TAGS
+
+uint32_t
+PacketTagList::Find(TypeId tid) const
+{
+    const uint8_t* records = GetRecords();
+    uint32_t offset = 0;
+    while (offset < m_used)
+    {
+        auto cur = reinterpret_cast<const TagData*>(records + offset);
+        if (cur->tid == tid)
+        {
+            break;
+        }
+        offset += GetRecordSize(cur->size);
+    }
+    return offset;
+}
+
+PacketTagList::TagData*
+PacketTagList::Insert(uint32_t offset, uint32_t dataSize)
+{
+    NS_ASSERT_MSG(dataSize <= std::numeric_limits<decltype(TagData::size)>::max(),
+                  "Requested TagData size " << dataSize << " exceeds maximum "
+                                            << std::numeric_limits<decltype(TagData::size)>::max());
+    uint32_t recordSize = GetRecordSize(dataSize);
+    uint8_t* records = GetRecords();
+    if (m_used + recordSize > m_capacity)
+    {
+        // Move the records to a larger block, leaving room for the new one
+        std::size_t capacity =
+            PacketPool::GetBlockSize(std::max(2 * m_capacity, m_used + recordSize));
+        auto heap = static_cast<uint8_t*>(PacketPool::Allocate(capacity));
+        std::memcpy(heap, records, offset);
+        std::memcpy(heap + offset + recordSize, records + offset, m_used - offset);
+        if (m_heap != nullptr)
+        {
+            ReleaseHeap();
+        }
+        m_heap = heap;
+        m_capacity = static_cast<uint32_t>(capacity);
+    }
+    else
+    {
+        std::memmove(records + offset + recordSize, records + offset, m_used - offset);
+    }
+    m_used += recordSize;
+    auto tag = new (GetRecords() + offset) TagData;
+    tag->size = static_cast<uint16_t>(dataSize);
+    return tag;
+}
+
+void
+PacketTagList::Erase(uint32_t offset)
+{
+    uint8_t* records = GetRecords();
+    uint32_t recordSize = GetRecordSize(reinterpret_cast<TagData*>(records + offset)->size);
+    std::memmove(records + offset,
+                 records + offset + recordSize,
+                 m_used - offset - recordSize);
+    m_used -= recordSize;
+}
+
+void
+PacketTagList::CopyRecords(const PacketTagList& o)
+{
+    if (o.m_used > m_capacity)
+    {
+        std::size_t capacity = PacketPool::GetBlockSize(o.m_used);
+        auto heap = static_cast<uint8_t*>(PacketPool::Allocate(capacity));
+        if (m_heap != nullptr)
+        {
+            ReleaseHeap();
+        }
+        m_heap = heap;
+        m_capacity = static_cast<uint32_t>(capacity);
+    }
+    std::memcpy(GetRecords(), o.GetRecords(), o.m_used);
+    m_used = o.m_used;
+}
+
+void
+PacketTagList::ReleaseHeap()
+{
+    PacketPool::Release(m_heap, m_capacity);
+    m_heap = nullptr;
+    m_capacity = INLINE_SIZE;
+}
+
+void
+PacketTagList::Add(const Tag& tag) const
+{
+    TypeId tid = tag.GetInstanceTypeId();
+    NS_LOG_FUNCTION(this << tid);
+    // ensure this id was not yet added
+    NS_ASSERT_MSG(Find(tid) == m_used,
+                  "Error: cannot add the same kind of tag twice. The tag type is "
+                      << tid.GetName());
+    // The most recent tag comes first
+    TagData* head = const_cast<PacketTagList*>(this)->Insert(0, tag.GetSerializedSize());
+    head->tid = tid;
+    tag.Serialize(TagBuffer(head->data, head->data + head->size));
+}
+
+bool
+PacketTagList::Remove(Tag& tag)
+{
+    TypeId tid = tag.GetInstanceTypeId();
+    NS_LOG_FUNCTION(this << tid);
+    uint32_t offset = Find(tid);
+    if (offset == m_used)
+    {
+        return false;
+    }
+    auto cur = reinterpret_cast<TagData*>(GetRecords() + offset);
+    tag.Deserialize(TagBuffer(cur->data, cur->data + cur->size));
+    Erase(offset);
+    return true;
+}
+
+bool
+PacketTagList::Replace(Tag& tag)
+{
+    TypeId tid = tag.GetInstanceTypeId();
+    NS_LOG_FUNCTION(this << tid);
+    uint32_t offset = Find(tid);
+    if (offset == m_used)
+    {
+        Add(tag);
+        return false;
+    }
+    uint32_t size = tag.GetSerializedSize();
+    auto cur = reinterpret_cast<TagData*>(GetRecords() + offset);
+    if (cur->size != size)
+    {
+        // resize the record in place
+        Erase(offset);
+        cur = Insert(offset, size);
+        cur->tid = tid;
+    }
+    tag.Serialize(TagBuffer(cur->data, cur->data + cur->size));
+    return true;
+}
+
+const PacketTagList::TagData*
+PacketTagList::Head() const
+{
+    if (m_used == 0)
+    {
+        return nullptr;
+    }
+    return reinterpret_cast<const TagData*>(GetRecords());
+}
+
+#else /* NS3_FLAT_PACKET_TAGS */
+
 PacketTagList::TagData*
 PacketTagList::CreateTagData(size_t dataSize)
 {
@@ -33,14 +192,22 @@ PacketTagList::CreateTagData(size_t dataSize)
                   "Requested TagData size " << dataSize << " exceeds maximum "
                                             << std::numeric_limits<decltype(TagData::size)>::max());
 
-    void* p = std::malloc(sizeof(TagData) + dataSize - 1);
-    // The matching frees are in RemoveAll and RemoveWriter
+    void* p = PacketPool::Allocate(sizeof(TagData) + dataSize - 1);
+    // The matching releases are in DeleteTagData
 
     auto tag = new (p) TagData;
     tag->size = dataSize;
     return tag;
 }
 
+void
+PacketTagList::DeleteTagData(TagData* tag)
+{
+    std::size_t size = sizeof(TagData) + tag->size - 1;
+    tag->~TagData();
+    PacketPool::Release(tag, size);
+}
+
 bool
 PacketTagList::COWTraverse(Tag& tag, PacketTagList::COWWriter Writer)
 {
@@ -184,8 +351,7 @@ PacketTagList::RemoveWriter(Tag& tag,
     if (preMerge)
     {
         // found tid before first merge, so delete cur
-        cur->~TagData();
-        std::free(cur);
+        DeleteTagData(cur);
     }
     else
     {
@@ -268,17 +434,26 @@ PacketTagList::Add(const Tag& tag) const
     const_cast<PacketTagList*>(this)->m_next = head;
 }
 
+const PacketTagList::TagData*
+PacketTagList::Head() const
+{
+    return m_next;
+}
+
+#endif /* NS3_FLAT_PACKET_TAGS */
+
 bool
 PacketTagList::Peek(Tag& tag) const
 {
     NS_LOG_FUNCTION(this << tag.GetInstanceTypeId());
     TypeId tid = tag.GetInstanceTypeId();
-    for (TagData* cur = m_next; cur != nullptr; cur = cur->next)
+    for (const TagData* cur = Head(); cur != nullptr; cur = Next(cur))
     {
         if (cur->tid == tid)
         {
             /* found tag */
-            tag.Deserialize(TagBuffer(cur->data, cur->data + cur->size));
+            tag.Deserialize(TagBuffer(const_cast<uint8_t*>(cur->data),
+                                      const_cast<uint8_t*>(cur->data) + cur->size));
             return true;
         }
     }
@@ -286,12 +461,6 @@ PacketTagList::Peek(Tag& tag) const
     return false;
 }
 
-const PacketTagList::TagData*
-PacketTagList::Head() const
-{
-    return m_next;
-}
-
 uint32_t
 PacketTagList::GetSerializedSize() const
 {
@@ -301,7 +470,7 @@ PacketTagList::GetSerializedSize() const
 
     size = 4; // numberOfTags
 
-    for (TagData* cur = m_next; cur != nullptr; cur = cur->next)
+    for (const TagData* cur = Head(); cur != nullptr; cur = Next(cur))
     {
         size += 4; // TagData -> size
 
@@ -335,7 +504,7 @@ PacketTagList::Serialize(uint32_t* buffer, uint32_t maxSize) const
     uint32_t* numberOfTags = p;
     *p++ = 0;
 
-    for (TagData* cur = m_next; cur != nullptr; cur = cur->next)
+    for (const TagData* cur = Head(); cur != nullptr; cur = Next(cur))
     {
         size += 4;
 
@@ -393,7 +562,9 @@ PacketTagList::Deserialize(const uint32_t* buffer, uint32_t size)
 
     NS_LOG_INFO("Deserializing number of tags " << numberOfTags);
 
+#ifndef NS3_FLAT_PACKET_TAGS
     TagData* prevTag = nullptr;
+#endif
     for (uint32_t i = 0; i < numberOfTags; ++i)
     {
         NS_ASSERT(sizeCheck >= 4);
@@ -411,10 +582,15 @@ PacketTagList::Deserialize(const uint32_t* buffer, uint32_t size)
 
         NS_LOG_INFO("Deserializing tag of type " << tid);
 
+#ifdef NS3_FLAT_PACKET_TAGS
+        TagData* newTag = Insert(m_used, tagSize);
+        newTag->tid = tid;
+#else
         TagData* newTag = CreateTagData(tagSize);
         newTag->count = 1;
         newTag->next = nullptr;
         newTag->tid = tid;
+#endif
 
         NS_ASSERT(sizeCheck >= tagSize);
         memcpy(newTag->data, p, tagSize);
@@ -424,6 +600,7 @@ PacketTagList::Deserialize(const uint32_t* buffer, uint32_t size)
         p += tagWordSize / 4;
         sizeCheck -= tagWordSize;
 
+#ifndef NS3_FLAT_PACKET_TAGS
         // Set link list pointers.
         if (i == 0)
         {
@@ -435,6 +612,7 @@ PacketTagList::Deserialize(const uint32_t* buffer, uint32_t size)
         }
 
         prevTag = newTag;
+#endif
     }
 
     NS_ASSERT(sizeCheck == 0);
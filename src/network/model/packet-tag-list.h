@@ -15,6 +15,8 @@
 
 #include "ns3/type-id.h"
 
+#include <cstddef>
+#include <cstring>
 #include <ostream>
 #include <stdint.h>
 
@@ -109,6 +111,18 @@ class Tag;
  *       The portion of the list between the first branch and the target is
  *       shared. This portion is copied before the #Remove or #Replace is
  *       performed.
+ *
+ * \par <b> Flat representation </b>
+ *
+ * When ns-3 is configured with \c NS3_FLAT_PACKET_TAGS, the tags are
+ * instead stored in a flat array of records, each made of a TagData header
+ * followed by the serialized tag, padded to a multiple of 4 bytes.  The
+ * array lives inside the PacketTagList itself, with room for
+ * #INLINE_TAGS tags of up to #INLINE_TAG_SIZE bytes, and moves to a block
+ * of the PacketPool when it outgrows this inline storage.  The most recent
+ * tag comes first, as in the tree.  Nothing is shared: copying a list
+ * copies its records, which is cheaper than walking and reference counting
+ * a few tree nodes as long as the records fit inline.
  */
 class PacketTagList
 {
@@ -128,6 +142,19 @@ class PacketTagList
      * type which will be serialized into data.  See Object::Aggregates
      * for a similar construction.
      */
+#ifdef NS3_FLAT_PACKET_TAGS
+    struct TagData
+    {
+        TypeId tid;      //!< Type of the tag serialized into #data
+        uint16_t size;   //!< Size of the \c data buffer
+        uint8_t data[4]; //!< Serialization buffer, padded to a multiple of 4 bytes
+    };
+
+    /** Number of tags which fit in the inline storage of the flat array. */
+    static constexpr uint32_t INLINE_TAGS = 4;
+    /** Size of the largest tags which fit in the inline storage. */
+    static constexpr uint32_t INLINE_TAG_SIZE = 24;
+#else
     struct TagData
     {
         TagData* next;   //!< Pointer to next in list
@@ -136,6 +163,7 @@ class PacketTagList
         uint32_t size;   //!< Size of the \c data buffer
         uint8_t data[1]; //!< Serialization buffer
     };
+#endif
 
     /**
      * Create a new PacketTagList.
@@ -207,6 +235,12 @@ class PacketTagList
      * \returns pointer to head of tag list
      */
     const PacketTagList::TagData* Head() const;
+    /**
+     * \param [in] tag A tag of the list.
+     * \returns pointer to the tag after \pname{tag}, or null if
+     * \pname{tag} is the last one.
+     */
+    inline const PacketTagList::TagData* Next(const TagData* tag) const;
     /**
      * Returns number of bytes required for packet serialization.
      *
@@ -233,6 +267,67 @@ class PacketTagList
     uint32_t Deserialize(const uint32_t* buffer, uint32_t size);
 
   private:
+#ifdef NS3_FLAT_PACKET_TAGS
+    /** Size of the inline storage of the records. */
+    static constexpr uint32_t INLINE_SIZE =
+        INLINE_TAGS * (offsetof(TagData, data) + INLINE_TAG_SIZE);
+
+    /**
+     * \param [in] dataSize The serialized size of a tag.
+     * \returns The size of the record of the tag.
+     */
+    static uint32_t GetRecordSize(uint32_t dataSize)
+    {
+        return offsetof(TagData, data) + ((dataSize + 3) & (~3));
+    }
+
+    /**
+     * \returns The records.
+     */
+    uint8_t* GetRecords() const
+    {
+        return m_heap != nullptr ? m_heap : const_cast<uint8_t*>(m_inline);
+    }
+
+    /**
+     * Find a tag.
+     *
+     * \param [in] tid The type of the tag.
+     * \returns The offset of the record of the tag, or m_used if there is
+     * none.
+     */
+    uint32_t Find(TypeId tid) const;
+    /**
+     * Make room for a record.
+     *
+     * \param [in] offset The offset of the record.
+     * \param [in] dataSize The serialized size of the tag.
+     * \returns The record, whose size field is set.
+     */
+    TagData* Insert(uint32_t offset, uint32_t dataSize);
+    /**
+     * Remove a record.
+     *
+     * \param [in] offset The offset of the record.
+     */
+    void Erase(uint32_t offset);
+    /**
+     * Copy the records of another list.
+     *
+     * \param [in] o The list to copy.
+     */
+    void CopyRecords(const PacketTagList& o);
+    /**
+     * Release the heap storage of the records, and go back to the inline
+     * storage.
+     */
+    void ReleaseHeap();
+
+    uint8_t* m_heap;     //!< Heap storage of the records, or null if inline
+    uint32_t m_used;     //!< Number of bytes of the records
+    uint32_t m_capacity; //!< Size of the storage of the records
+    alignas(TagData) uint8_t m_inline[INLINE_SIZE]; //!< Inline storage of the records
+#else
     /**
      * Allocate and construct a TagData struct, sizing the data area
      * large enough to serialize dataSize bytes from a Tag.
@@ -241,6 +336,12 @@ class PacketTagList
      * \returns The newly constructed TagData object.
      */
     static TagData* CreateTagData(size_t dataSize);
+    /**
+     * Destroy and release a TagData struct allocated by CreateTagData().
+     *
+     * \param [in] tag The TagData object.
+     */
+    static void DeleteTagData(TagData* tag);
 
     /**
      * Typedef of method function pointer for copy-on-write operations
@@ -294,6 +395,7 @@ class PacketTagList
      * Pointer to first \ref TagData on the list
      */
     TagData* m_next;
+#endif
 };
 
 } // namespace ns3
@@ -305,6 +407,72 @@ class PacketTagList
 namespace ns3
 {
 
+#ifdef NS3_FLAT_PACKET_TAGS
+
+PacketTagList::PacketTagList()
+    : m_heap(nullptr),
+      m_used(0),
+      m_capacity(INLINE_SIZE)
+{
+}
+
+PacketTagList::PacketTagList(const PacketTagList& o)
+    : m_heap(nullptr),
+      m_used(0),
+      m_capacity(INLINE_SIZE)
+{
+    if (o.m_used <= INLINE_SIZE)
+    {
+        std::memcpy(m_inline, o.GetRecords(), o.m_used);
+        m_used = o.m_used;
+    }
+    else
+    {
+        CopyRecords(o);
+    }
+}
+
+PacketTagList&
+PacketTagList::operator=(const PacketTagList& o)
+{
+    if (this != &o)
+    {
+        CopyRecords(o);
+    }
+    return *this;
+}
+
+PacketTagList::~PacketTagList()
+{
+    if (m_heap != nullptr)
+    {
+        ReleaseHeap();
+    }
+}
+
+void
+PacketTagList::RemoveAll()
+{
+    if (m_heap != nullptr)
+    {
+        ReleaseHeap();
+    }
+    m_used = 0;
+}
+
+const PacketTagList::TagData*
+PacketTagList::Next(const TagData* tag) const
+{
+    const uint8_t* next = reinterpret_cast<const uint8_t*>(tag) + GetRecordSize(tag->size);
+    if (next == GetRecords() + m_used)
+    {
+        return nullptr;
+    }
+    return reinterpret_cast<const TagData*>(next);
+}
+
+#else /* NS3_FLAT_PACKET_TAGS */
+
 PacketTagList::PacketTagList()
     : m_next()
 {
@@ -354,19 +522,25 @@ PacketTagList::RemoveAll()
         }
         if (prev != nullptr)
         {
-            prev->~TagData();
-            std::free(prev);
+            DeleteTagData(prev);
         }
         prev = cur;
     }
     if (prev != nullptr)
     {
-        prev->~TagData();
-        std::free(prev);
+        DeleteTagData(prev);
     }
     m_next = nullptr;
 }
 
+const PacketTagList::TagData*
+PacketTagList::Next(const TagData* tag) const
+{
+    return tag->next;
+}
+
+#endif /* NS3_FLAT_PACKET_TAGS */
+
 } // namespace ns3
 
 #endif /* PACKET_TAG_LIST_H */
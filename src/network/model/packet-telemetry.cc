@@ -0,0 +1,59 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "packet-telemetry.h"
+
+namespace ns3
+{
+
+PacketTelemetry::PacketTelemetry()
+    : m_lastHopTimestamp(),
+      m_maxHopDelay(),
+      m_hops(0),
+      m_stamped(false)
+{
+}
+
+uint32_t
+PacketTelemetry::Serialize(uint32_t* buffer, uint32_t maxSize) const
+{
+    if (maxSize < GetSerializedSize())
+    {
+        return 0;
+    }
+    auto lastHopTimestamp = static_cast<uint64_t>(m_lastHopTimestamp.GetTimeStep());
+    auto maxHopDelay = static_cast<uint64_t>(m_maxHopDelay.GetTimeStep());
+    buffer[0] = static_cast<uint32_t>(lastHopTimestamp);
+    buffer[1] = static_cast<uint32_t>(lastHopTimestamp >> 32);
+    buffer[2] = static_cast<uint32_t>(maxHopDelay);
+    buffer[3] = static_cast<uint32_t>(maxHopDelay >> 32);
+    buffer[4] = m_hops;
+    buffer[5] = m_stamped ? 1 : 0;
+    return 1;
+}
+
+uint32_t
+PacketTelemetry::Deserialize(const uint32_t* buffer, uint32_t size)
+{
+    if (size < GetSerializedSize())
+    {
+        return 0;
+    }
+    m_lastHopTimestamp = TimeStep(buffer[0] | (static_cast<uint64_t>(buffer[1]) << 32));
+    m_maxHopDelay = TimeStep(buffer[2] | (static_cast<uint64_t>(buffer[3]) << 32));
+    m_hops = buffer[4];
+    m_stamped = buffer[5] != 0;
+    return 1;
+}
+
+std::ostream&
+operator<<(std::ostream& os, const PacketTelemetry& telemetry)
+{
+    os << "LastHopTs=" << telemetry.GetLastHopTimestamp().GetNanoSeconds()
+       << "ns, MaxDelay=" << telemetry.GetMaxHopDelay().GetNanoSeconds()
+       << "ns, Hops=" << telemetry.GetHops();
+    return os;
+}
+
+} // namespace ns3
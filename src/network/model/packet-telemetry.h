@@ -0,0 +1,152 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef PACKET_TELEMETRY_H
+#define PACKET_TELEMETRY_H
+
+#include "ns3/nstime.h"
+
+#include <ostream>
+#include <stdint.h>
+
+namespace ns3
+{
+
+/**
+ * \ingroup packet
+ *
+ * \brief Fixed-size in-band telemetry record carried inline by every Packet.
+ *
+ * This is a lightweight, INT-style alternative to attaching a packet tag
+ * for per-hop delay measurements.  The record lives inside the Packet
+ * object itself, so updating it at each hop is a handful of stores: no
+ * PacketTagList node is allocated, copied, serialized or searched.
+ *
+ * The record tracks three quantities:
+ *   - the number of hops whose delay has been measured,
+ *   - the timestamp at which the packet was last stamped, and
+ *   - the maximum per-hop delay observed so far.
+ *
+ * The first call to RecordHop() only stamps the packet; each subsequent
+ * call measures the delay since the previous stamp and counts one hop.
+ *
+ * \note The telemetry record is copied along with the packet (Copy,
+ * CreateFragment) and, like packet tags, it is included in
+ * Packet::Serialize, so that it crosses the links between partitions or
+ * MPI ranks.
+ */
+class PacketTelemetry
+{
+  public:
+    PacketTelemetry();
+
+    /**
+     * \brief Stamp the packet at the current hop.
+     *
+     * If the packet was already stamped, the elapsed time since the
+     * previous stamp is counted as one hop and the maximum per-hop delay
+     * is updated.
+     *
+     * \param now the current simulation time
+     */
+    void RecordHop(Time now)
+    {
+        if (m_stamped)
+        {
+            Time hopDelay = now - m_lastHopTimestamp;
+            if (hopDelay > m_maxHopDelay)
+            {
+                m_maxHopDelay = hopDelay;
+            }
+            ++m_hops;
+        }
+        m_stamped = true;
+        m_lastHopTimestamp = now;
+    }
+
+    /**
+     * \brief Clear the record, as if the packet had never been stamped.
+     */
+    void Clear()
+    {
+        *this = PacketTelemetry();
+    }
+
+    /**
+     * \returns the number of bytes of the serialized record
+     */
+    uint32_t GetSerializedSize() const
+    {
+        return 24;
+    }
+
+    /**
+     * \brief Serialize the record into a buffer.
+     *
+     * \param [in,out] buffer the buffer the record is serialized to
+     * \param [in] maxSize the size of the buffer, in bytes
+     * \returns zero if the buffer is too small, non-zero otherwise
+     */
+    uint32_t Serialize(uint32_t* buffer, uint32_t maxSize) const;
+
+    /**
+     * \brief Deserialize the record from a buffer.
+     *
+     * \param [in] buffer the buffer the record is read from
+     * \param [in] size the size of the buffer, in bytes
+     * \returns zero if the buffer is too small, non-zero otherwise
+     */
+    uint32_t Deserialize(const uint32_t* buffer, uint32_t size);
+
+    /**
+     * \returns true if the packet has been stamped at least once
+     */
+    bool IsStamped() const
+    {
+        return m_stamped;
+    }
+
+    /**
+     * \returns the number of hops whose delay has been measured
+     */
+    uint32_t GetHops() const
+    {
+        return m_hops;
+    }
+
+    /**
+     * \returns the time at which the packet was last stamped
+     */
+    Time GetLastHopTimestamp() const
+    {
+        return m_lastHopTimestamp;
+    }
+
+    /**
+     * \returns the maximum per-hop delay measured so far
+     */
+    Time GetMaxHopDelay() const
+    {
+        return m_maxHopDelay;
+    }
+
+  private:
+    Time m_lastHopTimestamp; //!< Time at which the packet was last stamped
+    Time m_maxHopDelay;      //!< Maximum per-hop delay encountered so far
+    uint32_t m_hops;         //!< Number of hops whose delay has been measured
+    bool m_stamped;          //!< Whether the packet has been stamped at all
+};
+
+/**
+ * \brief Stream insertion operator.
+ *
+ * \param os the stream
+ * \param telemetry the telemetry record
+ * \returns a reference to the stream
+ */
+std::ostream& operator<<(std::ostream& os, const PacketTelemetry& telemetry);
+
+} // namespace ns3
+
+#endif /* PACKET_TELEMETRY_H */
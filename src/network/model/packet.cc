@@ -7,6 +7,8 @@
  */
 #include "packet.h"
 
+#include "packet-pool.h"
+
 #include "ns3/assert.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
@@ -19,7 +21,11 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("Packet");
 
+#ifdef NS3_MULTITHREADING
+std::atomic<uint32_t> Packet::m_globalUid = 0;
+#else
 uint32_t Packet::m_globalUid = 0;
+#endif
 
 TypeId
 ByteTagIterator::Item::GetTypeId() const
@@ -78,8 +84,9 @@ ByteTagIterator::ByteTagIterator(ByteTagList::Iterator i)
 {
 }
 
-PacketTagIterator::PacketTagIterator(const PacketTagList::TagData* head)
-    : m_current(head)
+PacketTagIterator::PacketTagIterator(const PacketTagList& list)
+    : m_list(&list),
+      m_current(list.Head())
 {
 }
 
@@ -94,7 +101,7 @@ PacketTagIterator::Next()
 {
     NS_ASSERT(HasNext());
     const PacketTagList::TagData* prev = m_current;
-    m_current = m_current->next;
+    m_current = m_list->Next(m_current);
     return PacketTagIterator::Item(prev);
 }
 
@@ -135,17 +142,17 @@ Packet::Packet()
        * zero.  The lower 32 bits are for the
        * global UID
        */
-      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid, 0),
+      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid++, 0),
       m_nixVector(nullptr)
 {
-    m_globalUid++;
 }
 
 Packet::Packet(const Packet& o)
     : m_buffer(o.m_buffer),
       m_byteTagList(o.m_byteTagList),
       m_packetTagList(o.m_packetTagList),
-      m_metadata(o.m_metadata)
+      m_metadata(o.m_metadata),
+      m_telemetry(o.m_telemetry)
 {
     o.m_nixVector ? m_nixVector = o.m_nixVector->Copy() : m_nixVector = nullptr;
 }
@@ -161,10 +168,23 @@ Packet::operator=(const Packet& o)
     m_byteTagList = o.m_byteTagList;
     m_packetTagList = o.m_packetTagList;
     m_metadata = o.m_metadata;
+    m_telemetry = o.m_telemetry;
     o.m_nixVector ? m_nixVector = o.m_nixVector->Copy() : m_nixVector = nullptr;
     return *this;
 }
 
+void*
+Packet::operator new(std::size_t size)
+{
+    return PacketPool::Allocate(size);
+}
+
+void
+Packet::operator delete(void* p, std::size_t size)
+{
+    PacketPool::Release(p, size);
+}
+
 Packet::Packet(uint32_t size)
     : m_buffer(size),
       m_byteTagList(),
@@ -175,10 +195,9 @@ Packet::Packet(uint32_t size)
        * zero.  The lower 32 bits are for the
        * global UID
        */
-      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid, size),
+      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid++, size),
       m_nixVector(nullptr)
 {
-    m_globalUid++;
 }
 
 Packet::Packet(const uint8_t* buffer, uint32_t size, bool magic)
@@ -202,10 +221,9 @@ Packet::Packet(const uint8_t* buffer, uint32_t size)
        * zero.  The lower 32 bits are for the
        * global UID
        */
-      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid, size),
+      m_metadata(static_cast<uint64_t>(Simulator::GetSystemId()) << 32 | m_globalUid++, size),
       m_nixVector(nullptr)
 {
-    m_globalUid++;
     m_buffer.AddAtStart(size);
     Buffer::Iterator i = m_buffer.Begin();
     i.Write(buffer, size);
@@ -238,6 +256,7 @@ Packet::CreateFragment(uint32_t start, uint32_t length) const
     Ptr<Packet> ret =
         Ptr<Packet>(new Packet(buffer, byteTagList, m_packetTagList, metadata), false);
     ret->SetNixVector(GetNixVector());
+    ret->m_telemetry = m_telemetry;
     return ret;
 }
 
@@ -253,6 +272,13 @@ Packet::GetNixVector() const
     return m_nixVector;
 }
 
+void
+Packet::ClearTelemetry()
+{
+    NS_LOG_FUNCTION(this);
+    m_telemetry.Clear();
+}
+
 void
 Packet::AddHeader(const Header& header)
 {
@@ -588,6 +614,13 @@ Packet::EnablePrinting()
     PacketMetadata::Enable();
 }
 
+void
+Packet::EnablePrintingForNode(uint32_t nodeId)
+{
+    NS_LOG_FUNCTION(nodeId);
+    PacketMetadata::EnableForNode(nodeId);
+}
+
 void
 Packet::EnableChecking()
 {
@@ -624,6 +657,12 @@ Packet::GetSerializedSize() const
     // add 4-bytes for entry of total length of packet tag list
     size += 4;
 
+    // increment total size by size of telemetry record
+    size += m_telemetry.GetSerializedSize();
+
+    // add 4-bytes for entry of total length of telemetry record
+    size += 4;
+
     // increment total size by size of byte tag list
     // ensuring 4-byte boundary
     size += ((m_byteTagList.GetSerializedSize() + 3) & (~3));
@@ -742,6 +781,29 @@ Packet::Serialize(uint8_t* buffer, uint32_t maxSize) const
     // ensuring 4-byte boundary
     p += ((packetTagSize + 3) & (~3)) / 4;
 
+    // Serialize the telemetry record
+    uint32_t telemetrySize = m_telemetry.GetSerializedSize();
+    size += telemetrySize;
+    if (size > maxSize)
+    {
+        return 0;
+    }
+
+    // put the total length of the telemetry record in the
+    // buffer. this includes 4-bytes for total
+    // length itself
+    *p++ = telemetrySize + 4;
+
+    // serialize the telemetry record
+    serialized = m_telemetry.Serialize(p, telemetrySize);
+    if (!serialized)
+    {
+        return 0;
+    }
+
+    // increment p by telemetrySize bytes
+    p += telemetrySize / 4;
+
     // Serialize Metadata
     uint32_t metaSize = m_metadata.GetSerializedSize();
     size += metaSize;
@@ -858,6 +920,23 @@ Packet::Deserialize(const uint8_t* buffer, uint32_t size)
     p += ((((packetTagSize - 4) + 3) & (~3)) / 4);
     size -= packetTagSize;
 
+    // read telemetry record
+    uint32_t telemetrySize = *p++;
+
+    // if size less than telemetrySize, the buffer
+    // will be overrun, assert
+    NS_ASSERT(size >= telemetrySize);
+
+    uint32_t telemetryDeserialized = m_telemetry.Deserialize(p, telemetrySize - 4);
+    if (!telemetryDeserialized)
+    {
+        // telemetry record not deserialized completely
+        return 0;
+    }
+    // increment p by telemetrySize
+    p += (telemetrySize - 4) / 4;
+    size -= telemetrySize;
+
     // read metadata
     uint32_t metaSize = *p++;
 
@@ -1008,7 +1087,7 @@ Packet::PrintPacketTags(std::ostream& os) const
 PacketTagIterator
 Packet::GetPacketTagIterator() const
 {
-    return PacketTagIterator(m_packetTagList.Head());
+    return PacketTagIterator(m_packetTagList);
 }
 
 std::ostream&
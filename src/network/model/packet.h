@@ -14,6 +14,7 @@
 #include "nix-vector.h"
 #include "packet-metadata.h"
 #include "packet-tag-list.h"
+#include "packet-telemetry.h"
 #include "tag.h"
 #include "trailer.h"
 
@@ -22,8 +23,13 @@
 #include "ns3/mac48-address.h"
 #include "ns3/ptr.h"
 
+#include <cstddef>
 #include <stdint.h>
 
+#ifdef NS3_MULTITHREADING
+#include <atomic>
+#endif
+
 namespace ns3
 {
 
@@ -169,9 +175,10 @@ class PacketTagIterator
     friend class Packet;
     /**
      * Constructor
-     * \param head head of the items
+     * \param list the list of the items
      */
-    PacketTagIterator(const PacketTagList::TagData* head);
+    PacketTagIterator(const PacketTagList& list);
+    const PacketTagList* m_list;             //!< the set of tags in a packet
     const PacketTagList::TagData* m_current; //!< actual position over the set of tags in a packet
 };
 
@@ -243,6 +250,18 @@ class Packet : public SimpleRefCount<Packet>
      * \return the copied object
      */
     Packet& operator=(const Packet& o);
+    /**
+     * \brief Allocate the memory of a packet from the PacketPool.
+     * \param size the size of the packet
+     * \return the memory of the packet
+     */
+    static void* operator new(std::size_t size);
+    /**
+     * \brief Release the memory of a packet to the PacketPool.
+     * \param p the memory of the packet
+     * \param size the size of the packet
+     */
+    static void operator delete(void* p, std::size_t size);
     /**
      * \brief Create a packet with a zero-filled payload.
      *
@@ -514,6 +533,19 @@ class Packet : public SimpleRefCount<Packet>
      * simulation setup and before any packet is created.
      */
     static void EnablePrinting();
+    /**
+     * \brief Enable printing the metadata of the packets sent by a node.
+     *
+     * Only the packets created by the node, and their copies and
+     * fragments, keep the metadata used by the Print methods, while the
+     * other packets do not pay for it.  The packets of a flow can thus
+     * be printed along their whole path by enabling the node which sends
+     * the flow.  This method can be called for several nodes, at any
+     * time: it applies to the packets created after the call.
+     *
+     * \param nodeId the id of the node
+     */
+    static void EnablePrintingForNode(uint32_t nodeId);
     /**
      * \brief Enable packets metadata checking.
      *
@@ -705,6 +737,27 @@ class Packet : public SimpleRefCount<Packet>
      */
     Ptr<NixVector> GetNixVector() const;
 
+    /**
+     * \brief Stamp the in-band telemetry record of this packet.
+     *
+     * Updates the hop count, last-hop timestamp and maximum per-hop
+     * delay carried inline by the packet.  Unlike a packet tag, this
+     * does not allocate nor search the packet tag list.
+     *
+     * \param now the current simulation time
+     */
+    inline void RecordTelemetryHop(Time now);
+    /**
+     * \brief Get the in-band telemetry record of this packet.
+     *
+     * \returns the telemetry record
+     */
+    inline const PacketTelemetry& GetTelemetry() const;
+    /**
+     * \brief Reset the in-band telemetry record of this packet.
+     */
+    void ClearTelemetry();
+
     /**
      * TracedCallback signature for Ptr<Packet>
      *
@@ -784,7 +837,13 @@ class Packet : public SimpleRefCount<Packet>
     /* Please see comments above about nix-vector */
     mutable Ptr<NixVector> m_nixVector; //!< the packet's Nix vector
 
+    PacketTelemetry m_telemetry; //!< the packet's in-band telemetry record
+
+#ifdef NS3_MULTITHREADING
+    static std::atomic<uint32_t> m_globalUid; //!< Global counter of packets Uid
+#else
     static uint32_t m_globalUid; //!< Global counter of packets Uid
+#endif
 };
 
 /**
@@ -852,6 +911,18 @@ Packet::GetSize() const
     return m_buffer.GetSize();
 }
 
+void
+Packet::RecordTelemetryHop(Time now)
+{
+    m_telemetry.RecordHop(now);
+}
+
+const PacketTelemetry&
+Packet::GetTelemetry() const
+{
+    return m_telemetry;
+}
+
 } // namespace ns3
 
 #endif /* PACKET_H */
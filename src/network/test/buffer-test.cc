@@ -382,6 +382,39 @@ BufferTest::DoRun()
     val2 <<= 8;
     val2 |= i.ReadU8();
     NS_TEST_ASSERT_MSG_EQ(val1, val2, "Bad ReadNtohU16()");
+
+    // Concatenating the fragments of a zero-filled payload, which share
+    // their data, keeps the zero area virtual.
+    buffer = Buffer(1000);
+    buffer.AddAtStart(2);
+    i = buffer.Begin();
+    i.WriteU8(0x1);
+    i.WriteU8(0x2);
+    buffer.AddAtEnd(2);
+    i = buffer.End();
+    i.Prev(2);
+    i.WriteU8(0x3);
+    i.WriteU8(0x4);
+    Buffer fragment = buffer.CreateFragment(0, 502);
+    fragment.AddAtEnd(buffer.CreateFragment(502, 500));
+    fragment.AddAtEnd(Buffer(10));
+    NS_TEST_ASSERT_MSG_EQ(fragment.GetSize(), 1012, "Buffer bad size");
+    NS_TEST_ASSERT_MSG_EQ(fragment.GetSerializedSize(),
+                          Buffer(1012).GetSerializedSize() + 4,
+                          "The zero area was written out");
+    fragment.AddAtEnd(2);
+    i = fragment.End();
+    i.Prev(2);
+    i.WriteU8(0x5);
+    i.WriteU8(0x6);
+    i = fragment.Begin();
+    NS_TEST_EXPECT_MSG_EQ(i.ReadNtohU16(), 0x0102, "Bad data before the zero area");
+    i.Next(1010);
+    NS_TEST_EXPECT_MSG_EQ(i.ReadNtohU16(), 0x0506, "Bad data after the zero area");
+    i = buffer.End();
+    i.Prev(3);
+    NS_TEST_EXPECT_MSG_EQ(i.ReadU8(), 0, "Bad zero area of the original buffer");
+    NS_TEST_EXPECT_MSG_EQ(i.ReadNtohU16(), 0x0304, "The original buffer was modified");
 }
 
 /**
@@ -8,6 +8,7 @@
 #include "ns3/header.h"
 #include "ns3/packet-metadata.h"
 #include "ns3/packet.h"
+#include "ns3/simulator.h"
 #include "ns3/test.h"
 #include "ns3/trailer.h"
 
@@ -468,10 +469,68 @@ PacketMetadataTest::DoAddHeader(Ptr<Packet> p)
 void
 PacketMetadataTest::DoRun()
 {
+    // Only the packets created by node 1, and their copies, record their
+    // metadata until it is enabled for all packets.
+    PacketMetadata::EnableForNode(1);
+
+    Ptr<Packet> p;
+    Ptr<Packet> p1;
+    Simulator::ScheduleWithContext(1, Seconds(0), [&p]() {
+        p = Create<Packet>(10);
+        ADD_HEADER(p, 1);
+        ADD_HEADER(p, 2);
+    });
+    Simulator::ScheduleWithContext(2, Seconds(0), [&p1]() {
+        p1 = Create<Packet>(10);
+        ADD_HEADER(p1, 1);
+        ADD_HEADER(p1, 2);
+    });
+    Simulator::Run();
+    CHECK_HISTORY(p, 3, 2, 1, 10);
+    CheckHistory(p1, 0);
+
+    Ptr<Packet> copy = p->Copy();
+    REM_HEADER(copy, 2);
+    ADD_TRAILER(copy, 3);
+    CHECK_HISTORY(copy, 3, 1, 10, 3);
+    copy = p->CreateFragment(0, 5);
+    copy->AddAtEnd(p->CreateFragment(5, 8));
+    CHECK_HISTORY(copy, 3, 2, 1, 10);
+    // The bytes of a packet which does not record its metadata cannot be
+    // described, so the metadata of the whole packet is dropped.
+    copy->AddAtEnd(p1);
+    CheckHistory(copy, 0);
+    Simulator::Destroy();
+
+    // The nodes selected in a simulation are forgotten by the next one.
+    PacketMetadata::EnableForNode(2);
+    Ptr<Packet> other;
+    Ptr<Packet> selected;
+    Simulator::ScheduleWithContext(1, Seconds(0), [&other]() {
+        other = Create<Packet>(10);
+        ADD_HEADER(other, 1);
+    });
+    Simulator::ScheduleWithContext(2, Seconds(0), [&selected]() {
+        selected = Create<Packet>(10);
+        ADD_HEADER(selected, 1);
+    });
+    Simulator::Run();
+    CheckHistory(other, 0);
+    CHECK_HISTORY(selected, 2, 1, 10);
+    Simulator::Destroy();
+
     PacketMetadata::Enable();
 
-    Ptr<Packet> p = Create<Packet>(0);
-    Ptr<Packet> p1 = Create<Packet>(0);
+    // Neither can a packet created after Enable() describe the bytes of a
+    // packet created before.
+    Ptr<Packet> unrecorded = p1;
+    p = Create<Packet>(10);
+    ADD_HEADER(p, 1);
+    p->AddAtEnd(unrecorded);
+    CheckHistory(p, 0);
+
+    p = Create<Packet>(0);
+    p1 = Create<Packet>(0);
 
     p = Create<Packet>(10);
     ADD_TRAILER(p, 100);
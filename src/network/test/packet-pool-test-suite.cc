@@ -0,0 +1,252 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "ns3/flow-id-tag.h"
+#include "ns3/packet-pool.h"
+#include "ns3/packet.h"
+#include "ns3/test.h"
+
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check the size classes of the PacketPool and the reuse of its blocks.
+ */
+class PacketPoolBlockTest : public TestCase
+{
+  public:
+    PacketPoolBlockTest();
+
+  private:
+    void DoRun() override;
+};
+
+PacketPoolBlockTest::PacketPoolBlockTest()
+    : TestCase("Check the size classes and the reuse of the blocks")
+{
+}
+
+void
+PacketPoolBlockTest::DoRun()
+{
+    bool enabled = PacketPool::IsEnabled();
+
+    PacketPool::SetEnabled(false);
+    void* before = PacketPool::Allocate(33);
+
+    PacketPool::SetEnabled(true);
+    NS_TEST_EXPECT_MSG_EQ(PacketPool::GetBlockSize(1), 32, "Wrong size class");
+    NS_TEST_EXPECT_MSG_EQ(PacketPool::GetBlockSize(32), 32, "Wrong size class");
+    NS_TEST_EXPECT_MSG_EQ(PacketPool::GetBlockSize(33), 40, "Wrong size class");
+    NS_TEST_EXPECT_MSG_EQ(PacketPool::GetBlockSize(65), 80, "Wrong size class");
+    NS_TEST_EXPECT_MSG_EQ(PacketPool::GetBlockSize(2048), 2048, "Wrong size class");
+    NS_TEST_EXPECT_MSG_EQ(PacketPool::GetBlockSize(2049), 2560, "Wrong size class");
+    NS_TEST_EXPECT_MSG_EQ(PacketPool::GetBlockSize(PacketPool::MAX_BLOCK_SIZE),
+                          PacketPool::MAX_BLOCK_SIZE,
+                          "Wrong size class");
+    NS_TEST_EXPECT_MSG_EQ(PacketPool::GetBlockSize(PacketPool::MAX_BLOCK_SIZE + 1),
+                          PacketPool::MAX_BLOCK_SIZE + 1,
+                          "Large blocks must bypass the pool");
+
+    // A block allocated while the pool was disabled is reused, for any size
+    // of its size class
+    PacketPool::Release(before, 33);
+    void* block = PacketPool::Allocate(40);
+    NS_TEST_EXPECT_MSG_EQ(block, before, "The released block was not reused");
+    PacketPool::Release(block, 40);
+
+    std::size_t size = PacketPool::GetBlockSize(1500);
+    block = PacketPool::Allocate(size);
+    PacketPool::Release(block, 1500);
+    void* first = PacketPool::Allocate(1500);
+    void* second = PacketPool::Allocate(1500);
+    NS_TEST_EXPECT_MSG_EQ(first, block, "The released block was not reused");
+    NS_TEST_EXPECT_MSG_NE(second, block, "A block was handed out twice");
+
+    // Blocks allocated while the pool is enabled can be released after it is
+    // disabled
+    PacketPool::SetEnabled(false);
+    PacketPool::Release(first, size);
+    PacketPool::Release(second, size);
+
+    PacketPool::SetEnabled(enabled);
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check that packets whose memory comes from the PacketPool keep
+ * their content, and that the memory of released packets is reused.
+ */
+class PacketPoolPacketTest : public TestCase
+{
+  public:
+    PacketPoolPacketTest();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Build a packet with a payload, a packet tag and a byte tag.
+     *
+     * \param [in] id The identifier of the flow, stored in the tags and the
+     * payload.
+     * \returns The packet.
+     */
+    static Ptr<Packet> Build(uint32_t id);
+
+    /**
+     * Check the content of a packet built by Build().
+     *
+     * \param [in] p The packet.
+     * \param [in] id The identifier of the flow.
+     */
+    void Check(Ptr<const Packet> p, uint32_t id);
+};
+
+PacketPoolPacketTest::PacketPoolPacketTest()
+    : TestCase("Check the packets allocated from the pool")
+{
+}
+
+Ptr<Packet>
+PacketPoolPacketTest::Build(uint32_t id)
+{
+    std::vector<uint8_t> payload(1000, static_cast<uint8_t>(id));
+    Ptr<Packet> p = Create<Packet>(payload.data(), payload.size());
+    p->AddPacketTag(FlowIdTag(id));
+    p->AddByteTag(FlowIdTag(id + 1));
+    return p;
+}
+
+void
+PacketPoolPacketTest::Check(Ptr<const Packet> p, uint32_t id)
+{
+    NS_TEST_ASSERT_MSG_EQ(p->GetSize(), 1000, "Wrong size");
+    std::vector<uint8_t> payload(p->GetSize());
+    p->CopyData(payload.data(), payload.size());
+    NS_TEST_EXPECT_MSG_EQ(payload.front(), static_cast<uint8_t>(id), "Wrong payload");
+    NS_TEST_EXPECT_MSG_EQ(payload.back(), static_cast<uint8_t>(id), "Wrong payload");
+    FlowIdTag tag;
+    NS_TEST_EXPECT_MSG_EQ(p->PeekPacketTag(tag), true, "Missing packet tag");
+    NS_TEST_EXPECT_MSG_EQ(tag.GetFlowId(), id, "Wrong packet tag");
+    NS_TEST_EXPECT_MSG_EQ(p->FindFirstMatchingByteTag(tag), true, "Missing byte tag");
+    NS_TEST_EXPECT_MSG_EQ(tag.GetFlowId(), id + 1, "Wrong byte tag");
+}
+
+void
+PacketPoolPacketTest::DoRun()
+{
+    bool enabled = PacketPool::IsEnabled();
+
+    // Packets allocated before the pool was enabled are released to it
+    PacketPool::SetEnabled(false);
+    Ptr<Packet> before = Build(1);
+    PacketPool::SetEnabled(true);
+    Check(before, 1);
+    before = nullptr;
+
+    std::vector<Ptr<Packet>> packets;
+    for (uint32_t i = 0; i < 16; i++)
+    {
+        packets.push_back(Build(i));
+        packets.push_back(packets.back()->Copy());
+        FlowIdTag tag;
+        packets.back()->RemovePacketTag(tag);
+        packets.back()->AddPacketTag(FlowIdTag(i));
+    }
+    for (uint32_t i = 0; i < 16; i++)
+    {
+        Check(packets[2 * i], i);
+        Check(packets[2 * i + 1], i);
+    }
+
+    packets.clear();
+
+    Ptr<Packet> last = Build(7);
+    const Packet* released = PeekPointer(last);
+    last = nullptr;
+    Ptr<Packet> reused = Build(42);
+    NS_TEST_EXPECT_MSG_EQ(PeekPointer(reused), released, "The packet memory was not reused");
+    Check(reused, 42);
+    Ptr<Packet> fragment = reused->CreateFragment(0, 500);
+    NS_TEST_EXPECT_MSG_EQ(fragment->GetSize(), 500, "Wrong fragment size");
+    reused->RemoveAtStart(500);
+    fragment->AddAtEnd(reused);
+    Check(fragment, 42);
+
+    PacketPool::SetEnabled(enabled);
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Check that packets created while the pool is enabled can be
+ * released after it is disabled.
+ *
+ * This test runs first, so that, when the suite runs alone, no buffer was
+ * created while the pool was disabled.
+ */
+class PacketPoolDisableTest : public TestCase
+{
+  public:
+    PacketPoolDisableTest();
+
+  private:
+    void DoRun() override;
+};
+
+PacketPoolDisableTest::PacketPoolDisableTest()
+    : TestCase("Check the release of the packets after the pool is disabled")
+{
+}
+
+void
+PacketPoolDisableTest::DoRun()
+{
+    bool enabled = PacketPool::IsEnabled();
+
+    PacketPool::SetEnabled(true);
+    std::vector<Ptr<Packet>> packets;
+    for (uint32_t i = 0; i < 16; i++)
+    {
+        packets.push_back(Create<Packet>(1000));
+    }
+    PacketPool::SetEnabled(false);
+    packets.clear();
+
+    Ptr<Packet> p = Create<Packet>(1000);
+    NS_TEST_EXPECT_MSG_EQ(p->GetSize(), 1000, "Wrong size");
+    p = nullptr;
+
+    PacketPool::SetEnabled(enabled);
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief PacketPool TestSuite
+ */
+class PacketPoolTestSuite : public TestSuite
+{
+  public:
+    PacketPoolTestSuite();
+};
+
+PacketPoolTestSuite::PacketPoolTestSuite()
+    : TestSuite("packet-pool", Type::UNIT)
+{
+    AddTestCase(new PacketPoolDisableTest, TestCase::Duration::QUICK);
+    AddTestCase(new PacketPoolBlockTest, TestCase::Duration::QUICK);
+    AddTestCase(new PacketPoolPacketTest, TestCase::Duration::QUICK);
+}
+
+static PacketPoolTestSuite g_packetPoolTestSuite; //!< Static variable for test initialization
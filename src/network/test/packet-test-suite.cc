@@ -15,6 +15,7 @@
 #include <iostream>
 #include <limits> // std:numeric_limits
 #include <string>
+#include <vector>
 
 using namespace ns3;
 
@@ -1257,6 +1258,83 @@ PacketTagListTest::DoRun()
     } // Timing
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * In-band packet telemetry unit tests.
+ */
+class PacketTelemetryTest : public TestCase
+{
+  public:
+    PacketTelemetryTest();
+
+  private:
+    void DoRun() override;
+};
+
+PacketTelemetryTest::PacketTelemetryTest()
+    : TestCase("Packet in-band telemetry")
+{
+}
+
+void
+PacketTelemetryTest::DoRun()
+{
+    Ptr<Packet> p = Create<Packet>(1000);
+    NS_TEST_EXPECT_MSG_EQ(p->GetTelemetry().IsStamped(), false, "new packet is not stamped");
+    NS_TEST_EXPECT_MSG_EQ(p->GetTelemetry().GetHops(), 0, "new packet has no hops");
+
+    // The first stamp only records the timestamp
+    p->RecordTelemetryHop(MicroSeconds(10));
+    NS_TEST_EXPECT_MSG_EQ(p->GetTelemetry().IsStamped(), true, "packet is stamped");
+    NS_TEST_EXPECT_MSG_EQ(p->GetTelemetry().GetHops(), 0, "first stamp measures no hop");
+    NS_TEST_EXPECT_MSG_EQ(p->GetTelemetry().GetLastHopTimestamp(),
+                          MicroSeconds(10),
+                          "wrong last hop timestamp");
+    NS_TEST_EXPECT_MSG_EQ(p->GetTelemetry().GetMaxHopDelay(), Time(0), "wrong max hop delay");
+
+    p->RecordTelemetryHop(MicroSeconds(40));
+    p->RecordTelemetryHop(MicroSeconds(50));
+    NS_TEST_EXPECT_MSG_EQ(p->GetTelemetry().GetHops(), 2, "wrong hop count");
+    NS_TEST_EXPECT_MSG_EQ(p->GetTelemetry().GetMaxHopDelay(),
+                          MicroSeconds(30),
+                          "wrong max hop delay");
+
+    // Copies and fragments carry the record; the copy evolves independently
+    Ptr<Packet> copy = p->Copy();
+    Ptr<Packet> fragment = p->CreateFragment(0, 500);
+    copy->RecordTelemetryHop(MicroSeconds(150));
+    NS_TEST_EXPECT_MSG_EQ(copy->GetTelemetry().GetHops(), 3, "copy did not keep the record");
+    NS_TEST_EXPECT_MSG_EQ(copy->GetTelemetry().GetMaxHopDelay(),
+                          MicroSeconds(100),
+                          "wrong max hop delay on copy");
+    NS_TEST_EXPECT_MSG_EQ(p->GetTelemetry().GetHops(), 2, "original modified through copy");
+    NS_TEST_EXPECT_MSG_EQ(fragment->GetTelemetry().GetHops(),
+                          2,
+                          "fragment did not keep the record");
+
+    // Telemetry does not use the packet tag list
+    NS_TEST_EXPECT_MSG_EQ(p->GetPacketTagIterator().HasNext(), false, "unexpected packet tag");
+
+    // The record survives serialization, as on the links between partitions
+    std::vector<uint8_t> buffer(p->GetSerializedSize());
+    NS_TEST_EXPECT_MSG_EQ(p->Serialize(buffer.data(), buffer.size()), 1, "serialization failed");
+    Ptr<Packet> received = Create<Packet>(buffer.data(), buffer.size(), true);
+    NS_TEST_EXPECT_MSG_EQ(received->GetTelemetry().IsStamped(), true, "stamp not serialized");
+    NS_TEST_EXPECT_MSG_EQ(received->GetTelemetry().GetHops(), 2, "hops not serialized");
+    NS_TEST_EXPECT_MSG_EQ(received->GetTelemetry().GetLastHopTimestamp(),
+                          MicroSeconds(50),
+                          "last hop timestamp not serialized");
+    NS_TEST_EXPECT_MSG_EQ(received->GetTelemetry().GetMaxHopDelay(),
+                          MicroSeconds(30),
+                          "max hop delay not serialized");
+
+    p->ClearTelemetry();
+    NS_TEST_EXPECT_MSG_EQ(p->GetTelemetry().IsStamped(), false, "record not cleared");
+    NS_TEST_EXPECT_MSG_EQ(p->GetTelemetry().GetHops(), 0, "hops not cleared");
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -1274,6 +1352,7 @@ PacketTestSuite::PacketTestSuite()
 {
     AddTestCase(new PacketTest, TestCase::Duration::QUICK);
     AddTestCase(new PacketTagListTest, TestCase::Duration::QUICK);
+    AddTestCase(new PacketTelemetryTest, TestCase::Duration::QUICK);
 }
 
 static PacketTestSuite g_packetTestSuite; //!< Static variable for test initialization
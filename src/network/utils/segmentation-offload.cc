@@ -0,0 +1,119 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "segmentation-offload.h"
+
+#include "ns3/log.h"
+
+#include <map>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("SegmentationOffload");
+
+NS_OBJECT_ENSURE_REGISTERED(SegmentationOffloadTag);
+
+TypeId
+SegmentationOffloadTag::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::SegmentationOffloadTag")
+                            .SetParent<Tag>()
+                            .SetGroupName("Network")
+                            .AddConstructor<SegmentationOffloadTag>();
+    return tid;
+}
+
+TypeId
+SegmentationOffloadTag::GetInstanceTypeId() const
+{
+    return GetTypeId();
+}
+
+uint32_t
+SegmentationOffloadTag::GetSerializedSize() const
+{
+    return 4;
+}
+
+void
+SegmentationOffloadTag::Serialize(TagBuffer buf) const
+{
+    buf.WriteU16(m_segmentSize);
+    buf.WriteU16(m_segments);
+}
+
+void
+SegmentationOffloadTag::Deserialize(TagBuffer buf)
+{
+    m_segmentSize = buf.ReadU16();
+    m_segments = buf.ReadU16();
+}
+
+void
+SegmentationOffloadTag::Print(std::ostream& os) const
+{
+    os << "SegmentSize=" << m_segmentSize << " Segments=" << m_segments;
+}
+
+SegmentationOffloadTag::SegmentationOffloadTag()
+    : Tag(),
+      m_segmentSize(0),
+      m_segments(0)
+{
+}
+
+SegmentationOffloadTag::SegmentationOffloadTag(uint16_t segmentSize, uint16_t segments)
+    : Tag(),
+      m_segmentSize(segmentSize),
+      m_segments(segments)
+{
+}
+
+uint16_t
+SegmentationOffloadTag::GetSegmentSize() const
+{
+    return m_segmentSize;
+}
+
+uint16_t
+SegmentationOffloadTag::GetSegments() const
+{
+    return m_segments;
+}
+
+/**
+ * \return the segmenters, by EtherType
+ */
+static std::map<uint16_t, SegmentationOffload::Segmenter>&
+GetSegmenters()
+{
+    static std::map<uint16_t, SegmentationOffload::Segmenter> segmenters;
+    return segmenters;
+}
+
+void
+SegmentationOffload::Register(uint16_t protocol, Segmenter segmenter)
+{
+    NS_LOG_FUNCTION(protocol);
+    GetSegmenters()[protocol] = segmenter;
+}
+
+bool
+SegmentationOffload::Segment(uint16_t protocol,
+                             Ptr<const Packet> packet,
+                             std::list<Ptr<Packet>>& segments)
+{
+    NS_LOG_FUNCTION(protocol << packet);
+    const auto& segmenters = GetSegmenters();
+    auto it = segmenters.find(protocol);
+    if (it == segmenters.end())
+    {
+        NS_LOG_LOGIC("No segmenter for protocol " << protocol);
+        return false;
+    }
+    return it->second(packet, segments);
+}
+
+} // namespace ns3
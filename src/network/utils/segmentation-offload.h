@@ -0,0 +1,116 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef SEGMENTATION_OFFLOAD_H
+#define SEGMENTATION_OFFLOAD_H
+
+#include "ns3/callback.h"
+#include "ns3/packet.h"
+#include "ns3/ptr.h"
+#include "ns3/tag.h"
+
+#include <list>
+#include <stdint.h>
+
+namespace ns3
+{
+
+/**
+ * \ingroup network
+ *
+ * \brief Packet tag of a super-segment, which the net device splits into
+ * segments when it serializes it (segmentation offload).
+ *
+ * A transport protocol which hands down several segments as one packet,
+ * with a single header, marks it with this tag.  The net devices which
+ * support segmentation offload (NetDevice::SupportsSegmentationOffload)
+ * split the packet when they start to transmit it, so that each segment
+ * takes its own time on the wire; the upper layers, the traffic control
+ * layer and the queue of the device only see the super-segment.
+ */
+class SegmentationOffloadTag : public Tag
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+    TypeId GetInstanceTypeId() const override;
+    uint32_t GetSerializedSize() const override;
+    void Serialize(TagBuffer buf) const override;
+    void Deserialize(TagBuffer buf) override;
+    void Print(std::ostream& os) const override;
+    SegmentationOffloadTag();
+
+    /**
+     * Constructs a SegmentationOffloadTag
+     *
+     * \param segmentSize payload size of the segments
+     * \param segments number of segments in the packet
+     */
+    SegmentationOffloadTag(uint16_t segmentSize, uint16_t segments);
+
+    /**
+     * \returns the payload size of the segments (but the last one, which may be smaller)
+     */
+    uint16_t GetSegmentSize() const;
+
+    /**
+     * \returns the number of segments in the packet
+     */
+    uint16_t GetSegments() const;
+
+  private:
+    uint16_t m_segmentSize; //!< Payload size of the segments
+    uint16_t m_segments;    //!< Number of segments
+};
+
+/**
+ * \ingroup network
+ *
+ * \brief Registry of the functions which split the super-segments of a
+ * network protocol.
+ *
+ * The net devices do not know the headers of the upper layers, so the
+ * protocols register, by their EtherType, the function which splits one
+ * of their packets marked with a SegmentationOffloadTag into standalone
+ * packets, each with its own copy of the headers.
+ */
+class SegmentationOffload
+{
+  public:
+    /**
+     * Function which splits a super-segment.  It appends the segments to
+     * the list, and returns false, without changing the list, when it
+     * can not split the packet.
+     */
+    typedef Callback<bool, Ptr<const Packet>, std::list<Ptr<Packet>>&> Segmenter;
+
+    /**
+     * Register the function which splits the super-segments of a protocol.
+     * The registrations are global, and are expected to happen before the
+     * simulation runs.
+     *
+     * \param protocol the EtherType of the protocol
+     * \param segmenter the function which splits its packets
+     */
+    static void Register(uint16_t protocol, Segmenter segmenter);
+
+    /**
+     * Split a super-segment.
+     *
+     * \param protocol the EtherType of the packet
+     * \param packet the packet, starting with the header of the protocol
+     * \param segments the list the segments are appended to
+     * \returns false if the packet could not be split
+     */
+    static bool Segment(uint16_t protocol,
+                        Ptr<const Packet> packet,
+                        std::list<Ptr<Packet>>& segments);
+};
+
+} // namespace ns3
+
+#endif /* SEGMENTATION_OFFLOAD_H */
@@ -0,0 +1,178 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// Implement the common base of the datacenter fabric topology helpers.
+
+#include "point-to-point-fabric.h"
+
+#include "ns3/abort.h"
+#include "ns3/ipv4-address-generator.h"
+#include "ns3/ipv4.h"
+#include "ns3/log.h"
+#include "ns3/net-device-queue-interface.h"
+#include "ns3/traffic-control-layer.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("PointToPointFabricHelper");
+
+PointToPointFabricHelper::~PointToPointFabricHelper()
+{
+}
+
+uint32_t
+PointToPointFabricHelper::HostCount() const
+{
+    return m_hosts.GetN();
+}
+
+Ptr<Node>
+PointToPointFabricHelper::GetHost(uint32_t i) const
+{
+    return m_hosts.Get(i);
+}
+
+NodeContainer
+PointToPointFabricHelper::GetHosts() const
+{
+    return m_hosts;
+}
+
+NodeContainer
+PointToPointFabricHelper::GetSwitches() const
+{
+    return m_switches;
+}
+
+NetDeviceContainer
+PointToPointFabricHelper::GetSwitchDevices() const
+{
+    return m_switchDevices;
+}
+
+Ptr<NetDevice>
+PointToPointFabricHelper::GetHostDevice(uint32_t i) const
+{
+    NS_ASSERT_MSG(i < m_hosts.GetN(), "Invalid host " << i);
+    // The host links are created first, in host order
+    return m_lowerDevices.Get(i);
+}
+
+Ipv4Address
+PointToPointFabricHelper::GetHostIpv4Address(uint32_t i) const
+{
+    NS_ASSERT_MSG(i < m_hostAddresses.size(), "No IPv4 address assigned to host " << i);
+    return m_hostAddresses[i];
+}
+
+void
+PointToPointFabricHelper::InstallStack(InternetStackHelper stack)
+{
+    stack.Install(m_switches);
+    stack.Install(m_hosts);
+}
+
+QueueDiscContainer
+PointToPointFabricHelper::InstallSwitchQueueDiscs(TrafficControlHelper tch)
+{
+    return tch.Install(m_switchDevices);
+}
+
+void
+PointToPointFabricHelper::AddHostLink(PointToPointHelper& helper, Ptr<Node> host, Ptr<Node> sw)
+{
+    NS_ASSERT_MSG(m_lowerDevices.GetN() < m_hosts.GetN() &&
+                      m_hosts.Get(m_lowerDevices.GetN()) == host,
+                  "Host links must be created first, in host order");
+    NetDeviceContainer c = helper.Install(host, sw);
+    m_lowerDevices.Add(c.Get(0));
+    m_upperDevices.Add(c.Get(1));
+    m_switchDevices.Add(c.Get(1));
+}
+
+void
+PointToPointFabricHelper::AddFabricLink(PointToPointHelper& helper,
+                                        Ptr<Node> lower,
+                                        Ptr<Node> upper)
+{
+    NetDeviceContainer c = helper.Install(lower, upper);
+    m_lowerDevices.Add(c.Get(0));
+    m_upperDevices.Add(c.Get(1));
+    m_switchDevices.Add(c.Get(0));
+    m_switchDevices.Add(c.Get(1));
+}
+
+void
+PointToPointFabricHelper::AssignIpv4Addresses(Ipv4Address network, Ipv4Mask mask)
+{
+    NS_LOG_FUNCTION(this << network << mask);
+
+    Ipv4Mask linkMask("255.255.255.252");
+    uint32_t nLinks = m_lowerDevices.GetN();
+    uint64_t size = static_cast<uint64_t>(~mask.Get()) + 1;
+    uint64_t linkSize = static_cast<uint64_t>(~linkMask.Get()) + 1;
+    NS_ABORT_MSG_IF(linkSize * nLinks > size,
+                    "Network " << network << "/" << mask.GetPrefixLength() << " too small for "
+                               << nLinks << " links");
+
+    // Allocate the link subnets through the Ipv4AddressGenerator, so that
+    // they cannot collide with the addresses allocated by other helpers.
+    // The network and broadcast addresses of every subnet are reserved too:
+    // the generator then records the fabric as a single range of addresses,
+    // which it extends in constant time, instead of one range per link.
+    Ipv4AddressGenerator::Init(network.CombineMask(mask), linkMask);
+    m_hostAddresses.clear();
+    m_hostAddresses.reserve(m_hosts.GetN());
+    for (uint32_t i = 0; i < nLinks; ++i)
+    {
+        Ipv4Address subnet = Ipv4AddressGenerator::GetNetwork(linkMask);
+        Ipv4AddressGenerator::AddAllocated(subnet);
+        Ipv4Address lower = Ipv4AddressGenerator::NextAddress(linkMask);
+        Ipv4Address upper = Ipv4AddressGenerator::NextAddress(linkMask);
+        Ipv4AddressGenerator::AddAllocated(subnet.GetSubnetDirectedBroadcast(linkMask));
+        AssignIpv4Address(m_lowerDevices.Get(i), lower, linkMask);
+        AssignIpv4Address(m_upperDevices.Get(i), upper, linkMask);
+        if (i < m_hosts.GetN())
+        {
+            m_hostAddresses.push_back(lower);
+        }
+        Ipv4AddressGenerator::NextNetwork(linkMask);
+        Ipv4AddressGenerator::InitAddress(Ipv4Address("0.0.0.1"), linkMask);
+    }
+}
+
+void
+PointToPointFabricHelper::AssignIpv4Address(Ptr<NetDevice> device,
+                                            Ipv4Address address,
+                                            Ipv4Mask mask)
+{
+    Ptr<Node> node = device->GetNode();
+    Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
+    NS_ASSERT_MSG(ipv4,
+                  "PointToPointFabricHelper::AssignIpv4Addresses(): node without IPv4 "
+                  "stack installed (maybe need to use InstallStack?)");
+
+    int32_t interface = ipv4->GetInterfaceForDevice(device);
+    if (interface == -1)
+    {
+        interface = ipv4->AddInterface(device);
+    }
+    ipv4->AddAddress(interface, Ipv4InterfaceAddress(address, mask));
+    ipv4->SetMetric(interface, 1);
+    ipv4->SetUp(interface);
+
+    // Same default traffic control configuration as Ipv4AddressHelper::Assign
+    Ptr<TrafficControlLayer> tc = node->GetObject<TrafficControlLayer>();
+    if (tc && !tc->GetRootQueueDiscOnDevice(device))
+    {
+        Ptr<NetDeviceQueueInterface> ndqi = device->GetObject<NetDeviceQueueInterface>();
+        if (ndqi)
+        {
+            TrafficControlHelper::Default(ndqi->GetNTxQueues()).Install(device);
+        }
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,162 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// Define the common base of the datacenter fabric topology helpers.
+
+#ifndef POINT_TO_POINT_FABRIC_HELPER_H
+#define POINT_TO_POINT_FABRIC_HELPER_H
+
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/net-device-container.h"
+#include "ns3/node-container.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/queue-disc-container.h"
+#include "ns3/traffic-control-helper.h"
+
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup point-to-point-layout
+ *
+ * \brief Common base of the helpers creating multi-tier datacenter fabrics
+ * (fat-trees, leaf-spines) with p2p links
+ *
+ * The derived helpers create the hosts, the switches of every tier and
+ * the links between them. This base class keeps the links in creation
+ * order, the host links first, and provides the bulk operations on the
+ * fabric:
+ *   - InstallStack installs the internet stack on every node;
+ *   - InstallSwitchQueueDiscs installs a queue disc on every switch port;
+ *   - AssignIpv4Addresses gives a /30 subnet to every link.
+ *
+ * Every operation takes time and memory linear in the number of links,
+ * so that fabrics of thousands of hosts are built in seconds.
+ *
+ * Since every link has its own subnet, the switches do not aggregate host
+ * prefixes, and global routing finds every equal-cost path between two
+ * hosts (see Ipv4GlobalRouting for the ECMP modes).
+ */
+class PointToPointFabricHelper
+{
+  public:
+    virtual ~PointToPointFabricHelper();
+
+    /**
+     * \returns total number of hosts
+     */
+    uint32_t HostCount() const;
+
+    /**
+     * \returns pointer to the i'th host
+     * \param i host number
+     */
+    Ptr<Node> GetHost(uint32_t i) const;
+
+    /**
+     * \returns the container of every host
+     */
+    NodeContainer GetHosts() const;
+
+    /**
+     * \returns the container of every switch, from the lowest tier up
+     */
+    NodeContainer GetSwitches() const;
+
+    /**
+     * \returns the container of the switch ports, i.e., the NetDevices
+     *          installed on the switches
+     */
+    NetDeviceContainer GetSwitchDevices() const;
+
+    /**
+     * \returns the NetDevice of the i'th host
+     * \param i host number
+     */
+    Ptr<NetDevice> GetHostDevice(uint32_t i) const;
+
+    /**
+     * \returns the Ipv4Address of the i'th host
+     * \param i host number
+     */
+    Ipv4Address GetHostIpv4Address(uint32_t i) const;
+
+    /**
+     * \param stack an InternetStackHelper which is used to install
+     *              on every node of the fabric
+     */
+    void InstallStack(InternetStackHelper stack);
+
+    /**
+     * Install a root queue disc on every switch port. This must be called
+     * before AssignIpv4Addresses, which installs the default queue disc on
+     * the ports that have none.
+     *
+     * \param tch the TrafficControlHelper used to install the queue discs
+     * \returns the installed queue discs
+     */
+    QueueDiscContainer InstallSwitchQueueDiscs(TrafficControlHelper tch);
+
+    /**
+     * Assign the i'th /30 subnet of the network to the i'th link: the lower
+     * end of the link (host, or switch of the lower tier) gets the first
+     * address of the subnet, and the upper end the second one.
+     *
+     * The subnets are allocated through the Ipv4AddressGenerator, which
+     * aborts if one of them is already in use.
+     *
+     * \param network the network the link subnets are carved from
+     * \param mask the mask of the network, which must have room for
+     *             4 addresses per link
+     */
+    void AssignIpv4Addresses(Ipv4Address network, Ipv4Mask mask);
+
+  protected:
+    PointToPointFabricHelper() = default;
+
+    /**
+     * Install a link between a host and a switch. The host links must be
+     * created first, in host order.
+     *
+     * \param helper the PointToPointHelper used to install the link
+     * \param host the host
+     * \param sw the switch
+     */
+    void AddHostLink(PointToPointHelper& helper, Ptr<Node> host, Ptr<Node> sw);
+
+    /**
+     * Install a link between two switches.
+     *
+     * \param helper the PointToPointHelper used to install the link
+     * \param lower the switch of the lower tier
+     * \param upper the switch of the upper tier
+     */
+    void AddFabricLink(PointToPointHelper& helper, Ptr<Node> lower, Ptr<Node> upper);
+
+    NodeContainer m_hosts;    //!< Hosts
+    NodeContainer m_switches; //!< Switches of every tier
+
+  private:
+    /**
+     * Add an address to the interface of a device, creating the interface
+     * if needed, the same way as Ipv4AddressHelper::Assign.
+     *
+     * \param device the NetDevice
+     * \param address the address
+     * \param mask the mask of the link subnet
+     */
+    void AssignIpv4Address(Ptr<NetDevice> device, Ipv4Address address, Ipv4Mask mask);
+
+    NetDeviceContainer m_lowerDevices;        //!< Lower end of each link
+    NetDeviceContainer m_upperDevices;        //!< Upper end of each link
+    NetDeviceContainer m_switchDevices;       //!< Switch ports
+    std::vector<Ipv4Address> m_hostAddresses; //!< Host addresses, in host order
+};
+
+} // namespace ns3
+
+#endif /* POINT_TO_POINT_FABRIC_HELPER_H */
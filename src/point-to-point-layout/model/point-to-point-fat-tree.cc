@@ -0,0 +1,105 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// Implement an object to create a k-ary fat-tree topology.
+
+#include "point-to-point-fat-tree.h"
+
+#include "ns3/abort.h"
+#include "ns3/log.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("PointToPointFatTreeHelper");
+
+PointToPointFatTreeHelper::PointToPointFatTreeHelper(uint32_t k,
+                                                     PointToPointHelper hostHelper,
+                                                     PointToPointHelper fabricHelper)
+    : m_k(k)
+{
+    NS_LOG_FUNCTION(this << k);
+    NS_ABORT_MSG_IF(k < 2 || k % 2 != 0, "The fat-tree arity must be even, not " << k);
+
+    uint32_t half = k / 2;
+    m_hosts.Create(k * half * half);
+    m_edge.Create(k * half);
+    m_aggregation.Create(k * half);
+    m_core.Create(half * half);
+    m_switches.Add(m_edge);
+    m_switches.Add(m_aggregation);
+    m_switches.Add(m_core);
+
+    // Host links first, in host order
+    for (uint32_t pod = 0; pod < k; ++pod)
+    {
+        for (uint32_t edge = 0; edge < half; ++edge)
+        {
+            for (uint32_t i = 0; i < half; ++i)
+            {
+                AddHostLink(hostHelper, GetHost(pod, edge, i), GetEdge(pod, edge));
+            }
+        }
+    }
+    for (uint32_t pod = 0; pod < k; ++pod)
+    {
+        for (uint32_t edge = 0; edge < half; ++edge)
+        {
+            for (uint32_t agg = 0; agg < half; ++agg)
+            {
+                AddFabricLink(fabricHelper, GetEdge(pod, edge), GetAggregation(pod, agg));
+            }
+        }
+    }
+    for (uint32_t pod = 0; pod < k; ++pod)
+    {
+        for (uint32_t agg = 0; agg < half; ++agg)
+        {
+            for (uint32_t i = 0; i < half; ++i)
+            {
+                AddFabricLink(fabricHelper, GetAggregation(pod, agg), GetCore(agg * half + i));
+            }
+        }
+    }
+}
+
+PointToPointFatTreeHelper::~PointToPointFatTreeHelper()
+{
+}
+
+uint32_t
+PointToPointFatTreeHelper::GetK() const
+{
+    return m_k;
+}
+
+Ptr<Node>
+PointToPointFatTreeHelper::GetHost(uint32_t pod, uint32_t edge, uint32_t i) const
+{
+    uint32_t half = m_k / 2;
+    NS_ASSERT_MSG(pod < m_k && edge < half && i < half, "Invalid host");
+    return m_hosts.Get((pod * half + edge) * half + i);
+}
+
+Ptr<Node>
+PointToPointFatTreeHelper::GetEdge(uint32_t pod, uint32_t i) const
+{
+    NS_ASSERT_MSG(pod < m_k && i < m_k / 2, "Invalid edge switch");
+    return m_edge.Get(pod * (m_k / 2) + i);
+}
+
+Ptr<Node>
+PointToPointFatTreeHelper::GetAggregation(uint32_t pod, uint32_t i) const
+{
+    NS_ASSERT_MSG(pod < m_k && i < m_k / 2, "Invalid aggregation switch");
+    return m_aggregation.Get(pod * (m_k / 2) + i);
+}
+
+Ptr<Node>
+PointToPointFatTreeHelper::GetCore(uint32_t i) const
+{
+    return m_core.Get(i);
+}
+
+} // namespace ns3
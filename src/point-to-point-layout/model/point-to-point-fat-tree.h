@@ -0,0 +1,96 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// Define an object to create a k-ary fat-tree topology.
+
+#ifndef POINT_TO_POINT_FAT_TREE_HELPER_H
+#define POINT_TO_POINT_FAT_TREE_HELPER_H
+
+#include "point-to-point-fabric.h"
+
+namespace ns3
+{
+
+/**
+ * \ingroup point-to-point-layout
+ *
+ * \brief A helper to make it easier to create a k-ary fat-tree topology
+ * with p2p links
+ *
+ * The fat-tree has k pods. Each pod holds k/2 edge switches and k/2
+ * aggregation switches; every edge switch is linked to every aggregation
+ * switch of its pod and to k/2 hosts. The (k/2)^2 core switches are split
+ * in k/2 groups of k/2: the j'th aggregation switch of every pod is linked
+ * to every core switch of the j'th group. The fat-tree thus has k^3/4
+ * hosts, 5k^2/4 switches and 3k^3/4 links, e.g. 8192 hosts for k = 32.
+ *
+ * Hosts are numbered pod by pod and edge switch by edge switch. The
+ * switches returned by GetSwitches are ordered edge, aggregation, core.
+ */
+class PointToPointFatTreeHelper : public PointToPointFabricHelper
+{
+  public:
+    /**
+     * Create a PointToPointFatTreeHelper in order to easily create
+     * fat-tree topologies using p2p links
+     *
+     * \param k number of ports of every switch; must be even
+     *
+     * \param hostHelper PointToPointHelper used to install the links
+     *                   between the hosts and the edge switches
+     *
+     * \param fabricHelper PointToPointHelper used to install the links
+     *                     between the switches
+     */
+    PointToPointFatTreeHelper(uint32_t k,
+                              PointToPointHelper hostHelper,
+                              PointToPointHelper fabricHelper);
+
+    ~PointToPointFatTreeHelper() override;
+
+    /**
+     * \returns the number of ports of every switch
+     */
+    uint32_t GetK() const;
+
+    /**
+     * \returns pointer to the i'th host of the j'th edge switch of a pod
+     * \param pod pod number
+     * \param edge edge switch number within the pod
+     * \param i host number within the edge switch
+     */
+    Ptr<Node> GetHost(uint32_t pod, uint32_t edge, uint32_t i) const;
+
+    using PointToPointFabricHelper::GetHost;
+
+    /**
+     * \returns pointer to an edge switch
+     * \param pod pod number
+     * \param i edge switch number within the pod
+     */
+    Ptr<Node> GetEdge(uint32_t pod, uint32_t i) const;
+
+    /**
+     * \returns pointer to an aggregation switch
+     * \param pod pod number
+     * \param i aggregation switch number within the pod
+     */
+    Ptr<Node> GetAggregation(uint32_t pod, uint32_t i) const;
+
+    /**
+     * \returns pointer to the i'th core switch
+     * \param i core switch number
+     */
+    Ptr<Node> GetCore(uint32_t i) const;
+
+  private:
+    uint32_t m_k;                //!< Number of ports of every switch
+    NodeContainer m_edge;        //!< Edge switches, pod by pod
+    NodeContainer m_aggregation; //!< Aggregation switches, pod by pod
+    NodeContainer m_core;        //!< Core switches
+};
+
+} // namespace ns3
+
+#endif /* POINT_TO_POINT_FAT_TREE_HELPER_H */
@@ -0,0 +1,83 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// Implement an object to create a leaf-spine topology.
+
+#include "point-to-point-leaf-spine.h"
+
+#include "ns3/log.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("PointToPointLeafSpineHelper");
+
+PointToPointLeafSpineHelper::PointToPointLeafSpineHelper(uint32_t nSpine,
+                                                         uint32_t nLeaf,
+                                                         uint32_t nHostPerLeaf,
+                                                         PointToPointHelper hostHelper,
+                                                         PointToPointHelper fabricHelper)
+    : m_nHostPerLeaf(nHostPerLeaf)
+{
+    NS_LOG_FUNCTION(this << nSpine << nLeaf << nHostPerLeaf);
+
+    m_hosts.Create(nLeaf * nHostPerLeaf);
+    m_leaves.Create(nLeaf);
+    m_spines.Create(nSpine);
+    m_switches.Add(m_leaves);
+    m_switches.Add(m_spines);
+
+    // Host links first, in host order
+    for (uint32_t leaf = 0; leaf < nLeaf; ++leaf)
+    {
+        for (uint32_t i = 0; i < nHostPerLeaf; ++i)
+        {
+            AddHostLink(hostHelper, GetHost(leaf, i), GetLeaf(leaf));
+        }
+    }
+    for (uint32_t leaf = 0; leaf < nLeaf; ++leaf)
+    {
+        for (uint32_t spine = 0; spine < nSpine; ++spine)
+        {
+            AddFabricLink(fabricHelper, GetLeaf(leaf), GetSpine(spine));
+        }
+    }
+}
+
+PointToPointLeafSpineHelper::~PointToPointLeafSpineHelper()
+{
+}
+
+Ptr<Node>
+PointToPointLeafSpineHelper::GetHost(uint32_t leaf, uint32_t i) const
+{
+    NS_ASSERT_MSG(leaf < m_leaves.GetN() && i < m_nHostPerLeaf, "Invalid host");
+    return m_hosts.Get(leaf * m_nHostPerLeaf + i);
+}
+
+Ptr<Node>
+PointToPointLeafSpineHelper::GetLeaf(uint32_t i) const
+{
+    return m_leaves.Get(i);
+}
+
+Ptr<Node>
+PointToPointLeafSpineHelper::GetSpine(uint32_t i) const
+{
+    return m_spines.Get(i);
+}
+
+uint32_t
+PointToPointLeafSpineHelper::LeafCount() const
+{
+    return m_leaves.GetN();
+}
+
+uint32_t
+PointToPointLeafSpineHelper::SpineCount() const
+{
+    return m_spines.GetN();
+}
+
+} // namespace ns3
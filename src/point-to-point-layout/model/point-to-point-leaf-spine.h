@@ -0,0 +1,91 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// Define an object to create a leaf-spine topology.
+
+#ifndef POINT_TO_POINT_LEAF_SPINE_HELPER_H
+#define POINT_TO_POINT_LEAF_SPINE_HELPER_H
+
+#include "point-to-point-fabric.h"
+
+namespace ns3
+{
+
+/**
+ * \ingroup point-to-point-layout
+ *
+ * \brief A helper to make it easier to create a two-tier leaf-spine
+ * topology with p2p links
+ *
+ * Every leaf switch is linked to every spine switch and to its own hosts.
+ * Hosts are numbered leaf by leaf. The switches returned by GetSwitches
+ * are ordered leaves, then spines.
+ */
+class PointToPointLeafSpineHelper : public PointToPointFabricHelper
+{
+  public:
+    /**
+     * Create a PointToPointLeafSpineHelper in order to easily create
+     * leaf-spine topologies using p2p links
+     *
+     * \param nSpine number of spine switches
+     *
+     * \param nLeaf number of leaf switches
+     *
+     * \param nHostPerLeaf number of hosts linked to every leaf switch
+     *
+     * \param hostHelper PointToPointHelper used to install the links
+     *                   between the hosts and the leaf switches
+     *
+     * \param fabricHelper PointToPointHelper used to install the links
+     *                     between the leaf and the spine switches
+     */
+    PointToPointLeafSpineHelper(uint32_t nSpine,
+                                uint32_t nLeaf,
+                                uint32_t nHostPerLeaf,
+                                PointToPointHelper hostHelper,
+                                PointToPointHelper fabricHelper);
+
+    ~PointToPointLeafSpineHelper() override;
+
+    /**
+     * \returns pointer to the i'th host of a leaf switch
+     * \param leaf leaf switch number
+     * \param i host number within the leaf switch
+     */
+    Ptr<Node> GetHost(uint32_t leaf, uint32_t i) const;
+
+    using PointToPointFabricHelper::GetHost;
+
+    /**
+     * \returns pointer to the i'th leaf switch
+     * \param i leaf switch number
+     */
+    Ptr<Node> GetLeaf(uint32_t i) const;
+
+    /**
+     * \returns pointer to the i'th spine switch
+     * \param i spine switch number
+     */
+    Ptr<Node> GetSpine(uint32_t i) const;
+
+    /**
+     * \returns total number of leaf switches
+     */
+    uint32_t LeafCount() const;
+
+    /**
+     * \returns total number of spine switches
+     */
+    uint32_t SpineCount() const;
+
+  private:
+    uint32_t m_nHostPerLeaf; //!< Number of hosts per leaf switch
+    NodeContainer m_leaves;  //!< Leaf switches
+    NodeContainer m_spines;  //!< Spine switches
+};
+
+} // namespace ns3
+
+#endif /* POINT_TO_POINT_LEAF_SPINE_HELPER_H */
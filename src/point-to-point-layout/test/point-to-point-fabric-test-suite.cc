@@ -0,0 +1,306 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "ns3/channel.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4.h"
+#include "ns3/point-to-point-fat-tree.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/point-to-point-leaf-spine.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include <set>
+#include <string>
+
+using namespace ns3;
+
+/**
+ * \ingroup point-to-point-layout
+ * \defgroup point-to-point-layout-test point-to-point-layout module tests
+ */
+
+/**
+ * \brief Get the node at the other end of the point-to-point link of a device.
+ * \param device the device
+ * \return the peer node
+ */
+static Ptr<Node>
+GetPeer(Ptr<NetDevice> device)
+{
+    Ptr<Channel> channel = device->GetChannel();
+    Ptr<NetDevice> peer = channel->GetDevice(channel->GetDevice(0) == device ? 1 : 0);
+    return peer->GetNode();
+}
+
+/**
+ * \brief Check whether two nodes are linked.
+ * \param a the first node
+ * \param b the second node
+ * \return true if one of the devices of a is linked to b
+ */
+static bool
+AreLinked(Ptr<Node> a, Ptr<Node> b)
+{
+    for (uint32_t i = 0; i < a->GetNDevices(); i++)
+    {
+        Ptr<NetDevice> device = a->GetDevice(i);
+        if (device->GetChannel() && GetPeer(device) == b)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * \ingroup point-to-point-layout-test
+ *
+ * \brief Base of the fabric test cases: check the addresses of a fabric.
+ */
+class PointToPointFabricTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     * \param name the name of the test case
+     */
+    PointToPointFabricTestCase(std::string name);
+
+  protected:
+    /**
+     * \brief Check that the i'th link got the i'th /30 subnet, its lower end
+     * the first address and its upper end the second one.
+     *
+     * \param fabric the fabric, with its addresses assigned from 10.0.0.0/8
+     * \param nLinks the number of links of the fabric
+     */
+    void CheckAddresses(const PointToPointFabricHelper& fabric, uint32_t nLinks);
+};
+
+PointToPointFabricTestCase::PointToPointFabricTestCase(std::string name)
+    : TestCase(name)
+{
+}
+
+void
+PointToPointFabricTestCase::CheckAddresses(const PointToPointFabricHelper& fabric, uint32_t nLinks)
+{
+    std::set<uint32_t> addresses;
+    NodeContainer nodes = fabric.GetHosts();
+    nodes.Add(fabric.GetSwitches());
+    for (auto node = nodes.Begin(); node != nodes.End(); node++)
+    {
+        Ptr<Ipv4> ipv4 = (*node)->GetObject<Ipv4>();
+        // Skip the loopback interface
+        for (uint32_t i = 1; i < ipv4->GetNInterfaces(); i++)
+        {
+            NS_TEST_EXPECT_MSG_EQ(ipv4->GetNAddresses(i), 1, "One address per interface");
+            Ipv4InterfaceAddress address = ipv4->GetAddress(i, 0);
+            NS_TEST_EXPECT_MSG_EQ(address.GetMask(), Ipv4Mask("/30"), "Wrong link mask");
+            addresses.insert(address.GetLocal().Get());
+        }
+    }
+    NS_TEST_EXPECT_MSG_EQ(addresses.size(), 2 * nLinks, "The addresses are not unique");
+    NS_TEST_EXPECT_MSG_EQ(*addresses.begin(), Ipv4Address("10.0.0.1").Get(), "First address");
+    NS_TEST_EXPECT_MSG_EQ(*addresses.rbegin(),
+                          Ipv4Address("10.0.0.2").Get() + 4 * (nLinks - 1),
+                          "Last address");
+
+    for (uint32_t i = 0; i < fabric.HostCount(); i++)
+    {
+        Ipv4Address expected(Ipv4Address("10.0.0.1").Get() + 4 * i);
+        NS_TEST_EXPECT_MSG_EQ(fabric.GetHostIpv4Address(i), expected, "Host " << i);
+        Ptr<Ipv4> ipv4 = fabric.GetHost(i)->GetObject<Ipv4>();
+        int32_t interface = ipv4->GetInterfaceForDevice(fabric.GetHostDevice(i));
+        NS_TEST_EXPECT_MSG_EQ(ipv4->GetAddress(interface, 0).GetLocal(),
+                              expected,
+                              "Host " << i << " device");
+
+        // The switch end of the host link gets the second address
+        Ptr<Node> sw = GetPeer(fabric.GetHostDevice(i));
+        Ipv4Address upper(expected.Get() + 1);
+        NS_TEST_EXPECT_MSG_GT_OR_EQ(sw->GetObject<Ipv4>()->GetInterfaceForAddress(upper),
+                                    0,
+                                    "Switch end of the link of host " << i);
+    }
+}
+
+/**
+ * \ingroup point-to-point-layout-test
+ *
+ * \brief Check the nodes, links and addresses of a k = 4 fat-tree.
+ */
+class PointToPointFatTreeTestCase : public PointToPointFabricTestCase
+{
+  public:
+    PointToPointFatTreeTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+PointToPointFatTreeTestCase::PointToPointFatTreeTestCase()
+    : PointToPointFabricTestCase("Fat-tree nodes, links and addresses")
+{
+}
+
+void
+PointToPointFatTreeTestCase::DoRun()
+{
+    const uint32_t k = 4;
+    const uint32_t half = k / 2;
+    PointToPointHelper p2p;
+    PointToPointFatTreeHelper fatTree(k, p2p, p2p);
+
+    // k^3/4 hosts, 5k^2/4 switches and 3k^3/4 links
+    NS_TEST_ASSERT_MSG_EQ(fatTree.GetK(), k, "Wrong arity");
+    NS_TEST_ASSERT_MSG_EQ(fatTree.HostCount(), 16, "Wrong number of hosts");
+    NS_TEST_ASSERT_MSG_EQ(fatTree.GetSwitches().GetN(), 20, "Wrong number of switches");
+    NS_TEST_ASSERT_MSG_EQ(fatTree.GetSwitchDevices().GetN(),
+                          16 + 2 * 32,
+                          "Wrong number of switch ports");
+    for (uint32_t i = 0; i < fatTree.HostCount(); i++)
+    {
+        NS_TEST_EXPECT_MSG_EQ(fatTree.GetHost(i)->GetNDevices(), 1, "Host " << i);
+    }
+    NodeContainer switches = fatTree.GetSwitches();
+    for (auto sw = switches.Begin(); sw != switches.End(); sw++)
+    {
+        NS_TEST_EXPECT_MSG_EQ((*sw)->GetNDevices(), k, "Every switch has k ports");
+    }
+
+    for (uint32_t pod = 0; pod < k; pod++)
+    {
+        for (uint32_t edge = 0; edge < half; edge++)
+        {
+            for (uint32_t i = 0; i < half; i++)
+            {
+                NS_TEST_EXPECT_MSG_EQ(fatTree.GetHost(pod, edge, i),
+                                      fatTree.GetHost((pod * half + edge) * half + i),
+                                      "Hosts are numbered pod by pod, edge by edge");
+                NS_TEST_EXPECT_MSG_EQ(AreLinked(fatTree.GetHost(pod, edge, i),
+                                                fatTree.GetEdge(pod, edge)),
+                                      true,
+                                      "Host not linked to its edge switch");
+            }
+            for (uint32_t agg = 0; agg < half; agg++)
+            {
+                NS_TEST_EXPECT_MSG_EQ(
+                    AreLinked(fatTree.GetEdge(pod, edge), fatTree.GetAggregation(pod, agg)),
+                    true,
+                    "Edge switch not linked to an aggregation switch of its pod");
+            }
+        }
+        for (uint32_t agg = 0; agg < half; agg++)
+        {
+            for (uint32_t core = 0; core < half * half; core++)
+            {
+                NS_TEST_EXPECT_MSG_EQ(
+                    AreLinked(fatTree.GetAggregation(pod, agg), fatTree.GetCore(core)),
+                    (core / half == agg),
+                    "Aggregation switch " << agg << " of pod " << pod << " and core switch "
+                                          << core);
+            }
+        }
+    }
+
+    fatTree.InstallStack(InternetStackHelper());
+    fatTree.AssignIpv4Addresses(Ipv4Address("10.0.0.0"), Ipv4Mask("255.0.0.0"));
+    CheckAddresses(fatTree, 48);
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup point-to-point-layout-test
+ *
+ * \brief Check the nodes, links and addresses of a leaf-spine fabric.
+ */
+class PointToPointLeafSpineTestCase : public PointToPointFabricTestCase
+{
+  public:
+    PointToPointLeafSpineTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+PointToPointLeafSpineTestCase::PointToPointLeafSpineTestCase()
+    : PointToPointFabricTestCase("Leaf-spine nodes, links and addresses")
+{
+}
+
+void
+PointToPointLeafSpineTestCase::DoRun()
+{
+    const uint32_t nSpine = 2;
+    const uint32_t nLeaf = 3;
+    const uint32_t nHostPerLeaf = 4;
+    PointToPointHelper p2p;
+    PointToPointLeafSpineHelper leafSpine(nSpine, nLeaf, nHostPerLeaf, p2p, p2p);
+
+    NS_TEST_ASSERT_MSG_EQ(leafSpine.HostCount(), 12, "Wrong number of hosts");
+    NS_TEST_ASSERT_MSG_EQ(leafSpine.LeafCount(), nLeaf, "Wrong number of leaf switches");
+    NS_TEST_ASSERT_MSG_EQ(leafSpine.SpineCount(), nSpine, "Wrong number of spine switches");
+    NS_TEST_ASSERT_MSG_EQ(leafSpine.GetSwitches().GetN(), 5, "Wrong number of switches");
+    NS_TEST_ASSERT_MSG_EQ(leafSpine.GetSwitchDevices().GetN(),
+                          12 + 2 * 6,
+                          "Wrong number of switch ports");
+
+    for (uint32_t leaf = 0; leaf < nLeaf; leaf++)
+    {
+        NS_TEST_EXPECT_MSG_EQ(leafSpine.GetLeaf(leaf)->GetNDevices(),
+                              nHostPerLeaf + nSpine,
+                              "Leaf switch " << leaf);
+        for (uint32_t i = 0; i < nHostPerLeaf; i++)
+        {
+            NS_TEST_EXPECT_MSG_EQ(leafSpine.GetHost(leaf, i),
+                                  leafSpine.GetHost(leaf * nHostPerLeaf + i),
+                                  "Hosts are numbered leaf by leaf");
+            NS_TEST_EXPECT_MSG_EQ(GetPeer(leafSpine.GetHostDevice(leaf * nHostPerLeaf + i)),
+                                  leafSpine.GetLeaf(leaf),
+                                  "Host not linked to its leaf switch");
+        }
+        for (uint32_t spine = 0; spine < nSpine; spine++)
+        {
+            NS_TEST_EXPECT_MSG_EQ(AreLinked(leafSpine.GetLeaf(leaf), leafSpine.GetSpine(spine)),
+                                  true,
+                                  "Leaf switch " << leaf << " not linked to spine " << spine);
+        }
+    }
+    for (uint32_t spine = 0; spine < nSpine; spine++)
+    {
+        NS_TEST_EXPECT_MSG_EQ(leafSpine.GetSpine(spine)->GetNDevices(),
+                              nLeaf,
+                              "Spine switch " << spine);
+    }
+
+    leafSpine.InstallStack(InternetStackHelper());
+    leafSpine.AssignIpv4Addresses(Ipv4Address("10.0.0.0"), Ipv4Mask("255.0.0.0"));
+    CheckAddresses(leafSpine, 18);
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup point-to-point-layout-test
+ *
+ * \brief TestSuite for the datacenter fabric topology helpers
+ */
+class PointToPointFabricTestSuite : public TestSuite
+{
+  public:
+    PointToPointFabricTestSuite();
+};
+
+PointToPointFabricTestSuite::PointToPointFabricTestSuite()
+    : TestSuite("point-to-point-fabric", Type::UNIT)
+{
+    AddTestCase(new PointToPointFatTreeTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new PointToPointLeafSpineTestCase, TestCase::Duration::QUICK);
+}
+
+/// Static variable for test initialization
+static PointToPointFabricTestSuite g_pointToPointFabricTestSuite;
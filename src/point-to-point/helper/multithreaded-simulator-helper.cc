@@ -0,0 +1,94 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "multithreaded-simulator-helper.h"
+
+#include "ns3/abort.h"
+#include "ns3/log.h"
+#include "ns3/multithreaded-simulator-impl.h"
+#include "ns3/net-device.h"
+#include "ns3/node-list.h"
+#include "ns3/node.h"
+#include "ns3/point-to-point-channel.h"
+#include "ns3/simulator.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("MultithreadedSimulatorHelper");
+
+MultithreadedSimulatorHelper::MultithreadedSimulatorHelper(uint32_t nThreads)
+    : m_nThreads(nThreads)
+{
+    NS_LOG_FUNCTION(this << nThreads);
+    NS_ABORT_MSG_IF(nThreads == 0, "At least one thread is needed");
+}
+
+void
+MultithreadedSimulatorHelper::SetPartition(Ptr<Node> node, uint32_t partition)
+{
+    NS_LOG_FUNCTION(this << node << partition);
+    NS_ABORT_MSG_IF(partition >= m_nThreads, "Partition " << partition << " out of range");
+    m_partitioner.SetPartition(node, partition);
+}
+
+void
+MultithreadedSimulatorHelper::SetPartition(NodeContainer nodes, uint32_t partition)
+{
+    for (auto i = nodes.Begin(); i != nodes.End(); ++i)
+    {
+        SetPartition(*i, partition);
+    }
+}
+
+void
+MultithreadedSimulatorHelper::SetNodeLoad(Ptr<Node> node, double load)
+{
+    m_partitioner.SetNodeLoad(node, load);
+}
+
+void
+MultithreadedSimulatorHelper::Install()
+{
+    NS_LOG_FUNCTION(this);
+    Ptr<MultithreadedSimulatorImpl> impl =
+        DynamicCast<MultithreadedSimulatorImpl>(Simulator::GetImplementation());
+    NS_ABORT_MSG_IF(!impl,
+                    "SimulatorImplementationType must be ns3::MultithreadedSimulatorImpl");
+
+    m_partitioner.Partition(m_nThreads);
+    for (uint32_t i = 0; i < NodeList::GetNNodes(); i++)
+    {
+        impl->SetPartition(i, m_partitioner.GetPartition(i));
+        Ptr<Node> node = NodeList::GetNode(i);
+        for (uint32_t j = 0; j < node->GetNDevices(); j++)
+        {
+            Ptr<PointToPointChannel> link =
+                DynamicCast<PointToPointChannel>(node->GetDevice(j)->GetChannel());
+            if (link)
+            {
+                link->SetPartitionBoundary(false);
+            }
+        }
+    }
+    for (const auto& link : m_partitioner.GetCutLinks())
+    {
+        link->SetPartitionBoundary(true);
+    }
+    impl->SetLookahead(m_partitioner.GetLookahead());
+}
+
+Time
+MultithreadedSimulatorHelper::GetLookahead() const
+{
+    return m_partitioner.GetLookahead();
+}
+
+const TopologyPartitionHelper&
+MultithreadedSimulatorHelper::GetPartitioner() const
+{
+    return m_partitioner;
+}
+
+} // namespace ns3
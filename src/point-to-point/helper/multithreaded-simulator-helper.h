@@ -0,0 +1,106 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+#ifndef MULTITHREADED_SIMULATOR_HELPER_H
+#define MULTITHREADED_SIMULATOR_HELPER_H
+
+#include "topology-partition-helper.h"
+
+#include "ns3/node-container.h"
+#include "ns3/nstime.h"
+
+namespace ns3
+{
+
+class Node;
+
+/**
+ * \brief Split the nodes of a simulation over the partitions of the
+ * MultithreadedSimulatorImpl
+ *
+ * The nodes are partitioned by a TopologyPartitionHelper, along the
+ * PointToPointChannel links with a positive delay: the nodes connected by
+ * any other channel, or by a zero-delay point-to-point link, always share a
+ * partition.  The partitions balance the estimated load of the nodes while
+ * cutting links with delays as large as possible.  Nodes can also be pinned
+ * to a partition explicitly.
+ *
+ * The lookahead is the smallest delay of the links between partitions,
+ * which are marked as partition boundaries so that they deep-copy the
+ * packets they carry.
+ *
+ * The helper must be installed once the topology is complete, and after
+ * the simulator implementation was set:
+ *
+ * \code
+ *   GlobalValue::Bind("SimulatorImplementationType",
+ *                     StringValue("ns3::MultithreadedSimulatorImpl"));
+ *   // ... build the topology ...
+ *   MultithreadedSimulatorHelper mt(4);
+ *   mt.Install();
+ *   Simulator::Run();
+ * \endcode
+ */
+class MultithreadedSimulatorHelper
+{
+  public:
+    /**
+     * Create a MultithreadedSimulatorHelper.
+     *
+     * \param nThreads the number of partitions, each run by its own thread
+     */
+    MultithreadedSimulatorHelper(uint32_t nThreads);
+
+    /**
+     * \brief Pin a node to a partition
+     *
+     * The nodes which must share the partition of the node are pinned along.
+     *
+     * \param node the node
+     * \param partition the partition
+     */
+    void SetPartition(Ptr<Node> node, uint32_t partition);
+
+    /**
+     * \brief Pin a set of nodes to a partition
+     *
+     * \param nodes the nodes
+     * \param partition the partition
+     */
+    void SetPartition(NodeContainer nodes, uint32_t partition);
+
+    /**
+     * \brief Set the estimated event load of a node
+     *
+     * \param node the node
+     * \param load the load, in arbitrary units
+     */
+    void SetNodeLoad(Ptr<Node> node, double load);
+
+    /**
+     * \brief Partition all the nodes and set the lookahead of the simulator
+     *
+     * Aborts if the simulator implementation is not a
+     * MultithreadedSimulatorImpl.
+     */
+    void Install();
+
+    /**
+     * \returns the lookahead set by the last Install(), or the maximum
+     * simulation time if no link crosses partitions
+     */
+    Time GetLookahead() const;
+
+    /**
+     * \returns the partitioner, to report the quality of the partitions
+     */
+    const TopologyPartitionHelper& GetPartitioner() const;
+
+  private:
+    uint32_t m_nThreads;                   //!< Number of partitions
+    TopologyPartitionHelper m_partitioner; //!< Partitioner of the nodes
+};
+
+} // namespace ns3
+
+#endif /* MULTITHREADED_SIMULATOR_HELPER_H */
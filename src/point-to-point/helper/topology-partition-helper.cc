@@ -0,0 +1,582 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "topology-partition-helper.h"
+
+#include "ns3/abort.h"
+#include "ns3/channel.h"
+#include "ns3/log.h"
+#include "ns3/net-device.h"
+#include "ns3/node-list.h"
+#include "ns3/node.h"
+#include "ns3/point-to-point-channel.h"
+#include "ns3/point-to-point-net-device.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+
+#ifdef NS3_MPI
+#include "ns3/mpi-interface.h"
+#include "ns3/mpi-receiver.h"
+#include "ns3/point-to-point-remote-channel.h"
+#endif
+
+#include <algorithm>
+#include <numeric>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("TopologyPartitionHelper");
+
+namespace
+{
+
+/**
+ * Find the representative of the group of a node, compressing the path.
+ *
+ * \param [in,out] parent The parent of every node.
+ * \param [in] node The node id.
+ * \returns The id of the representative node.
+ */
+uint32_t
+FindGroup(std::vector<uint32_t>& parent, uint32_t node)
+{
+    while (parent[node] != node)
+    {
+        parent[node] = parent[parent[node]];
+        node = parent[node];
+    }
+    return node;
+}
+
+/**
+ * Merge the groups of two nodes; the node with the lowest id represents
+ * the merged group.
+ *
+ * \param [in,out] parent The parent of every node.
+ * \param [in] a A node id.
+ * \param [in] b Another node id.
+ */
+void
+MergeGroups(std::vector<uint32_t>& parent, uint32_t a, uint32_t b)
+{
+    a = FindGroup(parent, a);
+    b = FindGroup(parent, b);
+    if (a < b)
+    {
+        parent[b] = a;
+    }
+    else
+    {
+        parent[a] = b;
+    }
+}
+
+/** Groups of nodes which are not separated, numbered by lowest node id. */
+struct Groups
+{
+    std::vector<uint32_t> of;     //!< Group of every node
+    std::vector<double> load;     //!< Load of every group
+    std::vector<uint32_t> pinned; //!< Partition of every group, or the number of partitions
+};
+
+/** An assignment of groups to partitions. */
+struct Assignment
+{
+    std::vector<uint32_t> partition; //!< Partition of every group
+    std::vector<double> load;        //!< Load of every partition
+    double maxLoad;                  //!< Largest load of a partition
+};
+
+/**
+ * Finish an assignment: compute the load of the partitions.
+ *
+ * \param [in] groups The groups.
+ * \param [in] n The number of partitions.
+ * \param [in,out] assignment The assignment.
+ */
+void
+ComputeLoads(const Groups& groups, uint32_t n, Assignment& assignment)
+{
+    assignment.load.assign(n, 0);
+    for (uint32_t g = 0; g < groups.load.size(); g++)
+    {
+        assignment.load[assignment.partition[g]] += groups.load[g];
+    }
+    assignment.maxLoad = *std::max_element(assignment.load.begin(), assignment.load.end());
+}
+
+/**
+ * Assign the groups to partitions.
+ *
+ * The groups are first assigned to blocks of consecutive groups, which
+ * usually follow the structure of the topology; if these blocks are not
+ * balanced, the groups are assigned from the heaviest one to the least
+ * loaded partition.
+ *
+ * \param [in] groups The groups.
+ * \param [in] n The number of partitions.
+ * \param [in] bound The largest load of a balanced partition.
+ * \returns The assignment.
+ */
+Assignment
+Pack(const Groups& groups, uint32_t n, double bound)
+{
+    uint32_t nGroups = groups.load.size();
+    double unpinned = 0;
+    for (uint32_t g = 0; g < nGroups; g++)
+    {
+        if (groups.pinned[g] == n)
+        {
+            unpinned += groups.load[g];
+        }
+    }
+
+    Assignment blocks;
+    blocks.partition = groups.pinned;
+    double target = unpinned / n;
+    double cumulated = 0;
+    for (uint32_t g = 0; g < nGroups; g++)
+    {
+        if (groups.pinned[g] == n)
+        {
+            // A group belongs to the block of its midpoint
+            double midpoint = cumulated + groups.load[g] / 2;
+            blocks.partition[g] =
+                target > 0 ? std::min<uint32_t>(n - 1, static_cast<uint32_t>(midpoint / target))
+                           : 0;
+            cumulated += groups.load[g];
+        }
+    }
+    ComputeLoads(groups, n, blocks);
+    if (blocks.maxLoad <= bound)
+    {
+        return blocks;
+    }
+
+    Assignment greedy;
+    greedy.partition = groups.pinned;
+    greedy.load.assign(n, 0);
+    std::vector<uint32_t> order;
+    for (uint32_t g = 0; g < nGroups; g++)
+    {
+        if (groups.pinned[g] == n)
+        {
+            order.push_back(g);
+        }
+        else
+        {
+            greedy.load[groups.pinned[g]] += groups.load[g];
+        }
+    }
+    std::stable_sort(order.begin(), order.end(), [&groups](uint32_t a, uint32_t b) {
+        return groups.load[a] > groups.load[b];
+    });
+    for (auto g : order)
+    {
+        auto lightest = std::min_element(greedy.load.begin(), greedy.load.end());
+        greedy.partition[g] = lightest - greedy.load.begin();
+        *lightest += groups.load[g];
+    }
+    ComputeLoads(groups, n, greedy);
+    return greedy.maxLoad < blocks.maxLoad ? greedy : blocks;
+}
+
+/**
+ * Move groups to the partition they have the most links to, as long as the
+ * partitions stay balanced, to cut fewer links.
+ *
+ * \param [in] groups The groups.
+ * \param [in] neighbors The groups at the other end of the links of every group.
+ * \param [in] n The number of partitions.
+ * \param [in] bound The largest load of a balanced partition.
+ * \param [in,out] assignment The assignment.
+ */
+void
+Refine(const Groups& groups,
+       const std::vector<std::vector<uint32_t>>& neighbors,
+       uint32_t n,
+       double bound,
+       Assignment& assignment)
+{
+    bool moved = true;
+    for (uint32_t pass = 0; moved && pass < 8; pass++)
+    {
+        moved = false;
+        for (uint32_t g = 0; g < groups.load.size(); g++)
+        {
+            if (groups.pinned[g] != n)
+            {
+                continue;
+            }
+            std::vector<uint32_t> links(n, 0);
+            for (auto neighbor : neighbors[g])
+            {
+                links[assignment.partition[neighbor]]++;
+            }
+            uint32_t from = assignment.partition[g];
+            uint32_t to = from;
+            for (uint32_t p = 0; p < n; p++)
+            {
+                if (links[p] > links[to] && assignment.load[p] + groups.load[g] <= bound)
+                {
+                    to = p;
+                }
+            }
+            if (to != from)
+            {
+                assignment.partition[g] = to;
+                assignment.load[from] -= groups.load[g];
+                assignment.load[to] += groups.load[g];
+                moved = true;
+            }
+        }
+    }
+    assignment.maxLoad = *std::max_element(assignment.load.begin(), assignment.load.end());
+}
+
+} // unnamed namespace
+
+TopologyPartitionHelper::TopologyPartitionHelper()
+    : m_tolerance(0.1),
+      m_nPartitions(0),
+      m_lookahead(Simulator::GetMaximumSimulationTime())
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+TopologyPartitionHelper::SetNodeLoad(Ptr<Node> node, double load)
+{
+    NS_LOG_FUNCTION(this << node << load);
+    NS_ABORT_MSG_IF(load < 0, "The load of a node cannot be negative");
+    m_load[node->GetId()] = load;
+}
+
+void
+TopologyPartitionHelper::SetPartition(Ptr<Node> node, uint32_t partition)
+{
+    NS_LOG_FUNCTION(this << node << partition);
+    m_pinned[node->GetId()] = partition;
+}
+
+void
+TopologyPartitionHelper::SetPartition(NodeContainer nodes, uint32_t partition)
+{
+    for (auto i = nodes.Begin(); i != nodes.End(); ++i)
+    {
+        SetPartition(*i, partition);
+    }
+}
+
+void
+TopologyPartitionHelper::SetImbalanceTolerance(double tolerance)
+{
+    NS_LOG_FUNCTION(this << tolerance);
+    NS_ABORT_MSG_IF(tolerance < 0, "The imbalance tolerance cannot be negative");
+    m_tolerance = tolerance;
+}
+
+double
+TopologyPartitionHelper::GetNodeLoad(Ptr<Node> node) const
+{
+    auto it = m_load.find(node->GetId());
+    if (it != m_load.end())
+    {
+        return it->second;
+    }
+    return 1 + node->GetNDevices() + node->GetNApplications();
+}
+
+void
+TopologyPartitionHelper::Partition(uint32_t nPartitions)
+{
+    NS_LOG_FUNCTION(this << nPartitions);
+    NS_ABORT_MSG_IF(nPartitions == 0, "At least one partition is needed");
+    for (const auto& [id, pinned] : m_pinned)
+    {
+        NS_ABORT_MSG_IF(pinned >= nPartitions,
+                        "Node " << id << " pinned to partition " << pinned << " out of range");
+    }
+
+    m_nPartitions = nPartitions;
+    uint32_t nNodes = NodeList::GetNNodes();
+    std::vector<uint32_t> base(nNodes);
+    std::iota(base.begin(), base.end(), 0);
+
+    // Group the nodes which cannot be separated, and list the links which
+    // can be cut
+    m_links.clear();
+    for (uint32_t i = 0; i < nNodes; i++)
+    {
+        Ptr<Node> node = NodeList::GetNode(i);
+        for (uint32_t j = 0; j < node->GetNDevices(); j++)
+        {
+            Ptr<Channel> channel = node->GetDevice(j)->GetChannel();
+            if (!channel)
+            {
+                continue;
+            }
+            Ptr<PointToPointChannel> link = DynamicCast<PointToPointChannel>(channel);
+            TimeValue delay;
+            if (link)
+            {
+                link->GetAttribute("Delay", delay);
+            }
+            if (link && link->GetNDevices() == 2 && delay.Get().IsStrictlyPositive())
+            {
+                // Every link is seen from both ends; keep it once
+                if (link->GetDevice(0)->GetNode() == node)
+                {
+                    m_links.push_back(
+                        {link, i, link->GetDevice(1)->GetNode()->GetId(), delay.Get()});
+                }
+                continue;
+            }
+            for (std::size_t k = 0; k < channel->GetNDevices(); k++)
+            {
+                MergeGroups(base, i, channel->GetDevice(k)->GetNode()->GetId());
+            }
+        }
+    }
+
+    std::vector<double> nodeLoad(nNodes);
+    double total = 0;
+    for (uint32_t i = 0; i < nNodes; i++)
+    {
+        nodeLoad[i] = GetNodeLoad(NodeList::GetNode(i));
+        total += nodeLoad[i];
+    }
+    double bound = total / nPartitions * (1 + m_tolerance);
+
+    // Try the delays of the links from the largest: the links shorter than
+    // the delay are not cut, and the first delay which leaves balanced
+    // partitions is the lookahead
+    std::vector<Time> delays;
+    for (const auto& link : m_links)
+    {
+        delays.push_back(link.delay);
+    }
+    std::sort(delays.begin(), delays.end(), std::greater<>());
+    delays.erase(std::unique(delays.begin(), delays.end()), delays.end());
+    if (delays.empty())
+    {
+        delays.push_back(Simulator::GetMaximumSimulationTime());
+    }
+
+    bool found = false;
+    Groups best;
+    Assignment bestAssignment;
+    for (const auto& delay : delays)
+    {
+        std::vector<uint32_t> parent = base;
+        for (const auto& link : m_links)
+        {
+            if (link.delay < delay)
+            {
+                MergeGroups(parent, link.a, link.b);
+            }
+        }
+
+        Groups groups;
+        groups.of.resize(nNodes);
+        std::vector<uint32_t> index(nNodes, UINT32_MAX);
+        for (uint32_t i = 0; i < nNodes; i++)
+        {
+            uint32_t root = FindGroup(parent, i);
+            if (index[root] == UINT32_MAX)
+            {
+                index[root] = groups.load.size();
+                groups.load.push_back(0);
+                groups.pinned.push_back(nPartitions);
+            }
+            groups.of[i] = index[root];
+            groups.load[index[root]] += nodeLoad[i];
+        }
+        for (const auto& [id, pinned] : m_pinned)
+        {
+            NS_ABORT_MSG_IF(id >= nNodes, "Pinned node " << id << " does not exist");
+            uint32_t& group = groups.pinned[groups.of[id]];
+            if (group != nPartitions && group != pinned)
+            {
+                // Pinned nodes must be separated by links of this delay at least
+                groups.load.clear();
+                break;
+            }
+            group = pinned;
+        }
+        if (groups.load.empty())
+        {
+            continue;
+        }
+
+        Assignment assignment = Pack(groups, nPartitions, bound);
+        NS_LOG_LOGIC("Cutting links of " << delay << " or more: " << groups.load.size()
+                                         << " groups, largest load " << assignment.maxLoad);
+        if (!found || assignment.maxLoad < bestAssignment.maxLoad)
+        {
+            found = true;
+            best = groups;
+            bestAssignment = assignment;
+        }
+        if (assignment.maxLoad <= bound)
+        {
+            break;
+        }
+    }
+    NS_ABORT_MSG_IF(!found, "Nodes pinned to different partitions cannot be separated");
+
+    std::vector<std::vector<uint32_t>> neighbors(best.load.size());
+    for (const auto& link : m_links)
+    {
+        uint32_t a = best.of[link.a];
+        uint32_t b = best.of[link.b];
+        if (a != b)
+        {
+            neighbors[a].push_back(b);
+            neighbors[b].push_back(a);
+        }
+    }
+    Refine(best, neighbors, nPartitions, std::max(bound, bestAssignment.maxLoad), bestAssignment);
+
+    m_partition.resize(nNodes);
+    for (uint32_t i = 0; i < nNodes; i++)
+    {
+        m_partition[i] = bestAssignment.partition[best.of[i]];
+    }
+    m_loads = bestAssignment.load;
+    m_lookahead = Simulator::GetMaximumSimulationTime();
+    for (const auto& link : m_links)
+    {
+        if (m_partition[link.a] != m_partition[link.b])
+        {
+            m_lookahead = Min(m_lookahead, link.delay);
+        }
+    }
+    NS_LOG_INFO(*this);
+}
+
+uint32_t
+TopologyPartitionHelper::GetPartition(uint32_t nodeId) const
+{
+    NS_ASSERT_MSG(nodeId < m_partition.size(), "Node " << nodeId << " was not partitioned");
+    return m_partition[nodeId];
+}
+
+uint32_t
+TopologyPartitionHelper::GetNPartitions() const
+{
+    return m_nPartitions;
+}
+
+Time
+TopologyPartitionHelper::GetLookahead() const
+{
+    return m_lookahead;
+}
+
+std::vector<Ptr<PointToPointChannel>>
+TopologyPartitionHelper::GetCutLinks() const
+{
+    std::vector<Ptr<PointToPointChannel>> links;
+    for (const auto& link : m_links)
+    {
+        if (m_partition[link.a] != m_partition[link.b])
+        {
+            links.push_back(link.channel);
+        }
+    }
+    return links;
+}
+
+double
+TopologyPartitionHelper::GetLoad(uint32_t partition) const
+{
+    NS_ASSERT(partition < m_loads.size());
+    return m_loads[partition];
+}
+
+double
+TopologyPartitionHelper::GetImbalance() const
+{
+    double total = std::accumulate(m_loads.begin(), m_loads.end(), 0.0);
+    if (total == 0)
+    {
+        return 1;
+    }
+    return *std::max_element(m_loads.begin(), m_loads.end()) * m_loads.size() / total;
+}
+
+void
+TopologyPartitionHelper::Print(std::ostream& os) const
+{
+    std::vector<uint32_t> nodes(m_nPartitions, 0);
+    for (auto partition : m_partition)
+    {
+        nodes[partition]++;
+    }
+    for (uint32_t p = 0; p < m_nPartitions; p++)
+    {
+        os << "Partition " << p << ": " << nodes[p] << " nodes, load " << m_loads[p]
+           << std::endl;
+    }
+    os << "Imbalance " << GetImbalance() << ", " << GetCutLinks().size() << " of "
+       << m_links.size() << " links cut, lookahead " << m_lookahead.As(Time::MS) << std::endl;
+}
+
+void
+TopologyPartitionHelper::AssignSystemIds()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ABORT_MSG_IF(m_partition.size() != NodeList::GetNNodes(),
+                    "The nodes must be partitioned first");
+
+    for (uint32_t i = 0; i < m_partition.size(); i++)
+    {
+        NodeList::GetNode(i)->SetAttribute("SystemId", UintegerValue(m_partition[i]));
+    }
+
+#ifdef NS3_MPI
+    if (!MpiInterface::IsEnabled())
+    {
+        return;
+    }
+    // Rebuild the links cut by the partitioning as remote channels, and the
+    // links within a partition as local channels
+    for (auto& link : m_links)
+    {
+        bool remote = m_partition[link.a] != m_partition[link.b];
+        if (remote == (DynamicCast<PointToPointRemoteChannel>(link.channel) != nullptr))
+        {
+            continue;
+        }
+        ObjectFactory factory(remote ? "ns3::PointToPointRemoteChannel"
+                                     : "ns3::PointToPointChannel");
+        factory.Set("Delay", TimeValue(link.delay));
+        Ptr<PointToPointChannel> channel = factory.Create<PointToPointChannel>();
+        for (std::size_t k = 0; k < 2; k++)
+        {
+            Ptr<PointToPointNetDevice> device =
+                DynamicCast<PointToPointNetDevice>(link.channel->GetDevice(k));
+            if (remote && !device->GetObject<MpiReceiver>())
+            {
+                Ptr<MpiReceiver> receiver = CreateObject<MpiReceiver>();
+                receiver->SetReceiveCallback(MakeCallback(&PointToPointNetDevice::Receive, device));
+                device->AggregateObject(receiver);
+            }
+            device->Attach(channel);
+        }
+        link.channel = channel;
+    }
+#endif
+}
+
+std::ostream&
+operator<<(std::ostream& os, const TopologyPartitionHelper& partitioner)
+{
+    partitioner.Print(os);
+    return os;
+}
+
+} // namespace ns3
@@ -0,0 +1,182 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+#ifndef TOPOLOGY_PARTITION_HELPER_H
+#define TOPOLOGY_PARTITION_HELPER_H
+
+#include "ns3/node-container.h"
+#include "ns3/nstime.h"
+
+#include <map>
+#include <ostream>
+#include <vector>
+
+namespace ns3
+{
+
+class Node;
+class PointToPointChannel;
+
+/**
+ * \brief Partition a topology for a parallel simulation
+ *
+ * The partitioner works on the topology already built, i.e., the nodes of
+ * the NodeList and their channels.  The nodes connected by a channel other
+ * than PointToPointChannel, or by a zero-delay point-to-point link, cannot
+ * be separated; the other point-to-point links can be cut.
+ *
+ * The partitions balance the estimated event load of the nodes, within a
+ * tolerance, while cutting links of delays as large as possible, since the
+ * smallest delay of the cut links is the lookahead of the conservative
+ * parallel simulators.  The partitioner looks for the largest delay such
+ * that the nodes joined by the shorter links still fit in balanced
+ * partitions, preferring blocks of consecutive node ids, then moves nodes
+ * across partitions to cut fewer links.
+ *
+ * The estimated load of a node is 1 plus its number of devices and
+ * applications, unless set with SetNodeLoad().
+ *
+ * The result can be applied to a DistributedSimulatorImpl, or
+ * NullMessageSimulatorImpl, run with AssignSystemIds(), or to a
+ * MultithreadedSimulatorImpl with the MultithreadedSimulatorHelper, which
+ * uses this partitioner.
+ */
+class TopologyPartitionHelper
+{
+  public:
+    /**
+     * Create a TopologyPartitionHelper.
+     */
+    TopologyPartitionHelper();
+
+    /**
+     * \brief Set the estimated event load of a node
+     *
+     * \param node the node
+     * \param load the load, in arbitrary units
+     */
+    void SetNodeLoad(Ptr<Node> node, double load);
+
+    /**
+     * \brief Pin a node to a partition
+     *
+     * The nodes which cannot be separated from the node are pinned along.
+     *
+     * \param node the node
+     * \param partition the partition
+     */
+    void SetPartition(Ptr<Node> node, uint32_t partition);
+
+    /**
+     * \brief Pin a set of nodes to a partition
+     *
+     * \param nodes the nodes
+     * \param partition the partition
+     */
+    void SetPartition(NodeContainer nodes, uint32_t partition);
+
+    /**
+     * \brief Set the imbalance tolerated to cut links of larger delays
+     *
+     * \param tolerance the largest load of a partition, relative to the
+     * average load, minus 1; 0.1 by default
+     */
+    void SetImbalanceTolerance(double tolerance);
+
+    /**
+     * \brief Partition all the nodes
+     *
+     * \param nPartitions the number of partitions
+     */
+    void Partition(uint32_t nPartitions);
+
+    /**
+     * \param nodeId the id of a node
+     * \returns the partition of the node
+     */
+    uint32_t GetPartition(uint32_t nodeId) const;
+
+    /**
+     * \returns the number of partitions
+     */
+    uint32_t GetNPartitions() const;
+
+    /**
+     * \returns the smallest delay of the cut links, or the maximum
+     * simulation time if no link is cut
+     */
+    Time GetLookahead() const;
+
+    /**
+     * \returns the links between partitions
+     */
+    std::vector<Ptr<PointToPointChannel>> GetCutLinks() const;
+
+    /**
+     * \param partition a partition
+     * \returns the estimated load of the partition
+     */
+    double GetLoad(uint32_t partition) const;
+
+    /**
+     * \returns the largest load of a partition, relative to the average load
+     */
+    double GetImbalance() const;
+
+    /**
+     * \brief Print the load of the partitions, the imbalance, the number of
+     * cut links and the lookahead
+     *
+     * \param os the output stream
+     */
+    void Print(std::ostream& os) const;
+
+    /**
+     * \brief Make the partitions the system ids of the nodes
+     *
+     * When MPI is enabled, the cut links become PointToPointRemoteChannel
+     * links, as if the topology had been built with these system ids.  This
+     * must be done before the applications are installed on the nodes of
+     * the local system.
+     */
+    void AssignSystemIds();
+
+  private:
+    /** A point-to-point link which can be cut. */
+    struct Link
+    {
+        Ptr<PointToPointChannel> channel; //!< The channel
+        uint32_t a;                       //!< The id of the node of the first device
+        uint32_t b;                       //!< The id of the node of the second device
+        Time delay;                       //!< The delay of the channel
+    };
+
+    /**
+     * \param node the node
+     * \returns the estimated event load of the node
+     */
+    double GetNodeLoad(Ptr<Node> node) const;
+
+    std::map<uint32_t, double> m_load;     //!< Load of the nodes, by node id
+    std::map<uint32_t, uint32_t> m_pinned; //!< Partition of the pinned nodes, by node id
+    double m_tolerance;                    //!< Imbalance tolerance
+
+    uint32_t m_nPartitions;             //!< Number of partitions
+    std::vector<uint32_t> m_partition;  //!< Partition of every node
+    std::vector<double> m_loads;        //!< Load of every partition
+    std::vector<Link> m_links;          //!< Links which can be cut
+    Time m_lookahead;                   //!< Smallest delay of the cut links
+};
+
+/**
+ * \brief Stream insertion operator.
+ *
+ * \param [in] os The reference to the output stream.
+ * \param [in] partitioner The partitioner.
+ * \returns The reference to the output stream.
+ */
+std::ostream& operator<<(std::ostream& os, const TopologyPartitionHelper& partitioner);
+
+} // namespace ns3
+
+#endif /* TOPOLOGY_PARTITION_HELPER_H */
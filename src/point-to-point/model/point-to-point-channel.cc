@@ -13,6 +13,8 @@
 #include "ns3/simulator.h"
 #include "ns3/trace-source-accessor.h"
 
+#include <vector>
+
 namespace ns3
 {
 
@@ -48,7 +50,8 @@ PointToPointChannel::GetTypeId()
 PointToPointChannel::PointToPointChannel()
     : Channel(),
       m_delay(Seconds(0.)),
-      m_nDevices(0)
+      m_nDevices(0),
+      m_partitionBoundary(false)
 {
     NS_LOG_FUNCTION_NOARGS();
 }
@@ -85,11 +88,25 @@ PointToPointChannel::TransmitStart(Ptr<const Packet> p, Ptr<PointToPointNetDevic
 
     uint32_t wire = src == m_link[0].m_src ? 0 : 1;
 
+    Ptr<Packet> copy;
+    if (m_partitionBoundary)
+    {
+        // The copy-on-write buffers of a packet are not thread-safe, so the
+        // receiving partition gets a packet of its own, rebuilt from the
+        // serialized packet as for the distributed simulations
+        std::vector<uint8_t> buffer(p->GetSerializedSize());
+        p->Serialize(buffer.data(), buffer.size());
+        copy = Create<Packet>(buffer.data(), buffer.size(), true);
+    }
+    else
+    {
+        copy = p->Copy();
+    }
     Simulator::ScheduleWithContext(m_link[wire].m_dst->GetNode()->GetId(),
                                    txTime + m_delay,
                                    &PointToPointNetDevice::Receive,
                                    m_link[wire].m_dst,
-                                   p->Copy());
+                                   copy);
 
     // Call the tx anim callback on the net device
     m_txrxPointToPoint(p, src, m_link[wire].m_dst, txTime, txTime + m_delay);
@@ -118,6 +135,19 @@ PointToPointChannel::GetDevice(std::size_t i) const
     return GetPointToPointDevice(i);
 }
 
+void
+PointToPointChannel::SetPartitionBoundary(bool boundary)
+{
+    NS_LOG_FUNCTION(this << boundary);
+    m_partitionBoundary = boundary;
+}
+
+bool
+PointToPointChannel::IsPartitionBoundary() const
+{
+    return m_partitionBoundary;
+}
+
 Time
 PointToPointChannel::GetDelay() const
 {
@@ -90,6 +90,23 @@ class PointToPointChannel : public Channel
      */
     Ptr<NetDevice> GetDevice(std::size_t i) const override;
 
+    /**
+     * \brief Mark the channel as a boundary between the partitions of a
+     * MultithreadedSimulatorImpl
+     *
+     * The packets crossing a boundary are deep copies, which share no buffer
+     * with the packets of the sending partition.
+     *
+     * \param boundary whether the two devices run in different partitions
+     */
+    void SetPartitionBoundary(bool boundary);
+
+    /**
+     * \brief Check whether the channel is a boundary between partitions
+     * \returns true if the two devices run in different partitions
+     */
+    bool IsPartitionBoundary() const;
+
   protected:
     /**
      * \brief Get the delay associated with this channel
@@ -141,8 +158,9 @@ class PointToPointChannel : public Channel
     /** Each point to point link has exactly two net devices. */
     static const std::size_t N_DEVICES = 2;
 
-    Time m_delay;           //!< Propagation delay
-    std::size_t m_nDevices; //!< Devices of this channel
+    Time m_delay;             //!< Propagation delay
+    std::size_t m_nDevices;   //!< Devices of this channel
+    bool m_partitionBoundary; //!< Whether the devices run in different partitions
 
     /**
      * The trace source for the packet transmission animation events that the
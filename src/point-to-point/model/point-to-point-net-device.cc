@@ -9,12 +9,14 @@
 #include "point-to-point-channel.h"
 #include "ppp-header.h"
 
+#include "ns3/boolean.h"
 #include "ns3/error-model.h"
 #include "ns3/llc-snap-header.h"
 #include "ns3/log.h"
 #include "ns3/mac48-address.h"
 #include "ns3/pointer.h"
 #include "ns3/queue.h"
+#include "ns3/segmentation-offload.h"
 #include "ns3/simulator.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/uinteger.h"
@@ -60,6 +62,13 @@ PointToPointNetDevice::GetTypeId()
                           TimeValue(Seconds(0.0)),
                           MakeTimeAccessor(&PointToPointNetDevice::m_tInterframeGap),
                           MakeTimeChecker())
+            .AddAttribute("SegmentationOffload",
+                          "Whether the super-segments are split by the device when it "
+                          "transmits them (segmentation offload), rather than by the "
+                          "upper layers",
+                          BooleanValue(true),
+                          MakeBooleanAccessor(&PointToPointNetDevice::m_segmentationOffload),
+                          MakeBooleanChecker())
 
             //
             // Transmit queueing discipline for the device which includes its own set
@@ -167,7 +176,8 @@ PointToPointNetDevice::PointToPointNetDevice()
     : m_txMachineState(READY),
       m_channel(nullptr),
       m_linkUp(false),
-      m_currentPkt(nullptr)
+      m_currentPkt(nullptr),
+      m_segmentationOffload(true)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -204,6 +214,7 @@ PointToPointNetDevice::DoDispose()
     m_channel = nullptr;
     m_receiveErrorModel = nullptr;
     m_currentPkt = nullptr;
+    m_segments.clear();
     m_queue = nullptr;
     NetDevice::DoDispose();
 }
@@ -271,7 +282,7 @@ PointToPointNetDevice::TransmitComplete()
     m_phyTxEndTrace(m_currentPkt);
     m_currentPkt = nullptr;
 
-    Ptr<Packet> p = m_queue->Dequeue();
+    Ptr<Packet> p = DequeueFrame();
     if (!p)
     {
         NS_LOG_LOGIC("No pending packets in device queue after tx complete");
@@ -286,6 +297,45 @@ PointToPointNetDevice::TransmitComplete()
     TransmitStart(p);
 }
 
+Ptr<Packet>
+PointToPointNetDevice::DequeueFrame()
+{
+    NS_LOG_FUNCTION(this);
+    if (!m_segments.empty())
+    {
+        Ptr<Packet> p = m_segments.front();
+        m_segments.pop_front();
+        return p;
+    }
+
+    Ptr<Packet> p = m_queue->Dequeue();
+    SegmentationOffloadTag gso;
+    if (!p || !m_segmentationOffload || !p->PeekPacketTag(gso))
+    {
+        return p;
+    }
+
+    //
+    // A super-segment is split now, so that each of its segments takes its
+    // own transmission time, as when the segments are sent one by one.
+    //
+    PppHeader ppp;
+    Ptr<Packet> packet = p->Copy();
+    packet->RemoveHeader(ppp);
+    if (!SegmentationOffload::Segment(PppToEther(ppp.GetProtocol()), packet, m_segments))
+    {
+        return p;
+    }
+    NS_LOG_LOGIC("Split packet " << p->GetUid() << " into " << m_segments.size() << " segments");
+    for (auto& segment : m_segments)
+    {
+        segment->AddHeader(ppp);
+    }
+    p = m_segments.front();
+    m_segments.pop_front();
+    return p;
+}
+
 bool
 PointToPointNetDevice::Attach(Ptr<PointToPointChannel> ch)
 {
@@ -533,7 +583,7 @@ PointToPointNetDevice::Send(Ptr<Packet> packet, const Address& dest, uint16_t pr
         //
         if (m_txMachineState == READY)
         {
-            packet = m_queue->Dequeue();
+            packet = DequeueFrame();
             m_snifferTrace(packet);
             m_promiscSnifferTrace(packet);
             bool ret = TransmitStart(packet);
@@ -597,6 +647,12 @@ PointToPointNetDevice::SupportsSendFrom() const
     return false;
 }
 
+bool
+PointToPointNetDevice::SupportsSegmentationOffload() const
+{
+    return m_segmentationOffload;
+}
+
 void
 PointToPointNetDevice::DoMpiReceive(Ptr<Packet> p)
 {
@@ -20,6 +20,7 @@
 #include "ns3/traced-callback.h"
 
 #include <cstring>
+#include <list>
 
 namespace ns3
 {
@@ -186,6 +187,7 @@ class PointToPointNetDevice : public NetDevice
 
     void SetPromiscReceiveCallback(PromiscReceiveCallback cb) override;
     bool SupportsSendFrom() const override;
+    bool SupportsSegmentationOffload() const override;
 
   protected:
     /**
@@ -250,6 +252,16 @@ class PointToPointNetDevice : public NetDevice
      */
     void TransmitComplete();
 
+    /**
+     * Get the next frame to transmit: the next segment of the super-segment
+     * being transmitted, or the next packet of the queue.  A super-segment
+     * dequeued when segmentation offload is enabled is split into segments,
+     * each of which is transmitted as a frame of its own.
+     *
+     * \returns the next frame, or nullptr if there is none
+     */
+    Ptr<Packet> DequeueFrame();
+
     /**
      * \brief Make the link up and running
      *
@@ -433,6 +445,9 @@ class PointToPointNetDevice : public NetDevice
 
     Ptr<Packet> m_currentPkt; //!< Current packet processed
 
+    bool m_segmentationOffload;        //!< Whether the super-segments are split by the device
+    std::list<Ptr<Packet>> m_segments; //!< Segments of the super-segment being transmitted
+
     /**
      * \brief PPP to Ethernet protocol number mapping
      * \param protocol A PPP protocol number
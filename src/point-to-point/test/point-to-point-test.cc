@@ -6,12 +6,18 @@
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 
+#include "ns3/config.h"
 #include "ns3/drop-tail-queue.h"
+#include "ns3/multithreaded-simulator-helper.h"
+#include "ns3/multithreaded-simulator-impl.h"
 #include "ns3/net-device-queue-interface.h"
 #include "ns3/point-to-point-channel.h"
+#include "ns3/point-to-point-helper.h"
 #include "ns3/point-to-point-net-device.h"
 #include "ns3/simulator.h"
+#include "ns3/string.h"
 #include "ns3/test.h"
+#include "ns3/topology-partition-helper.h"
 
 #include <string>
 
@@ -128,6 +134,210 @@ PointToPointTest::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \brief Test the partitioning of a chain of PointToPoint links for the
+ * MultithreadedSimulatorImpl
+ *
+ * The chain n0 -(1ms)- n1 -(10ms)- n2 -(0ms)- n3 is split over two
+ * partitions; n2 and n3 cannot be separated, and the partitions are
+ * balanced by cutting the longest link, n1 - n2.  A packet is then sent
+ * across the cut.
+ */
+class PointToPointPartitionTest : public TestCase
+{
+  public:
+    /**
+     * \brief Create the test
+     */
+    PointToPointPartitionTest();
+
+  private:
+    void DoRun() override;
+    void DoTeardown() override;
+
+    /**
+     * \brief Callback function which records the received packet
+     *
+     * \param dev The receiving device.
+     * \param pkt The received packet.
+     * \param mode The protocol mode used.
+     * \param sender The sender address.
+     *
+     * \return A boolean indicating packet handled properly.
+     */
+    bool RxPacket(Ptr<NetDevice> dev, Ptr<const Packet> pkt, uint16_t mode, const Address& sender);
+
+    Ptr<const Packet> m_recvdPacket; //!< received packet
+    Time m_recvdTime;                //!< reception time
+};
+
+PointToPointPartitionTest::PointToPointPartitionTest()
+    : TestCase("PointToPoint partitioning for the multithreaded simulator")
+{
+}
+
+bool
+PointToPointPartitionTest::RxPacket(Ptr<NetDevice> dev,
+                                    Ptr<const Packet> pkt,
+                                    uint16_t mode,
+                                    const Address& sender)
+{
+    m_recvdPacket = pkt;
+    m_recvdTime = Simulator::Now();
+    return true;
+}
+
+void
+PointToPointPartitionTest::DoRun()
+{
+    Config::SetGlobal("SimulatorImplementationType",
+                      StringValue("ns3::MultithreadedSimulatorImpl"));
+
+    NodeContainer nodes(4);
+    PointToPointHelper p2p;
+    NetDeviceContainer devices;
+    const char* delays[] = {"1ms", "10ms", "0ms"};
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        p2p.SetChannelAttribute("Delay", StringValue(delays[i]));
+        devices.Add(p2p.Install(nodes.Get(i), nodes.Get(i + 1)));
+    }
+
+    MultithreadedSimulatorHelper helper(2);
+    helper.Install();
+
+    Ptr<MultithreadedSimulatorImpl> impl =
+        DynamicCast<MultithreadedSimulatorImpl>(Simulator::GetImplementation());
+    std::vector<uint32_t> partition;
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        partition.push_back(impl->GetPartition(nodes.Get(i)->GetId()));
+    }
+    NS_TEST_EXPECT_MSG_EQ(partition[0], 0, "n0 should be in the first partition");
+    NS_TEST_EXPECT_MSG_EQ(partition[1], 0, "n1 should be in the first partition");
+    NS_TEST_EXPECT_MSG_EQ(partition[2], 1, "n2 should be in the second partition");
+    NS_TEST_EXPECT_MSG_EQ(partition[3], 1, "n3 should share the partition of n2");
+    NS_TEST_EXPECT_MSG_EQ(helper.GetLookahead(), MilliSeconds(10), "Wrong lookahead");
+
+    Ptr<PointToPointChannel> cut = DynamicCast<PointToPointChannel>(devices.Get(2)->GetChannel());
+    Ptr<PointToPointChannel> uncut =
+        DynamicCast<PointToPointChannel>(devices.Get(0)->GetChannel());
+    NS_TEST_EXPECT_MSG_EQ(cut->IsPartitionBoundary(), true, "n1 - n2 should be a boundary");
+    NS_TEST_EXPECT_MSG_EQ(uncut->IsPartitionBoundary(), false, "n0 - n1 is no boundary");
+
+    devices.Get(2)->SetReceiveCallback(MakeCallback(&PointToPointPartitionTest::RxPacket, this));
+    uint8_t txBuffer[] = "across the partitions";
+    Ptr<NetDevice> sender = devices.Get(3);
+    Simulator::ScheduleWithContext(nodes.Get(2)->GetId(), Seconds(1), [sender, &txBuffer]() {
+        sender->Send(Create<Packet>(txBuffer, sizeof(txBuffer)), sender->GetBroadcast(), 0x800);
+    });
+    Simulator::Run();
+
+    NS_TEST_ASSERT_MSG_NE(m_recvdPacket, nullptr, "No packet received");
+    NS_TEST_EXPECT_MSG_EQ(m_recvdPacket->GetSize(), sizeof(txBuffer), "Wrong packet size");
+    uint8_t rxBuffer[sizeof(txBuffer)];
+    m_recvdPacket->CopyData(rxBuffer, sizeof(rxBuffer));
+    NS_TEST_EXPECT_MSG_EQ(memcmp(rxBuffer, txBuffer, sizeof(txBuffer)), 0, "Wrong payload");
+    NS_TEST_EXPECT_MSG_GT(m_recvdTime, Seconds(1) + MilliSeconds(10), "Packet received too early");
+
+    Simulator::Destroy();
+}
+
+void
+PointToPointPartitionTest::DoTeardown()
+{
+    Config::SetGlobal("SimulatorImplementationType", StringValue("ns3::DefaultSimulatorImpl"));
+}
+
+/**
+ * \brief Test the TopologyPartitionHelper on pods of nodes
+ *
+ * Four pods of four nodes, chained by 1ms links, are joined in a ring by
+ * 20ms links.  Four balanced partitions are the four pods; pinning a node
+ * moves its pod.  Assigning the system ids gives each node the id of its
+ * partition.
+ */
+class TopologyPartitionTest : public TestCase
+{
+  public:
+    /**
+     * \brief Create the test
+     */
+    TopologyPartitionTest();
+
+  private:
+    void DoRun() override;
+};
+
+TopologyPartitionTest::TopologyPartitionTest()
+    : TestCase("Topology partitioning balances the load and maximizes the lookahead")
+{
+}
+
+void
+TopologyPartitionTest::DoRun()
+{
+    const uint32_t nPods = 4;
+    const uint32_t podSize = 4;
+    NodeContainer nodes(nPods * podSize);
+    PointToPointHelper p2p;
+    p2p.SetChannelAttribute("Delay", StringValue("1ms"));
+    for (uint32_t pod = 0; pod < nPods; pod++)
+    {
+        for (uint32_t i = 1; i < podSize; i++)
+        {
+            p2p.Install(nodes.Get(pod * podSize + i - 1), nodes.Get(pod * podSize + i));
+        }
+    }
+    p2p.SetChannelAttribute("Delay", StringValue("20ms"));
+    for (uint32_t pod = 0; pod < nPods; pod++)
+    {
+        // Join the middle nodes, so that blocks of consecutive nodes would
+        // cut 1ms links
+        p2p.Install(nodes.Get(pod * podSize + 1), nodes.Get(((pod + 1) % nPods) * podSize + 2));
+    }
+
+    TopologyPartitionHelper partitioner;
+    partitioner.Partition(nPods);
+    NS_TEST_EXPECT_MSG_EQ(partitioner.GetLookahead(), MilliSeconds(20), "Wrong lookahead");
+    NS_TEST_EXPECT_MSG_EQ(partitioner.GetCutLinks().size(), nPods, "Wrong number of cut links");
+    NS_TEST_EXPECT_MSG_EQ_TOL(partitioner.GetImbalance(), 1, 1e-9, "Unbalanced partitions");
+    for (uint32_t pod = 0; pod < nPods; pod++)
+    {
+        for (uint32_t i = 1; i < podSize; i++)
+        {
+            NS_TEST_EXPECT_MSG_EQ(partitioner.GetPartition(nodes.Get(pod * podSize + i)->GetId()),
+                                  partitioner.GetPartition(nodes.Get(pod * podSize)->GetId()),
+                                  "Pod " << pod << " was split");
+        }
+    }
+
+    partitioner.SetPartition(nodes.Get(podSize), 3);
+    partitioner.Partition(nPods);
+    NS_TEST_EXPECT_MSG_EQ(partitioner.GetPartition(nodes.Get(podSize + 3)->GetId()),
+                          3,
+                          "The pod of a pinned node should follow it");
+    NS_TEST_EXPECT_MSG_EQ(partitioner.GetLookahead(), MilliSeconds(20), "Wrong lookahead");
+
+    // Without MPI, the system ids change but the links stay local channels
+    partitioner.AssignSystemIds();
+    for (uint32_t i = 0; i < nodes.GetN(); i++)
+    {
+        Ptr<Node> node = nodes.Get(i);
+        NS_TEST_EXPECT_MSG_EQ(node->GetSystemId(),
+                              partitioner.GetPartition(node->GetId()),
+                              "Node " << i << " has not the system id of its partition");
+    }
+    for (const auto& channel : partitioner.GetCutLinks())
+    {
+        NS_TEST_EXPECT_MSG_EQ(channel->GetTypeId(),
+                              PointToPointChannel::GetTypeId(),
+                              "A cut link without MPI should stay a local channel");
+    }
+
+    Simulator::Destroy();
+}
+
 /**
  * \brief TestSuite for PointToPoint module
  */
@@ -144,6 +354,8 @@ PointToPointTestSuite::PointToPointTestSuite()
     : TestSuite("devices-point-to-point", Type::UNIT)
 {
     AddTestCase(new PointToPointTest, TestCase::Duration::QUICK);
+    AddTestCase(new PointToPointPartitionTest, TestCase::Duration::QUICK);
+    AddTestCase(new TopologyPartitionTest, TestCase::Duration::QUICK);
 }
 
 static PointToPointTestSuite g_pointToPointTestSuite; //!< The testsuite
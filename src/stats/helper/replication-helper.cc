@@ -0,0 +1,376 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "replication-helper.h"
+
+#include "ns3/abort.h"
+#include "ns3/command-line.h"
+#include "ns3/data-calculator.h"
+#include "ns3/data-output-interface.h"
+#include "ns3/log.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/simulation-fork.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("ReplicationHelper");
+
+namespace
+{
+
+/**
+ * Write the values output by the calculators of a replication, one
+ * "key<TAB>variable<TAB>value" line per value.
+ */
+class ReplicationOutputCallback : public DataOutputCallback
+{
+  public:
+    /**
+     * Constructor.
+     *
+     * \param [in,out] os The stream to write to.
+     */
+    ReplicationOutputCallback(std::ostream& os)
+        : m_os(os)
+    {
+        m_os << std::setprecision(17);
+    }
+
+    void OutputStatistic(std::string key,
+                         std::string variable,
+                         const StatisticalSummary* statSum) override
+    {
+        if (statSum->getCount() > 0)
+        {
+            Write(key, variable, statSum->getMean());
+        }
+    }
+
+    void OutputSingleton(std::string key, std::string variable, int val) override
+    {
+        Write(key, variable, val);
+    }
+
+    void OutputSingleton(std::string key, std::string variable, uint32_t val) override
+    {
+        Write(key, variable, val);
+    }
+
+    void OutputSingleton(std::string key, std::string variable, double val) override
+    {
+        Write(key, variable, val);
+    }
+
+    void OutputSingleton(std::string key, std::string variable, std::string val) override
+    {
+    }
+
+    void OutputSingleton(std::string key, std::string variable, Time val) override
+    {
+        Write(key, variable, val.GetSeconds());
+    }
+
+  private:
+    /**
+     * Write a value.
+     *
+     * \param [in] key The key of the variable.
+     * \param [in] variable The name of the variable.
+     * \param [in] value The value.
+     */
+    void Write(std::string key, std::string variable, double value)
+    {
+        for (auto* name : {&key, &variable})
+        {
+            for (auto& c : *name)
+            {
+                if (c == '\t' || c == '\n')
+                {
+                    c = ' ';
+                }
+            }
+        }
+        m_os << key << '\t' << variable << '\t' << value << '\n';
+    }
+
+    std::ostream& m_os; //!< The output stream
+};
+
+/**
+ * \param [in] a The first shape parameter.
+ * \param [in] b The second shape parameter.
+ * \param [in] x The point, in [0, 1].
+ * \returns The regularized incomplete beta function I_x(a, b).
+ */
+double
+IncompleteBeta(double a, double b, double x)
+{
+    if (x <= 0)
+    {
+        return 0;
+    }
+    if (x >= 1)
+    {
+        return 1;
+    }
+    // The continued fraction converges quickly for x < (a + 1) / (a + b + 2)
+    if (x > (a + 1) / (a + b + 2))
+    {
+        return 1 - IncompleteBeta(b, a, 1 - x);
+    }
+    double front = std::exp(std::lgamma(a + b) - std::lgamma(a) - std::lgamma(b) +
+                            a * std::log(x) + b * std::log(1 - x)) /
+                   a;
+    // Lentz's algorithm
+    const double tiny = 1e-300;
+    double c = 1;
+    double d = 1 - (a + b) * x / (a + 1);
+    d = 1 / (std::abs(d) < tiny ? tiny : d);
+    double f = d;
+    for (int m = 1; m <= 300; m++)
+    {
+        for (int step = 0; step < 2; step++)
+        {
+            double num = step == 0 ? m * (b - m) * x / ((a + 2 * m - 1) * (a + 2 * m))
+                                   : -(a + m) * (a + b + m) * x / ((a + 2 * m) * (a + 2 * m + 1));
+            d = 1 + num * d;
+            d = 1 / (std::abs(d) < tiny ? tiny : d);
+            c = 1 + num / c;
+            c = std::abs(c) < tiny ? tiny : c;
+            f *= c * d;
+        }
+        if (std::abs(c * d - 1) < 1e-15)
+        {
+            break;
+        }
+    }
+    return front * f;
+}
+
+/**
+ * \param [in] t The point.
+ * \param [in] dof The degrees of freedom.
+ * \returns The cumulative distribution function of the Student t
+ * distribution.
+ */
+double
+StudentCdf(double t, double dof)
+{
+    double tail = 0.5 * IncompleteBeta(dof / 2, 0.5, dof / (dof + t * t));
+    return t >= 0 ? 1 - tail : tail;
+}
+
+} // namespace
+
+ReplicationHelper::ReplicationHelper()
+    : m_replications(10),
+      m_firstRun(0),
+      m_firstRunSet(false),
+      m_jobs(0),
+      m_confidenceLevel(0.95)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+ReplicationHelper::SetReplications(uint32_t replications)
+{
+    NS_LOG_FUNCTION(this << replications);
+    m_replications = replications;
+}
+
+void
+ReplicationHelper::SetFirstRun(uint64_t run)
+{
+    NS_LOG_FUNCTION(this << run);
+    m_firstRun = run;
+    m_firstRunSet = true;
+}
+
+void
+ReplicationHelper::SetJobs(uint32_t jobs)
+{
+    NS_LOG_FUNCTION(this << jobs);
+    m_jobs = jobs;
+}
+
+void
+ReplicationHelper::SetConfidenceLevel(double level)
+{
+    NS_LOG_FUNCTION(this << level);
+    NS_ABORT_MSG_IF(level <= 0 || level >= 1, "The confidence level must be in (0, 1)");
+    m_confidenceLevel = level;
+}
+
+void
+ReplicationHelper::AddCommandLineOptions(CommandLine& cmd)
+{
+    cmd.AddValue("replications", "Number of independent replications", m_replications);
+    cmd.AddValue("jobs",
+                 "Maximum number of replications run in parallel, 0 for one per hardware thread",
+                 m_jobs);
+    cmd.AddValue("confidence", "Level of the confidence intervals", m_confidenceLevel);
+}
+
+void
+ReplicationHelper::Run(Callback<void, DataCollector&> replication)
+{
+    NS_LOG_FUNCTION(this);
+    NS_ABORT_MSG_IF(m_confidenceLevel <= 0 || m_confidenceLevel >= 1,
+                    "The confidence level must be in (0, 1)");
+    uint64_t firstRun = m_firstRunSet ? m_firstRun : RngSeedManager::GetRun();
+
+    SimulationFork fork;
+    if (m_jobs > 0)
+    {
+        fork.SetMaxChildren(m_jobs);
+    }
+    uint32_t index = fork.ForkAt(Simulator::Now(), m_replications);
+    if (fork.IsChild())
+    {
+        uint64_t run = firstRun + index;
+        RngSeedManager::SetRun(run);
+        Ptr<DataCollector> collector = CreateObject<DataCollector>();
+        collector->DescribeRun("", "", "", std::to_string(run));
+        replication(*collector);
+
+        std::ostringstream oss;
+        ReplicationOutputCallback callback(oss);
+        for (auto i = collector->DataCalculatorBegin(); i != collector->DataCalculatorEnd(); i++)
+        {
+            (*i)->Output(callback);
+        }
+        collector->Dispose();
+        fork.Exit(oss.str());
+    }
+
+    m_samples.clear();
+    const auto& results = fork.GetResults();
+    for (uint32_t i = 0; i < results.size(); i++)
+    {
+        std::istringstream lines(results[i]);
+        std::string line;
+        while (std::getline(lines, line))
+        {
+            std::size_t first = line.find('\t');
+            std::size_t second = line.find('\t', first + 1);
+            NS_ABORT_MSG_IF(first == std::string::npos || second == std::string::npos,
+                            "Malformed result of replication " << i << ": " << line);
+            std::string key = line.substr(0, first);
+            std::string variable = line.substr(first + 1, second - first - 1);
+            double value = std::stod(line.substr(second + 1));
+            auto it = std::find_if(m_samples.begin(), m_samples.end(), [&](const Variable& v) {
+                return v.key == key && v.variable == variable;
+            });
+            if (it == m_samples.end())
+            {
+                m_samples.push_back({key, variable, {}});
+                it = m_samples.end() - 1;
+            }
+            it->samples.push_back(value);
+        }
+    }
+
+    m_summaries.clear();
+    for (const auto& v : m_samples)
+    {
+        Summary summary{v.key, v.variable, static_cast<uint32_t>(v.samples.size()), 0, 0, 0};
+        double sum = 0;
+        for (double x : v.samples)
+        {
+            sum += x;
+        }
+        summary.mean = sum / summary.count;
+        if (summary.count > 1)
+        {
+            double sqrSum = 0;
+            for (double x : v.samples)
+            {
+                sqrSum += (x - summary.mean) * (x - summary.mean);
+            }
+            summary.stddev = std::sqrt(sqrSum / (summary.count - 1));
+            summary.halfWidth = GetStudentQuantile((1 + m_confidenceLevel) / 2,
+                                                   summary.count - 1) *
+                                summary.stddev / std::sqrt(summary.count);
+        }
+        else
+        {
+            summary.halfWidth = std::numeric_limits<double>::infinity();
+        }
+        m_summaries.push_back(summary);
+    }
+}
+
+const std::vector<ReplicationHelper::Summary>&
+ReplicationHelper::GetSummaries() const
+{
+    return m_summaries;
+}
+
+std::vector<double>
+ReplicationHelper::GetSamples(const std::string& key, const std::string& variable) const
+{
+    for (const auto& v : m_samples)
+    {
+        if (v.key == key && v.variable == variable)
+        {
+            return v.samples;
+        }
+    }
+    return {};
+}
+
+void
+ReplicationHelper::Print(std::ostream& os) const
+{
+    os << m_replications << " replications, " << m_confidenceLevel * 100
+       << "% confidence intervals" << std::endl;
+    for (const auto& summary : m_summaries)
+    {
+        os << summary.key << " " << summary.variable << ": " << summary.mean << " +/- "
+           << summary.halfWidth << " (stddev " << summary.stddev << ", " << summary.count
+           << " samples)" << std::endl;
+    }
+}
+
+double
+ReplicationHelper::GetStudentQuantile(double p, uint32_t dof)
+{
+    NS_ABORT_MSG_IF(p <= 0 || p >= 1, "The probability must be in (0, 1)");
+    NS_ABORT_MSG_IF(dof == 0, "At least one degree of freedom is needed");
+    if (p < 0.5)
+    {
+        return -GetStudentQuantile(1 - p, dof);
+    }
+    // Bisection on the cumulative distribution function
+    double low = 0;
+    double high = 1;
+    while (StudentCdf(high, dof) < p)
+    {
+        high *= 2;
+    }
+    for (int i = 0; i < 200 && high - low > 1e-12 * high; i++)
+    {
+        double mid = (low + high) / 2;
+        if (StudentCdf(mid, dof) < p)
+        {
+            low = mid;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    return (low + high) / 2;
+}
+
+} // namespace ns3
@@ -0,0 +1,163 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef REPLICATION_HELPER_H
+#define REPLICATION_HELPER_H
+
+#include "ns3/callback.h"
+#include "ns3/data-collector.h"
+
+#include <ostream>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+class CommandLine;
+
+/**
+ * \ingroup stats
+ * \brief Run independent replications of a simulation in parallel
+ * processes, and compute confidence intervals of their statistics.
+ *
+ * Every replication runs in a child process forked from the calling
+ * process (see SimulationFork), with its own run number: replication i
+ * runs with RngSeedManager::SetRun(firstRun + i), so that the replications
+ * use independent random streams.  The replication function builds and
+ * runs the whole simulation, and registers the calculators of the stats
+ * framework to report in the DataCollector it is given:
+ *
+ * \code
+ *   void
+ *   RunOnce(DataCollector& collector)
+ *   {
+ *       ... // build the scenario
+ *       Ptr<MinMaxAvgTotalCalculator<double>> delay = ...;
+ *       delay->SetContext("flow");
+ *       delay->SetKey("delay");
+ *       collector.AddDataCalculator(delay);
+ *       Simulator::Run();
+ *   }
+ *
+ *   ReplicationHelper replications;
+ *   replications.AddCommandLineOptions(cmd);
+ *   cmd.Parse(argc, argv);
+ *   replications.Run(MakeCallback(&RunOnce));
+ *   replications.Print(std::cout);
+ * \endcode
+ *
+ * Every singleton output by a calculator, and the mean of every
+ * statistic, is one sample per replication, named after the key and
+ * variable passed to the DataOutputCallback, i.e., the context and key of
+ * the calculator.  The helper summarizes each of them with its mean over
+ * the replications and the half-width of its Student t confidence
+ * interval.  String singletons are ignored.
+ *
+ * Run() must be called before the scenario is built, since the run number
+ * only applies to the random variables created afterwards.
+ *
+ * ReplicationHelper is not available on Windows.
+ */
+class ReplicationHelper
+{
+  public:
+    /** The summary of a variable over the replications. */
+    struct Summary
+    {
+        std::string key;      //!< The key of the variable
+        std::string variable; //!< The name of the variable
+        uint32_t count;       //!< The number of replications which output it
+        double mean;          //!< The mean over the replications
+        double stddev;        //!< The sample standard deviation
+        double halfWidth;     //!< The half-width of the confidence interval
+    };
+
+    ReplicationHelper();
+
+    /**
+     * \param [in] replications The number of replications; 10 by default.
+     */
+    void SetReplications(uint32_t replications);
+    /**
+     * \param [in] run The run number of the first replication; by default,
+     * the run number of the RngSeedManager, i.e., \c --RngRun.
+     */
+    void SetFirstRun(uint64_t run);
+    /**
+     * \param [in] jobs The maximum number of replications which run at the
+     * same time; by default, the number of hardware threads.
+     */
+    void SetJobs(uint32_t jobs);
+    /**
+     * \param [in] level The level of the confidence intervals, in (0, 1);
+     * 0.95 by default.
+     */
+    void SetConfidenceLevel(double level);
+
+    /**
+     * Add the \c --replications, \c --jobs and \c --confidence options to a
+     * command line.
+     *
+     * \param [in,out] cmd The command line.
+     */
+    void AddCommandLineOptions(CommandLine& cmd);
+
+    /**
+     * Run the replications, and summarize their results.
+     *
+     * \param [in] replication The function which runs one replication.
+     */
+    void Run(Callback<void, DataCollector&> replication);
+
+    /**
+     * \returns The summaries of the variables output by the replications,
+     * in the order they were first output.
+     */
+    const std::vector<Summary>& GetSummaries() const;
+
+    /**
+     * \param [in] key The key of the variable.
+     * \param [in] variable The name of the variable.
+     * \returns The samples of the variable, one per replication which
+     * output it.
+     */
+    std::vector<double> GetSamples(const std::string& key, const std::string& variable) const;
+
+    /**
+     * Print the summaries, one variable per line.
+     *
+     * \param [in,out] os The output stream.
+     */
+    void Print(std::ostream& os) const;
+
+    /**
+     * \param [in] p The probability, in (0, 1).
+     * \param [in] dof The degrees of freedom, at least 1.
+     * \returns The \pname{p} quantile of the Student t distribution.
+     */
+    static double GetStudentQuantile(double p, uint32_t dof);
+
+  private:
+    /** The samples of a variable. */
+    struct Variable
+    {
+        std::string key;             //!< The key of the variable
+        std::string variable;        //!< The name of the variable
+        std::vector<double> samples; //!< The samples
+    };
+
+    uint32_t m_replications;          //!< The number of replications
+    uint64_t m_firstRun;              //!< The run number of the first replication
+    bool m_firstRunSet;               //!< Whether the first run number was set
+    uint32_t m_jobs;                  //!< The maximum number of running replications
+    double m_confidenceLevel;         //!< The confidence level
+    std::vector<Variable> m_samples;  //!< The samples of every variable
+    std::vector<Summary> m_summaries; //!< The summaries of every variable
+};
+
+} // namespace ns3
+
+#endif /* REPLICATION_HELPER_H */
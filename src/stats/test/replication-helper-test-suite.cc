@@ -0,0 +1,169 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "ns3/basic-data-calculators.h"
+#include "ns3/data-collector.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/replication-helper.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include <cmath>
+#include <set>
+
+using namespace ns3;
+
+/**
+ * \ingroup stats-tests
+ *
+ * \brief Check the quantiles of the Student t distribution.
+ */
+class StudentQuantileTestCase : public TestCase
+{
+  public:
+    StudentQuantileTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+StudentQuantileTestCase::StudentQuantileTestCase()
+    : TestCase("Check the quantiles of the Student t distribution")
+{
+}
+
+void
+StudentQuantileTestCase::DoRun()
+{
+    const double tolerance = 1e-3;
+    NS_TEST_EXPECT_MSG_EQ_TOL(ReplicationHelper::GetStudentQuantile(0.975, 1),
+                              12.706,
+                              tolerance,
+                              "Wrong quantile");
+    NS_TEST_EXPECT_MSG_EQ_TOL(ReplicationHelper::GetStudentQuantile(0.975, 3),
+                              3.182,
+                              tolerance,
+                              "Wrong quantile");
+    NS_TEST_EXPECT_MSG_EQ_TOL(ReplicationHelper::GetStudentQuantile(0.95, 10),
+                              1.812,
+                              tolerance,
+                              "Wrong quantile");
+    NS_TEST_EXPECT_MSG_EQ_TOL(ReplicationHelper::GetStudentQuantile(0.995, 30),
+                              2.750,
+                              tolerance,
+                              "Wrong quantile");
+    NS_TEST_EXPECT_MSG_EQ_TOL(ReplicationHelper::GetStudentQuantile(0.975, 100000),
+                              1.960,
+                              tolerance,
+                              "Wrong quantile");
+    NS_TEST_EXPECT_MSG_EQ_TOL(ReplicationHelper::GetStudentQuantile(0.025, 3),
+                              -3.182,
+                              tolerance,
+                              "Wrong quantile");
+}
+
+/**
+ * \ingroup stats-tests
+ *
+ * \brief Check that the replications run with their own run numbers, and
+ * that their statistics are summarized.
+ */
+class ReplicationHelperTestCase : public TestCase
+{
+  public:
+    ReplicationHelperTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Run one replication.
+     *
+     * \param [in,out] collector The collector of the replication.
+     */
+    static void Replicate(DataCollector& collector);
+};
+
+ReplicationHelperTestCase::ReplicationHelperTestCase()
+    : TestCase("Check the replications and their confidence intervals")
+{
+}
+
+void
+ReplicationHelperTestCase::Replicate(DataCollector& collector)
+{
+    Ptr<CounterCalculator<>> run = CreateObject<CounterCalculator<>>();
+    run->SetContext("replication");
+    run->SetKey("run");
+    run->Update(RngSeedManager::GetRun());
+    collector.AddDataCalculator(run);
+
+    auto value = CreateObject<MinMaxAvgTotalCalculator<double>>();
+    value->SetContext("replication");
+    value->SetKey("value");
+    Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable>();
+    for (uint32_t i = 0; i < 10; i++)
+    {
+        Simulator::Schedule(MilliSeconds(i),
+                            &MinMaxAvgTotalCalculator<double>::Update,
+                            value,
+                            random->GetValue());
+    }
+    collector.AddDataCalculator(value);
+    Simulator::Run();
+}
+
+void
+ReplicationHelperTestCase::DoRun()
+{
+    ReplicationHelper replications;
+    replications.SetReplications(4);
+    replications.SetFirstRun(7);
+    replications.SetJobs(2);
+    replications.Run(MakeCallback(&ReplicationHelperTestCase::Replicate));
+
+    const auto& summaries = replications.GetSummaries();
+    NS_TEST_ASSERT_MSG_EQ(summaries.size(), 2, "Wrong number of variables");
+    NS_TEST_EXPECT_MSG_EQ(summaries[0].key, "replication", "Wrong key");
+    NS_TEST_EXPECT_MSG_EQ(summaries[0].variable, "run", "Wrong variable");
+    NS_TEST_EXPECT_MSG_EQ(summaries[0].count, 4, "Wrong number of samples");
+    NS_TEST_EXPECT_MSG_EQ_TOL(summaries[0].mean, 8.5, 1e-9, "Wrong mean of the run numbers");
+    // Sample standard deviation of 7, 8, 9, 10, and t(0.975, 3)
+    double stddev = std::sqrt(5.0 / 3);
+    NS_TEST_EXPECT_MSG_EQ_TOL(summaries[0].stddev, stddev, 1e-9, "Wrong standard deviation");
+    NS_TEST_EXPECT_MSG_EQ_TOL(summaries[0].halfWidth,
+                              3.182 * stddev / 2,
+                              1e-3,
+                              "Wrong confidence interval");
+
+    std::vector<double> samples = replications.GetSamples("replication", "value");
+    NS_TEST_ASSERT_MSG_EQ(samples.size(), 4, "Wrong number of samples");
+    std::set<double> distinct(samples.begin(), samples.end());
+    NS_TEST_EXPECT_MSG_EQ(distinct.size(), 4, "The replications share their random streams");
+    for (double sample : samples)
+    {
+        NS_TEST_EXPECT_MSG_GT(sample, 0, "Wrong mean of the uniform samples");
+        NS_TEST_EXPECT_MSG_LT(sample, 1, "Wrong mean of the uniform samples");
+    }
+}
+
+/**
+ * \ingroup stats-tests
+ *
+ * \brief The ReplicationHelper Test Suite.
+ */
+class ReplicationHelperTestSuite : public TestSuite
+{
+  public:
+    ReplicationHelperTestSuite()
+        : TestSuite("replication-helper", Type::UNIT)
+    {
+        AddTestCase(new StudentQuantileTestCase());
+        AddTestCase(new ReplicationHelperTestCase());
+    }
+};
+
+/// Static variable for test initialization.
+static ReplicationHelperTestSuite g_replicationHelperTestSuite;
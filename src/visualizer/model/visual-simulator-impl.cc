@@ -210,6 +210,12 @@ VisualSimulatorImpl::GetEventCount() const
     return m_simulator->GetEventCount();
 }
 
+uint64_t
+VisualSimulatorImpl::GetPendingEventCount() const
+{
+    return m_simulator->GetPendingEventCount();
+}
+
 void
 VisualSimulatorImpl::RunRealSimulator()
 {
@@ -61,6 +61,7 @@ class VisualSimulatorImpl : public SimulatorImpl
     uint32_t GetSystemId() const override;
     uint32_t GetContext() const override;
     uint64_t GetEventCount() const override;
+    uint64_t GetPendingEventCount() const override;
 
     /// calls Run() in the wrapped simulator
     void RunRealSimulator();
@@ -0,0 +1,191 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// This program benchmarks a long background bulk transfer over two
+// point-to-point links, from a sender through a router to a receiver, with
+// a short foreground transfer started on the same path in its middle.  It
+// runs with packets only, then with the background transfer advanced by
+// the fluid model of BulkFlowFastForward while it is alone on its path.
+// The fast-forward should cut the number of events, while the background
+// transfer delivers about the same number of bytes, and the foreground
+// transfer completes in about the same time.
+// Sample usage:  ./ns3 run 'bench-bulk-fast-forward --duration=2s'
+
+#include "ns3/bulk-flow-fast-forward.h"
+#include "ns3/bulk-send-helper.h"
+#include "ns3/command-line.h"
+#include "ns3/config.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-generator.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-global-routing-helper.h"
+#include "ns3/nstime.h"
+#include "ns3/packet-sink-helper.h"
+#include "ns3/packet-sink.h"
+#include "ns3/packet.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/uinteger.h"
+
+#include <iomanip>
+#include <iostream>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+/// Bytes of the background transfer delivered by the fluid model
+static uint64_t g_fluidBytes = 0;
+
+/// Bytes of the foreground transfer
+static uint32_t g_foregroundBytes = 0;
+
+/// Time at which the last byte of the foreground transfer was received
+static Time g_foregroundCompletion;
+
+/**
+ * Record the bytes of the background transfer delivered by the fluid model.
+ * \param flow the index of the flow
+ * \param bytes the number of bytes
+ */
+static void
+FluidRx(uint32_t flow, uint64_t bytes)
+{
+    g_fluidBytes += bytes;
+}
+
+/**
+ * Record the completion of the foreground transfer.
+ * \param sink the sink of the foreground transfer
+ * \param packet the packet received
+ * \param from the address of the sender
+ */
+static void
+ForegroundRx(Ptr<PacketSink> sink, Ptr<const Packet> packet, const Address& from)
+{
+    if (sink->GetTotalRx() == g_foregroundBytes)
+    {
+        g_foregroundCompletion = Simulator::Now();
+    }
+}
+
+/**
+ * Run the transfers.
+ * \param fastForward true to advance the background transfer with the fluid model
+ * \param duration duration of the background transfer
+ * \param foregroundStart start time of the foreground transfer
+ * \param[out] backgroundBytes bytes of the background transfer received
+ * \return the number of events executed
+ */
+static uint64_t
+RunTransfers(bool fastForward, Time duration, Time foregroundStart, uint64_t& backgroundBytes)
+{
+    g_fluidBytes = 0;
+    g_foregroundCompletion = Time();
+    Config::SetDefault("ns3::TcpSocket::SegmentSize", UintegerValue(1448));
+
+    NodeContainer nodes;
+    nodes.Create(3);
+    InternetStackHelper internet;
+    internet.Install(nodes);
+
+    PointToPointHelper p2p;
+    p2p.SetDeviceAttribute("DataRate", StringValue("10Gbps"));
+    p2p.SetChannelAttribute("Delay", StringValue("5us"));
+    NetDeviceContainer access = p2p.Install(nodes.Get(0), nodes.Get(1));
+    p2p.SetDeviceAttribute("DataRate", StringValue("1Gbps"));
+    NetDeviceContainer bottleneck = p2p.Install(nodes.Get(1), nodes.Get(2));
+
+    Ipv4AddressGenerator::Reset();
+    Ipv4AddressHelper address("10.0.1.0", "255.255.255.0");
+    address.Assign(access);
+    address.SetBase("10.0.2.0", "255.255.255.0");
+    Ipv4InterfaceContainer interfaces = address.Assign(bottleneck);
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+
+    // The background transfer, on port 9, and the foreground one, on port 10
+    ApplicationContainer sourceApps;
+    ApplicationContainer sinkApps;
+    for (uint16_t port : {9, 10})
+    {
+        BulkSendHelper sourceHelper("ns3::TcpSocketFactory",
+                                    InetSocketAddress(interfaces.GetAddress(1), port));
+        sourceHelper.SetAttribute("SendSize", UintegerValue(1448));
+        sourceHelper.SetAttribute("MaxBytes", UintegerValue(port == 9 ? 0 : g_foregroundBytes));
+        ApplicationContainer sourceApp = sourceHelper.Install(nodes.Get(0));
+        sourceApp.Start(port == 9 ? Seconds(0) : foregroundStart);
+        sourceApps.Add(sourceApp);
+        PacketSinkHelper sinkHelper("ns3::TcpSocketFactory",
+                                    InetSocketAddress(Ipv4Address::GetAny(), port));
+        sinkApps.Add(sinkHelper.Install(nodes.Get(2)));
+    }
+    sourceApps.Stop(duration);
+    Ptr<PacketSink> background = DynamicCast<PacketSink>(sinkApps.Get(0));
+    Ptr<PacketSink> foreground = DynamicCast<PacketSink>(sinkApps.Get(1));
+    foreground->TraceConnectWithoutContext("Rx", MakeBoundCallback(&ForegroundRx, foreground));
+
+    Ptr<BulkFlowFastForward> fluid;
+    if (fastForward)
+    {
+        NetDeviceContainer path;
+        path.Add(access.Get(0));
+        path.Add(bottleneck.Get(0));
+        fluid = CreateObject<BulkFlowFastForward>();
+        fluid->AddFlow(DynamicCast<BulkSendApplication>(sourceApps.Get(0)), background, path);
+        fluid->TraceConnectWithoutContext("FluidRx", MakeCallback(&FluidRx));
+        fluid->Start(Seconds(0));
+        fluid->Stop(duration);
+    }
+
+    Simulator::Stop(duration + MilliSeconds(10));
+    Simulator::Run();
+    uint64_t events = Simulator::GetEventCount();
+    backgroundBytes = background->GetTotalRx() + g_fluidBytes;
+    Simulator::Destroy();
+    return events;
+}
+
+int
+main(int argc, char* argv[])
+{
+    Time duration = Seconds(2);
+    Time foregroundStart = Seconds(1);
+    uint32_t foregroundBytes = 1000000;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark a long background transfer advanced by a fluid model");
+    cmd.AddValue("duration", "duration of the background transfer", duration);
+    cmd.AddValue("foreground-start", "start time of the foreground transfer", foregroundStart);
+    cmd.AddValue("foreground-bytes", "number of bytes of the foreground transfer", foregroundBytes);
+    cmd.Parse(argc, argv);
+
+    if (foregroundBytes == 0 || foregroundStart >= duration)
+    {
+        std::cerr << "Error-- foreground-bytes must be positive, and foreground-start before "
+                     "the end of the background transfer"
+                  << std::endl;
+        exit(1);
+    }
+    g_foregroundBytes = foregroundBytes;
+    std::cout << "Running bench-bulk-fast-forward with duration=" << duration.As()
+              << " foreground-start=" << foregroundStart.As()
+              << " foreground-bytes=" << foregroundBytes << std::endl;
+
+    for (bool fastForward : {false, true})
+    {
+        SystemWallClockMs time;
+        time.Start();
+        uint64_t backgroundBytes = 0;
+        uint64_t events = RunTransfers(fastForward, duration, foregroundStart, backgroundBytes);
+        int64_t deltaMs = time.End();
+        std::cout << std::setw(8) << (fastForward ? "fluid" : "packets") << ": " << std::setw(10)
+                  << events << " events, background " << backgroundBytes
+                  << " bytes, foreground completion "
+                  << (g_foregroundCompletion - foregroundStart).As(Time::US) << " (" << deltaMs
+                  << " ms elapsed)" << std::endl;
+    }
+    return 0;
+}
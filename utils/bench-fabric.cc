@@ -0,0 +1,70 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// This program benchmarks the construction of k-ary fat-trees with the
+// PointToPointFatTreeHelper: the creation of the nodes and links, the
+// installation of the internet stack and the assignment of the addresses.
+// Every step should take time linear in the number of links, so that a
+// k = 32 fat-tree, with 8192 hosts and 24576 links, is built in seconds.
+// Sample usage:  ./ns3 run 'bench-fabric --max-k=32'
+
+#include "ns3/command-line.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/point-to-point-fat-tree.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include <iomanip>
+#include <iostream>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t maxK = 32;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the construction of fat-trees");
+    cmd.AddValue("max-k", "largest number of ports per switch", maxK);
+    cmd.Parse(argc, argv);
+
+    if (maxK < 4)
+    {
+        std::cerr << "Error-- max-k must be at least 4" << std::endl;
+        exit(1);
+    }
+    std::cout << "Running bench-fabric with max-k=" << maxK << std::endl;
+    std::cout << "Times in ms: links, stack, addresses, total" << std::endl;
+
+    for (uint32_t k = 4; k <= maxK; k += 4)
+    {
+        SystemWallClockMs time;
+        time.Start();
+        PointToPointHelper p2p;
+        PointToPointFatTreeHelper fatTree(k, p2p, p2p);
+        uint64_t linksMs = time.End();
+
+        time.Start();
+        fatTree.InstallStack(InternetStackHelper());
+        uint64_t stackMs = time.End();
+
+        time.Start();
+        fatTree.AssignIpv4Addresses(Ipv4Address("10.0.0.0"), Ipv4Mask("255.0.0.0"));
+        uint64_t addressesMs = time.End();
+
+        // Every host link has one switch port, and every fabric link two
+        uint32_t nLinks = (fatTree.GetSwitchDevices().GetN() + fatTree.HostCount()) / 2;
+        std::cout << "k=" << std::setw(3) << k << " " << std::setw(6) << fatTree.HostCount()
+                  << " hosts " << std::setw(6) << nLinks << " links\t" << std::setw(8) << linksMs
+                  << " " << std::setw(8) << stackMs << " " << std::setw(8) << addressesMs << " "
+                  << std::setw(8) << linksMs + stackMs + addressesMs << std::endl;
+
+        Simulator::Destroy();
+    }
+
+    return 0;
+}
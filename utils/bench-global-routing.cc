@@ -0,0 +1,99 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// This program benchmarks the computation of the global routes of a k-ary
+// fat-tree: the startup cost with one and several SPF threads, and the cost
+// of recomputing the routes after a link failure, from scratch and
+// incrementally.
+// Sample usage:  ./ns3 run 'bench-global-routing --max-k=16 --threads=8'
+
+#include "ns3/boolean.h"
+#include "ns3/command-line.h"
+#include "ns3/global-value.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-global-routing-helper.h"
+#include "ns3/ipv4.h"
+#include "ns3/point-to-point-fat-tree.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/uinteger.h"
+
+#include <iomanip>
+#include <iostream>
+#include <stdlib.h> // for exit ()
+#include <thread>
+
+using namespace ns3;
+
+/**
+ * Time a recomputation of the global routes.
+ * \param threads number of SPF threads
+ * \param incremental whether the routes are recomputed incrementally
+ * \return the elapsed time, in ms
+ */
+static uint64_t
+Recompute(uint32_t threads, bool incremental)
+{
+    GlobalValue::Bind("GlobalRoutingThreads", UintegerValue(threads));
+    GlobalValue::Bind("GlobalRoutingIncremental", BooleanValue(incremental));
+    SystemWallClockMs time;
+    time.Start();
+    Ipv4GlobalRoutingHelper::RecomputeRoutingTables();
+    return time.End();
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t maxK = 12;
+    uint32_t threads = std::thread::hardware_concurrency();
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the computation of the global routes of fat-trees");
+    cmd.AddValue("max-k", "largest number of ports per switch", maxK);
+    cmd.AddValue("threads", "number of SPF threads of the parallel runs", threads);
+    cmd.Parse(argc, argv);
+
+    if (threads == 0)
+    {
+        std::cerr << "Error-- number of threads must be positive" << std::endl;
+        exit(1);
+    }
+    std::cout << "Running bench-global-routing with threads=" << threads << std::endl;
+    std::cout << "Times in ms: startup with 1 and " << threads << " threads, "
+              << "recomputation after a link failure, full and incremental" << std::endl;
+
+    for (uint32_t k = 4; k <= maxK; k += 4)
+    {
+        PointToPointHelper p2p;
+        PointToPointFatTreeHelper fatTree(k, p2p, p2p);
+        fatTree.InstallStack(InternetStackHelper());
+        fatTree.AssignIpv4Addresses(Ipv4Address("10.0.0.0"), Ipv4Mask("255.0.0.0"));
+        uint32_t nNodes = fatTree.HostCount() + fatTree.GetSwitches().GetN();
+
+        Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+        uint64_t serialMs = Recompute(1, false);
+        uint64_t parallelMs = Recompute(threads, false);
+
+        // Fail a link between an aggregation switch and a core switch
+        Ptr<Ipv4> ipv4 = fatTree.GetAggregation(0, 0)->GetObject<Ipv4>();
+        uint32_t interface = ipv4->GetNInterfaces() - 1;
+        ipv4->SetDown(interface);
+        uint64_t fullMs = Recompute(threads, false);
+        ipv4->SetUp(interface);
+        Recompute(threads, false);
+        ipv4->SetDown(interface);
+        uint64_t incrementalMs = Recompute(threads, true);
+
+        std::cout << "k=" << std::setw(3) << k << " " << std::setw(6) << nNodes << " nodes"
+                  << "\tstartup " << std::setw(8) << serialMs << " " << std::setw(8) << parallelMs
+                  << "\tfailure " << std::setw(8) << fullMs << " " << std::setw(8)
+                  << incrementalMs << std::endl;
+
+        Simulator::Destroy();
+    }
+
+    return 0;
+}
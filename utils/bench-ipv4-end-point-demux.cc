@@ -0,0 +1,123 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// This program benchmarks the demultiplexing of the packets received by a
+// server with many connections, e.g. the receiver of an incast.  All the
+// connections are accepted on the same local port, and each lookup finds
+// the endpoint of one of them in the Ipv4EndPointDemux.  The cost per
+// lookup should stay flat as the number of connections grows.
+// Sample usage:  ./ns3 run 'bench-ipv4-end-point-demux --max-sockets=50000'
+
+#include "ns3/abort.h"
+#include "ns3/command-line.h"
+#include "ns3/ipv4-end-point-demux.h"
+#include "ns3/ipv4-end-point.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include <iomanip>
+#include <iostream>
+#include <stdlib.h> // for exit ()
+#include <vector>
+
+using namespace ns3;
+
+/// Local address of the server
+static const Ipv4Address BENCH_SERVER("10.0.0.1");
+
+/// Local port of the server
+static const uint16_t BENCH_PORT = 80;
+
+/**
+ * \param i index of a connection
+ * \return the address of the peer of the connection
+ */
+static Ipv4Address
+GetPeerAddress(uint32_t i)
+{
+    return Ipv4Address(Ipv4Address("10.1.0.0").Get() + i / 1000);
+}
+
+/**
+ * \param i index of a connection
+ * \return the port of the peer of the connection
+ */
+static uint16_t
+GetPeerPort(uint32_t i)
+{
+    return 10000 + i % 1000;
+}
+
+/**
+ * Look up the endpoints of the packets received on the connections.
+ * \param sockets number of connections
+ * \param lookups number of lookups
+ * \return the time spent, in milliseconds
+ */
+static int64_t
+RunLookups(uint32_t sockets, uint32_t lookups)
+{
+    Ptr<Ipv4Interface> interface = CreateObject<Ipv4Interface>();
+    Ipv4EndPointDemux demux;
+    Ipv4EndPoint* listener = demux.Allocate(nullptr, BENCH_PORT);
+    std::vector<Ipv4EndPoint*> endPoints;
+    endPoints.reserve(sockets);
+    for (uint32_t i = 0; i < sockets; i++)
+    {
+        endPoints.push_back(
+            demux.Allocate(nullptr, BENCH_SERVER, BENCH_PORT, GetPeerAddress(i), GetPeerPort(i)));
+        NS_ABORT_MSG_IF(!endPoints.back(), "Allocation failed");
+    }
+
+    SystemWallClockMs time;
+    time.Start();
+    // The connections are visited in a scattered order, which covers all of
+    // them when the number of connections is not a multiple of the stride
+    uint32_t i = 0;
+    for (uint32_t j = 0; j < lookups; j++)
+    {
+        i = (i + 7919) % sockets;
+        Ipv4EndPointDemux::EndPoints found = demux.Lookup(BENCH_SERVER,
+                                                          BENCH_PORT,
+                                                          GetPeerAddress(i),
+                                                          GetPeerPort(i),
+                                                          interface);
+        NS_ABORT_MSG_IF(found.size() != 1 || found.front() != endPoints[i], "Wrong endpoint");
+    }
+    int64_t deltaMs = time.End();
+
+    Ipv4EndPointDemux::EndPoints found =
+        demux.Lookup(BENCH_SERVER, BENCH_PORT, Ipv4Address("10.2.0.1"), 10000, interface);
+    NS_ABORT_MSG_IF(found.size() != 1 || found.front() != listener, "New peers must be accepted");
+    return deltaMs;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t maxSockets = 50000;
+    uint32_t lookups = 1000000;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the lookups of Ipv4EndPointDemux with many connections");
+    cmd.AddValue("max-sockets", "largest number of connections", maxSockets);
+    cmd.AddValue("lookups", "number of lookups per number of connections", lookups);
+    cmd.Parse(argc, argv);
+
+    if (lookups == 0)
+    {
+        std::cerr << "Error-- number of lookups must be positive" << std::endl;
+        exit(1);
+    }
+    std::cout << "Running bench-ipv4-end-point-demux with lookups=" << lookups << std::endl;
+
+    for (uint32_t sockets = 50; sockets <= maxSockets; sockets *= 10)
+    {
+        int64_t deltaMs = RunLookups(sockets, lookups);
+        double ns = deltaMs * 1e6 / lookups;
+        std::cout << "sockets " << std::setw(7) << sockets << ": " << std::setw(10) << ns
+                  << " ns/lookup (" << deltaMs << " ms elapsed)" << std::endl;
+    }
+    return 0;
+}
@@ -9,21 +9,67 @@
 // This program can be used to benchmark packet serialization/deserialization
 // operations using Headers and Tags, for various numbers of packets 'n'
 // Sample usage:  ./ns3 run 'bench-packets --n=10000'
+//
+// Every benchmark also reports the number of heap allocations per packet;
+// use --packet-pool to allocate the packets from the ns3::PacketPool.
 
 #include "ns3/command-line.h"
 #include "ns3/packet-metadata.h"
+#include "ns3/packet-pool.h"
 #include "ns3/packet.h"
+#include "ns3/simulator.h"
 #include "ns3/system-wall-clock-ms.h"
 
 #include <algorithm>
 #include <iostream>
 #include <limits>
+#include <new>
 #include <sstream>
 #include <stdlib.h> // for exit ()
 #include <string>
 
 using namespace ns3;
 
+/// Number of heap allocations
+uint64_t g_allocations = 0;
+
+/**
+ * Count the heap allocations, to show the cost of creating packets.
+ * \param [in] size The size of the allocation.
+ * \returns The allocated memory.
+ */
+void*
+operator new(std::size_t size)
+{
+    ++g_allocations;
+    void* p = malloc(size ? size : 1);
+    if (!p)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+/**
+ * Release memory allocated by the counting operator new.
+ * \param [in] p The memory.
+ */
+void
+operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+/**
+ * Release memory allocated by the counting operator new.
+ * \param [in] p The memory.
+ */
+void
+operator delete(void* p, std::size_t /* size */) noexcept
+{
+    free(p);
+}
+
 /// BenchHeader class used for benchmarking packet serialization/deserialization
 template <int N>
 class BenchHeader : public Header
@@ -203,6 +249,138 @@ class BenchTag : public Tag
     }
 };
 
+/// HopDelayTag class used to benchmark per-hop delay telemetry carried as a packet tag
+class HopDelayTag : public Tag
+{
+  public:
+    /**
+     * Register this type.
+     * \return The TypeId.
+     */
+    static TypeId GetTypeId()
+    {
+        static TypeId tid = TypeId("anon::HopDelayTag")
+                                .SetParent<Tag>()
+                                .SetGroupName("Utils")
+                                .HideFromDocumentation()
+                                .AddConstructor<HopDelayTag>();
+        return tid;
+    }
+
+    TypeId GetInstanceTypeId() const override
+    {
+        return GetTypeId();
+    }
+
+    uint32_t GetSerializedSize() const override
+    {
+        return 24;
+    }
+
+    void Serialize(TagBuffer buf) const override
+    {
+        buf.WriteU64(m_lastHopTimestamp);
+        buf.WriteU64(m_maxDelay);
+        buf.WriteU64(m_hops);
+    }
+
+    void Deserialize(TagBuffer buf) override
+    {
+        m_lastHopTimestamp = buf.ReadU64();
+        m_maxDelay = buf.ReadU64();
+        m_hops = buf.ReadU64();
+    }
+
+    void Print(std::ostream& os) const override
+    {
+        os << "hops=" << m_hops;
+    }
+
+    uint64_t m_lastHopTimestamp{0}; //!< Time at which the packet was last stamped (ns)
+    uint64_t m_maxDelay{0};         //!< Maximum per-hop delay (ns)
+    uint64_t m_hops{0};             //!< Number of hops traversed
+};
+
+/// Number of hops traversed by each packet in the forwarding benchmarks
+static const uint32_t BENCH_HOPS = 4;
+
+static void
+benchHopDelayTag(uint32_t n)
+{
+    BenchHeader<25> ipv4;
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        Ptr<Packet> p = Create<Packet>(1000);
+        p->AddHeader(ipv4);
+        for (uint64_t hop = 0; hop < BENCH_HOPS; hop++)
+        {
+            // Each hop receives a copy of the packet, as Ipv4L3Protocol::Receive does
+            p = p->Copy();
+            uint64_t now = (i + hop) * 1000;
+            HopDelayTag tag;
+            if (!p->PeekPacketTag(tag))
+            {
+                tag.m_lastHopTimestamp = now;
+                p->AddPacketTag(tag);
+            }
+            else
+            {
+                tag.m_maxDelay = std::max(tag.m_maxDelay, now - tag.m_lastHopTimestamp);
+                tag.m_lastHopTimestamp = now;
+                tag.m_hops++;
+                p->ReplacePacketTag(tag);
+            }
+        }
+        HopDelayTag tag;
+        p->PeekPacketTag(tag);
+    }
+}
+
+static void
+benchHopDelayTelemetry(uint32_t n)
+{
+    BenchHeader<25> ipv4;
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        Ptr<Packet> p = Create<Packet>(1000);
+        p->AddHeader(ipv4);
+        for (uint64_t hop = 0; hop < BENCH_HOPS; hop++)
+        {
+            // Each hop receives a copy of the packet, as Ipv4L3Protocol::Receive does
+            p = p->Copy();
+            p->RecordTelemetryHop(NanoSeconds((i + hop) * 1000));
+        }
+        p->GetTelemetry().GetMaxHopDelay();
+    }
+}
+
+static void
+benchForward(uint32_t n)
+{
+    BenchHeader<25> ipv4;
+    BenchHeader<8> udp;
+    BenchTag<16> priority;
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        Ptr<Packet> p = Create<Packet>(1000);
+        p->AddHeader(udp);
+        p->AddHeader(ipv4);
+        for (uint32_t hop = 0; hop < BENCH_HOPS; hop++)
+        {
+            // Each hop receives a copy of the packet, as Ipv4L3Protocol::Receive does,
+            // and tags it while it goes through the queue of the output device
+            p = p->Copy();
+            p->RemoveHeader(ipv4);
+            p->AddHeader(ipv4);
+            p->AddPacketTag(priority);
+            p->RemovePacketTag(priority);
+        }
+    }
+}
+
 static void
 benchD(uint32_t n)
 {
@@ -321,6 +499,37 @@ benchFragment(uint32_t n)
     }
 }
 
+static void
+benchSegment(uint32_t n)
+{
+    BenchHeader<20> tcp;
+    BenchHeader<20> ipv4;
+    const uint32_t segmentSize = 1448;
+    const uint32_t sendSize = 512;
+
+    // Cut a stream of zero-filled application packets into segments, as
+    // TcpTxBuffer does: the rest of a packet stays in the buffer
+    Ptr<Packet> rest = Create<Packet>(sendSize);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        uint32_t size = std::min(rest->GetSize(), segmentSize);
+        Ptr<Packet> segment = rest->CreateFragment(0, size);
+        rest->RemoveAtStart(size);
+        while (segment->GetSize() < segmentSize)
+        {
+            if (rest->GetSize() == 0)
+            {
+                rest = Create<Packet>(sendSize);
+            }
+            size = std::min(rest->GetSize(), segmentSize - segment->GetSize());
+            segment->AddAtEnd(rest->CreateFragment(0, size));
+            rest->RemoveAtStart(size);
+        }
+        segment->AddHeader(tcp);
+        segment->AddHeader(ipv4);
+    }
+}
+
 static void
 benchByteTags(uint32_t n)
 {
@@ -339,13 +548,82 @@ benchByteTags(uint32_t n)
     }
 }
 
+/**
+ * Add the packet tags of the packet tag benchmarks: a flow id, a priority,
+ * a delay record and a socket option, as a typical stack does.
+ *
+ * \param p the packet
+ */
+static void
+addPacketTags(Ptr<Packet> p)
+{
+    p->AddPacketTag(BenchTag<4>());
+    p->AddPacketTag(BenchTag<1>());
+    p->AddPacketTag(BenchTag<24>());
+    p->AddPacketTag(BenchTag<2>());
+}
+
+static void
+benchPacketTagAdd(uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+    {
+        Ptr<Packet> p = Create<Packet>(1000);
+        addPacketTags(p);
+    }
+}
+
+static void
+benchPacketTagPeek(uint32_t n)
+{
+    Ptr<Packet> p = Create<Packet>(1000);
+    addPacketTags(p);
+    BenchTag<4> flowId;
+    BenchTag<24> delay;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        p->PeekPacketTag(flowId);
+        p->PeekPacketTag(delay);
+    }
+}
+
+static void
+benchPacketTagReplace(uint32_t n)
+{
+    Ptr<Packet> p = Create<Packet>(1000);
+    addPacketTags(p);
+    BenchTag<4> flowId;
+    BenchTag<24> delay;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        p->ReplacePacketTag(flowId);
+        p->ReplacePacketTag(delay);
+    }
+}
+
+static void
+benchPacketTagCopy(uint32_t n)
+{
+    Ptr<Packet> p = Create<Packet>(1000);
+    addPacketTags(p);
+    BenchTag<24> delay;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        // Each hop updates the delay record of its own copy
+        Ptr<Packet> copy = p->Copy();
+        copy->ReplacePacketTag(delay);
+    }
+}
+
 static uint64_t
-runBenchOneIteration(void (*bench)(uint32_t), uint32_t n)
+runBenchOneIteration(void (*bench)(uint32_t), uint32_t n, uint64_t& allocations)
 {
     SystemWallClockMs time;
+    uint64_t start = g_allocations;
     time.Start();
     (*bench)(n);
     uint64_t deltaMs = time.End();
+    allocations = g_allocations - start;
     return deltaMs;
 }
 
@@ -353,16 +631,21 @@ static void
 runBench(void (*bench)(uint32_t), uint32_t n, uint32_t minIterations, const char* name)
 {
     uint64_t minDelay = std::numeric_limits<uint64_t>::max();
+    uint64_t minAllocations = std::numeric_limits<uint64_t>::max();
     for (uint32_t i = 0; i < minIterations; i++)
     {
-        uint64_t delay = runBenchOneIteration(bench, n);
+        uint64_t allocations;
+        uint64_t delay = runBenchOneIteration(bench, n, allocations);
         minDelay = std::min(minDelay, delay);
+        minAllocations = std::min(minAllocations, allocations);
     }
     double ps = n;
     ps *= 1000;
     ps /= minDelay;
     std::cout << ps << " packets/s"
-              << " (" << minDelay << " ms elapsed)\t" << name << std::endl;
+              << " (" << minDelay << " ms elapsed, "
+              << static_cast<double>(minAllocations) / n << " allocs/packet)\t" << name
+              << std::endl;
 }
 
 int
@@ -371,6 +654,7 @@ main(int argc, char* argv[])
     uint32_t n = 0;
     uint32_t minIterations = 1;
     bool enablePrinting = false;
+    bool packetPool = false;
 
     CommandLine cmd(__FILE__);
     cmd.Usage("Benchmark Packet class");
@@ -379,7 +663,13 @@ main(int argc, char* argv[])
                  "number of subiterations to minimize iteration time over",
                  minIterations);
     cmd.AddValue("enable-printing", "enable packet printing", enablePrinting);
+    cmd.AddValue("packet-pool", "allocate the packets from the packet pool", packetPool);
     cmd.Parse(argc, argv);
+    PacketPool::SetEnabled(packetPool);
+    // Freeze the time resolution, as a running simulation does, so that the
+    // Time objects of the packets are not tracked in the set of marked times
+    Simulator::Run();
+    Simulator::Destroy();
 
     if (n == 0)
     {
@@ -395,7 +685,18 @@ main(int argc, char* argv[])
     runBench(&benchC, n, minIterations, "Remove by func call");
     runBench(&benchD, n, minIterations, "Intermixed add/remove headers and tags");
     runBench(&benchFragment, n, minIterations, "Fragmentation and concatenation");
+    runBench(&benchSegment, n, minIterations, "Segmentation of a zero-filled stream");
     runBench(&benchByteTags, n, minIterations, "Benchmark byte tags");
+    runBench(&benchHopDelayTag, n, minIterations, "Per-hop delay forwarding with packet tag");
+    runBench(&benchHopDelayTelemetry,
+             n,
+             minIterations,
+             "Per-hop delay forwarding with inline telemetry");
+    runBench(&benchForward, n, minIterations, "Forwarding with packet tags");
+    runBench(&benchPacketTagAdd, n, minIterations, "Add 4 packet tags");
+    runBench(&benchPacketTagPeek, n, minIterations, "Peek 2 packet tags out of 4");
+    runBench(&benchPacketTagReplace, n, minIterations, "Replace 2 packet tags out of 4");
+    runBench(&benchPacketTagCopy, n, minIterations, "Copy with 4 packet tags, replace 1");
 
     return 0;
 }
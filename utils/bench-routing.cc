@@ -0,0 +1,166 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// This program benchmarks IPv4 unicast route lookups of the static and the
+// global routing protocols as the forwarding table grows, e.g. in a large
+// datacenter fabric.  The per-lookup cost should stay flat as the number of
+// routes increases.
+// Sample usage:  ./ns3 run 'bench-routing --max-routes=100000 --n=1000000'
+
+#include "ns3/abort.h"
+#include "ns3/command-line.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-global-routing-helper.h"
+#include "ns3/ipv4-global-routing.h"
+#include "ns3/ipv4-static-routing-helper.h"
+#include "ns3/ipv4-static-routing.h"
+#include "ns3/node.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include <iomanip>
+#include <iostream>
+#include <stdlib.h> // for exit ()
+#include <vector>
+
+using namespace ns3;
+
+/// Number of interfaces of the benchmarked node
+static const uint32_t BENCH_INTERFACES = 4;
+
+/// First destination network of the benchmarked routes
+static const uint32_t BENCH_BASE = 0x0b000000; // 11.0.0.0
+
+/**
+ * Create a node with BENCH_INTERFACES addressed interfaces.
+ * \param routing the routing helper of the node
+ * \return the node
+ */
+static Ptr<Node>
+CreateRouter(const Ipv4RoutingHelper& routing)
+{
+    Ptr<Node> node = CreateObject<Node>();
+    InternetStackHelper internet;
+    internet.SetRoutingHelper(routing);
+    internet.Install(node);
+
+    SimpleNetDeviceHelper devHelper;
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("172.16.0.0", "255.255.255.0");
+    for (uint32_t i = 0; i < BENCH_INTERFACES; i++)
+    {
+        ipv4.Assign(devHelper.Install(node));
+        ipv4.NewNetwork();
+    }
+    return node;
+}
+
+/**
+ * Route lookups to random destinations among the benchmarked routes.
+ * \param routing the routing protocol
+ * \param dests the destinations
+ * \return the elapsed time, in ms
+ */
+static uint64_t
+RunLookups(Ptr<Ipv4RoutingProtocol> routing, const std::vector<Ipv4Address>& dests)
+{
+    Ipv4Header header;
+    header.SetSource(Ipv4Address("172.16.0.1"));
+    header.SetProtocol(17);
+    Socket::SocketErrno sockerr;
+    uint32_t found = 0;
+
+    SystemWallClockMs time;
+    time.Start();
+    for (const auto& dest : dests)
+    {
+        header.SetDestination(dest);
+        if (routing->RouteOutput(nullptr, header, nullptr, sockerr))
+        {
+            found++;
+        }
+    }
+    uint64_t deltaMs = time.End();
+    NS_ABORT_MSG_IF(found != dests.size(), "Missing routes");
+    return deltaMs;
+}
+
+/**
+ * Print the lookup cost of a routing protocol.
+ * \param name name of the routing protocol
+ * \param deltaMs elapsed time, in ms
+ * \param n number of lookups
+ */
+static void
+PrintLookups(const char* name, uint64_t deltaMs, uint32_t n)
+{
+    double ns = deltaMs * 1e6 / n;
+    std::cout << "\t" << name << " " << std::setw(10) << ns << " ns/lookup"
+              << " (" << deltaMs << " ms elapsed)";
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t n = 1000000;
+    uint32_t maxRoutes = 100000;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark IPv4 static and global routing lookups");
+    cmd.AddValue("n", "number of lookups per table size", n);
+    cmd.AddValue("max-routes", "largest number of routes", maxRoutes);
+    cmd.Parse(argc, argv);
+
+    if (n == 0)
+    {
+        std::cerr << "Error-- number of lookups must be positive" << std::endl;
+        exit(1);
+    }
+    std::cout << "Running bench-routing with n=" << n << std::endl;
+    std::cout << "All routes are /24 network routes." << std::endl;
+
+    Ipv4StaticRoutingHelper staticHelper;
+    Ipv4GlobalRoutingHelper globalHelper;
+
+    for (uint32_t nRoutes = 10; nRoutes <= maxRoutes; nRoutes *= 10)
+    {
+        Ptr<Node> staticNode = CreateRouter(staticHelper);
+        Ptr<Ipv4> staticIpv4 = staticNode->GetObject<Ipv4>();
+        Ptr<Ipv4StaticRouting> staticRouting = staticHelper.GetStaticRouting(staticIpv4);
+
+        Ptr<Node> globalNode = CreateRouter(globalHelper);
+        Ptr<Ipv4RoutingProtocol> globalProtocol =
+            globalNode->GetObject<Ipv4>()->GetRoutingProtocol();
+        Ptr<Ipv4GlobalRouting> globalRouting = globalProtocol->GetObject<Ipv4GlobalRouting>();
+
+        for (uint32_t i = 0; i < nRoutes; i++)
+        {
+            Ipv4Address network(BENCH_BASE + (i << 8));
+            uint32_t interface = 1 + i % BENCH_INTERFACES;
+            staticRouting->AddNetworkRouteTo(network, Ipv4Mask("/24"), interface);
+            globalRouting->AddNetworkRouteTo(network, Ipv4Mask("/24"), interface);
+        }
+
+        // Same pseudo-random destinations for both protocols
+        std::vector<Ipv4Address> dests;
+        dests.reserve(n);
+        uint32_t state = 12345;
+        for (uint32_t i = 0; i < n; i++)
+        {
+            state = state * 1664525 + 1013904223;
+            dests.emplace_back(BENCH_BASE + (((state >> 8) % nRoutes) << 8) + (state & 0xff));
+        }
+
+        std::cout << std::setw(7) << nRoutes << " routes";
+        PrintLookups("static", RunLookups(staticRouting, dests), n);
+        PrintLookups("global", RunLookups(globalRouting, dests), n);
+        std::cout << std::endl;
+
+        Simulator::Destroy();
+    }
+
+    return 0;
+}
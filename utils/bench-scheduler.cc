@@ -9,9 +9,11 @@
 #include "ns3/core-module.h"
 
 #include <cmath> // sqrt
+#include <cstdlib>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <new>
 #include <string.h>
 #include <vector>
 
@@ -36,6 +38,51 @@ std::string g_me;
 /** Output field width for numeric data. */
 int g_fwidth = 6;
 
+/** Number of heap allocations made by the program so far. */
+uint64_t g_allocations = 0;
+
+/**
+ * Count the heap allocations, to show the cost of creating events.
+ *
+ * The replacement operators are kept out of line: once inlined, GCC pairs
+ * the \c free() of operator delete with the \c new expression of the
+ * caller, and warns about a mismatched deallocation.
+ *
+ * \param [in] size The size of the allocation.
+ * \returns The allocated memory.
+ */
+[[gnu::noinline]] void*
+operator new(std::size_t size)
+{
+    ++g_allocations;
+    void* p = malloc(size ? size : 1);
+    if (!p)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+/**
+ * Release memory allocated by the counting operator new.
+ * \param [in] p The memory.
+ */
+[[gnu::noinline]] void
+operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+/**
+ * Release memory allocated by the counting operator new.
+ * \param [in] p The memory.
+ */
+[[gnu::noinline]] void
+operator delete(void* p, std::size_t /* size */) noexcept
+{
+    free(p);
+}
+
 /**
  *  Benchmark instance which can do a single run.
  *
@@ -96,6 +143,7 @@ class Bench
         double simu;     /**< Time (s) for simulation. */
         uint64_t pop;    /**< Event population. */
         uint64_t events; /**< Number of events executed. */
+        uint64_t allocs; /**< Number of heap allocations during the simulation. */
     };
 
     /**
@@ -139,14 +187,16 @@ Bench::Run()
     DEB("initialization took " << init << "s");
 
     DEB("running");
+    uint64_t allocs = g_allocations;
     timer.Start();
     Simulator::Run();
     simu = timer.End() / 1000.0;
+    allocs = g_allocations - allocs;
     DEB("run took " << simu << "s");
 
     Simulator::Destroy();
 
-    return Result{init, simu, m_population, m_count};
+    return Result{init, simu, m_population, m_count, allocs};
 }
 
 void
@@ -210,6 +260,7 @@ class BenchSuite
     {
         PhaseResult init; /**< Initialization phase results. */
         PhaseResult run;  /**< Run (simulation) phase results. */
+        double allocs;    /**< Heap allocations per simulated event. */
         /**
          * Construct from the individual run result.
          *
@@ -238,7 +289,8 @@ BenchSuite::Result
 BenchSuite::Result::Bench(Bench::Result r)
 {
     return Result{{r.init, r.pop / r.init, r.init / r.pop},
-                  {r.simu, r.events / r.simu, r.simu / r.events}};
+                  {r.simu, r.events / r.simu, r.simu / r.events},
+                  static_cast<double>(r.allocs) / r.events};
 }
 
 template <typename T>
@@ -250,7 +302,7 @@ BenchSuite::Result::Log(T label) const
     LOG(std::left << std::setw(g_fwidth) << label << std::setw(g_fwidth) << init.time
                   << std::setw(g_fwidth) << init.rate << std::setw(g_fwidth) << init.period
                   << std::setw(g_fwidth) << run.time << std::setw(g_fwidth) << run.rate
-                  << std::setw(g_fwidth) << run.period);
+                  << std::setw(g_fwidth) << run.period << std::setw(g_fwidth) << allocs);
 }
 
 BenchSuite::BenchSuite(ObjectFactory& factory,
@@ -309,12 +361,13 @@ BenchSuite::Header() const
                   << std::left << std::setw(g_fwidth) << "Rate (ev/s)" << std::left
                   << std::setw(g_fwidth) << "Per (s/ev)" << std::left << std::setw(g_fwidth)
                   << "Time (s)" << std::left << std::setw(g_fwidth) << "Rate (ev/s)" << std::left
-                  << "Per (s/ev)");
+                  << std::setw(g_fwidth) << "Per (s/ev)" << std::left << "Allocs/ev");
     LOG(std::setfill('-') << std::right << std::setw(g_fwidth) << " " << std::right
                           << std::setw(g_fwidth) << " " << std::right << std::setw(g_fwidth) << " "
                           << std::right << std::setw(g_fwidth) << " " << std::right
                           << std::setw(g_fwidth) << " " << std::right << std::setw(g_fwidth) << " "
-                          << std::right << std::setw(g_fwidth) << " " << std::setfill(' '));
+                          << std::right << std::setw(g_fwidth) << " " << std::right
+                          << std::setw(g_fwidth) << " " << std::setfill(' '));
 }
 
 void
@@ -335,7 +388,8 @@ BenchSuite::Log() const
     uint64_t n{0};                // number of samples
     Result average{m_results[0]}; // average
     Result moment2{{0, 0, 0},     // 2nd moment, to calculate stdev
-                   {0, 0, 0}};
+                   {0, 0, 0},
+                   0};
 
     for (; n < m_results.size(); ++n)
     {
@@ -358,6 +412,11 @@ BenchSuite::Log() const
         ACCUMULATE(run, period);
 
 #undef ACCUMULATE
+
+        deltaPre = run.allocs - average.allocs;
+        average.allocs += deltaPre / count;
+        deltaPost = run.allocs - average.allocs;
+        moment2.allocs += deltaPre * deltaPost;
     }
 
     auto stdev = Result{
@@ -367,6 +426,7 @@ BenchSuite::Log() const
         {std::sqrt(moment2.run.time / n),
          std::sqrt(moment2.run.rate / n),
          std::sqrt(moment2.run.period / n)},
+        std::sqrt(moment2.allocs / n),
     };
 
     average.Log("average");
@@ -379,21 +439,50 @@ BenchSuite::Log() const
 /**
  *  Create a RandomVariableStream to generate next event delays.
  *
- *  If the \p filename parameter is empty a default exponential time
- *  distribution will be used, with mean delay of 100 ns.
+ *  If the \p filename parameter is empty the \p dist distribution
+ *  will be used:
+ *  - `exp`: exponential, with mean delay of 100 ns (the default);
+ *  - `pareto`: skewed, Pareto with shape 1.2 and mean delay of 100 ns,
+ *    bounded to 1 ms;
+ *  - `bursty`: 99% of the delays within 10 ns, the others up to 10 us.
  *
  *  If the \p filename is `-` standard input will be used.
  *
  *  \param [in] filename The delay interval source file name.
+ *  \param [in] dist The delay distribution, when there is no \p filename.
  *  \returns The RandomVariableStream.
  */
 Ptr<RandomVariableStream>
-GetRandomStream(std::string filename)
+GetRandomStream(std::string filename, std::string dist)
 {
     Ptr<RandomVariableStream> stream = nullptr;
 
-    if (filename.empty())
+    if (filename.empty() && dist == "pareto")
+    {
+        LOG("  Event time distribution:      pareto");
+        auto prv = CreateObject<ParetoRandomVariable>();
+        prv->SetAttribute("Shape", DoubleValue(1.2));
+        prv->SetAttribute("Scale", DoubleValue(100 * 0.2 / 1.2));
+        prv->SetAttribute("Bound", DoubleValue(1000000));
+        stream = prv;
+    }
+    else if (filename.empty() && dist == "bursty")
     {
+        LOG("  Event time distribution:      bursty");
+        auto erv = CreateObject<EmpiricalRandomVariable>();
+        erv->SetInterpolate(true);
+        erv->CDF(0, 0);
+        erv->CDF(10, 0.99);
+        erv->CDF(10000, 1);
+        stream = erv;
+    }
+    else if (filename.empty())
+    {
+        if (dist != "exp")
+        {
+            std::cerr << "Unknown distribution " << dist << std::endl;
+            exit(1);
+        }
         LOG("  Event time distribution:      default exponential");
         auto erv = CreateObject<ExponentialRandomVariable>();
         erv->SetAttribute("Mean", DoubleValue(100));
@@ -449,11 +538,13 @@ main(int argc, char* argv[])
     bool schedList = false;
     bool schedMap = false; // default scheduler
     bool schedPQ = false;
+    bool schedLadder = false;
 
     uint64_t pop = 100000;
     uint64_t total = 1000000;
     uint64_t runs = 1;
     std::string filename = "";
+    std::string dist = "exp";
     bool calRev = false;
 
     CommandLine cmd(__FILE__);
@@ -461,6 +552,7 @@ main(int argc, char* argv[])
               "\n"
               "Event intervals are taken from one of:\n"
               "  an exponential distribution, with mean 100 ns,\n"
+              "  a skewed or a bursty distribution, given by the --dist argument,\n"
               "  an ascii file, given by the --file=\"<filename>\" argument,\n"
               "  or standard input, by the argument --file=\"-\"\n"
               "In the case of either --file form, the input is expected\n"
@@ -474,11 +566,13 @@ main(int argc, char* argv[])
     cmd.AddValue("list", "use ListScheduler", schedList);
     cmd.AddValue("map", "use MapScheduler (default)", schedMap);
     cmd.AddValue("pri", "use PriorityQueue", schedPQ);
+    cmd.AddValue("ladder", "use LadderScheduler", schedLadder);
     cmd.AddValue("debug", "enable debugging output", g_debug);
     cmd.AddValue("pop", "event population size", pop);
     cmd.AddValue("total", "total number of events to run", total);
     cmd.AddValue("runs", "number of runs", runs);
     cmd.AddValue("file", "file of relative event times", filename);
+    cmd.AddValue("dist", "distribution of relative event times: exp, pareto or bursty", dist);
     cmd.AddValue("prec", "printed output precision", g_fwidth);
     cmd.Parse(argc, argv);
 
@@ -490,19 +584,29 @@ main(int argc, char* argv[])
     LOG("  Event population size:        " << pop);
     LOG("  Total events per run:         " << total);
     LOG("  Number of runs per scheduler: " << runs);
+#ifdef NS3_EVENT_POOL
+    LOG("  Event memory pool:            enabled");
+#else
+    LOG("  Event memory pool:            disabled");
+#endif
+#ifdef NS3_COMPACT_EVENT_KEYS
+    LOG("  Compact event keys:           enabled");
+#else
+    LOG("  Compact event keys:           disabled");
+#endif
     DEB("debugging is ON");
 
     if (allSched)
     {
-        schedCal = schedHeap = schedList = schedMap = schedPQ = true;
+        schedCal = schedHeap = schedList = schedMap = schedPQ = schedLadder = true;
     }
     // Set the default case if nothing else is set
-    if (!(schedCal || schedHeap || schedList || schedMap || schedPQ))
+    if (!(schedCal || schedHeap || schedList || schedMap || schedPQ || schedLadder))
     {
         schedMap = true;
     }
 
-    auto eventStream = GetRandomStream(filename);
+    auto eventStream = GetRandomStream(filename, dist);
 
     ObjectFactory factory("ns3::MapScheduler");
     if (schedCal)
@@ -542,6 +646,11 @@ main(int argc, char* argv[])
         factory.SetTypeId("ns3::PriorityQueueScheduler");
         BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
     }
+    if (schedLadder)
+    {
+        factory.SetTypeId("ns3::LadderScheduler");
+        BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
+    }
 
     return 0;
 }
@@ -0,0 +1,212 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// This program benchmarks a bulk TCP transfer over two point-to-point
+// links, from a sender through a router to a receiver, without offloads,
+// with segmentation offload (TSO) at the sender, with generic receive
+// offload (GRO) at the receiver, and with both.  The offloads should cut
+// the number of events per byte, while the links still carry the same
+// segments, so that the completion time barely moves.
+// Sample usage:  ./ns3 run 'bench-tcp-offload --bytes=20000000'
+
+#include "ns3/abort.h"
+#include "ns3/command-line.h"
+#include "ns3/config.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-generator.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-global-routing-helper.h"
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/socket.h"
+#include "ns3/string.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/tcp-socket-factory.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+/// Port of the receiver
+static const uint16_t BENCH_PORT = 5000;
+
+/// Bytes of the transfer
+static uint32_t g_bytes = 0;
+
+/// Bytes written to the socket of the sender
+static uint32_t g_sent = 0;
+
+/// Bytes read from the socket of the receiver
+static uint32_t g_received = 0;
+
+/// Time at which the last byte was received
+static Time g_completion;
+
+/**
+ * Write the data of the transfer to the socket of the sender.
+ * \param socket the socket of the sender
+ * \param available the space available in its transmission buffer
+ */
+static void
+SendData(Ptr<Socket> socket, uint32_t available)
+{
+    while (g_sent < g_bytes && socket->GetTxAvailable() > 0)
+    {
+        uint32_t size = std::min(g_bytes - g_sent, socket->GetTxAvailable());
+        int sent = socket->Send(Create<Packet>(size));
+        NS_ABORT_MSG_IF(sent < 0, "Send failed");
+        g_sent += sent;
+    }
+}
+
+/**
+ * Read the data received by the receiver.
+ * \param socket the socket of the receiver
+ */
+static void
+ReceiveData(Ptr<Socket> socket)
+{
+    while (Ptr<Packet> packet = socket->Recv())
+    {
+        g_received += packet->GetSize();
+    }
+    if (g_received == g_bytes)
+    {
+        g_completion = Simulator::Now();
+    }
+}
+
+/**
+ * Accept the connection of the sender.
+ * \param socket the socket of the connection
+ * \param from the address of the sender
+ */
+static void
+Accept(Ptr<Socket> socket, const Address& from)
+{
+    socket->SetRecvCallback(MakeCallback(&ReceiveData));
+}
+
+/**
+ * Connect the sender, once the nodes are initialized.
+ * \param socket the socket of the sender
+ * \param remote the address of the receiver
+ */
+static void
+Connect(Ptr<Socket> socket, Address remote)
+{
+    socket->Connect(remote);
+}
+
+/**
+ * Run the transfer.
+ * \param tsoMaxSegments maximum number of segments of a super-segment
+ * \param groTimeout time a segment is held for coalescing
+ * \return the number of events executed
+ */
+static uint64_t
+RunTransfer(uint32_t tsoMaxSegments, Time groTimeout)
+{
+    g_sent = 0;
+    g_received = 0;
+    g_completion = Time();
+    Config::SetDefault("ns3::TcpSocket::SegmentSize", UintegerValue(1448));
+    Config::SetDefault("ns3::TcpSocketBase::TsoMaxSegments", UintegerValue(tsoMaxSegments));
+    Config::SetDefault("ns3::TcpSocketBase::GroTimeout", TimeValue(groTimeout));
+
+    NodeContainer nodes;
+    nodes.Create(3);
+    InternetStackHelper internet;
+    internet.Install(nodes);
+
+    PointToPointHelper p2p;
+    p2p.SetDeviceAttribute("DataRate", StringValue("10Gbps"));
+    p2p.SetChannelAttribute("Delay", StringValue("5us"));
+    NetDeviceContainer access = p2p.Install(nodes.Get(0), nodes.Get(1));
+    p2p.SetDeviceAttribute("DataRate", StringValue("1Gbps"));
+    NetDeviceContainer bottleneck = p2p.Install(nodes.Get(1), nodes.Get(2));
+
+    Ipv4AddressGenerator::Reset();
+    Ipv4AddressHelper address("10.0.1.0", "255.255.255.0");
+    address.Assign(access);
+    address.SetBase("10.0.2.0", "255.255.255.0");
+    Ipv4InterfaceContainer interfaces = address.Assign(bottleneck);
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+
+    Ptr<Socket> listener = Socket::CreateSocket(nodes.Get(2), TcpSocketFactory::GetTypeId());
+    listener->Bind(InetSocketAddress(Ipv4Address::GetAny(), BENCH_PORT));
+    listener->Listen();
+    listener->SetAcceptCallback(MakeNullCallback<bool, Ptr<Socket>, const Address&>(),
+                                MakeCallback(&Accept));
+
+    Ptr<Socket> sender = Socket::CreateSocket(nodes.Get(0), TcpSocketFactory::GetTypeId());
+    sender->SetSendCallback(MakeCallback(&SendData));
+    Address remote = InetSocketAddress(interfaces.GetAddress(1), BENCH_PORT);
+    Simulator::Schedule(Seconds(0), &Connect, sender, remote);
+
+    Simulator::Run();
+    uint64_t events = Simulator::GetEventCount();
+    Simulator::Destroy();
+    NS_ABORT_MSG_IF(g_received != g_bytes, "Wrong number of bytes received");
+    return events;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t bytes = 20000000;
+    uint32_t tsoMaxSegments = 16;
+    Time groTimeout = MicroSeconds(100);
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark a bulk TCP transfer with segmentation and receive offloads");
+    cmd.AddValue("bytes", "number of bytes of the transfer", bytes);
+    cmd.AddValue("tso-max-segments",
+                 "maximum number of segments of a super-segment",
+                 tsoMaxSegments);
+    cmd.AddValue("gro-timeout", "time a segment is held for coalescing", groTimeout);
+    cmd.Parse(argc, argv);
+
+    if (bytes == 0 || tsoMaxSegments < 2 || groTimeout.IsZero())
+    {
+        std::cerr << "Error-- tso-max-segments must be at least 2, and bytes and gro-timeout "
+                     "positive"
+                  << std::endl;
+        exit(1);
+    }
+    g_bytes = bytes;
+    std::cout << "Running bench-tcp-offload with bytes=" << bytes
+              << " tso-max-segments=" << tsoMaxSegments << " gro-timeout=" << groTimeout.As()
+              << std::endl;
+
+    const struct
+    {
+        const char* name;
+        uint32_t tsoMaxSegments;
+        Time groTimeout;
+    } modes[] = {
+        {"none", 1, Time()},
+        {"TSO", tsoMaxSegments, Time()},
+        {"GRO", 1, groTimeout},
+        {"TSO+GRO", tsoMaxSegments, groTimeout},
+    };
+    for (const auto& mode : modes)
+    {
+        SystemWallClockMs time;
+        time.Start();
+        uint64_t events = RunTransfer(mode.tsoMaxSegments, mode.groTimeout);
+        int64_t deltaMs = time.End();
+        std::cout << std::setw(8) << mode.name << ": " << std::setw(10) << events << " events, "
+                  << std::setw(8) << events * 1e6 / bytes << " events/MB, completion "
+                  << g_completion.As(Time::MS) << " (" << deltaMs << " ms elapsed)" << std::endl;
+    }
+    return 0;
+}
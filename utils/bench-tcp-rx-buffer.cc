@@ -0,0 +1,133 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// This program benchmarks the reordering buffer of TcpRxBuffer when the
+// segments of a flow are sprayed over paths of different delays, e.g. with
+// per-packet multipath in a datacenter fabric.  The segments sent on the
+// slowest path arrive after --reorder later segments, which the receiver
+// buffers, reports in its SACK blocks, and delivers to the application
+// once the gap is filled.  The cost per segment should stay flat as the
+// reordering depth grows.
+// Sample usage:  ./ns3 run 'bench-tcp-rx-buffer --max-reorder=10000'
+
+#include "ns3/abort.h"
+#include "ns3/command-line.h"
+#include "ns3/packet.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/tcp-header.h"
+#include "ns3/tcp-rx-buffer.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <stdlib.h> // for exit ()
+#include <vector>
+
+using namespace ns3;
+
+/// Segment size of the benchmarked connection
+static const uint32_t BENCH_SEGMENT_SIZE = 1000;
+
+/// First sequence number of the benchmarked connection
+static const uint32_t BENCH_ISN = 1;
+
+/**
+ * Order of arrival of segments sprayed round-robin over paths whose delays,
+ * in segment transmission times, grow linearly from 0 to reorder.
+ * \param n number of segments
+ * \param paths number of paths
+ * \param reorder delay of the slowest path
+ * \return the indexes of the segments in the order of arrival
+ */
+static std::vector<uint32_t>
+GetArrivals(uint32_t n, uint32_t paths, uint32_t reorder)
+{
+    std::vector<std::pair<uint64_t, uint32_t>> arrivals;
+    arrivals.reserve(n);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        uint32_t path = i % paths;
+        uint64_t delay = paths > 1 ? static_cast<uint64_t>(reorder) * path / (paths - 1) : 0;
+        arrivals.emplace_back(i + delay, i);
+    }
+    std::stable_sort(arrivals.begin(), arrivals.end());
+    std::vector<uint32_t> order;
+    order.reserve(n);
+    for (const auto& arrival : arrivals)
+    {
+        order.push_back(arrival.second);
+    }
+    return order;
+}
+
+/**
+ * Receive the segments of a flow.
+ * \param order the indexes of the segments in the order of arrival
+ * \return the number of bytes delivered to the application
+ */
+static uint64_t
+RunReceiver(const std::vector<uint32_t>& order)
+{
+    Ptr<TcpRxBuffer> rxBuf = CreateObject<TcpRxBuffer>();
+    rxBuf->SetMaxBufferSize(1 << 30);
+    rxBuf->SetNextRxSequence(SequenceNumber32(BENCH_ISN));
+
+    Ptr<Packet> segment = Create<Packet>(BENCH_SEGMENT_SIZE);
+    TcpHeader header;
+    uint64_t delivered = 0;
+    uint64_t sackBlocks = 0;
+    for (uint32_t index : order)
+    {
+        header.SetSequenceNumber(SequenceNumber32(BENCH_ISN + index * BENCH_SEGMENT_SIZE));
+        rxBuf->Add(segment->Copy(), header);
+
+        // Every segment is acknowledged, and the in-order data is read by the
+        // application as soon as it is available
+        sackBlocks += rxBuf->GetSackList().size();
+        if (rxBuf->Available() > 0)
+        {
+            delivered += rxBuf->Extract(rxBuf->Available())->GetSize();
+        }
+    }
+    NS_ABORT_MSG_IF(rxBuf->Size() != 0, "Data left in the buffer");
+    NS_ABORT_MSG_IF(sackBlocks == 0 && order.size() > 1 && order[0] != 0, "No SACK reported");
+    return delivered;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t n = 100000;
+    uint32_t paths = 4;
+    uint32_t maxReorder = 10000;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the reordering buffer of TcpRxBuffer with multipath reordering");
+    cmd.AddValue("n", "number of segments per reordering depth", n);
+    cmd.AddValue("paths", "number of paths", paths);
+    cmd.AddValue("max-reorder", "largest delay of the slowest path, in segments", maxReorder);
+    cmd.Parse(argc, argv);
+
+    if (n == 0 || paths == 0)
+    {
+        std::cerr << "Error-- number of segments and of paths must be positive" << std::endl;
+        exit(1);
+    }
+    std::cout << "Running bench-tcp-rx-buffer with n=" << n << " paths=" << paths << std::endl;
+
+    for (uint32_t reorder = 10; reorder <= maxReorder; reorder *= 10)
+    {
+        std::vector<uint32_t> order = GetArrivals(n, paths, reorder);
+        SystemWallClockMs time;
+        time.Start();
+        uint64_t delivered = RunReceiver(order);
+        uint64_t deltaMs = time.End();
+        NS_ABORT_MSG_IF(delivered != static_cast<uint64_t>(n) * BENCH_SEGMENT_SIZE,
+                        "Wrong number of bytes delivered");
+        double ns = deltaMs * 1e6 / n;
+        std::cout << "reorder " << std::setw(6) << reorder << " segments: " << std::setw(10) << ns
+                  << " ns/segment (" << deltaMs << " ms elapsed)" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,139 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+// This program benchmarks the SACK scoreboard of TcpTxBuffer during a loss
+// recovery over a large window, e.g. on a high bandwidth-delay product path.
+// Each ACK carries the SACK blocks of a receiver that lost one segment out
+// of every --loss-every, and the sender updates the scoreboard, asks for the
+// next segment to send, and retransmits it as TcpSocketBase does.  The cost
+// per ACK should stay flat as the window grows.
+// Sample usage:  ./ns3 run 'bench-tcp-tx-buffer --max-window=10000'
+
+#include "ns3/abort.h"
+#include "ns3/command-line.h"
+#include "ns3/packet.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/tcp-option-sack.h"
+#include "ns3/tcp-tx-buffer.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+/// Segment size of the benchmarked connection
+static const uint32_t BENCH_SEGMENT_SIZE = 1000;
+
+/// First sequence number of the benchmarked connection
+static const uint32_t BENCH_ISN = 1;
+
+/**
+ * \return an unlimited receiver window
+ */
+static uint32_t
+GetRWnd()
+{
+    return std::numeric_limits<uint32_t>::max();
+}
+
+/**
+ * Send a window, and run a loss recovery over it.
+ * \param window number of segments in flight
+ * \param lossEvery one segment out of lossEvery is lost
+ * \return the number of ACKs processed
+ */
+static uint32_t
+RunRecovery(uint32_t window, uint32_t lossEvery)
+{
+    Ptr<TcpTxBuffer> txBuf = CreateObject<TcpTxBuffer>();
+    txBuf->SetRWndCallback(MakeCallback(&GetRWnd));
+    txBuf->SetMaxBufferSize(window * BENCH_SEGMENT_SIZE);
+    txBuf->SetSegmentSize(BENCH_SEGMENT_SIZE);
+    txBuf->SetDupAckThresh(3);
+    txBuf->SetHeadSequence(SequenceNumber32(BENCH_ISN));
+    txBuf->Add(Create<Packet>(window * BENCH_SEGMENT_SIZE));
+
+    for (uint32_t i = 0; i < window; i++)
+    {
+        txBuf->CopyFromSequence(BENCH_SEGMENT_SIZE,
+                                SequenceNumber32(BENCH_ISN + i * BENCH_SEGMENT_SIZE));
+    }
+
+    // The receiver reports the block which holds the last received segment,
+    // followed by the two previous blocks (RFC 2018)
+    uint32_t acks = 0;
+    Ptr<TcpOptionSack> sack = CreateObject<TcpOptionSack>();
+    SequenceNumber32 seq;
+    SequenceNumber32 seqHigh;
+    for (uint32_t i = 1; i < window; i++)
+    {
+        if (i % lossEvery == 0)
+        {
+            continue;
+        }
+        uint32_t first = i - i % lossEvery + 1;
+        sack->ClearSackList();
+        for (uint32_t b = 0; b < 3 && first > lossEvery * b; b++)
+        {
+            uint32_t blockStart = first - lossEvery * b;
+            uint32_t blockEnd = b == 0 ? i + 1 : blockStart + lossEvery - 1;
+            sack->AddSackBlock(TcpOptionSack::SackBlock(
+                SequenceNumber32(BENCH_ISN + blockStart * BENCH_SEGMENT_SIZE),
+                SequenceNumber32(BENCH_ISN + blockEnd * BENCH_SEGMENT_SIZE)));
+        }
+        txBuf->Update(sack->GetSackList());
+        acks++;
+
+        if (txBuf->IsLost(txBuf->HeadSequence()) &&
+            txBuf->NextSeg(&seq, &seqHigh, true) && txBuf->IsLost(seq))
+        {
+            txBuf->CopyFromSequence(BENCH_SEGMENT_SIZE, seq);
+        }
+        txBuf->BytesInFlight();
+    }
+
+    txBuf->DiscardUpTo(SequenceNumber32(BENCH_ISN + window * BENCH_SEGMENT_SIZE));
+    NS_ABORT_MSG_IF(txBuf->Size() != 0, "Data left in the buffer");
+    return acks;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t maxWindow = 10000;
+    uint32_t lossEvery = 10;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the SACK scoreboard of TcpTxBuffer over large windows");
+    cmd.AddValue("max-window", "largest window, in segments", maxWindow);
+    cmd.AddValue("loss-every", "one segment out of loss-every is lost", lossEvery);
+    cmd.Parse(argc, argv);
+
+    if (lossEvery < 2)
+    {
+        std::cerr << "Error-- loss-every must be at least 2" << std::endl;
+        exit(1);
+    }
+    std::cout << "Running bench-tcp-tx-buffer with loss-every=" << lossEvery << std::endl;
+
+    for (uint32_t window = 100; window <= maxWindow; window *= 10)
+    {
+        // As many recoveries of the small windows as of the largest one
+        uint64_t acks = 0;
+        SystemWallClockMs time;
+        time.Start();
+        for (uint32_t run = 0; run < std::max(maxWindow / window, 1U); run++)
+        {
+            acks += RunRecovery(window, lossEvery);
+        }
+        uint64_t deltaMs = time.End();
+        double ns = deltaMs * 1e6 / acks;
+        std::cout << "window " << std::setw(7) << window << " segments: " << std::setw(10) << ns
+                  << " ns/ACK (" << deltaMs << " ms elapsed)" << std::endl;
+    }
+    return 0;
+}